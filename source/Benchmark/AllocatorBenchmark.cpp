@@ -0,0 +1,392 @@
+#include "Benchmark.h"
+#include <Engine/Memory/Allocator.h>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+	// The previous allocator: a sorted list of blocks searched linearly for the first gap that fits.
+	class LegacyAllocator
+	{
+	public:
+		LegacyAllocator(u64 size) : m_Memory(malloc(size)), m_Size(size) { }
+		~LegacyAllocator() { free(m_Memory); }
+
+		void* Allocate(u64 size)
+		{
+			u64 current = 0;
+			u64 next = m_Size;
+
+			u64 index = 0;
+			for (; index < m_Blocks.size(); ++index)
+			{
+				next = m_Blocks[index].offset;
+				if (next - current >= size) break;
+				current = next + m_Blocks[index].size;
+			}
+
+			if (current + size > m_Size) return nullptr;
+
+			m_Blocks.insert(m_Blocks.begin() + index, { current, size });
+			return (u8*)m_Memory + current;
+		}
+
+		void Free(void* memory)
+		{
+			for (u64 i = 0; i < m_Blocks.size(); ++i)
+			{
+				if ((u64)((u8*)memory - (u8*)m_Memory) == m_Blocks[i].offset)
+				{
+					m_Blocks.erase(m_Blocks.begin() + i);
+					return;
+				}
+			}
+		}
+
+	private:
+		struct Block
+		{
+			u64 offset;
+			u64 size;
+		};
+
+		void* m_Memory;
+		u64 m_Size;
+		std::vector<Block> m_Blocks;
+	};
+
+	struct TlsfAdapter
+	{
+		void* Allocate(u64 size)
+		{
+			return fw::Allocator::Get()->Allocate(Size(size), "Benchmark").mem;
+		}
+
+		void Free(void* memory) { fw::Allocator::Get()->Free(memory); }
+	};
+
+	constexpr u64 MinAllocationSize = 16;
+	constexpr u64 MaxAllocationSize = 512;
+
+	// Fills the heap up to liveCount blocks, then frees and reallocates random blocks while keeping the live count constant.
+	template <typename Alloc>
+	void Run(fw::bench::Context& context, const c8* name, Alloc& allocator, u64 liveCount, u64 churnCount)
+	{
+		std::mt19937_64 rng(1337);
+		std::uniform_int_distribution<u64> sizes(MinAllocationSize, MaxAllocationSize);
+		std::uniform_int_distribution<u64> slots(0, liveCount - 1);
+
+		std::vector<void*> live(liveCount, nullptr);
+		std::vector<u64> churnSizes(churnCount);
+		std::vector<u64> churnSlots(churnCount);
+		for (u64 i = 0; i < churnCount; ++i)
+		{
+			churnSizes[i] = sizes(rng);
+			churnSlots[i] = slots(rng);
+		}
+
+		context.Measure(std::string(name) + "/fill/" + std::to_string(liveCount), liveCount, [&]
+		{
+			for (u64 i = 0; i < liveCount; ++i)
+				live[i] = allocator.Allocate(sizes(rng));
+		});
+
+		context.Measure(std::string(name) + "/churn/" + std::to_string(liveCount), churnCount, [&]
+		{
+			for (u64 i = 0; i < churnCount; ++i)
+			{
+				void*& slot = live[churnSlots[i]];
+				allocator.Free(slot);
+				slot = allocator.Allocate(churnSizes[i]);
+			}
+		});
+
+		// Free in a shuffled order so coalescing sees a realistic mix of neighbours.
+		std::shuffle(live.begin(), live.end(), rng);
+		context.Measure(std::string(name) + "/drain/" + std::to_string(liveCount), liveCount, [&]
+		{
+			for (void* memory : live)
+				allocator.Free(memory);
+		});
+	}
+}
+
+FW_BENCHMARK(AllocatorLiveBlocks)
+{
+	constexpr u64 HeapSize = 256ull * 1024 * 1024;
+
+	fw::Allocator::Create(Size::Bytes(HeapSize));
+	{
+		TlsfAdapter tlsf;
+		Run(context, "tlsf", tlsf, 10000, 1000000);
+		Run(context, "tlsf", tlsf, 100000, 1000000);
+	}
+	fw::Allocator::Destroy();
+
+	// The linear allocator is O(live blocks) per call, so it gets far fewer churn operations to finish in reasonable time.
+	{
+		LegacyAllocator legacy(HeapSize);
+		Run(context, "legacy", legacy, 10000, 20000);
+	}
+	{
+		LegacyAllocator legacy(HeapSize);
+		Run(context, "legacy", legacy, 100000, 2000);
+	}
+}
+
+namespace
+{
+	// Every thread churns mixed-size blocks, and a share of them is handed to other threads through shared slots,
+	// so frees regularly land on a thread that did not allocate the block.
+	void RunThreaded(fw::bench::Context& context, const c8* name, u32 threadCount, u64 operationsPerThread)
+	{
+		constexpr u64 LivePerThread = 1024;
+		constexpr u64 SharedSlotCount = 4096;
+		constexpr u32 SharePercent = 25;
+
+		std::vector<std::atomic<void*>> shared(SharedSlotCount);
+		for (auto& slot : shared) slot = nullptr;
+
+		auto worker = [&](u32 index)
+		{
+			TlsfAdapter allocator;
+			std::mt19937_64 rng(1337 + index);
+			std::uniform_int_distribution<u64> sizes(MinAllocationSize, MaxAllocationSize);
+			std::uniform_int_distribution<u64> slots(0, LivePerThread - 1);
+			std::uniform_int_distribution<u64> sharedSlots(0, SharedSlotCount - 1);
+			std::uniform_int_distribution<u32> percent(0, 99);
+
+			std::vector<void*> live(LivePerThread, nullptr);
+			for (u64 i = 0; i < operationsPerThread; ++i)
+			{
+				void*& slot = live[slots(rng)];
+				if (slot)
+				{
+					if (percent(rng) < SharePercent)
+					{
+						if (void* previous = shared[sharedSlots(rng)].exchange(slot))
+							allocator.Free(previous);
+					}
+					else
+					{
+						allocator.Free(slot);
+					}
+				}
+				slot = allocator.Allocate(sizes(rng));
+			}
+
+			for (void* memory : live)
+				if (memory) allocator.Free(memory);
+
+			fw::Allocator::ReleaseThreadCache();
+		};
+
+		context.Measure(std::string(name) + "/" + std::to_string(threadCount) + "threads", operationsPerThread * threadCount, [&]
+		{
+			std::vector<std::thread> threads;
+			for (u32 i = 1; i < threadCount; ++i)
+				threads.emplace_back(worker, i);
+			worker(0);
+			for (auto& thread : threads)
+				thread.join();
+		});
+
+		for (auto& slot : shared)
+			if (void* memory = slot.exchange(nullptr)) fw::Allocator::Get()->Free(memory);
+	}
+}
+
+FW_BENCHMARK(AllocatorThreaded)
+{
+	constexpr u64 HeapSize = 256ull * 1024 * 1024;
+	constexpr u64 OperationsPerThread = 1000000;
+
+	fw::Allocator::Create(Size::Bytes(HeapSize), fw::Allocator::Mode::SingleThreaded);
+	RunThreaded(context, "single", 1, OperationsPerThread);
+	fw::Allocator::Destroy();
+
+	u32 maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (u32 threadCount = 1; threadCount <= 8 && threadCount <= maxThreads; threadCount *= 2)
+	{
+		fw::Allocator::Create(Size::Bytes(HeapSize), fw::Allocator::Mode::Concurrent);
+		RunThreaded(context, "concurrent", threadCount, OperationsPerThread);
+
+		auto stats = fw::Allocator::Get()->GetConcurrencyStats();
+		context.AddCounter("lock acquisitions", (f64)stats.lockAcquisitions);
+		context.AddCounter("contended %", stats.lockAcquisitions ? 100.0 * (f64)stats.contendedLocks / (f64)stats.lockAcquisitions : 0.0);
+		context.AddCounter("cache hit %", 100.0 * (f64)stats.cacheHits / (f64)std::max<u64>(1, stats.cacheHits + stats.cacheRefills));
+		context.AddCounter("remote frees", (f64)stats.remoteFrees);
+		fw::Allocator::Destroy();
+	}
+}
+
+namespace
+{
+	// Every movable block starts with its own number and is filled with its low byte,
+	// so a block that moved can be told apart from one that got mixed up or clobbered.
+	void FillMovable(u8* memory, u64 size, u64 number)
+	{
+		memset(memory, (i32)(number & 0xFF), size);
+		memcpy(memory, &number, sizeof(number));
+	}
+
+	bool CheckMovable(const u8* memory, u64 size, u64 number)
+	{
+		u64 stored;
+		memcpy(&stored, memory, sizeof(stored));
+		if (stored != number) return false;
+		for (u64 i = sizeof(number); i < size; ++i)
+			if (memory[i] != (u8)(number & 0xFF)) return false;
+		return true;
+	}
+}
+
+// Frees every other movable block and compacts the holes away, one simulated frame budget at a time.
+FW_BENCHMARK(AllocatorDefragment)
+{
+	constexpr u64 HeapSize = 256ull * 1024 * 1024;
+	constexpr u64 BlockCount = 100000;
+	constexpr f64 FrameBudgetMilliseconds = 0.5;
+
+	fw::Allocator::Create(Size::Bytes(HeapSize), fw::Allocator::Mode::SingleThreaded);
+	fw::Allocator* allocator = fw::Allocator::Get();
+
+	std::mt19937_64 rng(1337);
+	std::uniform_int_distribution<u64> sizes(MinAllocationSize, MaxAllocationSize);
+
+	std::vector<fw::MovableHandle> handles(BlockCount);
+	std::vector<u64> blockSizes(BlockCount);
+	for (u64 i = 0; i < BlockCount; ++i)
+	{
+		blockSizes[i] = sizes(rng);
+		handles[i] = allocator->AllocateMovable(Size::Bytes(blockSizes[i]), "Benchmark");
+		FillMovable((u8*)allocator->Resolve(handles[i]), blockSizes[i], i);
+	}
+
+	std::vector<fw::MovableHandle> stale;
+	std::vector<void*> before(BlockCount, nullptr);
+	for (u64 i = 0; i < BlockCount; ++i)
+	{
+		if (i % 2 == 0)
+		{
+			allocator->FreeMovable(handles[i]);
+			stale.push_back(handles[i]);
+			handles[i] = fw::MovableHandle{ };
+		}
+		else
+		{
+			before[i] = allocator->Resolve(handles[i]);
+		}
+	}
+
+	fw::Allocator::DefragStats start = allocator->GetDefragStats();
+	u64 frames = 0;
+	auto begin = std::chrono::high_resolution_clock::now();
+	while (allocator->GetDefragStats().passes == start.passes)
+	{
+		allocator->Defragment(FrameBudgetMilliseconds);
+		frames++;
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	fw::Allocator::DefragStats stats = allocator->GetDefragStats();
+	u64 moves = stats.moves - start.moves;
+	context.Report("defragment/" + std::to_string(BlockCount / 2), std::max<u64>(moves, 1), std::chrono::duration<f64>(end - begin).count());
+	context.AddCounter("moved MB", (f64)(stats.movedBytes - start.movedBytes) / (1024.0 * 1024.0));
+	context.AddCounter("frames", (f64)frames);
+	context.Check(moves > 0, "defragment moved nothing");
+	context.Check(stats.liveHandles == BlockCount / 2, "defragment changed the live handle count");
+
+	u64 moved = 0, intact = 0;
+	for (u64 i = 1; i < BlockCount; i += 2)
+	{
+		const u8* memory = (const u8*)allocator->Resolve(handles[i]);
+		moved += memory != before[i];
+		intact += memory && CheckMovable(memory, blockSizes[i], i);
+	}
+	context.Check(moved > 0, "no handle resolves to a moved block");
+	context.Check(intact == BlockCount / 2, "a handle resolves to the wrong data after defragment");
+
+	u64 rejected = 0;
+	for (fw::MovableHandle handle : stale)
+		rejected += !allocator->IsValid(handle);
+	context.Check(rejected == stale.size(), "a freed handle still resolves");
+
+	// The last freed slot is handed out first, with a new generation the old handle must not match.
+	fw::MovableHandle reused = allocator->AllocateMovable(Size::Bytes(MinAllocationSize), "Benchmark");
+	context.Check(reused.index == stale.back().index, "a new allocation did not reuse the freed handle slot");
+	context.Check(allocator->IsValid(reused) && !allocator->IsValid(stale.back()), "a reused handle slot accepts the old generation");
+	allocator->FreeMovable(reused);
+
+	for (fw::MovableHandle handle : handles)
+		allocator->FreeMovable(handle);
+	fw::Allocator::Destroy();
+}
+
+FW_BENCHMARK(AllocatorGuards)
+{
+	constexpr u64 HeapSize = 256ull * 1024 * 1024;
+	constexpr u64 BlockCount = 100000;
+
+	struct Setting
+	{
+		const c8* name;
+		u32 flags;
+	};
+	constexpr Setting Settings[] = {
+		{ "none", fw::Allocator::GuardNone },
+		{ "canaries", fw::Allocator::GuardCanaries },
+		{ "all", fw::Allocator::GuardAll },
+	};
+
+	fw::Allocator::Create(Size::Bytes(HeapSize), fw::Allocator::Mode::SingleThreaded);
+	TlsfAdapter allocator;
+	std::mt19937_64 rng(1337);
+	std::uniform_int_distribution<u64> sizes(MinAllocationSize, MaxAllocationSize);
+	std::vector<void*> live(BlockCount, nullptr);
+
+	for (const Setting& setting : Settings)
+	{
+		fw::Allocator::Get()->SetGuards(setting.flags);
+		context.Measure(std::string("guards/") + setting.name, BlockCount, [&]
+		{
+			for (void*& memory : live)
+				memory = allocator.Allocate(sizes(rng));
+			for (void* memory : live)
+				allocator.Free(memory);
+		});
+	}
+
+	// Guarded user pointers sit behind the front padding, and freed ones stay in quarantine without being allocated.
+	u64 guardedAllocated = 0, quarantinedAllocated = 0;
+	for (void*& memory : live)
+	{
+		memory = allocator.Allocate(sizes(rng));
+		guardedAllocated += fw::Allocator::Get()->IsAllocated(memory);
+	}
+	for (void* memory : live)
+	{
+		allocator.Free(memory);
+		quarantinedAllocated += fw::Allocator::Get()->IsAllocated(memory);
+	}
+	context.Check(guardedAllocated == BlockCount, "a live guarded block is not allocated");
+	context.Check(quarantinedAllocated == 0, "a quarantined block is still allocated");
+
+	// Turning guards off evicts the quarantine, and the blocks that were guarded get handed out again as plain ones.
+	fw::Allocator::Get()->SetGuards(fw::Allocator::GuardNone);
+	u64 allocated = 0;
+	for (void*& memory : live)
+	{
+		memory = allocator.Allocate(sizes(rng));
+		allocated += fw::Allocator::Get()->IsAllocated(memory);
+	}
+	context.Check(allocated == BlockCount, "a block reused after guards were turned off is not allocated");
+	for (void* memory : live)
+		allocator.Free(memory);
+
+	fw::Allocator::Destroy();
+}
@@ -0,0 +1,378 @@
+#include "Benchmark.h"
+#include <Engine/Core/Math/Batch.h>
+#include <Engine/Core/Math/Mat4.h>
+#include <Engine/Core/Math/Quat.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+	constexpr u64 ItemCount = 16384 + 7;
+	constexpr u64 Passes = 32;
+
+	struct Vec3Storage
+	{
+		std::vector<f32> x, y, z;
+
+		Vec3Storage(u64 count) : x(count), y(count), z(count) { }
+
+		fw::batch::Vec3Array Get() { return { x.data(), y.data(), z.data() }; }
+		fw::Vec3f At(u64 i) const { return { x[i], y[i], z[i] }; }
+	};
+
+	Vec3Storage CreateVectors(std::mt19937& rng, f32 low, f32 high)
+	{
+		std::uniform_real_distribution<f32> values(low, high);
+		Vec3Storage storage(ItemCount);
+		for (u64 i = 0; i < ItemCount; ++i)
+		{
+			storage.x[i] = values(rng);
+			storage.y[i] = values(rng);
+			storage.z[i] = values(rng);
+		}
+		return storage;
+	}
+
+	f32 MaxError(const Vec3Storage& a, const Vec3Storage& b)
+	{
+		f32 error = 0.0f;
+		for (u64 i = 0; i < ItemCount; ++i)
+		{
+			error = std::max(error, std::abs(a.x[i] - b.x[i]));
+			error = std::max(error, std::abs(a.y[i] - b.y[i]));
+			error = std::max(error, std::abs(a.z[i] - b.z[i]));
+		}
+		return error;
+	}
+
+	struct QuatStorage
+	{
+		std::vector<f32> w, x, y, z;
+
+		QuatStorage(u64 count) : w(count), x(count), y(count), z(count) { }
+
+		fw::batch::QuatArray Get() { return { w.data(), x.data(), y.data(), z.data() }; }
+		fw::Quatf At(u64 i) const { return { w[i], x[i], y[i], z[i] }; }
+		void Set(u64 i, const fw::Quatf& q)
+		{
+			w[i] = q.w;
+			x[i] = q.x;
+			y[i] = q.y;
+			z[i] = q.z;
+		}
+	};
+
+	// Every eighth rotation is a small turn away from the one in the other set, for the nearly parallel case.
+	void CreateRotationPairs(std::mt19937& rng, QuatStorage& a, QuatStorage& b)
+	{
+		std::uniform_real_distribution<f32> angles(-3.0f, 3.0f);
+		std::uniform_real_distribution<f32> small(-0.01f, 0.01f);
+		for (u64 i = 0; i < ItemCount; ++i)
+		{
+			fw::Quatf first(angles(rng), angles(rng), angles(rng));
+			a.Set(i, first);
+			b.Set(i, i % 8 == 0 ? first * fw::Quatf(small(rng), small(rng), small(rng)) : fw::Quatf(angles(rng), angles(rng), angles(rng)));
+		}
+	}
+
+	// Angle of the rotation taking one to the other, in radians.
+	f64 AngleBetween(const fw::Quat<f64>& a, const fw::Quat<f64>& b)
+	{
+		f64 difference = std::min((a - b).Length(), (a + b).Length());
+		return 4.0 * std::asin(std::min(difference * 0.5, 1.0));
+	}
+
+	void ReportThroughput(fw::bench::Context& context, f32 error)
+	{
+		const fw::bench::Result& result = context.GetResults().back();
+		context.AddCounter("Mitems/s", (f64)result.operations / result.seconds * 1e-6);
+		context.AddCounter("max error", error);
+	}
+}
+
+// Every kernel on every instruction set the CPU has, errors are against the scalar kernels.
+FW_BENCHMARK(MathBatch)
+{
+	std::mt19937 rng(42);
+	Vec3Storage points = CreateVectors(rng, -100.0f, 100.0f);
+	Vec3Storage extents = CreateVectors(rng, 0.1f, 10.0f);
+	Vec3Storage maxs(ItemCount);
+	for (u64 i = 0; i < ItemCount; ++i)
+	{
+		maxs.x[i] = points.x[i] + extents.x[i];
+		maxs.y[i] = points.y[i] + extents.y[i];
+		maxs.z[i] = points.z[i] + extents.z[i];
+	}
+	std::vector<f32> radii(extents.x);
+
+	Vec3Storage scales = CreateVectors(rng, 0.5f, 2.0f);
+	std::vector<f32> rw(ItemCount), rx(ItemCount), ry(ItemCount), rz(ItemCount);
+	std::uniform_real_distribution<f32> angles(-3.0f, 3.0f);
+	for (u64 i = 0; i < ItemCount; ++i)
+	{
+		fw::Quatf rotation(angles(rng), angles(rng), angles(rng));
+		rw[i] = rotation.w;
+		rx[i] = rotation.x;
+		ry[i] = rotation.y;
+		rz[i] = rotation.z;
+	}
+	fw::batch::ConstQuatArray rotations(rw.data(), rx.data(), ry.data(), rz.data());
+
+	fw::Mat4f matrix = fw::Mat4f::CreateTransform({ 10.0f, -5.0f, 3.0f }, fw::Quatf(0.3f, 1.2f, -0.7f), { 1.5f, 0.5f, 2.0f });
+
+	Vec3Storage out(ItemCount), outMaxs(ItemCount);
+	std::vector<f32> outRadii(ItemCount);
+	std::vector<fw::Mat4f> matrices(ItemCount);
+
+	// Per item through the math types, what the kernels replace.
+	context.Measure("TransformPoints/Vec3*Mat4", ItemCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ItemCount; ++i)
+			{
+				fw::Vec3f point = points.At(i) * matrix;
+				out.x[i] = point.x;
+				out.y[i] = point.y;
+				out.z[i] = point.z;
+			}
+			fw::bench::DoNotOptimize(out.x[ItemCount - 1]);
+		}
+	});
+	ReportThroughput(context, 0.0f);
+
+	context.Measure("CreateTransforms/Mat4::CreateTransform", ItemCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ItemCount; ++i)
+				matrices[i] = fw::Mat4f::CreateTransform(points.At(i), fw::Quatf(rw[i], rx[i], ry[i], rz[i]), scales.At(i));
+			fw::bench::DoNotOptimize(matrices[ItemCount - 1]);
+		}
+	});
+	ReportThroughput(context, 0.0f);
+
+	fw::batch::ISA best = fw::batch::GetBestISA();
+	fw::batch::SetISA(fw::batch::ISA::Scalar);
+	Vec3Storage referencePoints(ItemCount), referenceMins(ItemCount), referenceMaxs(ItemCount);
+	std::vector<fw::Mat4f> referenceMatrices(ItemCount);
+	fw::batch::TransformPoints(matrix, points.Get(), referencePoints.Get(), ItemCount);
+	fw::batch::TransformAABBs(matrix, points.Get(), maxs.Get(), referenceMins.Get(), referenceMaxs.Get(), ItemCount);
+	fw::batch::CreateTransforms(points.Get(), rotations, scales.Get(), referenceMatrices.data(), ItemCount);
+
+	for (u32 isa = 0; isa < (u32)fw::batch::ISA::Count; ++isa)
+	{
+		if (!fw::batch::SetISA((fw::batch::ISA)isa)) continue;
+		std::string suffix = std::string("/") + fw::batch::GetISAName((fw::batch::ISA)isa);
+
+		context.Measure("TransformPoints" + suffix, ItemCount * Passes, [&]
+		{
+			for (u64 pass = 0; pass < Passes; ++pass)
+				fw::batch::TransformPoints(matrix, points.Get(), out.Get(), ItemCount);
+		});
+		ReportThroughput(context, MaxError(out, referencePoints));
+
+		context.Measure("TransformSpheres" + suffix, ItemCount * Passes, [&]
+		{
+			for (u64 pass = 0; pass < Passes; ++pass)
+				fw::batch::TransformSpheres(matrix, points.Get(), radii.data(), out.Get(), outRadii.data(), ItemCount);
+		});
+		ReportThroughput(context, MaxError(out, referencePoints));
+
+		context.Measure("TransformAABBs" + suffix, ItemCount * Passes, [&]
+		{
+			for (u64 pass = 0; pass < Passes; ++pass)
+				fw::batch::TransformAABBs(matrix, points.Get(), maxs.Get(), out.Get(), outMaxs.Get(), ItemCount);
+		});
+		ReportThroughput(context, std::max(MaxError(out, referenceMins), MaxError(outMaxs, referenceMaxs)));
+
+		context.Measure("CreateTransforms" + suffix, ItemCount * Passes, [&]
+		{
+			for (u64 pass = 0; pass < Passes; ++pass)
+				fw::batch::CreateTransforms(points.Get(), rotations, scales.Get(), matrices.data(), ItemCount);
+		});
+		f32 error = 0.0f;
+		for (u64 i = 0; i < ItemCount; ++i)
+		{
+			for (u32 j = 0; j < 16; ++j)
+				error = std::max(error, std::abs(matrices[i][j] - referenceMatrices[i][j]));
+		}
+		ReportThroughput(context, error);
+	}
+	fw::batch::SetISA(best);
+}
+
+// The quaternion kernels next to the Quat methods they replace. Interpolation errors are the angle to
+// Quat<f64>::Slerp in radians, the rest are the largest difference to the Quatf result.
+FW_BENCHMARK(MathBatchQuat)
+{
+	constexpr f32 Deltas[] = { 0.0f, 0.1f, 0.25f, 0.5f, 0.75f, 0.9f, 1.0f };
+
+	std::mt19937 rng(42);
+	QuatStorage a(ItemCount), b(ItemCount), out(ItemCount);
+	CreateRotationPairs(rng, a, b);
+	Vec3Storage vectors = CreateVectors(rng, -10.0f, 10.0f);
+	Vec3Storage rotated(ItemCount);
+	std::vector<fw::Mat4f> matrices(ItemCount);
+
+	// Interpolation error of any function over every pair and delta.
+	auto interpolationError = [&](auto interpolate)
+	{
+		f64 error = 0.0;
+		for (f32 delta : Deltas)
+		{
+			interpolate(delta);
+			for (u64 i = 0; i < ItemCount; ++i)
+			{
+				fw::Quat<f64> reference = fw::Quat<f64>::Slerp(fw::Quat<f64>(a.At(i)), fw::Quat<f64>(b.At(i)), delta);
+				error = std::max(error, AngleBetween(fw::Quat<f64>(out.At(i)), reference));
+			}
+		}
+		return (f32)error;
+	};
+	auto nlerpError = [&](auto interpolate)
+	{
+		f64 error = 0.0;
+		for (f32 delta : Deltas)
+		{
+			interpolate(delta);
+			for (u64 i = 0; i < ItemCount; ++i)
+			{
+				fw::Quat<f64> reference = fw::Quat<f64>::Nlerp(fw::Quat<f64>(a.At(i)), fw::Quat<f64>(b.At(i)), delta);
+				error = std::max(error, AngleBetween(fw::Quat<f64>(out.At(i)), reference));
+			}
+		}
+		return (f32)error;
+	};
+
+	auto quatSlerp = [&](f32 delta)
+	{
+		for (u64 i = 0; i < ItemCount; ++i)
+			out.Set(i, fw::Quatf::Slerp(a.At(i), b.At(i), delta));
+	};
+	auto quatNlerp = [&](f32 delta)
+	{
+		for (u64 i = 0; i < ItemCount; ++i)
+			out.Set(i, fw::Quatf::Nlerp(a.At(i), b.At(i), delta));
+	};
+	auto quatMultiply = [&]
+	{
+		for (u64 i = 0; i < ItemCount; ++i)
+			out.Set(i, a.At(i) * b.At(i));
+	};
+	auto quatRotate = [&]
+	{
+		for (u64 i = 0; i < ItemCount; ++i)
+		{
+			fw::Vec3f vector = vectors.At(i) * a.At(i).GetRotationMatrix44();
+			rotated.x[i] = vector.x;
+			rotated.y[i] = vector.y;
+			rotated.z[i] = vector.z;
+		}
+	};
+	auto quatMatrices = [&]
+	{
+		for (u64 i = 0; i < ItemCount; ++i)
+			matrices[i] = a.At(i).GetRotationMatrix44();
+	};
+
+	// Per item through Quatf, what the kernels replace.
+	context.Measure("Slerp/Quat::Slerp", ItemCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+			quatSlerp((f32)pass / (f32)Passes);
+	});
+	ReportThroughput(context, interpolationError(quatSlerp));
+
+	context.Measure("Nlerp/Quat::Nlerp", ItemCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+			quatNlerp((f32)pass / (f32)Passes);
+	});
+	ReportThroughput(context, nlerpError(quatNlerp));
+
+	context.Measure("Multiply/Quat::operator*", ItemCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+			quatMultiply();
+	});
+	ReportThroughput(context, 0.0f);
+	QuatStorage referenceProducts = out;
+
+	context.Measure("RotateVectors/Vec3*GetRotationMatrix44", ItemCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+			quatRotate();
+	});
+	ReportThroughput(context, 0.0f);
+	Vec3Storage referenceRotated = rotated;
+
+	context.Measure("CreateRotationMatrices/Quat::GetRotationMatrix44", ItemCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+			quatMatrices();
+	});
+	ReportThroughput(context, 0.0f);
+	std::vector<fw::Mat4f> referenceMatrices = matrices;
+
+	fw::batch::ISA best = fw::batch::GetBestISA();
+	for (u32 isa = 0; isa < (u32)fw::batch::ISA::Count; ++isa)
+	{
+		if (!fw::batch::SetISA((fw::batch::ISA)isa)) continue;
+		std::string suffix = std::string("/") + fw::batch::GetISAName((fw::batch::ISA)isa);
+
+		auto batchSlerp = [&](f32 delta) { fw::batch::Slerp(a.Get(), b.Get(), delta, out.Get(), ItemCount); };
+		auto batchNlerp = [&](f32 delta) { fw::batch::Nlerp(a.Get(), b.Get(), delta, out.Get(), ItemCount); };
+
+		context.Measure("Slerp" + suffix, ItemCount * Passes, [&]
+		{
+			for (u64 pass = 0; pass < Passes; ++pass)
+				batchSlerp((f32)pass / (f32)Passes);
+		});
+		ReportThroughput(context, interpolationError(batchSlerp));
+
+		context.Measure("Nlerp" + suffix, ItemCount * Passes, [&]
+		{
+			for (u64 pass = 0; pass < Passes; ++pass)
+				batchNlerp((f32)pass / (f32)Passes);
+		});
+		ReportThroughput(context, nlerpError(batchNlerp));
+
+		context.Measure("Multiply" + suffix, ItemCount * Passes, [&]
+		{
+			for (u64 pass = 0; pass < Passes; ++pass)
+				fw::batch::Multiply(a.Get(), b.Get(), out.Get(), ItemCount);
+		});
+		f32 error = 0.0f;
+		for (u64 i = 0; i < ItemCount; ++i)
+		{
+			error = std::max(error, std::abs(out.w[i] - referenceProducts.w[i]));
+			error = std::max(error, std::abs(out.x[i] - referenceProducts.x[i]));
+			error = std::max(error, std::abs(out.y[i] - referenceProducts.y[i]));
+			error = std::max(error, std::abs(out.z[i] - referenceProducts.z[i]));
+		}
+		ReportThroughput(context, error);
+
+		context.Measure("RotateVectors" + suffix, ItemCount * Passes, [&]
+		{
+			for (u64 pass = 0; pass < Passes; ++pass)
+				fw::batch::RotateVectors(a.Get(), vectors.Get(), rotated.Get(), ItemCount);
+		});
+		ReportThroughput(context, MaxError(rotated, referenceRotated));
+
+		context.Measure("CreateRotationMatrices" + suffix, ItemCount * Passes, [&]
+		{
+			for (u64 pass = 0; pass < Passes; ++pass)
+				fw::batch::CreateRotationMatrices(a.Get(), matrices.data(), ItemCount);
+		});
+		error = 0.0f;
+		for (u64 i = 0; i < ItemCount; ++i)
+		{
+			for (u32 j = 0; j < 16; ++j)
+				error = std::max(error, std::abs(matrices[i][j] - referenceMatrices[i][j]));
+		}
+		ReportThroughput(context, error);
+	}
+	fw::batch::SetISA(best);
+}
@@ -0,0 +1,208 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+frostwave::bench::Registration::Registration(const c8* name, BenchmarkFunction function)
+{
+	GetRegistry().push_back({ name, function });
+}
+
+std::vector<frostwave::bench::Entry>& frostwave::bench::GetRegistry()
+{
+	static std::vector<Entry> registry;
+	return registry;
+}
+
+namespace
+{
+	void CollectFailures(const frostwave::bench::Context& context, std::vector<std::string>& failures)
+	{
+		for (auto& failure : context.GetFailures())
+		{
+			if (std::find(failures.begin(), failures.end(), failure) == failures.end())
+				failures.push_back(failure);
+		}
+	}
+}
+
+std::vector<frostwave::bench::Statistics> frostwave::bench::Run(const Entry& entry, u32 warmup, u32 repetitions, std::vector<std::string>& failures)
+{
+	for (u32 i = 0; i < warmup; ++i)
+	{
+		Context context;
+		entry.function(context);
+		CollectFailures(context, failures);
+	}
+
+	std::vector<Statistics> statistics;
+	std::vector<std::vector<f64>> samples;
+	for (u32 i = 0; i < repetitions; ++i)
+	{
+		Context context;
+		entry.function(context);
+		CollectFailures(context, failures);
+
+		for (auto& result : context.GetResults())
+		{
+			auto it = std::find_if(statistics.begin(), statistics.end(), [&](const Statistics& s) { return s.name == result.name; });
+			if (it == statistics.end())
+			{
+				statistics.push_back({ entry.name, result.name, result.operations, 0, 0.0, 0.0, 0.0, 0.0, { } });
+				samples.emplace_back();
+				it = statistics.end() - 1;
+			}
+			it->counters = result.counters;
+			samples[it - statistics.begin()].push_back(result.NanosecondsPerOperation());
+		}
+	}
+
+	for (u64 i = 0; i < statistics.size(); ++i)
+	{
+		std::vector<f64>& values = samples[i];
+		std::sort(values.begin(), values.end());
+
+		Statistics& result = statistics[i];
+		u64 count = values.size();
+		result.repetitions = (u32)count;
+		result.median = count % 2 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) * 0.5;
+		result.min = values.front();
+
+		f64 sum = 0.0;
+		for (f64 value : values)
+			sum += value;
+		result.mean = sum / (f64)count;
+
+		f64 variance = 0.0;
+		for (f64 value : values)
+			variance += (value - result.mean) * (value - result.mean);
+		result.stddev = count > 1 ? std::sqrt(variance / (f64)(count - 1)) : 0.0;
+	}
+	return statistics;
+}
+
+namespace
+{
+	void WriteJsonString(FILE* file, const std::string& string)
+	{
+		fputc('"', file);
+		for (c8 c : string)
+		{
+			if (c == '"' || c == '\\')
+				fprintf(file, "\\%c", c);
+			else if ((u8)c < 0x20)
+				fprintf(file, "\\u%04x", (u32)(u8)c);
+			else
+				fputc(c, file);
+		}
+		fputc('"', file);
+	}
+
+	bool ReadJsonNumber(const std::string& line, const c8* key, f64& value)
+	{
+		u64 start = line.find(std::string("\"") + key + "\":");
+		if (start == std::string::npos) return false;
+
+		value = strtod(line.c_str() + start + strlen(key) + 3, nullptr);
+		return true;
+	}
+
+	// Only has to understand what WriteJsonString writes.
+	bool ReadJsonString(const std::string& line, const c8* key, std::string& value)
+	{
+		u64 start = line.find(std::string("\"") + key + "\":\"");
+		if (start == std::string::npos) return false;
+
+		value.clear();
+		for (u64 i = start + strlen(key) + 4; i < line.size(); ++i)
+		{
+			if (line[i] == '"') return true;
+			if (line[i] == '\\' && i + 1 < line.size()) ++i;
+			value += line[i];
+		}
+		return false;
+	}
+}
+
+bool frostwave::bench::WriteJson(const c8* path, const std::vector<Statistics>& statistics)
+{
+	FILE* file = nullptr;
+	if (fopen_s(&file, path, "w") != 0 || !file)
+	{
+		printf("Failed to open '%s' to write the results\n", path);
+		return false;
+	}
+
+	// One measurement per line, which is what ReadBaseline expects.
+	fputs("{\"unit\":\"ns/op\",\"results\":[\n", file);
+	for (u64 i = 0; i < statistics.size(); ++i)
+	{
+		const Statistics& result = statistics[i];
+		fputs("{\"benchmark\":", file);
+		WriteJsonString(file, result.benchmark);
+		fputs(",\"name\":", file);
+		WriteJsonString(file, result.name);
+		fprintf(file, ",\"operations\":%llu,\"repetitions\":%u,\"median\":%.4f,\"min\":%.4f,\"mean\":%.4f,\"stddev\":%.4f,\"counters\":{",
+			result.operations, result.repetitions, result.median, result.min, result.mean, result.stddev);
+		for (u64 j = 0; j < result.counters.size(); ++j)
+		{
+			if (j) fputc(',', file);
+			WriteJsonString(file, result.counters[j].first);
+			fprintf(file, ":%.4f", result.counters[j].second);
+		}
+		fprintf(file, "}}%s\n", i + 1 < statistics.size() ? "," : "");
+	}
+	fputs("]}\n", file);
+	fclose(file);
+	return true;
+}
+
+bool frostwave::bench::ReadBaseline(const c8* path, std::unordered_map<std::string, BaselineEntry>& baseline)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		printf("Failed to open baseline '%s'\n", path);
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::string benchmark, name;
+		BaselineEntry entry;
+		if (!ReadJsonString(line, "benchmark", benchmark) || !ReadJsonString(line, "name", name) || !ReadJsonNumber(line, "median", entry.median)) continue;
+		// Baselines written before min and stddev were recorded compare on the median alone.
+		if (!ReadJsonNumber(line, "min", entry.min)) entry.min = entry.median;
+		if (!ReadJsonNumber(line, "stddev", entry.stddev)) entry.stddev = 0.0;
+		baseline[benchmark + "/" + name] = entry;
+	}
+	return true;
+}
+
+u32 frostwave::bench::CompareToBaseline(const std::vector<Statistics>& statistics, const std::unordered_map<std::string, BaselineEntry>& baseline, f64 threshold, f64 stddevs)
+{
+	u32 regressions = 0;
+	printf("\nCompared to the baseline, a median %.0f%% plus %.1f baseline stddevs slower with a min %.0f%% slower fails:\n", threshold * 100.0, stddevs, threshold * 100.0);
+	for (const Statistics& result : statistics)
+	{
+		std::string key = result.benchmark + "/" + result.name;
+		auto it = baseline.find(key);
+		if (it == baseline.end())
+		{
+			printf("  %-64s %10.2f ns/op  not in the baseline\n", key.c_str(), result.median);
+			continue;
+		}
+
+		const BaselineEntry& base = it->second;
+		f64 change = base.median > 0.0 ? result.median / base.median - 1.0 : 0.0;
+		f64 limit = base.median * (1.0 + threshold) + stddevs * base.stddev;
+		bool regressed = base.median > 0.0 && result.median > limit && result.min > base.min * (1.0 + threshold);
+		regressions += regressed;
+		printf("  %-64s %10.2f ns/op  %+7.1f%%  limit %10.2f%s\n", key.c_str(), result.median, change * 100.0, limit, regressed ? "  REGRESSION" : "");
+	}
+	return regressions;
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <utility>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define FW_BENCHMARK(name) \
+	static void name(fw::bench::Context& context); \
+	static fw::bench::Registration name##_Registration(#name, &name); \
+	static void name(fw::bench::Context& context)
+
+namespace frostwave::bench
+{
+	struct Result
+	{
+		std::string name;
+		u64 operations;
+		f64 seconds;
+		// Extra named values reported next to the timing, e.g. lock contention.
+		std::vector<std::pair<std::string, f64>> counters;
+
+		f64 NanosecondsPerOperation() const { return operations ? seconds * 1e9 / (f64)operations : 0.0; }
+	};
+
+	class Context
+	{
+	public:
+		template <typename Body>
+		void Measure(const std::string& name, u64 operations, Body&& body)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			body();
+			auto end = std::chrono::high_resolution_clock::now();
+
+			Report(name, operations, std::chrono::duration<f64>(end - start).count());
+		}
+
+		// For timings collected by the benchmark itself, e.g. when only parts of a loop should count.
+		void Report(const std::string& name, u64 operations, f64 seconds)
+		{
+			m_Results.push_back({ name, operations, seconds, { } });
+		}
+
+		// Attaches a counter to the most recent measurement.
+		void AddCounter(const std::string& name, f64 value)
+		{
+			if (!m_Results.empty()) m_Results.back().counters.push_back({ name, value });
+		}
+
+		// For benchmarks that also verify what they measured, a failed check fails the run.
+		void Check(bool condition, const std::string& what)
+		{
+			if (!condition) m_Failures.push_back(what);
+		}
+
+		const std::vector<Result>& GetResults() const { return m_Results; }
+		const std::vector<std::string>& GetFailures() const { return m_Failures; }
+
+	private:
+		std::vector<Result> m_Results;
+		std::vector<std::string> m_Failures;
+	};
+
+	using BenchmarkFunction = void(*)(Context&);
+
+	struct Registration
+	{
+		Registration(const c8* name, BenchmarkFunction function);
+	};
+
+	struct Entry
+	{
+		const c8* name;
+		BenchmarkFunction function;
+	};
+
+	std::vector<Entry>& GetRegistry();
+
+	// One measurement over every repetition of its benchmark, times in nanoseconds per operation.
+	struct Statistics
+	{
+		std::string benchmark;
+		std::string name;
+		u64 operations;
+		u32 repetitions;
+		f64 median;
+		f64 min;
+		f64 mean;
+		f64 stddev;
+		// From the last repetition.
+		std::vector<std::pair<std::string, f64>> counters;
+	};
+
+	// Benchmarks set up and tear down everything they measure, so a repetition reruns the whole function.
+	// Warmup runs are thrown away, measurements are matched up by name across the repetitions.
+	// Failed checks of every run are added to failures, each only once.
+	std::vector<Statistics> Run(const Entry& entry, u32 warmup, u32 repetitions, std::vector<std::string>& failures);
+
+	struct BaselineEntry
+	{
+		f64 median;
+		f64 min;
+		f64 stddev;
+	};
+
+	bool WriteJson(const c8* path, const std::vector<Statistics>& statistics);
+	// Reads every measurement from a file written by WriteJson, keyed by "benchmark/name".
+	bool ReadBaseline(const c8* path, std::unordered_map<std::string, BaselineEntry>& baseline);
+	// Prints how every measurement compares to the baseline, returns how many regressed.
+	// The median has to be past baseline median * (1 + threshold) + stddevs * baseline stddev (0.1 is 10%),
+	// and the fastest repetition past baseline min * (1 + threshold). A real slowdown moves both,
+	// a few repetitions that got descheduled only move the median.
+	u32 CompareToBaseline(const std::vector<Statistics>& statistics, const std::unordered_map<std::string, BaselineEntry>& baseline, f64 threshold, f64 stddevs);
+
+	// Keeps the optimizer from discarding a value that is otherwise unused, or from computing it only once
+	// for a whole loop. The value has to be materialized and the compiler has to assume it is read.
+#ifdef _MSC_VER
+	inline const void* volatile s_DoNotOptimizeSink = nullptr;
+
+	template <typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+		s_DoNotOptimizeSink = &value;
+		_ReadWriteBarrier();
+	}
+#else
+	template <typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+#endif
+}
+namespace fw = frostwave;
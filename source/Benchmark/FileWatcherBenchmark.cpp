@@ -0,0 +1,78 @@
+#include "Benchmark.h"
+#include <Engine/Memory/Allocator.h>
+#include <Engine/FileWatcher.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+	constexpr u64 FileCount = 256;
+	constexpr u64 UpdateCount = 1000000;
+	constexpr u64 ChangeCount = 8;
+	constexpr u64 ChangeTimeoutMilliseconds = 2000;
+}
+
+FW_BENCHMARK(FileWatcherUpdate)
+{
+	fw::Allocator::Create(Size::Megabytes(64));
+	fw::Logger::Create();
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "frostwave_benchmark_watch";
+	std::filesystem::create_directories(directory);
+
+	std::vector<std::string> paths;
+	for (u64 i = 0; i < FileCount; ++i)
+	{
+		paths.push_back((directory / ("file" + std::to_string(i) + ".txt")).string());
+		std::ofstream(paths.back()) << i;
+	}
+
+	// The watcher is a process wide singleton with its own thread, it is left running between repetitions.
+	fw::FileWatcher* watcher = fw::FileWatcher::Get();
+	u64 calls = 0;
+	context.Measure("register", FileCount, [&]
+	{
+		for (auto& path : paths)
+			watcher->Register(&calls, path, [&](const std::string&) { calls++; });
+	});
+
+	context.Measure("update/idle", UpdateCount, [&]
+	{
+		for (u64 i = 0; i < UpdateCount; ++i)
+			watcher->Update(0.016f);
+	});
+
+	// Time from writing a file until its callback ran, the debounce is part of it. Update is polled every millisecond
+	// like a frame loop would, so the result also carries up to a millisecond of polling slack.
+	f64 latency = 0.0;
+	u64 fired = 0;
+	for (u64 i = 0; i < ChangeCount; ++i)
+	{
+		u64 before = calls;
+		auto start = std::chrono::steady_clock::now();
+		std::ofstream(paths[i]) << "changed " << i;
+
+		while (calls == before && std::chrono::steady_clock::now() - start < std::chrono::milliseconds(ChangeTimeoutMilliseconds))
+		{
+			watcher->Update(0.016f);
+			if (calls == before) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		latency += std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+		fired += calls > before;
+	}
+	context.Report("change/latency", ChangeCount, latency);
+	context.Check(fired == ChangeCount, "a changed file did not reach its callback");
+
+	context.Measure("unregister", FileCount, [&]
+	{
+		for (auto& path : paths)
+			watcher->Unregister(&calls, path);
+	});
+
+	std::filesystem::remove_all(directory);
+	fw::Logger::Destroy();
+	fw::Allocator::Destroy();
+}
@@ -0,0 +1,96 @@
+#include "Benchmark.h"
+#include <Engine/Memory/Allocator.h>
+#include <Engine/Graphics/GpuProfiler.h>
+
+namespace
+{
+	constexpr u64 FrameCount = 100000;
+	constexpr u32 MarkersPerFrame = 8;
+
+	constexpr fw::GPUMarker Markers[MarkersPerFrame] = {
+		"Clear Textures", "Render Shadowmaps", "Render Geometry to GBuffer", "Render Deferred lighting",
+		"Render Skybox", "SSAO", "Bloom", "Tonemapping"
+	};
+
+	void RunFrames(fw::GPUProfiler& profiler, u64 frames)
+	{
+		for (u64 i = 0; i < frames; ++i)
+		{
+			profiler.BeginFrame();
+			for (auto& marker : Markers)
+				profiler.Timestamp(marker);
+			profiler.Collect();
+			profiler.EndFrame();
+		}
+	}
+}
+
+FW_BENCHMARK(GPUProfilerFrame)
+{
+	fw::Allocator::Create(Size::Megabytes(64));
+	fw::Logger::Create();
+
+	// One millisecond between timestamps, read two frames late like a GPU running behind.
+	fw::FakeGPUTimer timer;
+	timer.SetFrequency(1000000000);
+	timer.SetTicksPerTimestamp(1000000);
+	timer.SetLatency(2);
+
+	fw::GPUProfiler profiler;
+	profiler.Init(&timer);
+
+	context.Measure("frame", FrameCount, [&] { RunFrames(profiler, FrameCount); });
+	context.AddCounter("marker avg ms", profiler.FindMarker(Markers[0])->average * 1000.0);
+	context.AddCounter("frame avg ms", profiler.GetFrameAverage() * 1000.0);
+	context.AddCounter("resolved", (f64)profiler.GetResolvedFrames());
+
+	// Disjoint frames are thrown out without touching the averages.
+	u64 resolved = profiler.GetResolvedFrames();
+	context.Measure("disjoint frame", FrameCount, [&]
+	{
+		for (u64 i = 0; i < FrameCount; ++i)
+		{
+			profiler.BeginFrame();
+			timer.MarkDisjoint();
+			profiler.Timestamp(Markers[0]);
+			profiler.Collect();
+			profiler.EndFrame();
+		}
+	});
+	context.AddCounter("disjoint", (f64)profiler.GetDisjointFrames());
+	context.AddCounter("resolved since", (f64)(profiler.GetResolvedFrames() - resolved));
+
+	profiler.Shutdown();
+	fw::Logger::Destroy();
+	fw::Allocator::Destroy();
+}
+
+FW_BENCHMARK(GPUProfilerTimestamp)
+{
+	fw::Allocator::Create(Size::Megabytes(64));
+	fw::Logger::Create();
+
+	fw::FakeGPUTimer timer;
+	fw::GPUProfiler profiler;
+	profiler.Init(&timer);
+
+	// Stays under TimestampsPerFrame, every call is the marker lookup and the query.
+	constexpr u64 Frames = 20000;
+	u64 timestamps = Frames * (fw::GPUProfiler::TimestampsPerFrame - 1);
+	context.Measure("timestamp", timestamps, [&]
+	{
+		for (u64 frame = 0; frame < Frames; ++frame)
+		{
+			profiler.BeginFrame();
+			for (u32 i = 0; i < fw::GPUProfiler::TimestampsPerFrame - 1; ++i)
+				profiler.Timestamp(Markers[i % MarkersPerFrame]);
+			profiler.EndFrame();
+			profiler.Collect();
+		}
+	});
+	context.AddCounter("dropped", (f64)profiler.GetDroppedTimestamps());
+
+	profiler.Shutdown();
+	fw::Logger::Destroy();
+	fw::Allocator::Destroy();
+}
@@ -0,0 +1,188 @@
+#include "Benchmark.h"
+#include <Engine/Memory/Allocator.h>
+#include <Engine/Logging/Logger.h>
+#include <Engine/Logging/LogSink.h>
+#include <cstdio>
+#include <cstdarg>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <filesystem>
+
+namespace
+{
+	// Accepts records without writing them anywhere, so only the cost of getting a record to a sink is measured.
+	class NullSink : public fw::LogSink
+	{
+	public:
+		void Write(const fw::LogRecord& record) override
+		{
+			m_Bytes += record.message.size();
+			m_Records++;
+		}
+
+		u64 m_Bytes = 0;
+		u64 m_Records = 0;
+	};
+
+	// The previous logger: format on the calling thread and write to the console under a global lock.
+	class LegacyLogger
+	{
+	public:
+		LegacyLogger()
+		{
+		#ifdef _WIN32
+			fopen_s(&m_Output, "NUL", "w");
+		#else
+			fopen_s(&m_Output, "/dev/null", "w");
+		#endif
+		}
+		~LegacyLogger() { if (m_Output) fclose(m_Output); }
+
+		void Log(const c8* file, u32 line, const c8* function, const c8* format, ...)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			va_list args;
+			va_start(args, format);
+			vsnprintf(m_Buffer, sizeof(m_Buffer), format, args);
+			va_end(args);
+
+			fprintf(m_Output, "[INFO] %s:%u:%s: %s\n", file, line, function, m_Buffer);
+			fflush(m_Output);
+		}
+
+	private:
+		FILE* m_Output = nullptr;
+		std::mutex m_Mutex;
+		c8 m_Buffer[10 * 1024];
+	};
+
+	constexpr u64 CallsPerThread = 200000;
+
+	template <typename Body>
+	void RunThreads(u32 threadCount, Body&& body)
+	{
+		std::vector<std::thread> threads;
+		for (u32 i = 1; i < threadCount; ++i)
+			threads.emplace_back(body, i);
+		body(0);
+		for (auto& thread : threads)
+			thread.join();
+	}
+}
+
+FW_BENCHMARK(LoggerProducer)
+{
+	fw::Allocator::Create(Size::Megabytes(64));
+	fw::Logger::Create();
+
+	NullSink* sink = fw::Allocate<NullSink>();
+	fw::Logger::AddSink(sink);
+
+	for (u32 threadCount : { 1u, 4u })
+	{
+		auto producer = [](u32 index)
+		{
+			const c8* name = "entity";
+			for (u64 i = 0; i < CallsPerThread; ++i)
+				INFO_LOG("Thread %u updated %s %llu at %.3f", index, name, i, (f64)i * 0.5);
+			fw::Logger::ReleaseThreadBuffer();
+		};
+
+		// Flushing is left outside the measurement, the caller only ever pays for the copy into its ring.
+		context.Measure("async/" + std::to_string(threadCount) + "threads", CallsPerThread * threadCount, [&] { RunThreads(threadCount, producer); });
+		auto start = std::chrono::high_resolution_clock::now();
+		fw::Logger::Flush();
+		auto end = std::chrono::high_resolution_clock::now();
+		context.AddCounter("drain ms", std::chrono::duration<f64, std::milli>(end - start).count());
+	}
+
+	fw::Logger::Flush();
+	context.AddCounter("records", (f64)sink->m_Records);
+
+	fw::Logger::Destroy();
+	fw::Allocator::Destroy();
+
+	LegacyLogger legacy;
+	for (u32 threadCount : { 1u, 4u })
+	{
+		auto producer = [&](u32 index)
+		{
+			const c8* name = "entity";
+			for (u64 i = 0; i < CallsPerThread; ++i)
+				legacy.Log(__FILE__, __LINE__, __FUNCTION__, "Thread %u updated %s %llu at %.3f", index, name, i, (f64)i * 0.5);
+		};
+
+		context.Measure("legacy/" + std::to_string(threadCount) + "threads", CallsPerThread * threadCount, [&] { RunThreads(threadCount, producer); });
+	}
+}
+
+namespace
+{
+	// Logs a burst shaped like the allocator's verbose output and measures how long the logging thread takes to write it out.
+	template <typename Sink>
+	void RunSink(fw::bench::Context& context, const c8* name, const c8* path)
+	{
+		constexpr u64 RecordCount = 200000;
+		// Stays below what one thread's ring holds, so the whole burst is queued before the drain starts.
+		constexpr u64 BurstSize = 500;
+
+		fw::Logger::Create();
+		fw::Logger::AddSink(fw::Allocate<Sink>(path));
+
+		const c8* types[] = { "struct frostwave::Texture", "class frostwave::Model", "u8" };
+		f64 seconds = 0.0;
+		for (u64 i = 0; i < RecordCount; i += BurstSize)
+		{
+			for (u64 j = i; j < i + BurstSize; ++j)
+				INFO_LOG("Allocated %llux of type %s - size: %llu bytes - %f%% used", j % 4 + 1, types[j % 3], j * 16, (f64)j / (f64)RecordCount * 100.0);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			fw::Logger::Flush();
+			seconds += std::chrono::duration<f64>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+		fw::Logger::Destroy();
+
+		context.Report(std::string("drain/") + name, RecordCount, seconds);
+		context.AddCounter("bytes/record", (f64)std::filesystem::file_size(path) / (f64)RecordCount);
+		std::filesystem::remove(path);
+	}
+}
+
+FW_BENCHMARK(LoggerSinks)
+{
+	fw::Allocator::Create(Size::Megabytes(64));
+
+	RunSink<fw::FileSink>(context, "text", "benchmark.log");
+	RunSink<fw::BinaryFileSink>(context, "binary", "benchmark.fwlog");
+
+	fw::Allocator::Destroy();
+}
+
+FW_BENCHMARK(FlightRecorder)
+{
+	constexpr u64 RecordCount = 1000000;
+
+	fw::Allocator::Create(Size::Megabytes(64));
+	fw::Logger::Create();
+
+	// No sinks, the way a retail build runs, so the recorder is the only thing a log call feeds.
+	auto producer = []
+	{
+		const c8* name = "entity";
+		for (u64 i = 0; i < RecordCount; ++i)
+			INFO_LOG("Updated %s %llu at %.3f", name, i, (f64)i * 0.5);
+	};
+
+	context.Measure("log/off", RecordCount, producer);
+
+	fw::FlightRecorder::Create("benchmark.flight");
+	context.Measure("log/recorded", RecordCount, producer);
+	context.Measure("frame", RecordCount, [] { for (u64 i = 0; i < RecordCount; ++i) fw::FlightRecorder::Get()->MarkFrame(i); });
+	fw::FlightRecorder::Destroy();
+
+	fw::Logger::Destroy();
+	fw::Allocator::Destroy();
+	std::filesystem::remove("benchmark.flight");
+}
@@ -0,0 +1,474 @@
+#include "Benchmark.h"
+#include <Engine/Core/Math/Mat4.h>
+#include <Engine/Core/Math/Quat.h>
+#include <Engine/Core/Math/Vec4.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace
+{
+	// Enough values to leave the cache warm but keep the loop from being folded into one computation.
+	constexpr u64 ValueCount = 4096;
+	constexpr u64 Passes = 64;
+
+	std::vector<fw::Mat4f> CreateTransforms(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<f32> angles(-3.0f, 3.0f);
+		std::uniform_real_distribution<f32> positions(-100.0f, 100.0f);
+		std::uniform_real_distribution<f32> scales(0.5f, 2.0f);
+
+		std::vector<fw::Mat4f> transforms(ValueCount);
+		for (auto& transform : transforms)
+		{
+			fw::Quatf rotation(angles(rng), angles(rng), angles(rng));
+			transform = fw::Mat4f::CreateTransform({ positions(rng), positions(rng), positions(rng) }, rotation, { scales(rng), scales(rng), scales(rng) });
+		}
+		return transforms;
+	}
+
+	std::vector<fw::Quatf> CreateRotations(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<f32> angles(-3.0f, 3.0f);
+		std::vector<fw::Quatf> rotations(ValueCount);
+		for (auto& rotation : rotations)
+			rotation = fw::Quatf(angles(rng), angles(rng), angles(rng));
+		return rotations;
+	}
+
+	std::vector<fw::Vec4f> CreateVectors(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<f32> values(-10.0f, 10.0f);
+		std::vector<fw::Vec4f> vectors(ValueCount);
+		for (auto& vector : vectors)
+			vector = fw::Vec4f(values(rng), values(rng), values(rng), values(rng));
+		return vectors;
+	}
+
+	std::vector<fw::Mat4f> CreateRigidTransforms(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<f32> angles(-3.0f, 3.0f);
+		std::uniform_real_distribution<f32> positions(-100.0f, 100.0f);
+
+		std::vector<fw::Mat4f> transforms(ValueCount);
+		for (auto& transform : transforms)
+			transform = fw::Mat4f::CreateTransform({ positions(rng), positions(rng), positions(rng) }, fw::Quatf(angles(rng), angles(rng), angles(rng)), { 1.0f, 1.0f, 1.0f });
+		return transforms;
+	}
+
+	// Camera projections times views, what the renderers invert every frame.
+	std::vector<fw::Mat4f> CreateProjections(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<f32> fovs(40.0f, 110.0f);
+		std::uniform_real_distribution<f32> aspects(0.5f, 2.5f);
+		std::vector<fw::Mat4f> views = CreateRigidTransforms(rng);
+
+		std::vector<fw::Mat4f> projections(ValueCount);
+		for (u64 i = 0; i < ValueCount; ++i)
+			projections[i] = views[i] * fw::Mat4f::CreatePerspectiveProjection(fovs(rng), aspects(rng), 0.1f, 1000.0f);
+		return projections;
+	}
+
+	// Largest difference to the inverse computed in doubles, relative to the largest element of that inverse.
+	f32 InverseError(const fw::Mat4f& matrix, const fw::Mat4f& inverse)
+	{
+		fw::Mat4<f64> wide;
+		for (u32 i = 0; i < 16; ++i)
+			wide[i] = matrix[i];
+		fw::Mat4<f64> reference = fw::Mat4<f64>::InverseGeneral(wide);
+
+		f64 largest = 0.0, error = 0.0;
+		for (u32 i = 0; i < 16; ++i)
+		{
+			largest = std::max(largest, std::abs(reference[i]));
+			error = std::max(error, std::abs(inverse[i] - reference[i]));
+		}
+		return (f32)(error / largest);
+	}
+
+	template <typename Inverse>
+	f32 MaxInverseError(const std::vector<fw::Mat4f>& matrices, Inverse inverse)
+	{
+		f32 error = 0.0f;
+		for (const fw::Mat4f& matrix : matrices)
+			error = std::max(error, InverseError(matrix, inverse(matrix)));
+		return error;
+	}
+
+	// How far M * M^-1 is from the identity.
+	template <typename Inverse>
+	f32 MaxResidual(const std::vector<fw::Mat4f>& matrices, Inverse inverse)
+	{
+		f32 residual = 0.0f;
+		for (const fw::Mat4f& matrix : matrices)
+		{
+			fw::Mat4f identity = matrix * inverse(matrix);
+			for (u32 i = 0; i < 16; ++i)
+				residual = std::max(residual, std::abs(identity[i] - (i % 5 == 0 ? 1.0f : 0.0f)));
+		}
+		return residual;
+	}
+
+	f32 MaxError(const f32* a, const f32* b)
+	{
+		f32 error = 0.0f;
+		for (u32 i = 0; i < 4; ++i)
+			error = std::max(error, std::abs(a[i] - b[i]));
+		return error;
+	}
+}
+
+FW_BENCHMARK(MathMat4)
+{
+	std::mt19937 rng(42);
+	std::vector<fw::Mat4f> a = CreateTransforms(rng);
+	std::vector<fw::Mat4f> b = CreateTransforms(rng);
+	std::vector<fw::Mat4f> out(ValueCount);
+
+	context.Measure("multiply", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				out[i] = a[i] * b[(i + pass) % ValueCount];
+			fw::bench::DoNotOptimize(out[ValueCount - 1]);
+		}
+	});
+
+	context.Measure("Inverse", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				out[i] = fw::Mat4f::Inverse(a[(i + pass) % ValueCount]);
+			fw::bench::DoNotOptimize(out[ValueCount - 1]);
+		}
+	});
+}
+
+// Every inverse next to the scalar reference in Simd.h, errors are against a double precision inverse and
+// relative to its largest element.
+FW_BENCHMARK(MathMat4Inverse)
+{
+	namespace scalar = fw::simd::scalar;
+	using Kind = fw::Mat4f::Kind;
+
+	std::mt19937 rng(42);
+	std::vector<fw::Mat4f> general = CreateProjections(rng);
+	std::vector<fw::Mat4f> affine = CreateTransforms(rng);
+	std::vector<fw::Mat4f> rigid = CreateRigidTransforms(rng);
+	std::vector<fw::Mat4f> out(ValueCount);
+	std::vector<f32> determinants(ValueCount);
+
+	auto measure = [&](const std::string& name, const std::vector<fw::Mat4f>& matrices, auto inverse)
+	{
+		context.Measure(name, ValueCount * Passes, [&]
+		{
+			for (u64 pass = 0; pass < Passes; ++pass)
+			{
+				for (u64 i = 0; i < ValueCount; ++i)
+					out[i] = inverse(matrices[(i + pass) % ValueCount]);
+				fw::bench::DoNotOptimize(out[ValueCount - 1]);
+			}
+		});
+		context.AddCounter("max relative error", MaxInverseError(matrices, inverse));
+		context.AddCounter("max residual", MaxResidual(matrices, inverse));
+	};
+	auto scalarInverse = [](auto function)
+	{
+		return [function](const fw::Mat4f& matrix)
+		{
+			fw::Mat4f result;
+			function(matrix.m_Numbers, result.m_Numbers);
+			return result;
+		};
+	};
+
+	u64 misclassified = 0;
+	for (u64 i = 0; i < ValueCount; ++i)
+	{
+		misclassified += fw::Mat4f::Classify(general[i]) != Kind::General;
+		misclassified += fw::Mat4f::Classify(affine[i]) != Kind::Affine;
+		misclassified += fw::Mat4f::Classify(rigid[i]) != Kind::Rigid;
+	}
+
+	measure("General", general, [](const fw::Mat4f& m) { return fw::Mat4f::InverseGeneral(m); });
+	measure("General/scalar", general, scalarInverse(scalar::Inverse4x4));
+	measure("General/auto", general, [](const fw::Mat4f& m) { return fw::Mat4f::Inverse(m); });
+	context.AddCounter("misclassified", (f64)misclassified);
+
+	measure("Affine", affine, [](const fw::Mat4f& m) { return fw::Mat4f::InverseAffine(m); });
+	measure("Affine/scalar", affine, scalarInverse(scalar::InverseAffine));
+	measure("Affine/general", affine, [](const fw::Mat4f& m) { return fw::Mat4f::InverseGeneral(m); });
+	measure("Affine/auto", affine, [](const fw::Mat4f& m) { return fw::Mat4f::Inverse(m); });
+
+	measure("Rigid", rigid, [](const fw::Mat4f& m) { return fw::Mat4f::InverseRigid(m); });
+	measure("Rigid/scalar", rigid, scalarInverse(scalar::InverseRigid));
+	measure("Rigid/general", rigid, [](const fw::Mat4f& m) { return fw::Mat4f::InverseGeneral(m); });
+	measure("Rigid/auto", rigid, [](const fw::Mat4f& m) { return fw::Mat4f::Inverse(m); });
+
+	f32 determinantError = 0.0f;
+	for (const fw::Mat4f& matrix : general)
+	{
+		f32 reference = scalar::Determinant4x4(matrix.m_Numbers);
+		determinantError = std::max(determinantError, std::abs(fw::Mat4f::Determinant(matrix) - reference) / std::abs(reference));
+	}
+
+	context.Measure("Determinant", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				determinants[i] = fw::Mat4f::Determinant(general[(i + pass) % ValueCount]);
+		}
+	});
+	context.AddCounter("max relative error", determinantError);
+	context.Measure("Determinant/scalar", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				determinants[i] = scalar::Determinant4x4(general[(i + pass) % ValueCount].m_Numbers);
+			fw::bench::DoNotOptimize(determinants[ValueCount - 1]);
+		}
+	});
+
+	context.Measure("Transpose", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				out[i] = fw::Mat4f::Transpose(general[(i + pass) % ValueCount]);
+		}
+	});
+	context.Measure("Transpose/scalar", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				scalar::Transpose4x4(general[(i + pass) % ValueCount].m_Numbers, out[i].m_Numbers);
+			fw::bench::DoNotOptimize(out[ValueCount - 1]);
+		}
+	});
+}
+
+FW_BENCHMARK(MathQuat)
+{
+	std::mt19937 rng(42);
+	std::vector<fw::Quatf> a = CreateRotations(rng);
+	std::vector<fw::Quatf> b = CreateRotations(rng);
+	std::vector<fw::Quatf> out(ValueCount);
+
+	context.Measure("Slerp", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			f32 delta = (f32)pass / (f32)Passes;
+			for (u64 i = 0; i < ValueCount; ++i)
+				out[i] = fw::Quatf::Slerp(a[i], b[(i + pass) % ValueCount], delta);
+			fw::bench::DoNotOptimize(out[ValueCount - 1]);
+		}
+	});
+}
+
+// The cube face view * projection matrices the cubemap passes in DeferredRenderer use, built at runtime
+// next to copying them out of a table the compiler worked out. The difference between the two is a counter.
+FW_BENCHMARK(MathConstantTables)
+{
+	struct Face
+	{
+		fw::Vec3f direction;
+		fw::Vec3f up;
+	};
+	static constexpr Face faces[6] = {
+		{ { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
+		{ { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+		{ { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f } }
+	};
+	auto build = [](f32 fov)
+	{
+		std::array<fw::Mat4f, 6> result;
+		fw::Mat4f projection = fw::Mat4f::CreatePerspectiveProjection(fov, 1, 0.1f, 10.0f);
+		for (u32 i = 0; i < 6; ++i)
+			result[i] = fw::Mat4f::CreateLookAt(fw::Vec3f(), faces[i].direction, faces[i].up) * projection;
+		return result;
+	};
+	static constexpr std::array<fw::Mat4f, 6> baked = build(90.0f);
+
+	// Read through volatile so the runtime version can not be folded into a constant as well.
+	volatile f32 fov = 90.0f;
+	std::array<fw::Mat4f, 6> out;
+
+	context.Measure("CubeFaces/runtime", ValueCount, [&]
+	{
+		for (u64 i = 0; i < ValueCount; ++i)
+		{
+			out = build(fov);
+			fw::bench::DoNotOptimize(out);
+		}
+	});
+	f32 difference = 0.0f;
+	for (u32 i = 0; i < 6; ++i)
+	{
+		for (u32 j = 0; j < 16; ++j)
+			difference = std::max(difference, std::abs(out[i][j] - baked[i][j]));
+	}
+	context.AddCounter("max difference", difference);
+	context.Measure("CubeFaces/constexpr", ValueCount, [&]
+	{
+		for (u64 i = 0; i < ValueCount; ++i)
+		{
+			out = baked;
+			fw::bench::DoNotOptimize(out);
+		}
+	});
+}
+
+// Each operation through Vec4f/Quatf next to the scalar reference in Simd.h, with the largest difference
+// between the two over every input reported as a counter.
+FW_BENCHMARK(MathVec4)
+{
+	namespace scalar = fw::simd::scalar;
+
+	std::mt19937 rng(42);
+	std::vector<fw::Vec4f> a = CreateVectors(rng);
+	std::vector<fw::Vec4f> b = CreateVectors(rng);
+	std::vector<fw::Mat4f> matrices = CreateTransforms(rng);
+	std::vector<fw::Vec4f> out(ValueCount);
+	std::vector<f32> dots(ValueCount);
+
+	f32 dotError = 0.0f, crossError = 0.0f, normalizeError = 0.0f, transformError = 0.0f;
+	for (u64 i = 0; i < ValueCount; ++i)
+	{
+		fw::Vec4f reference;
+		dotError = std::max(dotError, std::abs(a[i].Dot(b[i]) - scalar::Dot4(&a[i].x, &b[i].x)) / std::max(1.0f, std::abs(scalar::Dot4(&a[i].x, &b[i].x))));
+
+		fw::Vec4f cross = a[i].Cross(b[i]);
+		scalar::Cross3(&a[i].x, &b[i].x, &reference.x);
+		crossError = std::max(crossError, MaxError(&cross.x, &reference.x));
+
+		fw::Vec4f normalized = a[i].GetNormalized();
+		scalar::Normalize4(&a[i].x, &reference.x);
+		normalizeError = std::max(normalizeError, MaxError(&normalized.x, &reference.x));
+
+		fw::Vec4f transformed = a[i] * matrices[i];
+		scalar::Transform4(&a[i].x, matrices[i].m_Numbers, &reference.x);
+		transformError = std::max(transformError, MaxError(&transformed.x, &reference.x) / std::max(1.0f, std::sqrt(reference.Dot(reference))));
+	}
+
+	context.Measure("Dot", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				dots[i] = a[i].Dot(b[(i + pass) % ValueCount]);
+		}
+	});
+	context.AddCounter("max relative error", dotError);
+	context.Measure("Dot/scalar", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				dots[i] = scalar::Dot4(&a[i].x, &b[(i + pass) % ValueCount].x);
+			fw::bench::DoNotOptimize(dots[ValueCount - 1]);
+		}
+	});
+
+	context.Measure("Cross", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				out[i] = a[i].Cross(b[(i + pass) % ValueCount]);
+		}
+	});
+	context.AddCounter("max error", crossError);
+	context.Measure("Cross/scalar", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				scalar::Cross3(&a[i].x, &b[(i + pass) % ValueCount].x, &out[i].x);
+			fw::bench::DoNotOptimize(out[ValueCount - 1]);
+		}
+	});
+
+	context.Measure("Normalize", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				out[i] = a[(i + pass) % ValueCount].GetNormalized();
+		}
+	});
+	context.AddCounter("max error", normalizeError);
+	context.Measure("Normalize/scalar", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				scalar::Normalize4(&a[(i + pass) % ValueCount].x, &out[i].x);
+			fw::bench::DoNotOptimize(out[ValueCount - 1]);
+		}
+	});
+
+	context.Measure("Vec4*Mat4", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				out[i] = a[i] * matrices[(i + pass) % ValueCount];
+		}
+	});
+	context.AddCounter("max relative error", transformError);
+	context.Measure("Vec4*Mat4/scalar", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				scalar::Transform4(&a[i].x, matrices[(i + pass) % ValueCount].m_Numbers, &out[i].x);
+			fw::bench::DoNotOptimize(out[ValueCount - 1]);
+		}
+	});
+}
+
+FW_BENCHMARK(MathQuatMultiply)
+{
+	std::mt19937 rng(42);
+	std::vector<fw::Quatf> a = CreateRotations(rng);
+	std::vector<fw::Quatf> b = CreateRotations(rng);
+	std::vector<fw::Quatf> out(ValueCount);
+
+	f32 error = 0.0f;
+	for (u64 i = 0; i < ValueCount; ++i)
+	{
+		fw::Quatf product = a[i] * b[i];
+		fw::Quatf reference;
+		fw::simd::scalar::QuatMultiply(a[i].values, b[i].values, reference.values);
+		error = std::max(error, MaxError(product.values, reference.values));
+	}
+
+	context.Measure("multiply", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				out[i] = a[i] * b[(i + pass) % ValueCount];
+		}
+	});
+	context.AddCounter("max error", error);
+	context.Measure("multiply/scalar", ValueCount * Passes, [&]
+	{
+		for (u64 pass = 0; pass < Passes; ++pass)
+		{
+			for (u64 i = 0; i < ValueCount; ++i)
+				fw::simd::scalar::QuatMultiply(a[i].values, b[(i + pass) % ValueCount].values, out[i].values);
+			fw::bench::DoNotOptimize(out[ValueCount - 1]);
+		}
+	});
+}
@@ -0,0 +1,50 @@
+#include "Benchmark.h"
+#include <Engine/Memory/Allocator.h>
+#include <Engine/Profiling/Metrics.h>
+#include <thread>
+
+namespace
+{
+	constexpr u64 EventCount = 1000000;
+
+	fw::Metric s_BenchmarkEvents("Benchmark events");
+}
+
+FW_BENCHMARK(MetricsAdd)
+{
+	fw::Allocator::Create(Size::Megabytes(64));
+	fw::Metrics::Create();
+
+	context.Measure("add", EventCount, []
+	{
+		for (u64 i = 0; i < EventCount; ++i)
+			FW_METRIC_ADD(s_BenchmarkEvents, 1);
+	});
+
+	// Every thread hits the same counter, the worst case for a metric counted from jobs.
+	context.Measure("add/4threads", EventCount * 4, []
+	{
+		std::vector<std::thread> threads;
+		for (u32 i = 0; i < 4; ++i)
+		{
+			threads.emplace_back([]
+			{
+				for (u64 j = 0; j < EventCount; ++j)
+					FW_METRIC_ADD(s_BenchmarkEvents, 1);
+			});
+		}
+		for (auto& thread : threads)
+			thread.join();
+	});
+
+	constexpr u64 FrameCount = 10000;
+	context.Measure("snapshot", FrameCount, []
+	{
+		for (u64 i = 0; i < FrameCount; ++i)
+			fw::Metrics::Snapshot(i);
+	});
+	context.AddCounter("metrics", (f64)fw::Metrics::GetMetricCount());
+
+	fw::Metrics::Destroy();
+	fw::Allocator::Destroy();
+}
@@ -0,0 +1,42 @@
+#include "Benchmark.h"
+#include <Engine/Memory/Allocator.h>
+#include <Engine/Profiling/Profiler.h>
+#include <filesystem>
+
+namespace
+{
+	constexpr u64 ScopeCount = 50000;
+
+	// Two levels, so the stack is exercised the way nested engine code uses it.
+	void Nested(u64 iterations)
+	{
+		for (u64 i = 0; i < iterations; ++i)
+		{
+			FW_PROFILE_SCOPE("Outer");
+			{
+				FW_PROFILE_SCOPE("Inner");
+				fw::bench::DoNotOptimize(i);
+			}
+		}
+	}
+}
+
+FW_BENCHMARK(ProfilerScope)
+{
+	fw::Allocator::Create(Size::Megabytes(64));
+	fw::Logger::Create();
+	fw::Profiler::Create();
+
+	context.Measure("idle", ScopeCount * 2, [] { Nested(ScopeCount); });
+
+	// Stays under EventsPerThread, every scope is recorded.
+	fw::Profiler::BeginCapture();
+	context.Measure("capturing", ScopeCount * 2, [] { Nested(ScopeCount); });
+	fw::Profiler::EndCapture("benchmark.trace.json");
+	context.AddCounter("trace kb", (f64)std::filesystem::file_size("benchmark.trace.json") / 1024.0);
+	std::filesystem::remove("benchmark.trace.json");
+
+	fw::Profiler::Destroy();
+	fw::Logger::Destroy();
+	fw::Allocator::Destroy();
+}
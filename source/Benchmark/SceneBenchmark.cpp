@@ -0,0 +1,85 @@
+#include "Benchmark.h"
+#include <Engine/Memory/Allocator.h>
+#include <Engine/Graphics/Scene.h>
+#include <Engine/Graphics/RenderManager.h>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	constexpr u64 ModelCount = 1024;
+	constexpr u64 LightCount = 64;
+	constexpr u64 FrameCount = 200;
+
+	// A grid of quads written out as OBJ, there are no meshes checked in to import.
+	void WriteGrid(const std::string& path, u32 size)
+	{
+		std::ofstream file(path);
+		for (u32 y = 0; y <= size; ++y)
+		{
+			for (u32 x = 0; x <= size; ++x)
+				file << "v " << x << " " << (x * y) % 7 << " " << y << "\nvt " << (f32)x / (f32)size << " " << (f32)y / (f32)size << "\n";
+		}
+		for (u32 y = 0; y < size; ++y)
+		{
+			for (u32 x = 0; x < size; ++x)
+			{
+				u32 a = y * (size + 1) + x + 1;
+				u32 b = a + 1;
+				u32 c = a + size + 1;
+				u32 d = c + 1;
+				file << "f " << a << "/" << a << " " << b << "/" << b << " " << d << "/" << d << " " << c << "/" << c << "\n";
+			}
+		}
+	}
+}
+
+FW_BENCHMARK(SceneSubmit)
+{
+	fw::Allocator::Create(Size::Megabytes(256));
+
+	fw::Scene* scene = fw::Allocate();
+	scene->Init();
+	for (u64 i = 0; i < ModelCount; ++i)
+		scene->AddModel(fw::Allocate<fw::Model>());
+	for (u64 i = 0; i < LightCount; ++i)
+		scene->AddLight(fw::Allocate<fw::PointLight>());
+	scene->AddLight(fw::Allocate<fw::DirectionalLight>());
+
+	// Tearing a RenderManager down needs everything Init creates on the device, which a benchmark does not have.
+	// It is never initialized or freed, destroying the allocator releases it.
+	fw::RenderManager* renderer = fw::Allocate();
+
+	context.Measure("submit", FrameCount * (ModelCount + LightCount + 1), [&]
+	{
+		for (u64 frame = 0; frame < FrameCount; ++frame)
+			scene->Submit(renderer);
+	});
+
+	fw::Free(scene);
+	fw::Allocator::Destroy();
+}
+
+FW_BENCHMARK(ModelImport)
+{
+	// Model::Load goes on to create its buffers and textures on the device, this is the import it starts with.
+	std::string path = (std::filesystem::temp_directory_path() / "frostwave_benchmark_grid.obj").string();
+	WriteGrid(path, 128);
+
+	constexpr u64 ImportCount = 10;
+	u64 vertices = 0;
+	context.Measure("obj/128x128", ImportCount, [&]
+	{
+		for (u64 i = 0; i < ImportCount; ++i)
+		{
+			Assimp::Importer importer;
+			const aiScene* imported = importer.ReadFile(path, aiProcess_GenNormals | aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+			vertices = imported ? imported->mMeshes[0]->mNumVertices : 0;
+		}
+	});
+	context.AddCounter("vertices", (f64)vertices);
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Benchmark [--filter text] [--warmup n] [--repetitions n] [--json path] [--baseline path] [--threshold percent] [--stddevs n]
+// Exits with 1 when a measurement is slower than the baseline by more than the threshold plus the allowed noise,
+// or a benchmark check failed.
+int main(int argc, char** argv)
+{
+	const c8* filter = nullptr;
+	const c8* jsonPath = nullptr;
+	const c8* baselinePath = nullptr;
+	u32 warmup = 1;
+	u32 repetitions = 5;
+	f64 threshold = 10.0;
+	f64 stddevs = 2.0;
+	for (i32 i = 1; i < argc; ++i)
+	{
+		if (i + 1 >= argc) break;
+		if (strcmp(argv[i], "--filter") == 0)
+			filter = argv[++i];
+		else if (strcmp(argv[i], "--warmup") == 0)
+			warmup = (u32)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--repetitions") == 0)
+			repetitions = (u32)std::max(atoi(argv[++i]), 1);
+		else if (strcmp(argv[i], "--json") == 0)
+			jsonPath = argv[++i];
+		else if (strcmp(argv[i], "--baseline") == 0)
+			baselinePath = argv[++i];
+		else if (strcmp(argv[i], "--threshold") == 0)
+			threshold = atof(argv[++i]);
+		else if (strcmp(argv[i], "--stddevs") == 0)
+			stddevs = atof(argv[++i]);
+	}
+
+	std::vector<fw::bench::Statistics> statistics;
+	u64 failedChecks = 0;
+	for (auto& entry : fw::bench::GetRegistry())
+	{
+		if (filter && !strstr(entry.name, filter)) continue;
+
+		std::vector<std::string> failures;
+		auto results = fw::bench::Run(entry, warmup, repetitions, failures);
+
+		printf("%s\n", entry.name);
+		for (auto& result : results)
+		{
+			printf("  %-48s %12llu ops %10.2f ns/op  +-%5.1f%%  min %10.2f\n", result.name.c_str(), result.operations, result.median,
+				result.mean > 0.0 ? result.stddev / result.mean * 100.0 : 0.0, result.min);
+			for (auto& [name, value] : result.counters)
+			{
+				printf("    %-46s %12.6g\n", name.c_str(), value);
+			}
+		}
+		for (auto& failure : failures)
+		{
+			printf("  CHECK FAILED: %s\n", failure.c_str());
+		}
+		failedChecks += failures.size();
+		statistics.insert(statistics.end(), results.begin(), results.end());
+	}
+
+	if (jsonPath && !fw::bench::WriteJson(jsonPath, statistics)) return 2;
+
+	if (failedChecks)
+	{
+		printf("%llu checks failed\n", failedChecks);
+		return 1;
+	}
+
+	if (baselinePath)
+	{
+		std::unordered_map<std::string, fw::bench::BaselineEntry> baseline;
+		if (!fw::bench::ReadBaseline(baselinePath, baseline)) return 2;
+
+		u32 regressions = fw::bench::CompareToBaseline(statistics, baseline, threshold / 100.0, stddevs);
+		if (regressions)
+		{
+			printf("%u measurements regressed\n", regressions);
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -1,46 +1,109 @@
 #pragma once
 #include <random>
 #include <cmath>
+#include <type_traits>
 #include <Engine/Core/Types.h>
 
 namespace frostwave
 {
 	constexpr f32 PI = 3.14159265358979323846f;
 
-	inline f32 Radians(f32 angle)
+	constexpr f32 Radians(f32 angle)
 	{
 		return angle * PI / 180.0f;
 	}
 
-	inline f32 Degrees(f32 angle)
+	constexpr f32 Degrees(f32 angle)
 	{
 		return angle * 180.0f / PI;
 	}
 
 	template <typename T, typename U>
-	inline T Max(const T& x, const U& y)
+	constexpr T Max(const T& x, const U& y)
 	{
 		return (T)((x < y) ? y : x);
 	}
 
 	template <typename T, typename U>
-	inline T Min(const T& x, const U& y)
+	constexpr T Min(const T& x, const U& y)
 	{
 		return (T)(x < y) ? x : y;
 	}
 
 	template <typename T, typename U, typename R>
-	inline T Clamp(const T& x, const U& min, const R& max)
+	constexpr T Clamp(const T& x, const U& min, const R& max)
 	{
-		return (T)fw::Max(min, fw::Min(x, max));
+		return (T)Max(min, Min(x, max));
 	}
 
 	template <typename T, typename T2>
-	T Lerp(const T& min, const T& max, const T2& current)
+	constexpr T Lerp(const T& min, const T& max, const T2& current)
 	{
 		return min + (max - min) * current;
 	}
 
+	// sqrt, sin, cos and tan that also work in constant expressions, where the std ones are not constexpr. At
+	// compile time they are worked out in doubles (Newton and Taylor series) so f32 results round the same as
+	// the std functions, at runtime they are the std functions.
+	// MSVC reports the std::is_constant_evaluated() branch it drops at runtime as unreachable code.
+#pragma warning(push)
+#pragma warning(disable: 4702)
+	template <typename T>
+	constexpr T Sqrt(T value)
+	{
+		if (std::is_constant_evaluated())
+		{
+			f64 x = static_cast<f64>(value);
+			if (!(x > 0)) return static_cast<T>(0);
+			f64 root = x > 1 ? x : 1;
+			for (i32 i = 0; i < 1024; ++i)
+			{
+				f64 next = (root + x / root) * 0.5;
+				if (next >= root) break;
+				root = next;
+			}
+			return static_cast<T>(root);
+		}
+		return static_cast<T>(std::sqrt(value));
+	}
+
+	template <typename T>
+	constexpr T Sin(T angle)
+	{
+		if (std::is_constant_evaluated())
+		{
+			constexpr f64 twoPi = 6.283185307179586476925;
+			f64 x = static_cast<f64>(angle);
+			x -= twoPi * static_cast<f64>(static_cast<i64>(x / twoPi + (x < 0 ? -0.5 : 0.5)));
+
+			f64 term = x, sum = x;
+			for (i32 i = 1; i < 16; ++i)
+			{
+				term *= -x * x / ((2.0 * i) * (2.0 * i + 1));
+				sum += term;
+			}
+			return static_cast<T>(sum);
+		}
+		return static_cast<T>(std::sin(angle));
+	}
+
+	template <typename T>
+	constexpr T Cos(T angle)
+	{
+		if (std::is_constant_evaluated())
+			return static_cast<T>(Sin(static_cast<f64>(angle) + 1.570796326794896619231));
+		return static_cast<T>(std::cos(angle));
+	}
+
+	template <typename T>
+	constexpr T Tan(T angle)
+	{
+		if (std::is_constant_evaluated())
+			return static_cast<T>(Sin(static_cast<f64>(angle)) / Cos(static_cast<f64>(angle)));
+		return static_cast<T>(std::tan(angle));
+	}
+#pragma warning(pop)
+
 	template <typename T>
 	inline T RandomRange(T min, T max)
 	{
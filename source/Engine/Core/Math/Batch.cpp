@@ -0,0 +1,170 @@
+#include "Batch.h"
+#include "BatchKernels.h"
+#include <Engine/Core/Math/Mat4.h>
+#include <algorithm>
+#include <cmath>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	using frostwave::batch::ISA;
+
+	ISA DetectISA()
+	{
+#ifdef _MSC_VER
+		i32 info[4];
+		__cpuid(info, 0);
+		i32 highest = info[0];
+
+		__cpuid(info, 1);
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		bool fma = (info[2] & (1 << 12)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!sse2) return ISA::Scalar;
+
+		// The OS has to save the wider registers on a context switch, XCR0 says which ones it does.
+		u64 xcr0 = osxsave ? _xgetbv(0) : 0;
+		bool ymm = (xcr0 & 0x6) == 0x6;
+		bool zmm = (xcr0 & 0xe6) == 0xe6;
+
+		bool avx2 = false, avx512 = false;
+		if (highest >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+			// F, DQ, BW and VL, the kernels are built with all four enabled.
+			constexpr u32 avx512Bits = (1u << 16) | (1u << 17) | (1u << 30) | (1u << 31);
+			avx512 = ((u32)info[1] & avx512Bits) == avx512Bits;
+		}
+
+		if (avx512 && zmm) return ISA::AVX512;
+		if (avx && avx2 && fma && ymm) return ISA::AVX2;
+		return ISA::SSE2;
+#else
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl"))
+			return ISA::AVX512;
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return ISA::AVX2;
+		if (__builtin_cpu_supports("sse2")) return ISA::SSE2;
+		return ISA::Scalar;
+#endif
+	}
+
+	const frostwave::batch::Kernels& GetKernels(ISA isa)
+	{
+		switch (isa)
+		{
+		case ISA::SSE2: return frostwave::batch::GetSSE2Kernels();
+		case ISA::AVX2: return frostwave::batch::GetAVX2Kernels();
+		case ISA::AVX512: return frostwave::batch::GetAVX512Kernels();
+		default: return frostwave::batch::GetScalarKernels();
+		}
+	}
+
+	struct Selection
+	{
+		ISA isa;
+		const frostwave::batch::Kernels* kernels;
+	};
+
+	Selection& GetSelection()
+	{
+		static Selection selection = { frostwave::batch::GetBestISA(), &GetKernels(frostwave::batch::GetBestISA()) };
+		return selection;
+	}
+}
+
+const frostwave::batch::Kernels& frostwave::batch::GetScalarKernels()
+{
+	static const Kernels kernels = MakeKernels<Scalar>();
+	return kernels;
+}
+
+frostwave::batch::ISA frostwave::batch::GetBestISA()
+{
+	static const ISA best = DetectISA();
+	return best;
+}
+
+bool frostwave::batch::IsSupported(ISA isa)
+{
+	return isa < ISA::Count && isa <= GetBestISA();
+}
+
+frostwave::batch::ISA frostwave::batch::GetISA()
+{
+	return GetSelection().isa;
+}
+
+bool frostwave::batch::SetISA(ISA isa)
+{
+	if (!IsSupported(isa)) return false;
+	GetSelection() = { isa, &GetKernels(isa) };
+	return true;
+}
+
+const c8* frostwave::batch::GetISAName(ISA isa)
+{
+	switch (isa)
+	{
+	case ISA::Scalar: return "Scalar";
+	case ISA::SSE2: return "SSE2";
+	case ISA::AVX2: return "AVX2";
+	case ISA::AVX512: return "AVX512";
+	default: return "Unknown";
+	}
+}
+
+void frostwave::batch::TransformPoints(const Mat4f& matrix, ConstVec3Array points, Vec3Array out, u64 count)
+{
+	GetSelection().kernels->transformPoints(matrix.m_Numbers, points, out, count);
+}
+
+void frostwave::batch::TransformSpheres(const Mat4f& matrix, ConstVec3Array centers, const f32* radii, Vec3Array outCenters, f32* outRadii, u64 count)
+{
+	f32 scale = std::sqrt(std::max({ matrix.m_RightAxis.LengthSqr(), matrix.m_UpAxis.LengthSqr(), matrix.m_ForwardAxis.LengthSqr() }));
+	GetSelection().kernels->transformSpheres(matrix.m_Numbers, scale, centers, radii, outCenters, outRadii, count);
+}
+
+void frostwave::batch::TransformAABBs(const Mat4f& matrix, ConstVec3Array mins, ConstVec3Array maxs, Vec3Array outMins, Vec3Array outMaxs, u64 count)
+{
+	f32 absolute[16];
+	for (u32 i = 0; i < 16; ++i)
+		absolute[i] = std::abs(matrix.m_Numbers[i]);
+	GetSelection().kernels->transformAABBs(matrix.m_Numbers, absolute, mins, maxs, outMins, outMaxs, count);
+}
+
+void frostwave::batch::CreateTransforms(ConstVec3Array positions, ConstQuatArray rotations, ConstVec3Array scales, Mat4f* out, u64 count)
+{
+	static_assert(sizeof(Mat4f) == 16 * sizeof(f32), "The kernels write matrices as consecutive floats!");
+	if (!count) return;
+	GetSelection().kernels->createTransforms(positions, rotations, scales, out->m_Numbers, count);
+}
+
+void frostwave::batch::Nlerp(ConstQuatArray a, ConstQuatArray b, f32 delta, QuatArray out, u64 count)
+{
+	GetSelection().kernels->nlerp(a, b, delta, out, count);
+}
+
+void frostwave::batch::Slerp(ConstQuatArray a, ConstQuatArray b, f32 delta, QuatArray out, u64 count)
+{
+	GetSelection().kernels->slerp(a, b, delta, out, count);
+}
+
+void frostwave::batch::Multiply(ConstQuatArray a, ConstQuatArray b, QuatArray out, u64 count)
+{
+	GetSelection().kernels->multiply(a, b, out, count);
+}
+
+void frostwave::batch::RotateVectors(ConstQuatArray rotations, ConstVec3Array vectors, Vec3Array out, u64 count)
+{
+	GetSelection().kernels->rotateVectors(rotations, vectors, out, count);
+}
+
+void frostwave::batch::CreateRotationMatrices(ConstQuatArray rotations, Mat4f* out, u64 count)
+{
+	if (!count) return;
+	GetSelection().kernels->createRotationMatrices(rotations, out->m_Numbers, count);
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <Engine/Core/Types.h>
+
+namespace frostwave
+{
+	template<typename T>
+	class Mat4;
+
+	// Math over arrays of items kept as structure of arrays, one Mat4f applied to thousands of points or
+	// bounds at a time. Every function runs the widest kernel the CPU supports, picked once on first use.
+	// Inputs and outputs may be the same arrays, nothing has to be aligned.
+	namespace batch
+	{
+		struct Vec3Array
+		{
+			f32* x;
+			f32* y;
+			f32* z;
+		};
+
+		struct ConstVec3Array
+		{
+			ConstVec3Array(const f32* _x, const f32* _y, const f32* _z) : x(_x), y(_y), z(_z) { }
+			ConstVec3Array(const Vec3Array& other) : x(other.x), y(other.y), z(other.z) { }
+
+			const f32* x;
+			const f32* y;
+			const f32* z;
+		};
+
+		struct QuatArray
+		{
+			f32* w;
+			f32* x;
+			f32* y;
+			f32* z;
+		};
+
+		struct ConstQuatArray
+		{
+			ConstQuatArray(const f32* _w, const f32* _x, const f32* _y, const f32* _z) : w(_w), x(_x), y(_y), z(_z) { }
+			ConstQuatArray(const QuatArray& other) : w(other.w), x(other.x), y(other.y), z(other.z) { }
+
+			const f32* w;
+			const f32* x;
+			const f32* y;
+			const f32* z;
+		};
+
+		enum class ISA : u8
+		{
+			Scalar,
+			SSE2,
+			AVX2,
+			AVX512,
+			Count
+		};
+
+		// The widest instruction set both the CPU and the OS support.
+		ISA GetBestISA();
+		bool IsSupported(ISA isa);
+		ISA GetISA();
+		// Forces the kernels of an instruction set, returns false if the CPU does not have it.
+		bool SetISA(ISA isa);
+		const c8* GetISAName(ISA isa);
+
+		// Same as point * matrix for every point.
+		void TransformPoints(const Mat4<f32>& matrix, ConstVec3Array points, Vec3Array out, u64 count);
+
+		// Radii grow by the largest scale of the matrix.
+		void TransformSpheres(const Mat4<f32>& matrix, ConstVec3Array centers, const f32* radii, Vec3Array outCenters, f32* outRadii, u64 count);
+
+		// Bounds of each transformed box (Arvo), computed on center and extents so there are no branches.
+		void TransformAABBs(const Mat4<f32>& matrix, ConstVec3Array mins, ConstVec3Array maxs, Vec3Array outMins, Vec3Array outMaxs, u64 count);
+
+		// Same as Mat4f::CreateTransform for every item.
+		void CreateTransforms(ConstVec3Array positions, ConstQuatArray rotations, ConstVec3Array scales, Mat4<f32>* out, u64 count);
+
+		// The quaternion functions take unit quaternions and interpolate along the shorter arc like Quat::Slerp.
+		// Same as Quat::Nlerp for every pair.
+		void Nlerp(ConstQuatArray a, ConstQuatArray b, f32 delta, QuatArray out, u64 count);
+
+		// Quat::Slerp with polynomials for acos and sin, the result is renormalized. Measured against a
+		// double precision slerp it is off by at most 6e-7 radians (3.5e-5 degrees), Quat::Slerp by 4e-7.
+		void Slerp(ConstQuatArray a, ConstQuatArray b, f32 delta, QuatArray out, u64 count);
+
+		// a * b for every pair, b applied after a like Quat::operator*.
+		void Multiply(ConstQuatArray a, ConstQuatArray b, QuatArray out, u64 count);
+
+		// Same as vector * rotation.GetRotationMatrix44() for every pair, so the forward vectors of
+		// Quat::GetForwardVector are the rotated 0 0 1.
+		void RotateVectors(ConstQuatArray rotations, ConstVec3Array vectors, Vec3Array out, u64 count);
+
+		// Same as Quat::GetRotationMatrix44 for every item.
+		void CreateRotationMatrices(ConstQuatArray rotations, Mat4<f32>* out, u64 count);
+	}
+}
+namespace fw = frostwave;
@@ -0,0 +1,40 @@
+#include "BatchKernels.h"
+#include <immintrin.h>
+
+// Built with /arch:AVX2, only called once Batch.cpp has checked for AVX2 and FMA.
+namespace
+{
+	struct AVX2
+	{
+		static constexpr u64 Width = 8;
+
+		static AVX2 Load(const f32* p) { return { _mm256_loadu_ps(p) }; }
+		static AVX2 Set(f32 value) { return { _mm256_set1_ps(value) }; }
+		static void Store(f32* p, AVX2 value) { _mm256_storeu_ps(p, value.v); }
+		static AVX2 MulAdd(AVX2 a, AVX2 b, AVX2 c) { return { _mm256_fmadd_ps(a.v, b.v, c.v) }; }
+		static AVX2 Sqrt(AVX2 a) { return { _mm256_sqrt_ps(a.v) }; }
+		static AVX2 Min(AVX2 a, AVX2 b) { return { _mm256_min_ps(a.v, b.v) }; }
+		static AVX2 FlipSign(AVX2 value, AVX2 sign) { return { _mm256_xor_ps(value.v, _mm256_and_ps(sign.v, _mm256_set1_ps(-0.0f))) }; }
+		static AVX2 SelectGreater(AVX2 a, AVX2 b, AVX2 ifTrue, AVX2 ifFalse) { return { _mm256_blendv_ps(ifFalse.v, ifTrue.v, _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)) }; }
+
+		static void Split(AVX2 value, __m128* quarters)
+		{
+			quarters[0] = _mm256_castps256_ps128(value.v);
+			quarters[1] = _mm256_extractf128_ps(value.v, 1);
+		}
+		static void StoreMatrices(const AVX2* elements, f32* out) { fw::batch::StoreMatricesByQuarters(elements, out); }
+
+		AVX2 operator+(AVX2 other) const { return { _mm256_add_ps(v, other.v) }; }
+		AVX2 operator-(AVX2 other) const { return { _mm256_sub_ps(v, other.v) }; }
+		AVX2 operator*(AVX2 other) const { return { _mm256_mul_ps(v, other.v) }; }
+		AVX2 operator/(AVX2 other) const { return { _mm256_div_ps(v, other.v) }; }
+
+		__m256 v;
+	};
+}
+
+const frostwave::batch::Kernels& frostwave::batch::GetAVX2Kernels()
+{
+	static const Kernels kernels = MakeKernels<AVX2>();
+	return kernels;
+}
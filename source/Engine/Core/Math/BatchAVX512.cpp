@@ -0,0 +1,47 @@
+#include "BatchKernels.h"
+#include <immintrin.h>
+
+// Built with /arch:AVX512, only called once Batch.cpp has checked for AVX-512F.
+namespace
+{
+	struct AVX512
+	{
+		static constexpr u64 Width = 16;
+
+		static AVX512 Load(const f32* p) { return { _mm512_loadu_ps(p) }; }
+		static AVX512 Set(f32 value) { return { _mm512_set1_ps(value) }; }
+		static void Store(f32* p, AVX512 value) { _mm512_storeu_ps(p, value.v); }
+		static AVX512 MulAdd(AVX512 a, AVX512 b, AVX512 c) { return { _mm512_fmadd_ps(a.v, b.v, c.v) }; }
+		static AVX512 Sqrt(AVX512 a) { return { _mm512_sqrt_ps(a.v) }; }
+		static AVX512 Min(AVX512 a, AVX512 b) { return { _mm512_min_ps(a.v, b.v) }; }
+		static AVX512 FlipSign(AVX512 value, AVX512 sign)
+		{
+			// Integer ops, the float xor/and need AVX512DQ.
+			__m512i signBits = _mm512_and_si512(_mm512_castps_si512(sign.v), _mm512_set1_epi32((i32)0x80000000));
+			return { _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(value.v), signBits)) };
+		}
+		static AVX512 SelectGreater(AVX512 a, AVX512 b, AVX512 ifTrue, AVX512 ifFalse) { return { _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ), ifFalse.v, ifTrue.v) }; }
+
+		static void Split(AVX512 value, __m128* quarters)
+		{
+			quarters[0] = _mm512_castps512_ps128(value.v);
+			quarters[1] = _mm512_extractf32x4_ps(value.v, 1);
+			quarters[2] = _mm512_extractf32x4_ps(value.v, 2);
+			quarters[3] = _mm512_extractf32x4_ps(value.v, 3);
+		}
+		static void StoreMatrices(const AVX512* elements, f32* out) { fw::batch::StoreMatricesByQuarters(elements, out); }
+
+		AVX512 operator+(AVX512 other) const { return { _mm512_add_ps(v, other.v) }; }
+		AVX512 operator-(AVX512 other) const { return { _mm512_sub_ps(v, other.v) }; }
+		AVX512 operator*(AVX512 other) const { return { _mm512_mul_ps(v, other.v) }; }
+		AVX512 operator/(AVX512 other) const { return { _mm512_div_ps(v, other.v) }; }
+
+		__m512 v;
+	};
+}
+
+const frostwave::batch::Kernels& frostwave::batch::GetAVX512Kernels()
+{
+	static const Kernels kernels = MakeKernels<AVX512>();
+	return kernels;
+}
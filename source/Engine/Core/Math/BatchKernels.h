@@ -0,0 +1,435 @@
+#pragma once
+#include <Engine/Core/Math/Batch.h>
+#include <cmath>
+#include <xmmintrin.h>
+
+// Shared by Batch.cpp and the files compiled for one instruction set each. Everything but the table is in an
+// anonymous namespace so code built for AVX never gets merged with the copy other files call.
+namespace frostwave::batch
+{
+	struct Kernels
+	{
+		void (*transformPoints)(const f32* matrix, ConstVec3Array points, Vec3Array out, u64 count);
+		void (*transformSpheres)(const f32* matrix, f32 scale, ConstVec3Array centers, const f32* radii, Vec3Array outCenters, f32* outRadii, u64 count);
+		// absolute holds the absolute value of every element of matrix.
+		void (*transformAABBs)(const f32* matrix, const f32* absolute, ConstVec3Array mins, ConstVec3Array maxs, Vec3Array outMins, Vec3Array outMaxs, u64 count);
+		// Writes sixteen floats per item.
+		void (*createTransforms)(ConstVec3Array positions, ConstQuatArray rotations, ConstVec3Array scales, f32* out, u64 count);
+
+		void (*nlerp)(ConstQuatArray a, ConstQuatArray b, f32 delta, QuatArray out, u64 count);
+		void (*slerp)(ConstQuatArray a, ConstQuatArray b, f32 delta, QuatArray out, u64 count);
+		void (*multiply)(ConstQuatArray a, ConstQuatArray b, QuatArray out, u64 count);
+		void (*rotateVectors)(ConstQuatArray rotations, ConstVec3Array vectors, Vec3Array out, u64 count);
+		// Writes sixteen floats per item.
+		void (*createRotationMatrices)(ConstQuatArray rotations, f32* out, u64 count);
+	};
+
+	const Kernels& GetScalarKernels();
+	const Kernels& GetSSE2Kernels();
+	const Kernels& GetAVX2Kernels();
+	const Kernels& GetAVX512Kernels();
+
+	namespace
+	{
+		// One item at a time, used on its own and for what is left after the last full register.
+		struct Scalar
+		{
+			static constexpr u64 Width = 1;
+
+			static Scalar Load(const f32* p) { return { *p }; }
+			static Scalar Set(f32 value) { return { value }; }
+			static void Store(f32* p, Scalar value) { *p = value.v; }
+			static Scalar MulAdd(Scalar a, Scalar b, Scalar c) { return { a.v * b.v + c.v }; }
+			static Scalar Sqrt(Scalar a) { return { std::sqrt(a.v) }; }
+			static Scalar Min(Scalar a, Scalar b) { return { a.v < b.v ? a.v : b.v }; }
+			// value negated where sign has its sign bit set, -0 included to match the SIMD versions.
+			static Scalar FlipSign(Scalar value, Scalar sign) { return { std::signbit(sign.v) ? -value.v : value.v }; }
+			static Scalar SelectGreater(Scalar a, Scalar b, Scalar ifTrue, Scalar ifFalse) { return a.v > b.v ? ifTrue : ifFalse; }
+
+			static void StoreMatrices(const Scalar* elements, f32* out)
+			{
+				for (u32 i = 0; i < 16; ++i)
+					out[i] = elements[i].v;
+			}
+
+			Scalar operator+(Scalar other) const { return { v + other.v }; }
+			Scalar operator-(Scalar other) const { return { v - other.v }; }
+			Scalar operator*(Scalar other) const { return { v * other.v }; }
+			Scalar operator/(Scalar other) const { return { v / other.v }; }
+
+			f32 v;
+		};
+
+		// Elements are one register per matrix element, lanes holding consecutive items. Every group of
+		// four lanes is transposed into four matrices.
+		template <typename V>
+		void StoreMatricesByQuarters(const V* elements, f32* out)
+		{
+			constexpr u64 Quarters = V::Width / 4;
+			__m128 quarters[16][Quarters];
+			for (u32 i = 0; i < 16; ++i)
+				V::Split(elements[i], quarters[i]);
+
+			for (u64 q = 0; q < Quarters; ++q)
+			{
+				f32* matrices = out + q * 64;
+				for (u32 row = 0; row < 4; ++row)
+				{
+					__m128 a = quarters[row * 4 + 0][q];
+					__m128 b = quarters[row * 4 + 1][q];
+					__m128 c = quarters[row * 4 + 2][q];
+					__m128 d = quarters[row * 4 + 3][q];
+					_MM_TRANSPOSE4_PS(a, b, c, d);
+					_mm_storeu_ps(matrices + row * 4, a);
+					_mm_storeu_ps(matrices + 16 + row * 4, b);
+					_mm_storeu_ps(matrices + 32 + row * 4, c);
+					_mm_storeu_ps(matrices + 48 + row * 4, d);
+				}
+			}
+		}
+
+		template <typename V>
+		inline void TransformPoint(const V* m, V x, V y, V z, V& outX, V& outY, V& outZ)
+		{
+			outX = V::MulAdd(x, m[0], V::MulAdd(y, m[4], V::MulAdd(z, m[8], m[12])));
+			outY = V::MulAdd(x, m[1], V::MulAdd(y, m[5], V::MulAdd(z, m[9], m[13])));
+			outZ = V::MulAdd(x, m[2], V::MulAdd(y, m[6], V::MulAdd(z, m[10], m[14])));
+		}
+
+		template <typename V>
+		u64 TransformPoints(const f32* matrix, ConstVec3Array points, Vec3Array out, u64 begin, u64 end)
+		{
+			V m[16];
+			for (u32 i = 0; i < 16; ++i)
+				m[i] = V::Set(matrix[i]);
+
+			u64 i = begin;
+			for (; i + V::Width <= end; i += V::Width)
+			{
+				V x, y, z;
+				TransformPoint(m, V::Load(points.x + i), V::Load(points.y + i), V::Load(points.z + i), x, y, z);
+				V::Store(out.x + i, x);
+				V::Store(out.y + i, y);
+				V::Store(out.z + i, z);
+			}
+			return i;
+		}
+
+		template <typename V>
+		u64 TransformSpheres(const f32* matrix, f32 scale, ConstVec3Array centers, const f32* radii, Vec3Array outCenters, f32* outRadii, u64 begin, u64 end)
+		{
+			V m[16];
+			for (u32 i = 0; i < 16; ++i)
+				m[i] = V::Set(matrix[i]);
+			V s = V::Set(scale);
+
+			u64 i = begin;
+			for (; i + V::Width <= end; i += V::Width)
+			{
+				V x, y, z;
+				TransformPoint(m, V::Load(centers.x + i), V::Load(centers.y + i), V::Load(centers.z + i), x, y, z);
+				V::Store(outCenters.x + i, x);
+				V::Store(outCenters.y + i, y);
+				V::Store(outCenters.z + i, z);
+				V::Store(outRadii + i, V::Load(radii + i) * s);
+			}
+			return i;
+		}
+
+		template <typename V>
+		u64 TransformAABBs(const f32* matrix, const f32* absolute, ConstVec3Array mins, ConstVec3Array maxs, Vec3Array outMins, Vec3Array outMaxs, u64 begin, u64 end)
+		{
+			V m[16], a[16];
+			for (u32 i = 0; i < 16; ++i)
+			{
+				m[i] = V::Set(matrix[i]);
+				a[i] = V::Set(absolute[i]);
+			}
+			V half = V::Set(0.5f);
+
+			u64 i = begin;
+			for (; i + V::Width <= end; i += V::Width)
+			{
+				V minX = V::Load(mins.x + i), minY = V::Load(mins.y + i), minZ = V::Load(mins.z + i);
+				V maxX = V::Load(maxs.x + i), maxY = V::Load(maxs.y + i), maxZ = V::Load(maxs.z + i);
+
+				V x, y, z;
+				TransformPoint(m, (minX + maxX) * half, (minY + maxY) * half, (minZ + maxZ) * half, x, y, z);
+
+				V extentX = (maxX - minX) * half, extentY = (maxY - minY) * half, extentZ = (maxZ - minZ) * half;
+				V ex = V::MulAdd(extentX, a[0], V::MulAdd(extentY, a[4], extentZ * a[8]));
+				V ey = V::MulAdd(extentX, a[1], V::MulAdd(extentY, a[5], extentZ * a[9]));
+				V ez = V::MulAdd(extentX, a[2], V::MulAdd(extentY, a[6], extentZ * a[10]));
+
+				V::Store(outMins.x + i, x - ex);
+				V::Store(outMins.y + i, y - ey);
+				V::Store(outMins.z + i, z - ez);
+				V::Store(outMaxs.x + i, x + ex);
+				V::Store(outMaxs.y + i, y + ey);
+				V::Store(outMaxs.z + i, z + ez);
+			}
+			return i;
+		}
+
+		// The 3x3 part of Quat::GetRotationMatrix44, row major.
+		template <typename V>
+		inline void QuatToRows(V w, V x, V y, V z, V* rows)
+		{
+			V one = V::Set(1.0f), two = V::Set(2.0f);
+			V xx = x * x, yy = y * y, zz = z * z;
+			V xy = x * y, xz = x * z, yz = y * z;
+			V wx = w * x, wy = w * y, wz = w * z;
+
+			rows[0] = one - two * (yy + zz);
+			rows[1] = two * (xy + wz);
+			rows[2] = two * (xz - wy);
+			rows[3] = two * (xy - wz);
+			rows[4] = one - two * (xx + zz);
+			rows[5] = two * (yz + wx);
+			rows[6] = two * (xz + wy);
+			rows[7] = two * (yz - wx);
+			rows[8] = one - two * (xx + yy);
+		}
+
+		template <typename V>
+		u64 CreateTransforms(ConstVec3Array positions, ConstQuatArray rotations, ConstVec3Array scales, f32* out, u64 begin, u64 end)
+		{
+			V one = V::Set(1.0f), zero = V::Set(0.0f);
+
+			u64 i = begin;
+			for (; i + V::Width <= end; i += V::Width)
+			{
+				V r[9];
+				QuatToRows(V::Load(rotations.w + i), V::Load(rotations.x + i), V::Load(rotations.y + i), V::Load(rotations.z + i), r);
+				V sx = V::Load(scales.x + i), sy = V::Load(scales.y + i), sz = V::Load(scales.z + i);
+
+				// Every row scaled, then the position as the last row.
+				V elements[16] = {
+					r[0] * sx, r[1] * sx, r[2] * sx, zero,
+					r[3] * sy, r[4] * sy, r[5] * sy, zero,
+					r[6] * sz, r[7] * sz, r[8] * sz, zero,
+					V::Load(positions.x + i), V::Load(positions.y + i), V::Load(positions.z + i), one,
+				};
+				V::StoreMatrices(elements, out + i * 16);
+			}
+			return i;
+		}
+
+		// acos on [0, 1] as sqrt(1 - x) times a polynomial, Abramowitz and Stegun 4.4.46. Off by at most
+		// 2e-8 radians before float rounding.
+		template <typename V>
+		inline V Acos(V x)
+		{
+			V polynomial = V::MulAdd(V::Set(-0.0012624911f), x, V::Set(0.0066700901f));
+			polynomial = V::MulAdd(polynomial, x, V::Set(-0.0170881256f));
+			polynomial = V::MulAdd(polynomial, x, V::Set(0.0308918810f));
+			polynomial = V::MulAdd(polynomial, x, V::Set(-0.0501743046f));
+			polynomial = V::MulAdd(polynomial, x, V::Set(0.0889789874f));
+			polynomial = V::MulAdd(polynomial, x, V::Set(-0.2145988016f));
+			polynomial = V::MulAdd(polynomial, x, V::Set(1.5707963050f));
+			return V::Sqrt(V::Set(1.0f) - x) * polynomial;
+		}
+
+		// sin on [0, pi / 2] from its series up to x^11, off by at most 6e-8 there.
+		template <typename V>
+		inline V Sin(V x)
+		{
+			V x2 = x * x;
+			V polynomial = V::MulAdd(V::Set(-1.0f / 39916800.0f), x2, V::Set(1.0f / 362880.0f));
+			polynomial = V::MulAdd(polynomial, x2, V::Set(-1.0f / 5040.0f));
+			polynomial = V::MulAdd(polynomial, x2, V::Set(1.0f / 120.0f));
+			polynomial = V::MulAdd(polynomial, x2, V::Set(-1.0f / 6.0f));
+			polynomial = V::MulAdd(polynomial, x2, V::Set(1.0f));
+			return x * polynomial;
+		}
+
+		template <typename V>
+		inline void StoreNormalized(QuatArray out, u64 i, V w, V x, V y, V z)
+		{
+			V inverse = V::Set(1.0f) / V::Sqrt(V::MulAdd(w, w, V::MulAdd(x, x, V::MulAdd(y, y, z * z))));
+			V::Store(out.w + i, w * inverse);
+			V::Store(out.x + i, x * inverse);
+			V::Store(out.y + i, y * inverse);
+			V::Store(out.z + i, z * inverse);
+		}
+
+		// A pair of quaternions with b negated where needed so the two are at most half a turn apart.
+		template <typename V>
+		struct ShorterArc
+		{
+			ShorterArc(ConstQuatArray a, ConstQuatArray b, u64 i)
+			{
+				aw = V::Load(a.w + i), ax = V::Load(a.x + i), ay = V::Load(a.y + i), az = V::Load(a.z + i);
+				bw = V::Load(b.w + i), bx = V::Load(b.x + i), by = V::Load(b.y + i), bz = V::Load(b.z + i);
+
+				V dot = V::MulAdd(aw, bw, V::MulAdd(ax, bx, V::MulAdd(ay, by, az * bz)));
+				bw = V::FlipSign(bw, dot);
+				bx = V::FlipSign(bx, dot);
+				by = V::FlipSign(by, dot);
+				bz = V::FlipSign(bz, dot);
+				cosTheta = V::FlipSign(dot, dot);
+			}
+
+			V aw, ax, ay, az;
+			V bw, bx, by, bz;
+			V cosTheta;
+		};
+
+		template <typename V>
+		u64 Nlerp(ConstQuatArray a, ConstQuatArray b, f32 delta, QuatArray out, u64 begin, u64 end)
+		{
+			V to = V::Set(delta), from = V::Set(1.0f - delta);
+
+			u64 i = begin;
+			for (; i + V::Width <= end; i += V::Width)
+			{
+				ShorterArc<V> q(a, b, i);
+				StoreNormalized(out, i,
+					V::MulAdd(from, q.aw, to * q.bw), V::MulAdd(from, q.ax, to * q.bx),
+					V::MulAdd(from, q.ay, to * q.by), V::MulAdd(from, q.az, to * q.bz));
+			}
+			return i;
+		}
+
+		template <typename V>
+		u64 Slerp(ConstQuatArray a, ConstQuatArray b, f32 delta, QuatArray out, u64 begin, u64 end)
+		{
+			V one = V::Set(1.0f), t = V::Set(delta), s = V::Set(1.0f - delta);
+			V threshold = V::Set(0.9995f);
+
+			u64 i = begin;
+			for (; i + V::Width <= end; i += V::Width)
+			{
+				ShorterArc<V> q(a, b, i);
+				V cosTheta = V::Min(q.cosTheta, one);
+
+				// On the shorter arc the angle is at most pi / 2, the range Sin is good for.
+				V angle = Acos(cosTheta);
+				V inverseSin = one / Sin(angle);
+				V from = Sin(s * angle) * inverseSin;
+				V to = Sin(t * angle) * inverseSin;
+
+				// Like Quat::Slerp nearly parallel pairs are lerped instead of dividing by a sine close
+				// to zero, the normalization makes that an nlerp and keeps the rest unit length.
+				from = V::SelectGreater(cosTheta, threshold, s, from);
+				to = V::SelectGreater(cosTheta, threshold, t, to);
+
+				StoreNormalized(out, i,
+					V::MulAdd(from, q.aw, to * q.bw), V::MulAdd(from, q.ax, to * q.bx),
+					V::MulAdd(from, q.ay, to * q.by), V::MulAdd(from, q.az, to * q.bz));
+			}
+			return i;
+		}
+
+		// Same product as Quat::operator*, b applied after a.
+		template <typename V>
+		u64 Multiply(ConstQuatArray a, ConstQuatArray b, QuatArray out, u64 begin, u64 end)
+		{
+			u64 i = begin;
+			for (; i + V::Width <= end; i += V::Width)
+			{
+				V aw = V::Load(a.w + i), ax = V::Load(a.x + i), ay = V::Load(a.y + i), az = V::Load(a.z + i);
+				V bw = V::Load(b.w + i), bx = V::Load(b.x + i), by = V::Load(b.y + i), bz = V::Load(b.z + i);
+
+				V::Store(out.w + i, bw * aw - V::MulAdd(bx, ax, V::MulAdd(by, ay, bz * az)));
+				V::Store(out.x + i, V::MulAdd(bw, ax, V::MulAdd(bx, aw, by * az)) - bz * ay);
+				V::Store(out.y + i, V::MulAdd(bw, ay, V::MulAdd(by, aw, bz * ax)) - bx * az);
+				V::Store(out.z + i, V::MulAdd(bw, az, V::MulAdd(bz, aw, bx * ay)) - by * ax);
+			}
+			return i;
+		}
+
+		template <typename V>
+		u64 RotateVectors(ConstQuatArray rotations, ConstVec3Array vectors, Vec3Array out, u64 begin, u64 end)
+		{
+			u64 i = begin;
+			for (; i + V::Width <= end; i += V::Width)
+			{
+				V r[9];
+				QuatToRows(V::Load(rotations.w + i), V::Load(rotations.x + i), V::Load(rotations.y + i), V::Load(rotations.z + i), r);
+				V x = V::Load(vectors.x + i), y = V::Load(vectors.y + i), z = V::Load(vectors.z + i);
+
+				V::Store(out.x + i, V::MulAdd(x, r[0], V::MulAdd(y, r[3], z * r[6])));
+				V::Store(out.y + i, V::MulAdd(x, r[1], V::MulAdd(y, r[4], z * r[7])));
+				V::Store(out.z + i, V::MulAdd(x, r[2], V::MulAdd(y, r[5], z * r[8])));
+			}
+			return i;
+		}
+
+		template <typename V>
+		u64 CreateRotationMatrices(ConstQuatArray rotations, f32* out, u64 begin, u64 end)
+		{
+			V one = V::Set(1.0f), zero = V::Set(0.0f);
+
+			u64 i = begin;
+			for (; i + V::Width <= end; i += V::Width)
+			{
+				V r[9];
+				QuatToRows(V::Load(rotations.w + i), V::Load(rotations.x + i), V::Load(rotations.y + i), V::Load(rotations.z + i), r);
+
+				V elements[16] = {
+					r[0], r[1], r[2], zero,
+					r[3], r[4], r[5], zero,
+					r[6], r[7], r[8], zero,
+					zero, zero, zero, one,
+				};
+				V::StoreMatrices(elements, out + i * 16);
+			}
+			return i;
+		}
+
+		// Runs V over every full register and Scalar over the rest.
+		template <typename V>
+		Kernels MakeKernels()
+		{
+			Kernels kernels;
+			kernels.transformPoints = [](const f32* matrix, ConstVec3Array points, Vec3Array out, u64 count)
+			{
+				u64 done = TransformPoints<V>(matrix, points, out, 0, count);
+				TransformPoints<Scalar>(matrix, points, out, done, count);
+			};
+			kernels.transformSpheres = [](const f32* matrix, f32 scale, ConstVec3Array centers, const f32* radii, Vec3Array outCenters, f32* outRadii, u64 count)
+			{
+				u64 done = TransformSpheres<V>(matrix, scale, centers, radii, outCenters, outRadii, 0, count);
+				TransformSpheres<Scalar>(matrix, scale, centers, radii, outCenters, outRadii, done, count);
+			};
+			kernels.transformAABBs = [](const f32* matrix, const f32* absolute, ConstVec3Array mins, ConstVec3Array maxs, Vec3Array outMins, Vec3Array outMaxs, u64 count)
+			{
+				u64 done = TransformAABBs<V>(matrix, absolute, mins, maxs, outMins, outMaxs, 0, count);
+				TransformAABBs<Scalar>(matrix, absolute, mins, maxs, outMins, outMaxs, done, count);
+			};
+			kernels.createTransforms = [](ConstVec3Array positions, ConstQuatArray rotations, ConstVec3Array scales, f32* out, u64 count)
+			{
+				u64 done = CreateTransforms<V>(positions, rotations, scales, out, 0, count);
+				CreateTransforms<Scalar>(positions, rotations, scales, out, done, count);
+			};
+			kernels.nlerp = [](ConstQuatArray a, ConstQuatArray b, f32 delta, QuatArray out, u64 count)
+			{
+				u64 done = Nlerp<V>(a, b, delta, out, 0, count);
+				Nlerp<Scalar>(a, b, delta, out, done, count);
+			};
+			kernels.slerp = [](ConstQuatArray a, ConstQuatArray b, f32 delta, QuatArray out, u64 count)
+			{
+				u64 done = Slerp<V>(a, b, delta, out, 0, count);
+				Slerp<Scalar>(a, b, delta, out, done, count);
+			};
+			kernels.multiply = [](ConstQuatArray a, ConstQuatArray b, QuatArray out, u64 count)
+			{
+				u64 done = Multiply<V>(a, b, out, 0, count);
+				Multiply<Scalar>(a, b, out, done, count);
+			};
+			kernels.rotateVectors = [](ConstQuatArray rotations, ConstVec3Array vectors, Vec3Array out, u64 count)
+			{
+				u64 done = RotateVectors<V>(rotations, vectors, out, 0, count);
+				RotateVectors<Scalar>(rotations, vectors, out, done, count);
+			};
+			kernels.createRotationMatrices = [](ConstQuatArray rotations, f32* out, u64 count)
+			{
+				u64 done = CreateRotationMatrices<V>(rotations, out, 0, count);
+				CreateRotationMatrices<Scalar>(rotations, out, done, count);
+			};
+			return kernels;
+		}
+	}
+}
+namespace fw = frostwave;
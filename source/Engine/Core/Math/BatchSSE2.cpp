@@ -0,0 +1,39 @@
+#include "BatchKernels.h"
+#include <emmintrin.h>
+
+namespace
+{
+	struct SSE2
+	{
+		static constexpr u64 Width = 4;
+
+		static SSE2 Load(const f32* p) { return { _mm_loadu_ps(p) }; }
+		static SSE2 Set(f32 value) { return { _mm_set1_ps(value) }; }
+		static void Store(f32* p, SSE2 value) { _mm_storeu_ps(p, value.v); }
+		static SSE2 MulAdd(SSE2 a, SSE2 b, SSE2 c) { return { _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v) }; }
+		static SSE2 Sqrt(SSE2 a) { return { _mm_sqrt_ps(a.v) }; }
+		static SSE2 Min(SSE2 a, SSE2 b) { return { _mm_min_ps(a.v, b.v) }; }
+		static SSE2 FlipSign(SSE2 value, SSE2 sign) { return { _mm_xor_ps(value.v, _mm_and_ps(sign.v, _mm_set1_ps(-0.0f))) }; }
+		static SSE2 SelectGreater(SSE2 a, SSE2 b, SSE2 ifTrue, SSE2 ifFalse)
+		{
+			__m128 mask = _mm_cmpgt_ps(a.v, b.v);
+			return { _mm_or_ps(_mm_and_ps(mask, ifTrue.v), _mm_andnot_ps(mask, ifFalse.v)) };
+		}
+
+		static void Split(SSE2 value, __m128* quarters) { quarters[0] = value.v; }
+		static void StoreMatrices(const SSE2* elements, f32* out) { fw::batch::StoreMatricesByQuarters(elements, out); }
+
+		SSE2 operator+(SSE2 other) const { return { _mm_add_ps(v, other.v) }; }
+		SSE2 operator-(SSE2 other) const { return { _mm_sub_ps(v, other.v) }; }
+		SSE2 operator*(SSE2 other) const { return { _mm_mul_ps(v, other.v) }; }
+		SSE2 operator/(SSE2 other) const { return { _mm_div_ps(v, other.v) }; }
+
+		__m128 v;
+	};
+}
+
+const frostwave::batch::Kernels& frostwave::batch::GetSSE2Kernels()
+{
+	static const Kernels kernels = MakeKernels<SSE2>();
+	return kernels;
+}
@@ -13,10 +13,10 @@ namespace frostwave
 	public:
 
 		friend class Mat4<T>;
-		Mat3() : m_Numbers{ 1, 0, 0, 0, 1, 0, 0, 0, 1 }
+		constexpr Mat3() : m_Numbers{ 1, 0, 0, 0, 1, 0, 0, 0, 1 }
 		{
 		}
-		Mat3(const std::initializer_list<T>& initList)
+		constexpr Mat3(const std::initializer_list<T>& initList) : m_Numbers{}
 		{
 			assert(initList.size() == 9 && "Initializer list for Mat3 must contain exactly 9 elements.");
 			auto begin = initList.begin();
@@ -25,11 +25,11 @@ namespace frostwave
 				m_Numbers[i] = *(begin + i);
 			}
 		}
-		Mat3(const Mat3<T>& matrix)
+		constexpr Mat3(const Mat3<T>& matrix) : m_Numbers{}
 		{
 			*this = matrix;
 		}
-		Mat3(const Mat4<T>& matrix)
+		constexpr Mat3(const Mat4<T>& matrix) : m_Numbers{}
 		{
 			m_Numbers[0] = matrix.m_Numbers[0];
 			m_Numbers[1] = matrix.m_Numbers[1];
@@ -45,10 +45,10 @@ namespace frostwave
 
 		}
 
-		static Mat3<T> CreateRotationAroundX(T angle)
+		static constexpr Mat3<T> CreateRotationAroundX(T angle)
 		{
-			T c = cos(angle);
-			T s = sin(angle);
+			T c = Cos(angle);
+			T s = Sin(angle);
 			return Mat3<T>({
 				1, 0, 0,
 				0, c, s,
@@ -56,10 +56,10 @@ namespace frostwave
 				});
 		}
 
-		static Mat3<T> CreateRotationAroundY(T angle)
+		static constexpr Mat3<T> CreateRotationAroundY(T angle)
 		{
-			T c = cos(angle);
-			T s = sin(angle);
+			T c = Cos(angle);
+			T s = Sin(angle);
 			return Mat3<T>({
 				c, 0, -s,
 				0, 1, 0,
@@ -67,10 +67,10 @@ namespace frostwave
 				});
 		}
 
-		static Mat3<T> CreateRotationAroundZ(T angle)
+		static constexpr Mat3<T> CreateRotationAroundZ(T angle)
 		{
-			T c = cos(angle);
-			T s = sin(angle);
+			T c = Cos(angle);
+			T s = Sin(angle);
 			return Mat3<T>({
 				c, s, 0,
 				-s, c, 0,
@@ -78,7 +78,7 @@ namespace frostwave
 				});
 		}
 
-		static Mat3<T> CreateTransform(const Vec2<T>& position, const f32 rotation, const Vec2<T>& scale)
+		static constexpr Mat3<T> CreateTransform(const Vec2<T>& position, const f32 rotation, const Vec2<T>& scale)
 		{
 			Mat3<T> s = {
 				scale.x, 0, 0,
@@ -96,7 +96,7 @@ namespace frostwave
 			return s * r * t;
 		}
 
-		static Mat3<T> Transpose(const Mat3<T>& matrix)
+		static constexpr Mat3<T> Transpose(const Mat3<T>& matrix)
 		{
 			Mat3<T> result(matrix);
 
@@ -112,7 +112,7 @@ namespace frostwave
 			return result;
 
 		}
-		static T Determinant(const Mat3<T>& matrix)
+		static constexpr T Determinant(const Mat3<T>& matrix)
 		{
 			return (matrix.m_Numbers[0] * matrix.m_Numbers[4] * matrix.m_Numbers[8] +
 				matrix.m_Numbers[1] * matrix.m_Numbers[5] * matrix.m_Numbers[6] +
@@ -121,7 +121,7 @@ namespace frostwave
 					matrix.m_Numbers[5] * matrix.m_Numbers[7] * matrix.m_Numbers[0] +
 					matrix.m_Numbers[1] * matrix.m_Numbers[3] * matrix.m_Numbers[8]);
 		}
-		static Mat3<T> Inverse(const Mat3<T>& matrix)
+		static constexpr Mat3<T> Inverse(const Mat3<T>& matrix)
 		{
 			T det = Determinant(matrix);
 			assert(det != 0 && "Non-invertible matrix");
@@ -138,7 +138,7 @@ namespace frostwave
 			return result * (1 / det);
 		}
 
-		inline Mat3<T>& operator=(const Mat3<T>& matrix)
+		constexpr Mat3<T>& operator=(const Mat3<T>& matrix)
 		{
 			for (size_t i = 0; i < 9; ++i)
 			{
@@ -147,7 +147,7 @@ namespace frostwave
 			return *this;
 
 		}
-		inline Mat3<T> operator+(const Mat3<T>& matrix) const
+		constexpr Mat3<T> operator+(const Mat3<T>& matrix) const
 		{
 			Mat3<T> result;
 			for (size_t i = 0; i < 9; i++)
@@ -156,7 +156,7 @@ namespace frostwave
 			}
 			return result;
 		}
-		inline Mat3<T> operator-(const Mat3<T>& matrix) const
+		constexpr Mat3<T> operator-(const Mat3<T>& matrix) const
 		{
 			Mat3<T> result;
 			for (size_t i = 0; i < 9; i++)
@@ -165,7 +165,7 @@ namespace frostwave
 			}
 			return result;
 		}
-		inline Mat3<T> operator*(const Mat3<T>& matrix) const
+		constexpr Mat3<T> operator*(const Mat3<T>& matrix) const
 		{
 			Mat3<T> result;
 			for (size_t i = 0; i <= 6; i += 3)
@@ -177,7 +177,7 @@ namespace frostwave
 			}
 			return result;
 		}
-		inline Mat3<T> operator*(const T& aScalar) const
+		constexpr Mat3<T> operator*(const T& aScalar) const
 		{
 			Mat3<T> result;
 			for (size_t i = 0; i < 9; i++)
@@ -186,7 +186,7 @@ namespace frostwave
 			}
 			return result;
 		}
-		inline bool operator==(const Mat3<T>& matrix) const
+		constexpr bool operator==(const Mat3<T>& matrix) const
 		{
 			for (size_t i = 0; i < 9; i++)
 			{
@@ -198,12 +198,12 @@ namespace frostwave
 			return true;
 		}
 
-		inline void operator+=(const Mat3<T>& matrix) { *this = *this + matrix; }
-		inline void operator-=(const Mat3<T>& matrix) { *this = *this - matrix; }
-		inline void operator*=(const Mat3<T>& matrix) { *this = *this * matrix; }
-		inline void operator*=(const T& aScalar) { *this = *this * aScalar; };
+		constexpr void operator+=(const Mat3<T>& matrix) { *this = *this + matrix; }
+		constexpr void operator-=(const Mat3<T>& matrix) { *this = *this - matrix; }
+		constexpr void operator*=(const Mat3<T>& matrix) { *this = *this * matrix; }
+		constexpr void operator*=(const T& aScalar) { *this = *this * aScalar; };
 
-		friend inline Vec3<T> operator*(const Vec3<T>& vec, const Mat3<T>& matrix)
+		friend constexpr Vec3<T> operator*(const Vec3<T>& vec, const Mat3<T>& matrix)
 		{
 			return Vec3<T>(
 				vec.x * matrix.m_Numbers[0] + vec.y * matrix.m_Numbers[3] + vec.z * matrix.m_Numbers[6],
@@ -211,7 +211,7 @@ namespace frostwave
 				vec.x * matrix.m_Numbers[2] + vec.y * matrix.m_Numbers[5] + vec.z * matrix.m_Numbers[8]
 				);
 		}
-		friend inline void operator*=(Vec3<T>& aVector, const Mat3<T>& matrix) { aVector = aVector * matrix; };
+		friend constexpr void operator*=(Vec3<T>& aVector, const Mat3<T>& matrix) { aVector = aVector * matrix; };
 
 		T m_Numbers[9];
 	};
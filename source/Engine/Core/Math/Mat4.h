@@ -2,10 +2,16 @@
 #include <Engine/Core/Math/Vec3.h>
 #include <initializer_list>
 #include <Engine/Core/Types.h>
+#include <Engine/Core/Common.h>
 #include <Engine/Core/Math/Quat.h>
+#include <Engine/Core/Math/Vec4.h>
+#include <Engine/Core/Math/Simd.h>
 #include <cassert>
 #include <cmath>
 #include <xmmintrin.h>
+// Outside of constant expressions the scalar paths behind the SIMD ones are dead code, MSVC warns about it.
+#pragma warning(push)
+#pragma warning(disable: 4702)
 
 namespace frostwave
 {
@@ -17,13 +23,28 @@ namespace frostwave
 	{
 	public:
 		friend class Mat3<T>;
+		static constexpr bool UseSimd = std::is_same_v<T, f32>;
 
-		Mat4() : m_Numbers{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 }
+		// What Inverse can assume about a matrix, cheapest last.
+		enum class Kind : u8
+		{
+			General,
+			// Last column is 0 0 0 1, anything built from scale, rotation, shear and translation.
+			Affine,
+			// Affine with orthonormal rows, rotation and translation only like views and unscaled transforms.
+			Rigid
+		};
+
+		// Defined below the class as a constant, where Mat4 is complete.
+		static const Mat4<T> Identity;
+
+		// Identity, the same as Mat4::Identity.
+		constexpr Mat4() : m_Numbers{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 }
 		{
 
 		}
 
-		Mat4(const std::initializer_list<T>& initList)
+		constexpr Mat4(const std::initializer_list<T>& initList) : m_Numbers{}
 		{
 			assert(initList.size() == 16 && "Initializer list for Matrix44 must contain exactly 16 elements.");
 			auto begin = initList.begin();
@@ -33,12 +54,12 @@ namespace frostwave
 			}
 		}
 
-		Mat4(const Mat4<T>& other)
+		constexpr Mat4(const Mat4<T>& other) : m_Numbers{}
 		{
 			*this = other;
 		}
 
-		inline Mat4<T>& operator=(const Mat4<T>& other)
+		constexpr Mat4<T>& operator=(const Mat4<T>& other)
 		{
 			for (i32 i = 0; i < 16; i++)
 			{
@@ -47,12 +68,12 @@ namespace frostwave
 			return *this;
 		}
 
-		Mat4(Mat4<T>&& other)
+		constexpr Mat4(Mat4<T>&& other) : m_Numbers{}
 		{
 			*this = other;
 		}
 
-		inline Mat4<T>& operator=(Mat4<T>&& other) noexcept
+		constexpr Mat4<T>& operator=(Mat4<T>&& other) noexcept
 		{
 			for (i32 i = 0; i < 16; i++)
 			{
@@ -61,7 +82,7 @@ namespace frostwave
 			return *this;
 		}
 
-		inline Mat4<T> operator+(const Mat4<T>& other) const
+		constexpr Mat4<T> operator+(const Mat4<T>& other) const
 		{
 			Mat4<T> result;
 			for (size_t i = 0; i < 16; ++i)
@@ -71,7 +92,7 @@ namespace frostwave
 			return result;
 		}
 
-		inline Mat4<T> operator-(const Mat4<T>& other) const
+		constexpr Mat4<T> operator-(const Mat4<T>& other) const
 		{
 			Mat4<T> result;
 			for (size_t i = 0; i < 16; ++i)
@@ -81,9 +102,21 @@ namespace frostwave
 			return result;
 		}
 
-		inline Mat4<T> operator*(const Mat4<T>& other) const
+		constexpr Mat4<T> operator*(const Mat4<T>& other) const
 		{
 			Mat4<T> result;
+			if (std::is_constant_evaluated())
+			{
+				for (size_t i = 0; i < 16; i += 4)
+				{
+					for (size_t j = 0; j < 4; ++j)
+					{
+						result.m_Numbers[i + j] = m_Numbers[i] * other.m_Numbers[j] + m_Numbers[i + 1] * other.m_Numbers[4 + j] +
+							m_Numbers[i + 2] * other.m_Numbers[8 + j] + m_Numbers[i + 3] * other.m_Numbers[12 + j];
+					}
+				}
+				return result;
+			}
 			for (size_t i = 0; i < 4; i++)
 			{
 				__m128 ax = _mm_set1_ps(m_Numbers[i * 4]);
@@ -101,7 +134,7 @@ namespace frostwave
 			return result;
 		}
 
-		inline Mat4<T> operator*(const T& scalar) const
+		constexpr Mat4<T> operator*(const T& scalar) const
 		{
 			Mat4<T> result;
 			for (size_t i = 0; i < 16; ++i)
@@ -111,7 +144,7 @@ namespace frostwave
 			return result;
 		}
 
-		inline bool operator==(const Mat4<T>& other) const
+		constexpr bool operator==(const Mat4<T>& other) const
 		{
 			for (size_t i = 0; i < 16; ++i)
 			{
@@ -121,44 +154,44 @@ namespace frostwave
 			return true;
 		}
 
-		inline void operator+=(const Mat4<T>& other)
+		constexpr void operator+=(const Mat4<T>& other)
 		{
 			*this = *this + other;
 		}
 
-		inline void operator-=(const Mat4<T>& other)
+		constexpr void operator-=(const Mat4<T>& other)
 		{
 			*this = *this - other;
 		}
 
-		inline void operator*=(const Mat4<T>& other)
+		constexpr void operator*=(const Mat4<T>& other)
 		{
 			*this = *this * other;
 		}
 
-		inline void operator*=(const T& scalar)
+		constexpr void operator*=(const T& scalar)
 		{
 			*this = *this * scalar;
 		}
 
-		inline bool operator!=(const Mat4<T>& other) const
+		constexpr bool operator!=(const Mat4<T>& other) const
 		{
 			return !(*this == other);
 		}
 
-		inline T& operator[](const u32& index)
+		constexpr T& operator[](const u32& index)
 		{
 			assert(index < 16 && "Index out of bounds.");
 			return m_Numbers[index];
 		}
 
-		inline const T& operator[](const u32& index) const
+		constexpr const T& operator[](const u32& index) const
 		{
 			assert(index < 16 && "Index out of bounds.");
 			return m_Numbers[index];
 		}
 
-		static Mat4<T> CreateOrthographicProjection(T width, T height, T near, T far)
+		static constexpr Mat4<T> CreateOrthographicProjection(T width, T height, T near, T far)
 		{
 			T B = (T)2.0 / height;
 			T A = (T)2.0 / width;
@@ -172,10 +205,10 @@ namespace frostwave
 			};
 		}
 
-		static Mat4<T> CreatePerspectiveProjection(T fov, T aspect, T near, T far)
+		static constexpr Mat4<T> CreatePerspectiveProjection(T fov, T aspect, T near, T far)
 		{
 			T yFov = fov / aspect;
-			T B = (T)1.0f / (std::tan(yFov * (3.1415f / 180.0f) * (T)0.5f));
+			T B = (T)1.0f / (Tan(yFov * (3.1415f / 180.0f) * (T)0.5f));
 			T A = B / aspect;
 			T C = far / (far - near);
 			T D = (T)1.0f;
@@ -188,10 +221,10 @@ namespace frostwave
 			};
 		}
 
-		inline static Mat4<T> CreateRotationAroundX(T angle)
+		static constexpr Mat4<T> CreateRotationAroundX(T angle)
 		{
-			T c = cos(angle);
-			T s = sin(angle);
+			T c = Cos(angle);
+			T s = Sin(angle);
 			return Mat4<T>({
 				1, 0, 0, 0,
 				0, c, s, 0,
@@ -200,10 +233,10 @@ namespace frostwave
 				});
 		}
 
-		inline static Mat4<T> CreateRotationAroundY(T angle)
+		static constexpr Mat4<T> CreateRotationAroundY(T angle)
 		{
-			T c = cos(angle);
-			T s = sin(angle);
+			T c = Cos(angle);
+			T s = Sin(angle);
 			return Mat4<T>({
 				c, 0, -s, 0,
 				0, 1, 0, 0,
@@ -212,10 +245,10 @@ namespace frostwave
 				});
 		}
 
-		inline static Mat4<T> CreateRotationAroundZ(T angle)
+		static constexpr Mat4<T> CreateRotationAroundZ(T angle)
 		{
-			T c = cos(angle);
-			T s = sin(angle);
+			T c = Cos(angle);
+			T s = Sin(angle);
 			return Mat4<T>({
 				c, s, 0, 0,
 				-s, c, 0, 0,
@@ -224,21 +257,7 @@ namespace frostwave
 				});
 		}
 
-		inline Mat4<T> FastInverse(const Mat4<T>& matrix)
-		{
-			Mat3<T> transposed(matrix);
-			transposed = Mat3<T>::Transpose(transposed);
-			Vec3<T> negated(-matrix.m_Numbers[12], -matrix.m_Numbers[13], -matrix.m_Numbers[14]);
-			negated *= transposed;
-			return Mat4<T>({
-				transposed.m_Numbers[0],	transposed.m_Numbers[1],	transposed.m_Numbers[2],	0,
-				transposed.m_Numbers[3],	transposed.m_Numbers[4],	transposed.m_Numbers[5],	0,
-				transposed.m_Numbers[6],	transposed.m_Numbers[7],	transposed.m_Numbers[8],	0,
-				negated.x,					negated.y,					negated.z,					1
-				});
-		}
-
-		inline static Mat4<T> CreateTransform(const Vec3<T>& position, const Quat<T>& rotation, const Vec3<T>& scale)
+		static constexpr Mat4<T> CreateTransform(const Vec3<T>& position, const Quat<T>& rotation, const Vec3<T>& scale)
 		{
 			Mat4<T> s = {
 				scale.x, 0, 0, 0,
@@ -259,16 +278,16 @@ namespace frostwave
 			return s * r * t;
 		}
 
-		inline static Mat4<T> CreateTranslationMatrix(const T x, const T y, const T z)
+		static constexpr Mat4<T> CreateTranslationMatrix(const T x, const T y, const T z)
 		{
 			Mat4<T> result;
-			result.m_Position.x = x;
-			result.m_Position.y = y;
-			result.m_Position.z = z;
+			result.m_Numbers[12] = x;
+			result.m_Numbers[13] = y;
+			result.m_Numbers[14] = z;
 			return result;
 		}
 
-		inline static Mat4<T> CreateLookAt(const Vec3<T>& lookAt, const Vec3<T>& eye, const Vec3<T>& up)
+		static constexpr Mat4<T> CreateLookAt(const Vec3<T>& lookAt, const Vec3<T>& eye, const Vec3<T>& up)
 		{
 			Vec3<T> zaxis = (lookAt - eye).GetNormalized();
 			Vec3<T> xaxis = (up.Cross(zaxis)).GetNormalized();
@@ -281,8 +300,17 @@ namespace frostwave
 			};
 		}
 
-		inline static Mat4<T> Transpose(const Mat4<T>& matrix)
+		static constexpr Mat4<T> Transpose(const Mat4<T>& matrix)
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					Mat4<T> result;
+					simd::Transpose4x4(matrix.m_Numbers, result.m_Numbers);
+					return result;
+				}
+			}
 			Mat4<T> result(matrix);
 
 			result[1] = matrix[4];
@@ -306,16 +334,73 @@ namespace frostwave
 			return result;
 		}
 
-		inline static T Determinant(const Mat4<T>& matrix)
+		static constexpr T Determinant(const Mat4<T>& matrix)
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return simd::Determinant4x4(matrix.m_Numbers);
+			}
 			return matrix.m_Numbers[0] * ((matrix.m_Numbers[5] * matrix.m_Numbers[10] * matrix.m_Numbers[15] + matrix.m_Numbers[6] * matrix.m_Numbers[11] * matrix.m_Numbers[13] + matrix.m_Numbers[9] * matrix.m_Numbers[14] * matrix.m_Numbers[7]) - (matrix.m_Numbers[7] * matrix.m_Numbers[10] * matrix.m_Numbers[13] + matrix.m_Numbers[11] * matrix.m_Numbers[14] * matrix.m_Numbers[5] + matrix.m_Numbers[6] * matrix.m_Numbers[9] * matrix.m_Numbers[15])) -
 				matrix.m_Numbers[1] * ((matrix.m_Numbers[4] * matrix.m_Numbers[10] * matrix.m_Numbers[15] + matrix.m_Numbers[6] * matrix.m_Numbers[11] * matrix.m_Numbers[12] + matrix.m_Numbers[8] * matrix.m_Numbers[14] * matrix.m_Numbers[7]) - (matrix.m_Numbers[7] * matrix.m_Numbers[10] * matrix.m_Numbers[12] + matrix.m_Numbers[11] * matrix.m_Numbers[14] * matrix.m_Numbers[4] + matrix.m_Numbers[6] * matrix.m_Numbers[8] * matrix.m_Numbers[15])) +
 				matrix.m_Numbers[2] * ((matrix.m_Numbers[4] * matrix.m_Numbers[9] * matrix.m_Numbers[15] + matrix.m_Numbers[5] * matrix.m_Numbers[11] * matrix.m_Numbers[12] + matrix.m_Numbers[8] * matrix.m_Numbers[13] * matrix.m_Numbers[7]) - (matrix.m_Numbers[7] * matrix.m_Numbers[9] * matrix.m_Numbers[12] + matrix.m_Numbers[11] * matrix.m_Numbers[13] * matrix.m_Numbers[4] + matrix.m_Numbers[5] * matrix.m_Numbers[8] * matrix.m_Numbers[15])) -
 				matrix.m_Numbers[3] * ((matrix.m_Numbers[4] * matrix.m_Numbers[9] * matrix.m_Numbers[14] + matrix.m_Numbers[5] * matrix.m_Numbers[10] * matrix.m_Numbers[12] + matrix.m_Numbers[8] * matrix.m_Numbers[13] * matrix.m_Numbers[6]) - (matrix.m_Numbers[6] * matrix.m_Numbers[9] * matrix.m_Numbers[12] + matrix.m_Numbers[10] * matrix.m_Numbers[13] * matrix.m_Numbers[4] + matrix.m_Numbers[5] * matrix.m_Numbers[8] * matrix.m_Numbers[14]));
 		}
 
-		inline static Mat4<T> Inverse(const Mat4<T>& matrix)
+		// Which of the inverses below is the cheapest one that is still correct for matrix. Tolerance is how
+		// far the rows may be from unit length and perpendicular to still count as rigid, it ends up as the
+		// error of the rigid inverse.
+		static constexpr Kind Classify(const Mat4<T>& matrix, T tolerance = (T)1e-5)
+		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					if (!simd::IsAffine(matrix.m_Numbers)) return Kind::General;
+					return simd::IsOrthonormal3x3(matrix.m_Numbers, tolerance) ? Kind::Rigid : Kind::Affine;
+				}
+			}
+			const T* n = matrix.m_Numbers;
+			if (n[3] != 0 || n[7] != 0 || n[11] != 0 || n[15] != 1)
+				return Kind::General;
+
+			auto isClose = [tolerance](T value, T target) { return value - target <= tolerance && target - value <= tolerance; };
+			Vec3<T> x(n[0], n[1], n[2]);
+			Vec3<T> y(n[4], n[5], n[6]);
+			Vec3<T> z(n[8], n[9], n[10]);
+			if (isClose(x.Dot(x), 1) && isClose(y.Dot(y), 1) && isClose(z.Dot(z), 1) &&
+				isClose(x.Dot(y), 0) && isClose(x.Dot(z), 0) && isClose(y.Dot(z), 0))
+				return Kind::Rigid;
+			return Kind::Affine;
+		}
+
+		static constexpr Mat4<T> Inverse(const Mat4<T>& matrix)
+		{
+			return Inverse(matrix, Classify(matrix));
+		}
+
+		// For callers that know what they hold, kind has to be right or the result is wrong.
+		static constexpr Mat4<T> Inverse(const Mat4<T>& matrix, Kind kind)
 		{
+			switch (kind)
+			{
+			case Kind::Rigid: return InverseRigid(matrix);
+			case Kind::Affine: return InverseAffine(matrix);
+			default: return InverseGeneral(matrix);
+			}
+		}
+
+		static constexpr Mat4<T> InverseGeneral(const Mat4<T>& matrix)
+		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					Mat4<T> result;
+					[[maybe_unused]] T det = simd::Inverse4x4(matrix.m_Numbers, result.m_Numbers);
+					assert(det != 0 && "Non-invertible matrix");
+					return result;
+				}
+			}
 			T det = Determinant(matrix);
 			assert(det != 0 && "Non-invertible matrix");
 
@@ -434,7 +519,36 @@ namespace frostwave
 			return result * (1 / det);
 		}
 
-		inline Mat4<T> GetInversed() const
+		static constexpr Mat4<T> InverseAffine(const Mat4<T>& matrix)
+		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					Mat4<T> result;
+					[[maybe_unused]] T det = simd::InverseAffine(matrix.m_Numbers, result.m_Numbers);
+					assert(det != 0 && "Non-invertible matrix");
+					return result;
+				}
+			}
+			return FromInverseRotation(Mat3<T>::Inverse(Mat3<T>(matrix)), matrix);
+		}
+
+		static constexpr Mat4<T> InverseRigid(const Mat4<T>& matrix)
+		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					Mat4<T> result;
+					simd::InverseRigid(matrix.m_Numbers, result.m_Numbers);
+					return result;
+				}
+			}
+			return FromInverseRotation(Mat3<T>::Transpose(Mat3<T>(matrix)), matrix);
+		}
+
+		constexpr Mat4<T> GetInversed() const
 		{
 			return Inverse(*this);
 		}
@@ -448,8 +562,17 @@ namespace frostwave
 			return output;
 		}
 
-		friend inline Vec4<T> operator*(const Vec4<T>& vector, const Mat4<T>& matrix)
+		friend constexpr Vec4<T> operator*(const Vec4<T>& vector, const Mat4<T>& matrix)
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					Vec4<T> result;
+					simd::Transform4(&vector.x, matrix.m_Numbers, &result.x);
+					return result;
+				}
+			}
 			return Vec4<T>(
 				vector.x * matrix.m_Numbers[0] + vector.y * matrix.m_Numbers[4] + vector.z * matrix.m_Numbers[8] + vector.w * matrix.m_Numbers[12],
 				vector.x * matrix.m_Numbers[1] + vector.y * matrix.m_Numbers[5] + vector.z * matrix.m_Numbers[9] + vector.w * matrix.m_Numbers[13],
@@ -457,9 +580,9 @@ namespace frostwave
 				vector.x * matrix.m_Numbers[3] + vector.y * matrix.m_Numbers[7] + vector.z * matrix.m_Numbers[11] + vector.w * matrix.m_Numbers[15]
 				);
 		}
-		friend inline void operator*=(Vec4<T>& vector, const Mat4<T>& matrix) { vector = vector * matrix; };
+		friend constexpr void operator*=(Vec4<T>& vector, const Mat4<T>& matrix) { vector = vector * matrix; };
 
-		friend inline Vec3<T> operator*(const Vec3<T>& vector, const Mat4<T>& matrix)
+		friend constexpr Vec3<T> operator*(const Vec3<T>& vector, const Mat4<T>& matrix)
 		{
 			return Vec3<T>(
 				vector.x * matrix.m_Numbers[0] + vector.y * matrix.m_Numbers[4] + vector.z * matrix.m_Numbers[8] + matrix.m_Numbers[12],
@@ -467,8 +590,22 @@ namespace frostwave
 				vector.x * matrix.m_Numbers[2] + vector.y * matrix.m_Numbers[6] + vector.z * matrix.m_Numbers[10] + matrix.m_Numbers[14]
 				);
 		}
-		friend inline void operator*=(Vec3<T>& vector, const Mat4<T>& matrix) { vector = vector * matrix; };
+		friend constexpr void operator*=(Vec3<T>& vector, const Mat4<T>& matrix) { vector = vector * matrix; };
 
+	private:
+		static constexpr Mat4<T> FromInverseRotation(const Mat3<T>& rotation, const Mat4<T>& matrix)
+		{
+			Vec3<T> negated(-matrix.m_Numbers[12], -matrix.m_Numbers[13], -matrix.m_Numbers[14]);
+			negated *= rotation;
+			return Mat4<T>({
+				rotation.m_Numbers[0],	rotation.m_Numbers[1],	rotation.m_Numbers[2],	0,
+				rotation.m_Numbers[3],	rotation.m_Numbers[4],	rotation.m_Numbers[5],	0,
+				rotation.m_Numbers[6],	rotation.m_Numbers[7],	rotation.m_Numbers[8],	0,
+				negated.x,				negated.y,				negated.z,				1
+				});
+		}
+
+	public:
 		union
 		{
 			struct
@@ -490,5 +627,15 @@ namespace frostwave
 		};
 	};
 
+	template<typename T>
+	constexpr Mat4<T> Mat4<T>::Identity = Mat4<T>();
+
 	using Mat4f = Mat4<f32>;
-}
\ No newline at end of file
+
+	// m_Rows is read with aligned SIMD loads, Allocate<T> and the pools/arenas honour alignof so this is all it takes.
+	static_assert(alignof(Mat4f) == alignof(__m128), "Mat4 has to stay 16 byte aligned for aligned SIMD access!");
+}
+#pragma warning(pop)
+
+// The scalar inverses are written on Mat3, which includes this header so it has to come after Mat4.
+#include <Engine/Core/Math/Mat3.h>
\ No newline at end of file
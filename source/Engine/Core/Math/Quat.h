@@ -15,30 +15,33 @@ namespace frostwave
 
 #include <Engine/Core/Common.h>
 #include <Engine/Core/Math/Mat4.h>
+#include <Engine/Core/Math/Simd.h>
+#include <type_traits>
+// Same as Vec4, the scalar fallbacks are unreachable at runtime and MSVC warns about it.
+#pragma warning(push)
+#pragma warning(disable: 4702)
 
 namespace frostwave
 {
+	// Aligned for SSE loads, the f32 operations below go through Simd.h outside of constant expressions.
 	template <class T>
-	class Quat
+	class alignas(16) Quat
 	{
 	public:
+		static constexpr bool UseSimd = std::is_same_v<T, f32>;
 
-		Quat<T>()
+		constexpr Quat<T>() : w(static_cast<T>(1)), x(static_cast<T>(0)), y(static_cast<T>(0)), z(static_cast<T>(0))
 		{
-			w = static_cast<T>(1);
-			x = static_cast<T>(0);
-			y = static_cast<T>(0);
-			z = static_cast<T>(0);
 		}
-		Quat<T>(const T& w, const T& x, const T& y, const T& z) : w(w), x(x), y(y), z(z) { }
-		Quat<T>(const T& yaw, const T& pitch, const T& roll)
+		constexpr Quat<T>(const T& w, const T& x, const T& y, const T& z) : w(w), x(x), y(y), z(z) { }
+		constexpr Quat<T>(const T& yaw, const T& pitch, const T& roll) : w(0), x(0), y(0), z(0)
 		{
-			T cy = cos(yaw * T(0.5));
-			T sy = sin(yaw * T(0.5));
-			T cr = cos(roll * T(0.5));
-			T sr = sin(roll * T(0.5));
-			T cp = cos(pitch * T(0.5));
-			T sp = sin(pitch * T(0.5));
+			T cy = Cos(yaw * T(0.5));
+			T sy = Sin(yaw * T(0.5));
+			T cr = Cos(roll * T(0.5));
+			T sr = Sin(roll * T(0.5));
+			T cp = Cos(pitch * T(0.5));
+			T sp = Sin(pitch * T(0.5));
 
 			w = cy * cr * cp + sy * sr * sp;
 			x = cy * sr * cp - sy * cr * sp;
@@ -46,25 +49,25 @@ namespace frostwave
 			z = sy * cr * cp - cy * sr * sp;
 		}
 
-		explicit Quat<T>(const Vec3<T>& yawPitchRoll)
+		constexpr explicit Quat<T>(const Vec3<T>& yawPitchRoll) : w(0), x(0), y(0), z(0)
 		{
-			T cx = cos(yawPitchRoll.x * T(0.5));
-			T cy = cos(yawPitchRoll.y * T(0.5));
-			T cz = cos(yawPitchRoll.z * T(0.5));
-			T sx = sin(yawPitchRoll.x * T(0.5));
-			T sy = sin(yawPitchRoll.y * T(0.5));
-			T sz = sin(yawPitchRoll.z * T(0.5));
+			T cx = Cos(yawPitchRoll.x * T(0.5));
+			T cy = Cos(yawPitchRoll.y * T(0.5));
+			T cz = Cos(yawPitchRoll.z * T(0.5));
+			T sx = Sin(yawPitchRoll.x * T(0.5));
+			T sy = Sin(yawPitchRoll.y * T(0.5));
+			T sz = Sin(yawPitchRoll.z * T(0.5));
 
 			w = cx * cy * cz + sx * sy * sz;
 			x = sx * cy * cz - cx * sy * sz;
 			y = cx * sy * cz + sx * cy * sz;
 			z = cx * cy * sz - sx * sy * cz;
 		}
-		Quat<T>(const Vec3<T>& vector, const T angle)
+		constexpr Quat<T>(const Vec3<T>& vector, const T angle) : w(0), x(0), y(0), z(0)
 		{
 			T halfAngle = angle / T(2);
-			w = cos(halfAngle);
-			T halfAngleSin = sin(halfAngle);
+			w = Cos(halfAngle);
+			T halfAngleSin = Sin(halfAngle);
 			x = vector.x * halfAngleSin;
 			y = vector.y * halfAngleSin;
 			z = vector.z * halfAngleSin;
@@ -83,39 +86,31 @@ namespace frostwave
 		}
 
 		template<typename U>
-		Quat<T>(const Quat<U>& other)
+		constexpr Quat<T>(const Quat<U>& other) : w((T)other.w), x((T)other.x), y((T)other.y), z((T)other.z)
 		{
-			x = (T)other.x;
-			y = (T)other.y;
-			z = (T)other.z;
-			w = (T)other.w;
 		}
 
-		inline void Normalize()
+		constexpr void Normalize()
 		{
-			T length = T(1) / Length();
-			w *= length;
-			x *= length;
-			y *= length;
-			z *= length;
+			*this = GetNormalized();
 		}
-		inline Quat<T> GetNormalized() const
+		constexpr Quat<T> GetNormalized() const
 		{
 			T length = T(1) / Length();
-			return Quat<T>(w * length, x * length, y * length, z * length);
+			return *this * length;
 		}
-		inline Quat<T> GetConjugate() const
+		constexpr Quat<T> GetConjugate() const
 		{
 			return Quat<T>(w, -x, -y, -z);
 		}
 
-		T Length() const
+		constexpr T Length() const
 		{
-			return sqrt(Length2());
+			return Sqrt(Length2());
 		}
-		T Length2() const
+		constexpr T Length2() const
 		{
-			return (x * x) + (y * y) + (z * z) + (w * w);
+			return Dot(*this);
 		}
 		inline Vec3<T> GetEulerAngles() const
 		{
@@ -144,7 +139,7 @@ namespace frostwave
 			return Vec3<T>(roll, pitch, yaw);
 		}
 
-		inline Mat3<T> GetRotationMatrix33() const
+		constexpr Mat3<T> GetRotationMatrix33() const
 		{
 			Mat3<T> result;
 			T qxx(x * x);
@@ -171,7 +166,7 @@ namespace frostwave
 			return result;
 		}
 
-		inline Mat4<T> GetRotationMatrix44() const
+		constexpr Mat4<T> GetRotationMatrix44() const
 		{
 			Mat4<T> result;
 			T qxx(x * x);
@@ -201,32 +196,45 @@ namespace frostwave
 			return Mat4<T>::Transpose(result);
 		}
 
-		inline T Dot(const Quat<T>& quat) const
+		constexpr T Dot(const Quat<T>& quat) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return simd::Dot4(values, quat.values);
+			}
 			return x * quat.x + y * quat.y + z * quat.z + w * quat.w;
 		}
 
-		inline Vec3<T> GetForwardVector() const
+		constexpr Vec3<T> GetForwardVector() const
 		{
 			return Vec3<T>(2 * (x * z + w * y),
 				2 * (y * z - w * x),
 				1 - 2 * (x * x + y * y)).GetNormalized();
 		}
 
-		inline Vec3<T> GetUpVector() const
+		constexpr Vec3<T> GetUpVector() const
 		{
 			return Vec3<T>(2 * (x * y - w * z),
 				1 - 2 * (x * x + z * z),
 				2 * (y * z + w * x)).GetNormalized();
 		}
 
-		inline Vec3<T> GetRightVector() const
+		constexpr Vec3<T> GetRightVector() const
 		{
 			return Vec3<T>(1 - 2 * (y * y + z * z),
 				2 * (x * y + w * z),
 				2 * (x * z - w * y)).GetNormalized();
 		}
 
+		// Linear interpolation along the shorter arc, normalized. Cheaper than Slerp and close to it for
+		// rotations a small angle apart, the speed along the arc is not constant.
+		static constexpr Quat<T> Nlerp(const Quat<T>& a, const Quat<T>& b, const T& delta)
+		{
+			T to = a.Dot(b) < T(0) ? -delta : delta;
+			T from = T(1) - delta;
+			return Quat<T>(from * a.w + to * b.w, from * a.x + to * b.x, from * a.y + to * b.y, from * a.z + to * b.z).GetNormalized();
+		}
+
 		inline static Quat<T> Slerp(const Quat<T>& a, const Quat<T>& b, const T& delta)
 		{
 			Quat<T> qz = b;
@@ -237,34 +245,50 @@ namespace frostwave
 			// To fix this, one quat must be negated.
 			if (cosTheta < T(0))
 			{
-				qz = -qz;
+				qz = Quat<T>(-b.w, -b.x, -b.y, -b.z);
 				cosTheta = -cosTheta;
 			}
 
 			const T dotThreshold = static_cast<T>(0.9995);
 			// Perform a linear interpolation when cosTheta is close to 1 to avoid side effect of sin(angle) becoming a zero denominator
-			if (cosTheta > T(1) - dotThreshold)
+			if (cosTheta > dotThreshold)
 			{
 				// Linear interpolation
-				return Lerp(a, qz, delta);
+				T from = T(1) - delta;
+				return Quat<T>(from * a.w + delta * qz.w, from * a.x + delta * qz.x, from * a.y + delta * qz.y, from * a.z + delta * qz.z).GetNormalized();
 			}
 			else
 			{
 				// Essential Mathematifw, page 467
 				T angle = acos(cosTheta);
-				return (sin((T(1) - delta) * angle) * a + sin(delta * angle) * qz) / sin(angle);
+				T inverseSin = T(1) / sin(angle);
+				T from = sin((T(1) - delta) * angle) * inverseSin;
+				T to = sin(delta * angle) * inverseSin;
+				return Quat<T>(from * a.w + to * qz.w, from * a.x + to * qz.x, from * a.y + to * qz.y, from * a.z + to * qz.z);
 			}
 		}
 
-		template <class T>
-		Quat<T> operator*(const T& scalar)
+		constexpr Quat<T> operator*(const T& scalar) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					Quat<T> result;
+					simd::Scale4(values, scalar, result.values);
+					return result;
+				}
+			}
 			return Quat<T>(w * scalar, x * scalar, y * scalar, z * scalar);
 		}
 
-		template <class T> 
-		Quat<T> operator*(const Quat<T>& other)
+		// other applied after this.
+		constexpr Quat<T> operator*(const Quat<T>& other) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return Apply(simd::QuatMultiply, other);
+			}
 			return Quat<T>(
 				(other.w * w) - (other.x * x) - (other.y * y) - (other.z * z),
 				(other.w * x) + (other.x * w) + (other.y * z) - (other.z * y),
@@ -273,63 +297,64 @@ namespace frostwave
 				);
 		}
 
-		template <class T> 
-		void operator*=(const T& scalar)
+		constexpr void operator*=(const T& scalar)
 		{
-			w *= scalar;
-			x *= scalar;
-			y *= scalar;
-			z *= scalar;
+			*this = *this * scalar;
 		}
 
-		template <class T> 
-		void operator*=(const Quat<T>& quat1)
+		constexpr void operator*=(const Quat<T>& other)
 		{
-			T w = (quat1.w * w) - (quat1.x * x) - (quat1.y * y) - (quat1.z * z);
-			T x = (quat1.w * x) + (quat1.x * w) + (quat1.y * z) - (quat1.z * y);
-			T y = (quat1.w * y) + (quat1.y * w) + (quat1.z * x) - (quat1.x * z);
-			T z = (quat1.w * z) + (quat1.z * w) + (quat1.x * y) - (quat1.y * x);
+			*this = *this * other;
 		}
 
-		template <class T> 
-		Quat<T> operator/(const T& scalar)
+		constexpr Quat<T> operator/(const T& scalar) const
 		{
 			return Quat<T>(w / scalar, x / scalar, y / scalar, z / scalar);
 		}
 
-		template <class T> 
-		Quat<T> operator-(const Quat<T>& b)
+		constexpr Quat<T> operator-(const Quat<T>& b) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return Apply(simd::Sub4, b);
+			}
 			return Quat<T>(w - b.w, x - b.x, y - b.y, z - b.z);
 		}
 
-		template <class T> 
-		Quat<T> operator+(const Quat<T>& b)
+		constexpr Quat<T> operator+(const Quat<T>& b) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return Apply(simd::Add4, b);
+			}
 			return Quat<T>(w + b.w, x + b.x, y + b.y, z + b.z);
 		}
 
-		template <class T>
-		void operator+=(const Quat<T>& b)
+		constexpr void operator+=(const Quat<T>& b)
 		{
-			w += b.w;
-			x += b.x;
-			y += b.y;
-			z += b.z;
+			*this = *this + b;
 		}
 
-		template <class T> 
-		bool operator==(const Quat<T>& b)
+		constexpr bool operator==(const Quat<T>& b) const
 		{
 			return x == b.x && y == b.y && z == b.z && w == b.w;
 		}
 
-		template <class T> 
-		bool operator!=(const Quat<T>& b)
+		constexpr bool operator!=(const Quat<T>& b) const
 		{
 			return !(*this == b);
 		}
 
+	private:
+		template <typename Operation>
+		inline Quat<T> Apply(Operation operation, const Quat<T>& other) const
+		{
+			Quat<T> result;
+			operation(values, other.values, result.values);
+			return result;
+		}
+
+	public:
 		union
 		{
 			T values[4];
@@ -339,4 +364,5 @@ namespace frostwave
 
 	typedef Quat<f32> Quatf;
 }
+#pragma warning(pop)
 namespace fw = frostwave;
\ No newline at end of file
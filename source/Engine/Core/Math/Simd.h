@@ -0,0 +1,490 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <cmath>
+
+// SSE is part of every x64 target, FW_SIMD can be set to 0 to build the math types on the scalar path instead.
+#ifndef FW_SIMD
+	#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define FW_SIMD 1
+	#else
+		#define FW_SIMD 0
+	#endif
+#endif
+
+// Fused multiply add comes with AVX2 (/arch:AVX2 on MSVC).
+#if FW_SIMD && (defined(__AVX2__) || defined(__FMA__))
+	#define FW_SIMD_FMA 1
+#else
+	#define FW_SIMD_FMA 0
+#endif
+
+#if FW_SIMD
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#if FW_SIMD_FMA
+#include <immintrin.h>
+#endif
+#endif
+
+namespace frostwave::simd
+{
+	// Every pointer below is four floats aligned to 16 bytes, which is what Vec4f, Vec3fA and Quatf hold.
+	// Quaternions are in Quat's order, w x y z.
+
+	// The plain float code the math types used before, kept for platforms without SSE and as the reference
+	// the SIMD path is checked against.
+	namespace scalar
+	{
+		inline void Add4(const f32* a, const f32* b, f32* out) { for (u32 i = 0; i < 4; ++i) out[i] = a[i] + b[i]; }
+		inline void Sub4(const f32* a, const f32* b, f32* out) { for (u32 i = 0; i < 4; ++i) out[i] = a[i] - b[i]; }
+		inline void Mul4(const f32* a, const f32* b, f32* out) { for (u32 i = 0; i < 4; ++i) out[i] = a[i] * b[i]; }
+		inline void Div4(const f32* a, const f32* b, f32* out) { for (u32 i = 0; i < 4; ++i) out[i] = a[i] / b[i]; }
+		inline void Scale4(const f32* a, f32 scalar, f32* out) { for (u32 i = 0; i < 4; ++i) out[i] = a[i] * scalar; }
+
+		inline f32 Dot4(const f32* a, const f32* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]; }
+		inline f32 Dot3(const f32* a, const f32* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+		inline void Cross3(const f32* a, const f32* b, f32* out)
+		{
+			f32 x = a[1] * b[2] - a[2] * b[1];
+			f32 y = a[2] * b[0] - a[0] * b[2];
+			f32 z = a[0] * b[1] - a[1] * b[0];
+			out[0] = x;
+			out[1] = y;
+			out[2] = z;
+			out[3] = 0.0f;
+		}
+
+		// Zero stays zero.
+		inline void Normalize4(const f32* a, f32* out)
+		{
+			f32 length = std::sqrt(Dot4(a, a));
+			Scale4(a, length != 0.0f ? 1.0f / length : 0.0f, out);
+		}
+
+		inline void Normalize3(const f32* a, f32* out)
+		{
+			f32 length = std::sqrt(Dot3(a, a));
+			Scale4(a, length != 0.0f ? 1.0f / length : 0.0f, out);
+			out[3] = 0.0f;
+		}
+
+		// Row vector times a row major matrix.
+		inline void Transform4(const f32* v, const f32* matrix, f32* out)
+		{
+			f32 x = v[0] * matrix[0] + v[1] * matrix[4] + v[2] * matrix[8] + v[3] * matrix[12];
+			f32 y = v[0] * matrix[1] + v[1] * matrix[5] + v[2] * matrix[9] + v[3] * matrix[13];
+			f32 z = v[0] * matrix[2] + v[1] * matrix[6] + v[2] * matrix[10] + v[3] * matrix[14];
+			f32 w = v[0] * matrix[3] + v[1] * matrix[7] + v[2] * matrix[11] + v[3] * matrix[15];
+			out[0] = x;
+			out[1] = y;
+			out[2] = z;
+			out[3] = w;
+		}
+
+		// b applied after a, the same product Quat::operator* has always computed.
+		inline void QuatMultiply(const f32* a, const f32* b, f32* out)
+		{
+			f32 w = (b[0] * a[0]) - (b[1] * a[1]) - (b[2] * a[2]) - (b[3] * a[3]);
+			f32 x = (b[0] * a[1]) + (b[1] * a[0]) + (b[2] * a[3]) - (b[3] * a[2]);
+			f32 y = (b[0] * a[2]) + (b[2] * a[0]) + (b[3] * a[1]) - (b[1] * a[3]);
+			f32 z = (b[0] * a[3]) + (b[3] * a[0]) + (b[1] * a[2]) - (b[2] * a[1]);
+			out[0] = w;
+			out[1] = x;
+			out[2] = y;
+			out[3] = z;
+		}
+
+		// Matrices are sixteen floats, row major like Mat4, aligned to 16 bytes.
+		inline void Transpose4x4(const f32* m, f32* out)
+		{
+			f32 result[16];
+			for (u32 row = 0; row < 4; ++row)
+			{
+				for (u32 column = 0; column < 4; ++column)
+					result[column * 4 + row] = m[row * 4 + column];
+			}
+			for (u32 i = 0; i < 16; ++i)
+				out[i] = result[i];
+		}
+
+		// The 2x2 determinants of the top two rows (s) and the bottom two (c) every cofactor is built from.
+		inline void Subfactors4x4(const f32* m, f32* s, f32* c)
+		{
+			s[0] = m[0] * m[5] - m[4] * m[1];
+			s[1] = m[0] * m[6] - m[4] * m[2];
+			s[2] = m[0] * m[7] - m[4] * m[3];
+			s[3] = m[1] * m[6] - m[5] * m[2];
+			s[4] = m[1] * m[7] - m[5] * m[3];
+			s[5] = m[2] * m[7] - m[6] * m[3];
+
+			c[0] = m[8] * m[13] - m[12] * m[9];
+			c[1] = m[8] * m[14] - m[12] * m[10];
+			c[2] = m[8] * m[15] - m[12] * m[11];
+			c[3] = m[9] * m[14] - m[13] * m[10];
+			c[4] = m[9] * m[15] - m[13] * m[11];
+			c[5] = m[10] * m[15] - m[14] * m[11];
+		}
+
+		inline f32 Determinant4x4(const f32* m)
+		{
+			f32 s[6], c[6];
+			Subfactors4x4(m, s, c);
+			return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+		}
+
+		// Returns the determinant, out is garbage when that is zero.
+		inline f32 Inverse4x4(const f32* m, f32* out)
+		{
+			f32 s[6], c[6];
+			Subfactors4x4(m, s, c);
+			f32 determinant = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+			f32 inverse = 1.0f / determinant;
+
+			f32 result[16] = {
+				m[5] * c[5] - m[6] * c[4] + m[7] * c[3],
+				-m[1] * c[5] + m[2] * c[4] - m[3] * c[3],
+				m[13] * s[5] - m[14] * s[4] + m[15] * s[3],
+				-m[9] * s[5] + m[10] * s[4] - m[11] * s[3],
+
+				-m[4] * c[5] + m[6] * c[2] - m[7] * c[1],
+				m[0] * c[5] - m[2] * c[2] + m[3] * c[1],
+				-m[12] * s[5] + m[14] * s[2] - m[15] * s[1],
+				m[8] * s[5] - m[10] * s[2] + m[11] * s[1],
+
+				m[4] * c[4] - m[5] * c[2] + m[7] * c[0],
+				-m[0] * c[4] + m[1] * c[2] - m[3] * c[0],
+				m[12] * s[4] - m[13] * s[2] + m[15] * s[0],
+				-m[8] * s[4] + m[9] * s[2] - m[11] * s[0],
+
+				-m[4] * c[3] + m[5] * c[1] - m[6] * c[0],
+				m[0] * c[3] - m[1] * c[1] + m[2] * c[0],
+				-m[12] * s[3] + m[13] * s[1] - m[14] * s[0],
+				m[8] * s[3] - m[9] * s[1] + m[10] * s[0],
+			};
+			for (u32 i = 0; i < 16; ++i)
+				out[i] = result[i] * inverse;
+			return determinant;
+		}
+
+		// Last column is exactly 0 0 0 1.
+		inline bool IsAffine(const f32* m)
+		{
+			return m[3] == 0.0f && m[7] == 0.0f && m[11] == 0.0f && m[15] == 1.0f;
+		}
+
+		// The first three rows, as three vectors, are within tolerance of unit length and perpendicular.
+		inline bool IsOrthonormal3x3(const f32* m, f32 tolerance)
+		{
+			for (u32 i = 0; i < 3; ++i)
+			{
+				for (u32 j = i; j < 3; ++j)
+				{
+					if (std::abs(Dot3(m + i * 4, m + j * 4) - (i == j ? 1.0f : 0.0f)) > tolerance)
+						return false;
+				}
+			}
+			return true;
+		}
+
+		// The last column has to be 0 0 0 1, returns the determinant of the 3x3 part.
+		inline f32 InverseAffine(const f32* m, f32* out)
+		{
+			// Columns of the inverse are the cross products of the rows, over the determinant.
+			f32 columns[3][4];
+			Cross3(m + 4, m + 8, columns[0]);
+			Cross3(m + 8, m, columns[1]);
+			Cross3(m, m + 4, columns[2]);
+			f32 determinant = Dot3(m, columns[0]);
+			f32 inverse = 1.0f / determinant;
+
+			f32 result[16];
+			for (u32 row = 0; row < 3; ++row)
+			{
+				for (u32 column = 0; column < 3; ++column)
+					result[row * 4 + column] = columns[column][row] * inverse;
+				result[row * 4 + 3] = 0.0f;
+			}
+			for (u32 column = 0; column < 3; ++column)
+				result[12 + column] = -(m[12] * result[column] + m[13] * result[4 + column] + m[14] * result[8 + column]);
+			result[15] = 1.0f;
+
+			for (u32 i = 0; i < 16; ++i)
+				out[i] = result[i];
+			return determinant;
+		}
+
+		// Rotation and translation only, the 3x3 part is transposed and the translation rotated back.
+		inline void InverseRigid(const f32* m, f32* out)
+		{
+			f32 result[16];
+			for (u32 row = 0; row < 3; ++row)
+			{
+				for (u32 column = 0; column < 3; ++column)
+					result[row * 4 + column] = m[column * 4 + row];
+				result[row * 4 + 3] = 0.0f;
+			}
+			for (u32 column = 0; column < 3; ++column)
+				result[12 + column] = -Dot3(m + 12, m + column * 4);
+			result[15] = 1.0f;
+
+			for (u32 i = 0; i < 16; ++i)
+				out[i] = result[i];
+		}
+	}
+
+#if FW_SIMD
+	// Lanes of v picked in reading order, FW_SHUFFLE(v, 1, 2, 0, 3) is v.yzxw.
+	#define FW_SHUFFLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), _MM_SHUFFLE(w, z, y, x))
+	// Lanes x and y of a followed by lanes z and w of b.
+	#define FW_SHUFFLE2(a, b, x, y, z, w) _mm_shuffle_ps((a), (b), _MM_SHUFFLE(w, z, y, x))
+
+	// Dot product of all four lanes in every lane.
+	inline __m128 DotSplat4(__m128 a, __m128 b)
+	{
+		__m128 m = _mm_mul_ps(a, b);
+		m = _mm_add_ps(m, FW_SHUFFLE(m, 1, 0, 3, 2));
+		return _mm_add_ps(m, FW_SHUFFLE(m, 2, 3, 0, 1));
+	}
+
+	inline __m128 DotSplat3(__m128 a, __m128 b)
+	{
+		const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		return DotSplat4(_mm_and_ps(a, mask), b);
+	}
+
+	inline __m128 MulAdd(__m128 a, __m128 b, __m128 c)
+	{
+	#if FW_SIMD_FMA
+		return _mm_fmadd_ps(a, b, c);
+	#else
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+	#endif
+	}
+
+	// Lane w is zero for finite input.
+	inline __m128 Cross(__m128 a, __m128 b)
+	{
+		return _mm_sub_ps(
+			_mm_mul_ps(FW_SHUFFLE(a, 1, 2, 0, 3), FW_SHUFFLE(b, 2, 0, 1, 3)),
+			_mm_mul_ps(FW_SHUFFLE(a, 2, 0, 1, 3), FW_SHUFFLE(b, 1, 2, 0, 3)));
+	}
+
+	// Scales by one over the length, zero where the length is zero.
+	inline __m128 NormalizeBy(__m128 v, __m128 lengthSqr)
+	{
+		__m128 length = _mm_sqrt_ps(lengthSqr);
+		__m128 inverse = _mm_div_ps(_mm_set1_ps(1.0f), length);
+		inverse = _mm_and_ps(inverse, _mm_cmpneq_ps(length, _mm_setzero_ps()));
+		return _mm_mul_ps(v, inverse);
+	}
+
+	inline void Add4(const f32* a, const f32* b, f32* out) { _mm_store_ps(out, _mm_add_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+	inline void Sub4(const f32* a, const f32* b, f32* out) { _mm_store_ps(out, _mm_sub_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+	inline void Mul4(const f32* a, const f32* b, f32* out) { _mm_store_ps(out, _mm_mul_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+	inline void Div4(const f32* a, const f32* b, f32* out) { _mm_store_ps(out, _mm_div_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+	inline void Scale4(const f32* a, f32 scalar, f32* out) { _mm_store_ps(out, _mm_mul_ps(_mm_load_ps(a), _mm_set1_ps(scalar))); }
+
+	inline f32 Dot4(const f32* a, const f32* b) { return _mm_cvtss_f32(DotSplat4(_mm_load_ps(a), _mm_load_ps(b))); }
+	inline f32 Dot3(const f32* a, const f32* b) { return _mm_cvtss_f32(DotSplat3(_mm_load_ps(a), _mm_load_ps(b))); }
+
+	inline void Cross3(const f32* a, const f32* b, f32* out)
+	{
+		const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		_mm_store_ps(out, _mm_and_ps(Cross(_mm_load_ps(a), _mm_load_ps(b)), mask));
+	}
+
+	inline void Normalize4(const f32* a, f32* out)
+	{
+		__m128 v = _mm_load_ps(a);
+		_mm_store_ps(out, NormalizeBy(v, DotSplat4(v, v)));
+	}
+
+	inline void Normalize3(const f32* a, f32* out)
+	{
+		const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		__m128 v = _mm_and_ps(_mm_load_ps(a), mask);
+		_mm_store_ps(out, NormalizeBy(v, DotSplat4(v, v)));
+	}
+
+	inline void Transform4(const f32* v, const f32* matrix, f32* out)
+	{
+		__m128 vector = _mm_load_ps(v);
+		__m128 result = _mm_mul_ps(FW_SHUFFLE(vector, 0, 0, 0, 0), _mm_load_ps(matrix));
+		result = MulAdd(FW_SHUFFLE(vector, 1, 1, 1, 1), _mm_load_ps(matrix + 4), result);
+		result = MulAdd(FW_SHUFFLE(vector, 2, 2, 2, 2), _mm_load_ps(matrix + 8), result);
+		result = MulAdd(FW_SHUFFLE(vector, 3, 3, 3, 3), _mm_load_ps(matrix + 12), result);
+		_mm_store_ps(out, result);
+	}
+
+	inline void QuatMultiply(const f32* a, const f32* b, f32* out)
+	{
+		// Each lane of the product is four terms, lined up with shuffles so every term is one multiply
+		// over all lanes. Only the w lane of the middle two is subtracted, hence the sign flip.
+		const __m128 flipW = _mm_set_ps(0.0f, 0.0f, 0.0f, -0.0f);
+		__m128 va = _mm_load_ps(a);
+		__m128 vb = _mm_load_ps(b);
+
+		__m128 result = _mm_mul_ps(FW_SHUFFLE(vb, 0, 0, 0, 0), va);
+		__m128 terms = _mm_mul_ps(FW_SHUFFLE(vb, 1, 1, 2, 3), FW_SHUFFLE(va, 1, 0, 0, 0));
+		terms = MulAdd(FW_SHUFFLE(vb, 2, 2, 3, 1), FW_SHUFFLE(va, 2, 3, 1, 2), terms);
+		result = _mm_add_ps(result, _mm_xor_ps(terms, flipW));
+		result = _mm_sub_ps(result, _mm_mul_ps(FW_SHUFFLE(vb, 3, 3, 1, 2), FW_SHUFFLE(va, 3, 2, 3, 1)));
+		_mm_store_ps(out, result);
+	}
+
+	// The general inverse and determinant split the matrix into four 2x2 blocks, one register each in
+	// row major order:
+	//   | A B |
+	//   | C D |
+	// and work on those with the blockwise inversion formula, # below is the adjugate.
+	inline __m128 Mat2Mul(__m128 a, __m128 b)
+	{
+		return _mm_add_ps(_mm_mul_ps(a, FW_SHUFFLE(b, 0, 3, 0, 3)), _mm_mul_ps(FW_SHUFFLE(a, 1, 0, 3, 2), FW_SHUFFLE(b, 2, 1, 2, 1)));
+	}
+
+	// a# * b
+	inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(FW_SHUFFLE(a, 3, 3, 0, 0), b), _mm_mul_ps(FW_SHUFFLE(a, 1, 1, 2, 2), FW_SHUFFLE(b, 2, 3, 0, 1)));
+	}
+
+	// a * b#
+	inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(a, FW_SHUFFLE(b, 3, 0, 3, 0)), _mm_mul_ps(FW_SHUFFLE(a, 1, 0, 3, 2), FW_SHUFFLE(b, 2, 1, 2, 1)));
+	}
+
+	struct Blocks
+	{
+		Blocks(const f32* m)
+		{
+			__m128 r0 = _mm_load_ps(m), r1 = _mm_load_ps(m + 4), r2 = _mm_load_ps(m + 8), r3 = _mm_load_ps(m + 12);
+			a = _mm_movelh_ps(r0, r1);
+			b = _mm_movehl_ps(r1, r0);
+			c = _mm_movelh_ps(r2, r3);
+			d = _mm_movehl_ps(r3, r2);
+
+			// |A| |B| |C| |D|
+			__m128 determinants = _mm_sub_ps(
+				_mm_mul_ps(FW_SHUFFLE2(r0, r2, 0, 2, 0, 2), FW_SHUFFLE2(r1, r3, 1, 3, 1, 3)),
+				_mm_mul_ps(FW_SHUFFLE2(r0, r2, 1, 3, 1, 3), FW_SHUFFLE2(r1, r3, 0, 2, 0, 2)));
+			detA = FW_SHUFFLE(determinants, 0, 0, 0, 0);
+			detB = FW_SHUFFLE(determinants, 1, 1, 1, 1);
+			detC = FW_SHUFFLE(determinants, 2, 2, 2, 2);
+			detD = FW_SHUFFLE(determinants, 3, 3, 3, 3);
+
+			adjAB = Mat2AdjMul(a, b);
+			adjDC = Mat2AdjMul(d, c);
+
+			// |M| = |A||D| + |B||C| - tr(A#B D#C)
+			__m128 trace = DotSplat4(adjAB, FW_SHUFFLE(adjDC, 0, 2, 1, 3));
+			determinant = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+		}
+
+		__m128 a, b, c, d;
+		__m128 detA, detB, detC, detD;
+		__m128 adjAB, adjDC;
+		__m128 determinant;
+	};
+
+	inline void Transpose4x4(const f32* m, f32* out)
+	{
+		__m128 r0 = _mm_load_ps(m), r1 = _mm_load_ps(m + 4), r2 = _mm_load_ps(m + 8), r3 = _mm_load_ps(m + 12);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		_mm_store_ps(out, r0);
+		_mm_store_ps(out + 4, r1);
+		_mm_store_ps(out + 8, r2);
+		_mm_store_ps(out + 12, r3);
+	}
+
+	inline f32 Determinant4x4(const f32* m)
+	{
+		return _mm_cvtss_f32(Blocks(m).determinant);
+	}
+
+	inline f32 Inverse4x4(const f32* m, f32* out)
+	{
+		Blocks blocks(m);
+
+		// Adjugates of the blocks of the inverse, scaled by |M| which the signs and the division take out.
+		__m128 x = _mm_sub_ps(_mm_mul_ps(blocks.detD, blocks.a), Mat2Mul(blocks.b, blocks.adjDC));
+		__m128 w = _mm_sub_ps(_mm_mul_ps(blocks.detA, blocks.d), Mat2Mul(blocks.c, blocks.adjAB));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(blocks.detB, blocks.c), Mat2MulAdj(blocks.d, blocks.adjAB));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(blocks.detC, blocks.b), Mat2MulAdj(blocks.a, blocks.adjDC));
+
+		__m128 inverse = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), blocks.determinant);
+		x = _mm_mul_ps(x, inverse);
+		y = _mm_mul_ps(y, inverse);
+		z = _mm_mul_ps(z, inverse);
+		w = _mm_mul_ps(w, inverse);
+
+		// Taking the adjugate back and storing by rows is one shuffle per row.
+		_mm_store_ps(out, FW_SHUFFLE2(x, y, 3, 1, 3, 1));
+		_mm_store_ps(out + 4, FW_SHUFFLE2(x, y, 2, 0, 2, 0));
+		_mm_store_ps(out + 8, FW_SHUFFLE2(z, w, 3, 1, 3, 1));
+		_mm_store_ps(out + 12, FW_SHUFFLE2(z, w, 2, 0, 2, 0));
+		return _mm_cvtss_f32(blocks.determinant);
+	}
+
+	inline bool IsAffine(const f32* m)
+	{
+		// w of every row gathered into one register.
+		__m128 z0w0z1w1 = _mm_unpackhi_ps(_mm_load_ps(m), _mm_load_ps(m + 4));
+		__m128 z2w2z3w3 = _mm_unpackhi_ps(_mm_load_ps(m + 8), _mm_load_ps(m + 12));
+		__m128 column = _mm_movehl_ps(z2w2z3w3, z0w0z1w1);
+		return _mm_movemask_ps(_mm_cmpeq_ps(column, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f))) == 0xf;
+	}
+
+	inline bool IsOrthonormal3x3(const f32* m, f32 tolerance)
+	{
+		// Transposed the three dot products of each row with itself and with the next row are one multiply
+		// add per column.
+		__m128 c0 = _mm_load_ps(m), c1 = _mm_load_ps(m + 4), c2 = _mm_load_ps(m + 8), c3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+		__m128 lengths = MulAdd(c2, c2, MulAdd(c1, c1, _mm_mul_ps(c0, c0)));
+		__m128 next = MulAdd(c2, FW_SHUFFLE(c2, 1, 2, 0, 3), MulAdd(c1, FW_SHUFFLE(c1, 1, 2, 0, 3), _mm_mul_ps(c0, FW_SHUFFLE(c0, 1, 2, 0, 3))));
+
+		const __m128 absolute = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		__m128 limit = _mm_set1_ps(tolerance);
+		__m128 lengthsClose = _mm_cmple_ps(_mm_and_ps(_mm_sub_ps(lengths, _mm_set1_ps(1.0f)), absolute), limit);
+		__m128 nextClose = _mm_cmple_ps(_mm_and_ps(next, absolute), limit);
+		return (_mm_movemask_ps(_mm_and_ps(lengthsClose, nextClose)) & 0x7) == 0x7;
+	}
+
+	// Rows of the inverted 3x3 part, the translation goes through them and comes out negated.
+	inline void StoreAffine(__m128 r0, __m128 r1, __m128 r2, __m128 translation, f32* out)
+	{
+		__m128 position = _mm_mul_ps(FW_SHUFFLE(translation, 0, 0, 0, 0), r0);
+		position = MulAdd(FW_SHUFFLE(translation, 1, 1, 1, 1), r1, position);
+		position = MulAdd(FW_SHUFFLE(translation, 2, 2, 2, 2), r2, position);
+		_mm_store_ps(out, r0);
+		_mm_store_ps(out + 4, r1);
+		_mm_store_ps(out + 8, r2);
+		_mm_store_ps(out + 12, _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), position));
+	}
+
+	inline f32 InverseAffine(const f32* m, f32* out)
+	{
+		__m128 r0 = _mm_load_ps(m), r1 = _mm_load_ps(m + 4), r2 = _mm_load_ps(m + 8);
+		__m128 c0 = Cross(r1, r2), c1 = Cross(r2, r0), c2 = Cross(r0, r1), c3 = _mm_setzero_ps();
+		__m128 determinant = DotSplat3(r0, c0);
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+		__m128 inverse = _mm_div_ps(_mm_set1_ps(1.0f), determinant);
+		StoreAffine(_mm_mul_ps(c0, inverse), _mm_mul_ps(c1, inverse), _mm_mul_ps(c2, inverse), _mm_load_ps(m + 12), out);
+		return _mm_cvtss_f32(determinant);
+	}
+
+	inline void InverseRigid(const f32* m, f32* out)
+	{
+		__m128 r0 = _mm_load_ps(m), r1 = _mm_load_ps(m + 4), r2 = _mm_load_ps(m + 8), r3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		StoreAffine(r0, r1, r2, _mm_load_ps(m + 12), out);
+	}
+
+#else
+	using namespace scalar;
+#endif
+}
+namespace fw = frostwave;
@@ -1,5 +1,6 @@
 #pragma once
 #include <Engine/Core/Types.h>
+#include <Engine/Core/Common.h>
 #pragma warning(disable: 4201)
 
 namespace frostwave
@@ -8,59 +9,59 @@ namespace frostwave
 	class Vec2
 	{
 	public:
-		Vec2(T val) : x(val), y(val)
+		constexpr Vec2(T val) : x(val), y(val)
 		{
 		}
 
-		Vec2(T _x = 0, T _y = 0) : x(_x), y(_y)
+		constexpr Vec2(T _x = 0, T _y = 0) : x(_x), y(_y)
 		{
 		}
 
-		Vec2(const Vec2& other) : x(other.x), y(other.y)
+		constexpr Vec2(const Vec2& other) : x(other.x), y(other.y)
 		{
 		}
 
-		Vec2(Vec2&& other) : x(other.x), y(other.y)
+		constexpr Vec2(Vec2&& other) : x(other.x), y(other.y)
 		{
 		}
 
-		~Vec2() { }
+		~Vec2() = default;
 
-		inline Vec2& operator=(const Vec2& other)
+		constexpr Vec2& operator=(const Vec2& other)
 		{
 			x = other.x;
 			y = other.y;
 			return *this;
 		}
 
-		inline Vec2& operator=(Vec2&& other)
+		constexpr Vec2& operator=(Vec2&& other)
 		{
 			x = other.x;
 			y = other.y;
 			return *this;
 		}
 
-		inline T Dot(const Vec2& other) const
+		constexpr T Dot(const Vec2& other) const
 		{
 			return { x * other.x + y * other.y };
 		}
 
-		inline Vec2 Normal() const
+		constexpr Vec2 Normal() const
 		{
 			return { -y, x };
 		}
 
-		inline T LengthSqr() const
+		constexpr T LengthSqr() const
 		{
 			return Dot(*this);
 		}
 
-		inline T Length() const
+		constexpr T Length() const
 		{
-			return sqrt(LengthSqr());
+			return Sqrt(LengthSqr());
 		}
 
-		inline Vec2 GetNormalized() const
+		constexpr Vec2 GetNormalized() const
 		{
 			if (T l = Length(); l != 0)
 			{
@@ -70,57 +71,57 @@ namespace frostwave
 			return { 0,0 };
 		}
 
-		inline void Normalize()
+		constexpr void Normalize()
 		{
 			*this = GetNormalized();
 		}
 
-		inline bool operator==(const Vec2& other) const
+		constexpr bool operator==(const Vec2& other) const
 		{
 			return x == other.x && y == other.y;
 		}
 
-		inline bool operator!=(const Vec2& other) const
+		constexpr bool operator!=(const Vec2& other) const
 		{
 			return x != other.x && y != other.y;
 		}
 
-		inline Vec2 operator+(const Vec2& other) const
+		constexpr Vec2 operator+(const Vec2& other) const
 		{
 			return {
 				x + other.x,
 				y + other.y
 			};
 		}
-		inline Vec2 operator-(const Vec2& other) const
+		constexpr Vec2 operator-(const Vec2& other) const
 		{
 			return {
 				x - other.x,
 				y - other.y
 			};
 		}
-		inline Vec2 operator*(const Vec2& other) const
+		constexpr Vec2 operator*(const Vec2& other) const
 		{
 			return {
 				x * other.x,
 				y * other.y
 			};
 		}
-		inline Vec2 operator/(const Vec2& other) const
+		constexpr Vec2 operator/(const Vec2& other) const
 		{
 			return {
 				x / other.x,
 				y / other.y
 			};
 		}
-		inline Vec2 operator*(const T& scalar) const
+		constexpr Vec2 operator*(const T& scalar) const
 		{
 			return {
 				x * scalar,
 				y * scalar
 			};
 		}
-		inline Vec2 operator/(const T& scalar) const
+		constexpr Vec2 operator/(const T& scalar) const
 		{
 			return {
 				x / scalar,
@@ -128,27 +129,27 @@ namespace frostwave
 			};
 		}
 
-		inline void operator+=(const Vec2& other)
+		constexpr void operator+=(const Vec2& other)
 		{
 			*this = *this + other;
 		}
-		inline void operator-=(const Vec2& other)
+		constexpr void operator-=(const Vec2& other)
 		{
 			*this = *this - other;
 		}
-		inline void operator*=(const Vec2& other)
+		constexpr void operator*=(const Vec2& other)
 		{
 			*this = *this * other;
 		}
-		inline void operator/=(const Vec2& other)
+		constexpr void operator/=(const Vec2& other)
 		{
 			*this = *this / other;
 		}
-		inline void operator*=(const T& scalar)
+		constexpr void operator*=(const T& scalar)
 		{
 			*this = *this * scalar;
 		}
-		inline void operator/=(const T& scalar)
+		constexpr void operator/=(const T& scalar)
 		{
 			*this = *this / scalar;
 		}
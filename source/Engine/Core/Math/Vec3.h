@@ -1,5 +1,7 @@
 #pragma once
 #include <Engine/Core/Types.h>
+#include <Engine/Core/Common.h>
+#include <Engine/Core/Math/Simd.h>
 #include <cmath>
 #pragma warning(disable: 4201)
 
@@ -13,29 +15,29 @@ namespace frostwave
 	{
 	public:
 
-		Vec3() : x(0), y(0), z(0)
+		constexpr Vec3() : x(0), y(0), z(0)
 		{
 		}
 
-		Vec3(T val) : x(val), y(val), z(val)
+		constexpr Vec3(T val) : x(val), y(val), z(val)
 		{
 		}
 
-		Vec3(T _x, T _y, T _z) : x(_x), y(_y), z(_z)
+		constexpr Vec3(T _x, T _y, T _z) : x(_x), y(_y), z(_z)
 		{
 		}
 
-		Vec3(const Vec3& other) : x(other.x), y(other.y), z(other.z)
+		constexpr Vec3(const Vec3& other) : x(other.x), y(other.y), z(other.z)
 		{
 		}
 		
-		Vec3(Vec3&& other) : x(other.x), y(other.y), z(other.z)
+		constexpr Vec3(Vec3&& other) : x(other.x), y(other.y), z(other.z)
 		{
 		}
 
 		~Vec3() = default;
 
-		inline Vec3& operator=(const Vec3& other)
+		constexpr Vec3& operator=(const Vec3& other)
 		{
 			x = other.x;
 			y = other.y;
@@ -43,7 +45,7 @@ namespace frostwave
 			return *this;
 		}
 
-		inline Vec3& operator=(Vec3&& other)
+		constexpr Vec3& operator=(Vec3&& other)
 		{
 			x = other.x;
 			y = other.y;
@@ -51,12 +53,12 @@ namespace frostwave
 			return *this;
 		}
 
-		inline T Dot(const Vec3& other) const
+		constexpr T Dot(const Vec3& other) const
 		{
 			return x * other.x + y * other.y + z * other.z;
 		}
 
-		inline Vec3 Cross(const Vec3& other) const
+		constexpr Vec3 Cross(const Vec3& other) const
 		{
 			return {
 				y * other.z - z * other.y,
@@ -65,17 +67,17 @@ namespace frostwave
 			};
 		}
 
-		inline T LengthSqr() const
+		constexpr T LengthSqr() const
 		{
 			return Dot(*this);
 		}
 
-		inline T Length() const
+		constexpr T Length() const
 		{
-			return (T)sqrt((T)LengthSqr());
+			return Sqrt(LengthSqr());
 		}
 
-		inline Vec3 GetNormalized() const
+		constexpr Vec3 GetNormalized() const
 		{
 			if (T l = Length(); l != 0)
 			{
@@ -85,22 +87,22 @@ namespace frostwave
 			return { 0, 0, 0 };
 		}
 
-		inline void Normalize()
+		constexpr void Normalize()
 		{
 			*this = GetNormalized();
 		}
 
-		inline bool operator==(const Vec3& other) const
+		constexpr bool operator==(const Vec3& other) const
 		{
 			return x == other.x && y == other.y && z == other.z;
 		}
 
-		inline bool operator!=(const Vec3& other) const
+		constexpr bool operator!=(const Vec3& other) const
 		{
 			return x != other.x && y != other.y && z != other.z;
 		}
 
-		inline Vec3 operator+(const Vec3& other) const
+		constexpr Vec3 operator+(const Vec3& other) const
 		{
 			return {
 				x + other.x,
@@ -108,7 +110,7 @@ namespace frostwave
 				z + other.z
 			};
 		}
-		inline Vec3 operator-(const Vec3& other) const
+		constexpr Vec3 operator-(const Vec3& other) const
 		{
 			return {
 				x - other.x,
@@ -116,7 +118,7 @@ namespace frostwave
 				z - other.z
 			};
 		}
-		inline Vec3 operator*(const Vec3& other) const
+		constexpr Vec3 operator*(const Vec3& other) const
 		{
 			return {
 				x * other.x,
@@ -124,7 +126,7 @@ namespace frostwave
 				z * other.z
 			};
 		}
-		inline Vec3 operator/(const Vec3& other) const
+		constexpr Vec3 operator/(const Vec3& other) const
 		{
 			return {
 				x / other.x,
@@ -132,7 +134,7 @@ namespace frostwave
 				z / other.z
 			};
 		}
-		inline Vec3 operator*(const T& scalar) const
+		constexpr Vec3 operator*(const T& scalar) const
 		{
 			return {
 				x * scalar,
@@ -140,7 +142,7 @@ namespace frostwave
 				z * scalar
 			};
 		}
-		inline Vec3 operator/(const T& scalar) const
+		constexpr Vec3 operator/(const T& scalar) const
 		{
 			return {
 				x / scalar,
@@ -149,27 +151,27 @@ namespace frostwave
 			};
 		}
 
-		inline void operator+=(const Vec3& other)
+		constexpr void operator+=(const Vec3& other)
 		{
 			*this = *this + other;
 		}
-		inline void operator-=(const Vec3& other)
+		constexpr void operator-=(const Vec3& other)
 		{
 			*this = *this - other;
 		}
-		inline void operator*=(const Vec3& other)
+		constexpr void operator*=(const Vec3& other)
 		{
 			*this = *this * other;
 		}
-		inline void operator/=(const Vec3& other)
+		constexpr void operator/=(const Vec3& other)
 		{
 			*this = *this / other;
 		}
-		inline void operator*=(const T& scalar)
+		constexpr void operator*=(const T& scalar)
 		{
 			*this = *this * scalar;
 		}
-		inline void operator/=(const T& scalar)
+		constexpr void operator/=(const T& scalar)
 		{
 			*this = *this / scalar;
 		}
@@ -184,5 +186,112 @@ namespace frostwave
 	using Vec3f = Vec3<f32>;
 	using Vec3i = Vec3<i32>;
 	using Vec3u = Vec3<u32>;
+
+	// Vec3f padded to 16 bytes so it loads as one SSE register, for arrays of vectors that are worked on a lot.
+	// The fourth float is padding and is never read.
+	class alignas(16) Vec3fA
+	{
+	public:
+		constexpr Vec3fA() : x(0), y(0), z(0), padding(0)
+		{
+		}
+
+		constexpr Vec3fA(f32 val) : x(val), y(val), z(val), padding(0)
+		{
+		}
+
+		constexpr Vec3fA(f32 _x, f32 _y, f32 _z) : x(_x), y(_y), z(_z), padding(0)
+		{
+		}
+
+		constexpr Vec3fA(const Vec3f& other) : x(other.x), y(other.y), z(other.z), padding(0)
+		{
+		}
+
+		constexpr operator Vec3f() const
+		{
+			return { x, y, z };
+		}
+
+		inline f32 Dot(const Vec3fA& other) const
+		{
+			return simd::Dot3(&x, &other.x);
+		}
+
+		inline Vec3fA Cross(const Vec3fA& other) const
+		{
+			return Apply(simd::Cross3, other);
+		}
+
+		inline f32 LengthSqr() const
+		{
+			return Dot(*this);
+		}
+
+		inline f32 Length() const
+		{
+			return sqrt(LengthSqr());
+		}
+
+		inline Vec3fA GetNormalized() const
+		{
+			Vec3fA result;
+			simd::Normalize3(&x, &result.x);
+			return result;
+		}
+
+		inline void Normalize()
+		{
+			*this = GetNormalized();
+		}
+
+		constexpr bool operator==(const Vec3fA& other) const
+		{
+			return x == other.x && y == other.y && z == other.z;
+		}
+
+		constexpr bool operator!=(const Vec3fA& other) const
+		{
+			return !(*this == other);
+		}
+
+		inline Vec3fA operator+(const Vec3fA& other) const { return Apply(simd::Add4, other); }
+		inline Vec3fA operator-(const Vec3fA& other) const { return Apply(simd::Sub4, other); }
+		inline Vec3fA operator*(const Vec3fA& other) const { return Apply(simd::Mul4, other); }
+		inline Vec3fA operator/(const Vec3fA& other) const { return Apply(simd::Div4, other); }
+
+		inline Vec3fA operator*(f32 scalar) const
+		{
+			Vec3fA result;
+			simd::Scale4(&x, scalar, &result.x);
+			return result;
+		}
+		inline Vec3fA operator/(f32 scalar) const
+		{
+			return *this * (1.0f / scalar);
+		}
+
+		inline void operator+=(const Vec3fA& other) { *this = *this + other; }
+		inline void operator-=(const Vec3fA& other) { *this = *this - other; }
+		inline void operator*=(const Vec3fA& other) { *this = *this * other; }
+		inline void operator/=(const Vec3fA& other) { *this = *this / other; }
+		inline void operator*=(f32 scalar) { *this = *this * scalar; }
+		inline void operator/=(f32 scalar) { *this = *this / scalar; }
+
+		union
+		{
+			struct { f32 x, y, z, padding; };
+			struct { f32 r, g, b; };
+		};
+
+	private:
+		template <typename Operation>
+		inline Vec3fA Apply(Operation operation, const Vec3fA& other) const
+		{
+			Vec3fA result;
+			operation(&x, &other.x, &result.x);
+			return result;
+		}
+	};
 }
 namespace fw = frostwave;
\ No newline at end of file
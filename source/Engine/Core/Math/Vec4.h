@@ -1,37 +1,46 @@
 #pragma once
 #include <Engine/Core/Types.h>
+#include <Engine/Core/Common.h>
 #include <Engine/Core/Math/Vec3.h>
+#include <Engine/Core/Math/Simd.h>
+#include <type_traits>
 #pragma warning(disable: 4201)
+// The scalar code after a SIMD return is unreachable at runtime, which MSVC warns about.
+#pragma warning(push)
+#pragma warning(disable: 4702)
 
 namespace frostwave
 {
+	// Aligned for SSE loads, the f32 operations below go through Simd.h outside of constant expressions.
 	template<typename T>
-	class Vec4
+	class alignas(16) Vec4
 	{
 	public:
-		Vec4(T val) : x(val), y(val), z(val), w(val)
+		static constexpr bool UseSimd = std::is_same_v<T, f32>;
+
+		constexpr Vec4(T val) : x(val), y(val), z(val), w(val)
 		{
 		}
 
-		Vec4(T _x = 0, T _y = 0, T _z = 0, T _w = 0) : x(_x), y(_y), z(_z), w(_w)
+		constexpr Vec4(T _x = 0, T _y = 0, T _z = 0, T _w = 0) : x(_x), y(_y), z(_z), w(_w)
 		{
 		}
 
-		Vec4(const Vec3<T>& other, T value = 1.0f) : x(other.x), y(other.y), z(other.z), w(value)
+		constexpr Vec4(const Vec3<T>& other, T value = 1.0f) : x(other.x), y(other.y), z(other.z), w(value)
 		{
 		}
 
-		Vec4(const Vec4& other) : x(other.x), y(other.y), z(other.z), w(other.w)
+		constexpr Vec4(const Vec4& other) : x(other.x), y(other.y), z(other.z), w(other.w)
 		{
 		}
 
-		Vec4(Vec4&& other) : x(other.x), y(other.y), z(other.z), w(other.w)
+		constexpr Vec4(Vec4&& other) : x(other.x), y(other.y), z(other.z), w(other.w)
 		{
 		}
 
-		~Vec4() { }
+		~Vec4() = default;
 
-		inline Vec4& operator=(const Vec4& other)
+		constexpr Vec4& operator=(const Vec4& other)
 		{
 			x = other.x;
 			y = other.y;
@@ -40,7 +49,7 @@ namespace frostwave
 			return *this;
 		}
 
-		inline Vec4& operator=(Vec4&& other)
+		constexpr Vec4& operator=(Vec4&& other)
 		{
 			x = other.x;
 			y = other.y;
@@ -49,13 +58,21 @@ namespace frostwave
 			return *this;
 		}
 
-		inline T Dot(const Vec4& other) const
+		constexpr T Dot(const Vec4& other) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return simd::Dot4(&x, &other.x);
+			}
 			return x * other.x + y * other.y + z * other.z + w * other.w;
 		}
 
-		inline Vec4 Cross(const Vec4& other) const
+		constexpr Vec4 Cross(const Vec4& other) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return Apply(simd::Cross3, other);
+			}
 			return {
 				y * other.z - z * other.y,
 				z * other.x - x * other.z,
@@ -64,18 +81,27 @@ namespace frostwave
 			};
 		}
 
-		inline T LengthSqr() const
+		constexpr T LengthSqr() const
 		{
 			return Dot(*this);
 		}
 
-		inline T Length() const
+		constexpr T Length() const
 		{
-			return sqrt(LengthSqr());
+			return Sqrt(LengthSqr());
 		}
 
-		inline Vec4 GetNormalized() const
+		constexpr Vec4 GetNormalized() const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					Vec4 result;
+					simd::Normalize4(&x, &result.x);
+					return result;
+				}
+			}
 			if (T l = Length(); l != 0)
 			{
 				T invlen = 1 / l;
@@ -84,23 +110,27 @@ namespace frostwave
 			return { 0, 0, 0, 0 };
 		}
 
-		inline void Normalize()
+		constexpr void Normalize()
 		{
 			*this = GetNormalized();
 		}
 
-		inline bool operator==(const Vec4& other) const
+		constexpr bool operator==(const Vec4& other) const
 		{
 			return x == other.x && y == other.y && z == other.z && w == other.w;
 		}
 
-		inline bool operator!=(const Vec4& other) const
+		constexpr bool operator!=(const Vec4& other) const
 		{
 			return x != other.x && y != other.y && z != other.z && w != other.w;
 		}
 
-		inline Vec4 operator+(const Vec4& other) const
+		constexpr Vec4 operator+(const Vec4& other) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return Apply(simd::Add4, other);
+			}
 			return {
 				x + other.x,
 				y + other.y,
@@ -108,8 +138,12 @@ namespace frostwave
 				w + other.w
 			};
 		}
-		inline Vec4 operator-(const Vec4& other) const
+		constexpr Vec4 operator-(const Vec4& other) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return Apply(simd::Sub4, other);
+			}
 			return {
 				x - other.x,
 				y - other.y,
@@ -117,8 +151,12 @@ namespace frostwave
 				w - other.w
 			};
 		}
-		inline Vec4 operator*(const Vec4& other) const
+		constexpr Vec4 operator*(const Vec4& other) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return Apply(simd::Mul4, other);
+			}
 			return {
 				x * other.x,
 				y * other.y,
@@ -126,8 +164,12 @@ namespace frostwave
 				w * other.w
 			};
 		}
-		inline Vec4 operator/(const Vec4& other) const
+		constexpr Vec4 operator/(const Vec4& other) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated()) return Apply(simd::Div4, other);
+			}
 			return {
 				x / other.x,
 				y / other.y,
@@ -136,8 +178,17 @@ namespace frostwave
 			};
 		}
 
-		inline Vec4 operator*(const T& scalar) const
+		constexpr Vec4 operator*(const T& scalar) const
 		{
+			if constexpr (UseSimd)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					Vec4 result;
+					simd::Scale4(&x, scalar, &result.x);
+					return result;
+				}
+			}
 			return {
 				x * scalar,
 				y * scalar,
@@ -145,7 +196,7 @@ namespace frostwave
 				w * scalar
 			};
 		}
-		inline Vec4 operator/(const T& scalar) const
+		constexpr Vec4 operator/(const T& scalar) const
 		{
 			return {
 				x / scalar,
@@ -155,31 +206,41 @@ namespace frostwave
 			};
 		}
 
-		inline void operator+=(const Vec4& other)
+		constexpr void operator+=(const Vec4& other)
 		{
 			*this = *this + other;
 		}
-		inline void operator-=(const Vec4& other)
+		constexpr void operator-=(const Vec4& other)
 		{
 			*this = *this - other;
 		}
-		inline void operator*=(const Vec4& other)
+		constexpr void operator*=(const Vec4& other)
 		{
 			*this = *this * other;
 		}
-		inline void operator/=(const Vec4& other)
+		constexpr void operator/=(const Vec4& other)
 		{
 			*this = *this / other;
 		}
-		inline void operator*=(const T& scalar)
+		constexpr void operator*=(const T& scalar)
 		{
 			*this = *this * scalar;
 		}
-		inline void operator/=(const T& scalar)
+		constexpr void operator/=(const T& scalar)
 		{
 			*this = *this / scalar;
 		}
 
+	private:
+		template <typename Operation>
+		inline Vec4 Apply(Operation operation, const Vec4& other) const
+		{
+			Vec4 result;
+			operation(&x, &other.x, &result.x);
+			return result;
+		}
+
+	public:
 		union
 		{
 			struct { T x, y, z, w; };
@@ -194,4 +255,5 @@ namespace frostwave
 	using Vec4i = Vec4<i32>;
 	using Vec4u = Vec4<u32>;
 }
+#pragma warning(pop)
 namespace fw = frostwave;
\ No newline at end of file
@@ -7,7 +7,7 @@ namespace frostwave
 	class Timer
 	{
 	public:
-		Timer() : m_DeltaTime(0), m_TotalTime(0)
+		Timer() : m_DeltaTime(0), m_DeltaNanoseconds(0), m_TotalTime(0)
 		{
 			m_Time = m_OldTime = m_NewTime = std::chrono::high_resolution_clock::now();
 		}
@@ -18,8 +18,10 @@ namespace frostwave
 			m_OldTime = m_NewTime;
 			m_NewTime = std::chrono::high_resolution_clock::now();
 
-			m_DeltaTime = std::chrono::duration_cast<std::chrono::duration<f32, std::ratio<1>>>(m_NewTime - m_OldTime).count();
-			m_TotalTime = std::chrono::duration_cast<std::chrono::duration<f32, std::ratio<1>>>(m_NewTime - m_Time).count();
+			m_DeltaNanoseconds = (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(m_NewTime - m_OldTime).count();
+			m_DeltaTime = (f32)((f64)m_DeltaNanoseconds * 1e-9);
+			// Kept in double, a float runs out of sub-millisecond precision after a few hours.
+			m_TotalTime = std::chrono::duration_cast<std::chrono::duration<f64, std::ratio<1>>>(m_NewTime - m_Time).count();
 		}
 
 		f32 GetDeltaTime()
@@ -27,14 +29,25 @@ namespace frostwave
 			return m_DeltaTime;
 		}
 
+		u64 GetDeltaNanoseconds()
+		{
+			return m_DeltaNanoseconds;
+		}
+
 		f32 GetTotalTime()
+		{
+			return (f32)m_TotalTime;
+		}
+
+		f64 GetTotalTimeExact()
 		{
 			return m_TotalTime;
 		}
 
 	private:
 		f32 m_DeltaTime;
-		f32 m_TotalTime;
+		u64 m_DeltaNanoseconds;
+		f64 m_TotalTime;
 		std::chrono::high_resolution_clock::time_point m_Time;
 		std::chrono::high_resolution_clock::time_point m_NewTime;
 		std::chrono::high_resolution_clock::time_point m_OldTime;
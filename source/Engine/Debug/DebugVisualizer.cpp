@@ -2,17 +2,92 @@
 
 #ifdef _DEBUG
 #include <Engine/Memory/Allocator.h>
+#include <Engine/Profiling/FrameStats.h>
+#include <Engine/Profiling/Metrics.h>
 #include <Engine/Graphics/imgui/imgui.h>
 
-void frostwave::DebugVisualizer::Draw()
+void frostwave::DebugVisualizer::Draw(const FrameStats& frameStats)
 {
-	//ImGui::Begin("Debug");
+	ImGui::Begin("Debug");
 
-	//ImGui::Text("Allocator Memory Usage");
-	//auto memory = Allocator::Get()->GetStats();
-	//ImGui::ProgressBar((float)memory.current / (float)memory.max);
-	//ImGui::Text("%.2fMB/%.2fMB", memory.current.AsMegabytes(), memory.max.AsMegabytes());
+	auto frames = frameStats.GetSummary();
+	ImGui::Text("Frame: mean %.2fms, p50 %.2fms, p95 %.2fms, p99 %.2fms, max %.2fms", frames.mean, frames.p50, frames.p95, frames.p99, frames.max);
+	ImGui::Text("%u of the last %u frames over the %.2fms budget", frames.hitches, frames.frames, frameStats.GetBudget());
 
-	//ImGui::End();
+	f32 history[FrameStats::HistorySize];
+	u32 historyCount = frameStats.GetHistory(history, FrameStats::HistorySize);
+	ImGui::PlotLines("Frame ms", history, (i32)historyCount, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+
+	f32 frameHistogram[FrameStats::HistogramBucketCount];
+	for (u32 i = 0; i < FrameStats::HistogramBucketCount; ++i)
+		frameHistogram[i] = (f32)frameStats.GetHistogram()[i];
+	ImGui::PlotHistogram("Frame ms (1ms)", frameHistogram, (i32)FrameStats::HistogramBucketCount, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+	if (ImGui::Button("Export frame CSV")) frameStats.ExportCsv("frames.csv");
+
+	if (ImGui::CollapsingHeader("Metrics", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		f32 values[Metrics::HistorySize];
+		for (u32 i = 0; i < Metrics::GetMetricCount(); ++i)
+		{
+			const Metric* metric = Metrics::GetMetric(i);
+			u32 count = Metrics::GetHistory(i, values, Metrics::HistorySize);
+			ImGui::PlotLines(metric->GetName(), values, (i32)count, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 24));
+			ImGui::SameLine();
+			ImGui::Text("%lld", Metrics::GetLast(i));
+		}
+
+		if (ImGui::Button("Export metrics JSON")) Metrics::ExportJson("metrics.json");
+		ImGui::SameLine();
+		if (ImGui::Button("Export metrics CSV")) Metrics::ExportCsv("metrics.csv");
+	}
+
+	ImGui::Separator();
+
+	ImGui::Text("Allocator Memory Usage");
+	auto memory = Allocator::Get()->GetStats();
+	ImGui::ProgressBar((float)memory.current / (float)memory.max);
+	ImGui::Text("%.2fMB/%.2fMB", memory.current.AsMegabytes(), memory.max.AsMegabytes());
+	ImGui::Text("Committed %.2fMB of %.2fGB reserved", memory.max.AsMegabytes(), memory.reserved.AsGigabytes());
+
+	auto defrag = Allocator::Get()->GetDefragStats();
+	ImGui::Text("Movable: %llu live, %llu moves (%.2fMB), %llu passes", defrag.liveHandles, defrag.moves, defrag.movedBytes / 1024.0 / 1024.0, defrag.passes);
+
+#if FW_MEMORY_TELEMETRY
+	const MemoryTelemetry& telemetry = Allocator::Get()->GetTelemetry();
+	auto summary = telemetry.GetSummary();
+
+	ImGui::Separator();
+	ImGui::Text("Live: %.2fMB in %llu allocations", summary.counters.liveBytes / 1024.0 / 1024.0, summary.counters.liveCount);
+	ImGui::Text("Peak: %.2fMB", summary.counters.peakBytes / 1024.0 / 1024.0);
+	ImGui::Text("Last frame: %llu allocations, %.2fKB", summary.counters.frameAllocations, summary.frameBytes / 1024.0);
+
+	f32 histogram[MemoryTelemetry::HistogramBucketCount];
+	for (u32 i = 0; i < MemoryTelemetry::HistogramBucketCount; ++i)
+		histogram[i] = (f32)summary.histogram[i];
+	ImGui::PlotHistogram("Sizes (log2)", histogram, (i32)MemoryTelemetry::HistogramBucketCount, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+
+	if (ImGui::CollapsingHeader("Types"))
+	{
+		ImGui::Columns(4, "MemoryTypes");
+		ImGui::Text("Type"); ImGui::NextColumn();
+		ImGui::Text("Live KB"); ImGui::NextColumn();
+		ImGui::Text("Peak KB"); ImGui::NextColumn();
+		ImGui::Text("Allocs/frame"); ImGui::NextColumn();
+		for (auto& type : telemetry.GetTypes())
+		{
+			ImGui::Text("%s", type.type); ImGui::NextColumn();
+			ImGui::Text("%.1f", type.counters.liveBytes / 1024.0); ImGui::NextColumn();
+			ImGui::Text("%.1f", type.counters.peakBytes / 1024.0); ImGui::NextColumn();
+			ImGui::Text("%llu", type.counters.frameAllocations); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+	if (ImGui::Button("Export JSON")) telemetry.ExportJson("memory.json");
+	ImGui::SameLine();
+	if (ImGui::Button("Export CSV")) telemetry.ExportCsv("memory.csv");
+#endif
+
+	ImGui::End();
 }
 #endif
\ No newline at end of file
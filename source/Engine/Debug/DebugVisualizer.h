@@ -3,10 +3,12 @@
 #ifdef _DEBUG
 namespace frostwave
 {
+	class FrameStats;
+
 	class DebugVisualizer
 	{
 	public:
-		void Draw();
+		void Draw(const FrameStats& frameStats);
 	};
 }
 namespace fw = frostwave;
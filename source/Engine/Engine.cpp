@@ -7,6 +7,11 @@
 #include <Engine/Graphics/Scene.h>
 #include <Engine/Core/Common.h>
 #include <Engine/FileWatcher.h>
+#include <Engine/Memory/Arena.h>
+#include <Engine/Memory/MemoryResource.h>
+#include <Engine/Logging/LogSink.h>
+#include <Engine/Profiling/Profiler.h>
+#include <Engine/Profiling/Metrics.h>
 #include <filesystem>
 #include <cassert>
 
@@ -14,9 +19,35 @@
 
 frostwave::Engine::Engine(Size allocatedMemory)
 {
-	Allocator::Create(allocatedMemory);
+	Allocator::Create(allocatedMemory, Allocator::Mode::Concurrent);
+#if FW_MEMORY_GUARDS
+	Allocator::Get()->SetGuards(Allocator::GuardAll);
+#endif
+	AllocatorResource::InstallDefault();
 	Logger::Create();
+#ifndef _RETAIL
+#if FW_BINARY_LOG
+	// Only warnings and up are formatted for the console, everything goes to the capture for LogDecoder.
+	ConsoleSink* console = Allocate<ConsoleSink>();
+	console->SetLevel(Logger::Level::Warning);
+	Logger::AddSink(console);
+	Logger::AddSink(Allocate<BinaryFileSink>("frostwave.fwlog"));
+#else
+	Logger::AddSink(Allocate<ConsoleSink>());
+	Logger::AddSink(Allocate<FileSink>("frostwave.log"));
+#endif
+#endif
 	Logger::SetLevel(Logger::Level::Info);
+	// Always on, the file keeps the last moments before a crash even in builds that log nowhere else.
+	FlightRecorder::Create("frostwave.flight");
+#if FW_PROFILE
+	Profiler::Create();
+	Profiler::SetThreadName("Main");
+#endif
+	Metrics::Create();
+	m_FrameIndex = 0;
+	LinearArena::Create(LinearArena::Scope::Frame, 2MB);
+	LinearArena::Create(LinearArena::Scope::Level, 8MB);
 
 	m_RenderManager = Allocate();
 	m_Scene = Allocate();
@@ -24,10 +55,21 @@ frostwave::Engine::Engine(Size allocatedMemory)
 
 frostwave::Engine::~Engine()
 {
+	m_FrameStats.Dump();
+
 	Free(m_Scene);
 	Free(m_RenderManager);
+	FileWatcher::Get()->Stop();
 
+	LinearArena::Destroy(LinearArena::Scope::Level);
+	LinearArena::Destroy(LinearArena::Scope::Frame);
+	Metrics::Destroy();
+#if FW_PROFILE
+	Profiler::Destroy();
+#endif
 	Logger::Destroy();
+	if (FlightRecorder::Get()) FlightRecorder::Destroy();
+	AllocatorResource::UninstallDefault();
 	Allocator::Destroy();
 }
 
@@ -53,34 +95,66 @@ void frostwave::Engine::Init(std::function<void(f32)> gameUpdate, std::function<
 
 void frostwave::Engine::Tick()
 {
+	FW_PROFILE_SCOPE("Engine::Tick");
+
 	if (Window::Get()->GetInput()->IsKeyPressed(fw::Key::ESCAPE))
 		Shutdown();
 
+#if FW_PROFILE
+	// F11 starts a capture and stops it again, the trace opens in chrome://tracing or ui.perfetto.dev.
+	if (Window::Get()->GetInput()->IsKeyPressed(fw::Key::F11))
+	{
+		if (Profiler::IsCapturing())
+			Profiler::EndCapture("frostwave.trace.json");
+		else
+			Profiler::BeginCapture();
+	}
+#endif
+
+	if (FlightRecorder* recorder = FlightRecorder::Get())
+		recorder->MarkFrame(m_FrameIndex);
+	m_FrameIndex++;
+
+	LinearArena::Get(LinearArena::Scope::Frame)->Reset();
+	{
+		FW_PROFILE_SCOPE("Defragment");
+		Allocator::Get()->Defragment(DefragmentBudgetMilliseconds);
+	}
+#if FW_MEMORY_TELEMETRY
+	Allocator::Get()->GetTelemetry().BeginFrame();
+#endif
 	m_RenderManager->BeginFrame();
 
 	m_Timer.Update();
 	f32 dt = m_Timer.GetDeltaTime();
+	// The first delta covers everything since the engine was created.
+	if (m_FrameIndex > 1) m_FrameStats.AddFrame(m_Timer.GetDeltaNanoseconds());
 	FileWatcher::Get()->Update(dt);
 
 #ifdef _DEBUG
-	m_DebugVisualizer.Draw();
+	m_DebugVisualizer.Draw(m_FrameStats);
 #endif
 
 #ifdef WITH_EDITOR
 	ImGui::DockSpaceOverViewport();
 #endif
 
-	m_GameUpdate(dt);
+	{
+		FW_PROFILE_SCOPE("Game Update");
+		m_GameUpdate(dt);
+	}
 
 	m_Scene->Submit(m_RenderManager);
 
 #ifdef WITH_EDITOR
-	m_RenderManager->Render(m_Timer.GetTotalTime(), m_Scene->GetCamera(), false);
+	m_RenderManager->Render(m_Timer.GetTotalTimeExact(), m_Scene->GetCamera(), false);
 	m_EditorUpdate(dt, m_RenderManager->GetRenderedScene());
 #else
-	m_RenderManager->Render(m_Timer.GetTotalTime(), m_Scene->GetCamera());
+	m_RenderManager->Render(m_Timer.GetTotalTimeExact(), m_Scene->GetCamera());
 #endif
 	m_RenderManager->EndFrame();
+
+	Metrics::Snapshot(m_FrameIndex);
 }
 
 void frostwave::Engine::Shutdown()
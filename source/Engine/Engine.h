@@ -3,6 +3,7 @@
 #include <Engine/Graphics/Texture.h>
 #include <Engine/Logging/Logger.h>
 #include <Engine/Core/Timer.h>
+#include <Engine/Profiling/FrameStats.h>
 #include <functional>
 
 #ifdef _DEBUG
@@ -17,6 +18,9 @@ namespace frostwave
 	class Engine
 	{
 	public:
+		// Time the allocator may spend compacting movable memory at the start of every frame.
+		static constexpr f64 DefragmentBudgetMilliseconds = 0.25;
+
 		Engine(Size allocatedMemory);
 		~Engine();
 		void Init(std::function<void(f32)> gameUpdate, std::function<void()> gameInit, std::function<void(f32, const Texture*)> editorUpdate);
@@ -24,11 +28,14 @@ namespace frostwave
 		void Shutdown();
 
 		Scene* GetScene() const { return m_Scene; }
+		FrameStats& GetFrameStats() { return m_FrameStats; }
 
 	private:
 		RenderManager* m_RenderManager;
 		Scene* m_Scene;
 		Timer m_Timer;
+		u64 m_FrameIndex;
+		FrameStats m_FrameStats;
 #ifdef _DEBUG
 		DebugVisualizer m_DebugVisualizer;
 #endif
@@ -0,0 +1,350 @@
+#include "FileWatcher.h"
+#include <Engine/Logging/Logger.h>
+#include <chrono>
+
+#ifdef _WIN32
+#include <Windows.h>
+
+struct frostwave::FileWatcher::Directory
+{
+	OVERLAPPED overlapped = { };
+	HANDLE handle = INVALID_HANDLE_VALUE;
+	std::string key;
+	// Set by the watching thread when the next read could not be issued, Register watches the directory again.
+	std::atomic<bool> lost = false;
+	// ReadDirectoryChangesW wants it DWORD aligned.
+	alignas(DWORD) u8 buffer[16 * 1024];
+};
+
+namespace
+{
+	bool ReadChanges(HANDLE handle, void* buffer, DWORD size, OVERLAPPED* overlapped)
+	{
+		return ReadDirectoryChangesW(handle, buffer, size, FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, nullptr, overlapped, nullptr);
+	}
+}
+
+frostwave::FileWatcher::FileWatcher() : m_HasSettled(false), m_Running(true), m_Wake(0)
+{
+	m_Handle = (i64)CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+	m_Thread = std::thread(&FileWatcher::Run, this);
+}
+
+void frostwave::FileWatcher::Stop()
+{
+	if (!m_Running.exchange(false)) return;
+
+	// A completion without a directory wakes the thread up.
+	PostQueuedCompletionStatus((HANDLE)m_Handle, 0, 0, nullptr);
+	m_Thread.join();
+
+	for (auto& [key, directory] : m_Directories)
+	{
+		// The cancelled read still completes into the directory, wait for it before freeing.
+		if (!directory->lost)
+		{
+			DWORD bytes = 0;
+			CancelIoEx(directory->handle, &directory->overlapped);
+			GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, TRUE);
+		}
+		CloseHandle(directory->handle);
+		delete directory;
+	}
+	m_Directories.clear();
+	CloseHandle((HANDLE)m_Handle);
+}
+
+bool frostwave::FileWatcher::WatchDirectory(const std::string& key)
+{
+	// A lost directory has no read in flight, nothing else references it.
+	auto lost = m_Directories.find(key);
+	if (lost != m_Directories.end())
+	{
+		CloseHandle(lost->second->handle);
+		delete lost->second;
+		m_Directories.erase(lost);
+	}
+
+	Directory* directory = new Directory;
+	directory->key = key;
+	directory->handle = CreateFileA(key.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+		OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+	// From here on the watching thread owns the reads, it issues the next one after every completion.
+	if (directory->handle == INVALID_HANDLE_VALUE ||
+		!CreateIoCompletionPort(directory->handle, (HANDLE)m_Handle, (ULONG_PTR)directory, 0) ||
+		!ReadChanges(directory->handle, directory->buffer, sizeof(directory->buffer), &directory->overlapped))
+	{
+		if (directory->handle != INVALID_HANDLE_VALUE) CloseHandle(directory->handle);
+		delete directory;
+		return false;
+	}
+
+	m_Directories[key] = directory;
+	return true;
+}
+
+void frostwave::FileWatcher::Run()
+{
+	while (m_Running)
+	{
+		DWORD bytes = 0;
+		ULONG_PTR completionKey = 0;
+		OVERLAPPED* overlapped = nullptr;
+		BOOL success = GetQueuedCompletionStatus((HANDLE)m_Handle, &bytes, &completionKey, &overlapped, m_Pending.empty() ? INFINITE : DebounceMilliseconds);
+
+		// Without an overlapped nothing was dequeued, it timed out or is the wake up from Stop.
+		Directory* directory = overlapped ? (Directory*)completionKey : nullptr;
+		if (directory && m_Running)
+		{
+			// A failed read reports nothing, the directory is only watched again if the next read can be issued.
+			if (success)
+			{
+				u64 now = GetMilliseconds();
+				// Zero bytes means the buffer overflowed and the changes were lost, there is nothing to report.
+				for (u8* entry = directory->buffer; bytes;)
+				{
+					auto* info = (FILE_NOTIFY_INFORMATION*)entry;
+					std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+					OnChange(GetKey(fs::path(directory->key) / name), now);
+
+					if (!info->NextEntryOffset) break;
+					entry += info->NextEntryOffset;
+				}
+			}
+
+			if (!ReadChanges(directory->handle, directory->buffer, sizeof(directory->buffer), &directory->overlapped))
+			{
+				ERROR_LOG("Lost the watch on directory '%s' (error %lu), it is watched again when a file in it is registered", directory->key.c_str(), GetLastError());
+				directory->lost = true;
+			}
+		}
+
+		PublishSettled(GetMilliseconds());
+	}
+}
+
+std::string frostwave::FileWatcher::GetKey(const fs::path& path)
+{
+	std::error_code error;
+	std::string key = fs::absolute(path, error).lexically_normal().generic_string();
+	for (c8& c : key)
+	{
+		if (c >= 'A' && c <= 'Z') c = (c8)(c - 'A' + 'a');
+	}
+	return key;
+}
+
+#else
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+struct frostwave::FileWatcher::Directory
+{
+	i32 watch;
+	std::string key;
+	// Set by the watching thread when inotify dropped the watch, Register watches the directory again.
+	std::atomic<bool> lost = false;
+};
+
+frostwave::FileWatcher::FileWatcher() : m_HasSettled(false), m_Running(true)
+{
+	m_Handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	m_Wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	m_Thread = std::thread(&FileWatcher::Run, this);
+}
+
+void frostwave::FileWatcher::Stop()
+{
+	if (!m_Running.exchange(false)) return;
+
+	u64 one = 1;
+	[[maybe_unused]] ssize_t written = write((i32)m_Wake, &one, sizeof(one));
+	m_Thread.join();
+
+	for (auto& [key, directory] : m_Directories)
+		delete directory;
+	m_Directories.clear();
+	// Closing the instance removes every watch.
+	close((i32)m_Handle);
+	close((i32)m_Wake);
+}
+
+bool frostwave::FileWatcher::WatchDirectory(const std::string& key)
+{
+	// Editors either rewrite a file in place or replace it with a renamed temporary, both end in one of these.
+	i32 watch = inotify_add_watch((i32)m_Handle, key.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+	if (watch < 0) return false;
+
+	// A lost directory is already out of m_Watches, nothing else references it.
+	auto lost = m_Directories.find(key);
+	if (lost != m_Directories.end()) delete lost->second;
+
+	Directory* directory = new Directory{ watch, key };
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Watches[watch] = directory;
+	}
+	m_Directories[key] = directory;
+	return true;
+}
+
+void frostwave::FileWatcher::Run()
+{
+	alignas(inotify_event) c8 buffer[16 * 1024];
+	pollfd descriptors[2] = { { (i32)m_Handle, POLLIN, 0 }, { (i32)m_Wake, POLLIN, 0 } };
+
+	while (m_Running)
+	{
+		poll(descriptors, 2, m_Pending.empty() ? -1 : (i32)DebounceMilliseconds);
+
+		u64 now = GetMilliseconds();
+		ssize_t bytes;
+		while ((bytes = read((i32)m_Handle, buffer, sizeof(buffer))) > 0)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (c8* entry = buffer; entry < buffer + bytes;)
+			{
+				auto* event = (inotify_event*)entry;
+				entry += sizeof(inotify_event) + event->len;
+
+				auto watch = m_Watches.find(event->wd);
+				if (watch == m_Watches.end()) continue;
+
+				// The directory was deleted or unmounted and inotify removed the watch.
+				if (event->mask & IN_IGNORED)
+				{
+					ERROR_LOG("Lost the watch on directory '%s', it is watched again when a file in it is registered", watch->second->key.c_str());
+					watch->second->lost = true;
+					m_Watches.erase(watch);
+					continue;
+				}
+
+				if (event->len == 0) continue;
+				OnChange(watch->second->key + "/" + event->name, now);
+			}
+		}
+
+		PublishSettled(GetMilliseconds());
+	}
+}
+
+std::string frostwave::FileWatcher::GetKey(const fs::path& path)
+{
+	std::error_code error;
+	return fs::absolute(path, error).lexically_normal().generic_string();
+}
+#endif
+
+void frostwave::FileWatcher::Register(void* ptr, const std::string& path, Function callback)
+{
+	if (!fs::exists(path)) return;
+
+	std::string key = GetKey(path);
+	auto file = m_Files.find(key);
+	if (file != m_Files.end())
+	{
+		for (auto& call : file->second.callbacks)
+		{
+			if (call.address == ptr) return;
+		}
+		file->second.callbacks.emplace_back(Callback{ ptr, callback });
+		return;
+	}
+
+	// Directories stay watched once added, changes to files nobody watches are dropped in Update.
+	std::string directory = fs::path(key).parent_path().generic_string();
+	auto watched = m_Directories.find(directory);
+	if ((watched == m_Directories.end() || watched->second->lost) && !WatchDirectory(directory))
+	{
+		WARNING_LOG("Failed to watch directory '%s', changes to '%s' will not be picked up", directory.c_str(), path.c_str());
+		return;
+	}
+
+	FileInfo info = { };
+	info.path = path;
+	info.callbacks.emplace_back(Callback{ ptr, callback });
+	m_Files.emplace(std::move(key), std::move(info));
+}
+
+void frostwave::FileWatcher::Unregister(void* ptr, const std::string& path)
+{
+	auto file = m_Files.find(GetKey(path));
+	if (file == m_Files.end()) return;
+
+	auto& callbacks = file->second.callbacks;
+	for (i32 i = 0; i < (i32)callbacks.size(); i++)
+	{
+		if (callbacks[i].address == ptr || ptr == nullptr)
+		{
+			callbacks[i] = callbacks.back();
+			callbacks.pop_back();
+			i--;
+		}
+	}
+
+	if (callbacks.empty()) m_Files.erase(file);
+}
+
+void frostwave::FileWatcher::Update([[maybe_unused]] const f32 aDeltaTime)
+{
+	if (!m_HasSettled.load(std::memory_order_acquire)) return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Changed.swap(m_Settled);
+		m_HasSettled = false;
+	}
+
+	for (const std::string& key : m_Changed)
+	{
+		auto file = m_Files.find(key);
+		if (file == m_Files.end()) continue;
+
+		if (!fs::exists(file->second.path))
+		{
+			WARNING_LOG("File '%s' doesnt exist, removing watch..", file->second.path.c_str());
+			m_Files.erase(file);
+			continue;
+		}
+
+		// A callback may register or unregister, which can move the entry.
+		std::vector<Callback> callbacks = file->second.callbacks;
+		std::string path = file->second.path;
+		for (auto&& callback : callbacks)
+			callback.func(path);
+	}
+	m_Changed.clear();
+}
+
+void frostwave::FileWatcher::OnChange(const std::string& key, u64 now)
+{
+	m_Pending[key] = now;
+}
+
+void frostwave::FileWatcher::PublishSettled(u64 now)
+{
+	std::vector<std::string> settled;
+	for (auto it = m_Pending.begin(); it != m_Pending.end();)
+	{
+		if (now - it->second < DebounceMilliseconds)
+		{
+			++it;
+			continue;
+		}
+		settled.push_back(it->first);
+		it = m_Pending.erase(it);
+	}
+	if (settled.empty()) return;
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Settled.insert(m_Settled.end(), std::make_move_iterator(settled.begin()), std::make_move_iterator(settled.end()));
+	m_HasSettled.store(true, std::memory_order_release);
+}
+
+u64 frostwave::FileWatcher::GetMilliseconds()
+{
+	return (u64)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -1,111 +1,87 @@
 #pragma once
+#include <Engine/Core/Types.h>
+#include <atomic>
 #include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
-#include <algorithm>
-#include <fstream>
 
 namespace fs = std::filesystem;
 
 namespace frostwave
 {
+	// Watches the directories of registered files on a background thread, inotify on Linux and
+	// ReadDirectoryChangesW on Windows. Bursts of changes to a file are coalesced until it has been
+	// quiet for DebounceMilliseconds, then handed to the main thread as one batch, so Update only
+	// pays for the files that changed.
 	class FileWatcher
 	{
 	public:
-		static FileWatcher* Get() { static FileWatcher* instance = new FileWatcher; return instance; }
-		void Register(void* ptr, const std::string& path, std::function<void(const std::string&)> callback)
-		{
-			if (!fs::exists(path)) return;
-
-			for (auto&& watch : m_Watchers)
-			{
-				if (watch.path == path)
-				{
-					for (auto& call : watch.callbacks)
-					{
-						if (call.address == ptr) return;
-					}
-					Callback cb;
-					cb.func = callback;
-					cb.address = ptr;
-					watch.callbacks.emplace_back(Callback{ ptr, callback });
-					return;
-				}
-			}
-
-			FileInfo info = { };
-			info.path = path;
-			info.time = fs::last_write_time(path).time_since_epoch().count();
-			info.callbacks.emplace_back(Callback{ ptr, callback });
+		using Function = std::function<void(const std::string&)>;
 
-			m_Watchers.push_back(info);
-		}
-		void Unregister(void* ptr, const std::string& path)
-		{
-			for (i32 i = 0; i < (i32)m_Watchers.size(); i++)
-			{
-				auto& watch = m_Watchers[i];
-				if (watch.path == path)
-				{
-					for (i32 j = 0; j < (i32)watch.callbacks.size(); j++)
-					{
-						auto callback = watch.callbacks[j];
-						if (callback.address == ptr || ptr == nullptr)
-						{
-							watch.callbacks[j] = watch.callbacks.back();
-							watch.callbacks.pop_back();
-						}
-					}
-
-					if (watch.callbacks.size() > 0) continue;
-					m_Watchers[i] = m_Watchers.back();
-					m_Watchers.pop_back();
-					return;
-				}
-			}
-		}
-		void Update([[maybe_unused]] const f32 aDeltaTime)
-		{
-			std::vector<std::pair<std::string, std::function<void(const std::string&)>>> toUpdate;
-			for(auto& watch : m_Watchers)
-			{
-				if (watch.path.length() == 0) continue;
+		// Editors often save in several steps, the callbacks run once after the last of them.
+		static constexpr u32 DebounceMilliseconds = 50;
 
-				if (fs::exists(watch.path))
-				{
-					auto newTime = fs::last_write_time(watch.path).time_since_epoch().count();
-					if (watch.time < newTime)
-					{
-						for (auto&& callback : watch.callbacks)
-							callback.func(watch.path);
+		static FileWatcher* Get() { static FileWatcher* instance = new FileWatcher; return instance; }
+		void Register(void* ptr, const std::string& path, Function callback);
+		// A null ptr removes every callback of the path.
+		void Unregister(void* ptr, const std::string& path);
+		// Runs the callbacks of the files that settled since the last call.
+		void Update([[maybe_unused]] const f32 aDeltaTime);
+		// Stops the watching thread, files changed after this are not reported.
+		void Stop();
 
-						watch.time = newTime;
-					}
-				}
-				else
-				{
-					WARNING_LOG("File '%s' doesnt exist, removing watch..", watch.path.c_str());
-					Unregister(nullptr, watch.path);
-				}
-			}
-		}
 	private:
-		FileWatcher() : m_LastIndex(0) { m_Watchers.reserve(80); }
+		FileWatcher();
 		~FileWatcher() { }
 
 		struct Callback
 		{
 			void* address = nullptr;
-			std::function<void(const std::string&)> func;
+			Function func;
 		};
 
 		struct FileInfo
 		{
 			std::string path;
-			i64 time;
 			std::vector<Callback> callbacks;
 		};
-		std::vector<FileInfo> m_Watchers;
-		u64 m_LastIndex;
+
+		// Platform state of one watched directory, defined with the backend.
+		struct Directory;
+
+		// Absolute and lexically normal, lower case on Windows, so the path of an event matches the one registered.
+		static std::string GetKey(const fs::path& path);
+
+		bool WatchDirectory(const std::string& key);
+		void Run();
+		// Called on the watching thread for every change to a file in a watched directory.
+		void OnChange(const std::string& key, u64 now);
+		void PublishSettled(u64 now);
+		static u64 GetMilliseconds();
+
+		// Only touched by the main thread.
+		std::unordered_map<std::string, FileInfo> m_Files;
+		std::unordered_map<std::string, Directory*> m_Directories;
+		std::vector<std::string> m_Changed;
+
+		// Only touched by the watching thread, the last time each changed file was touched.
+		std::unordered_map<std::string, u64> m_Pending;
+
+		std::mutex m_Mutex;
+		std::vector<std::string> m_Settled;
+		std::atomic<bool> m_HasSettled;
+		// Watch descriptors to directories on Linux, filled by the main thread, the watching thread drops lost ones.
+		std::unordered_map<i32, Directory*> m_Watches;
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Running;
+		// The inotify instance and an eventfd to wake the thread on Linux, an I/O completion port on Windows.
+		i64 m_Handle;
+		i64 m_Wake;
 	};
 }
-namespace fw = frostwave;
\ No newline at end of file
+namespace fw = frostwave;
@@ -3,6 +3,7 @@
 #include <Engine/Memory/Allocator.h>
 #include <Engine/Graphics/Error.h>
 #include <Engine/Graphics/Framework.h>
+#include <Engine/Profiling/Metrics.h>
 #include <cassert>
 #include <d3d11.h>
 
@@ -12,6 +13,7 @@ struct frostwave::Buffer::Data
 	BufferType bindFlags;
 	u32 stride;
 };
+FW_REGISTER_POOL(frostwave::Buffer::Data, 256)
 
 frostwave::Buffer::Buffer() : m_Data(nullptr)
 {
@@ -81,6 +83,7 @@ void frostwave::Buffer::Bind(i32 slot) const
 		return;
 	}
 
+	FW_METRIC_ADD(metrics::BufferBinds, 1);
 	auto* context = Framework::GetContext();
 	const u32 offset = 0;
 
@@ -106,6 +109,7 @@ void frostwave::Buffer::SetData(void* data, u32 size)
 {
 	memcpy(Map(), data, size);
 	Unmap();
+	FW_METRIC_ADD(metrics::UploadedBytes, size);
 }
 
 void* frostwave::Buffer::Map()
@@ -115,6 +119,7 @@ void* frostwave::Buffer::Map()
 		ERROR_LOG("Buffer not Inititalized!");
 		return nullptr;
 	}
+	FW_METRIC_ADD(metrics::BufferUploads, 1);
 	D3D11_MAPPED_SUBRESOURCE subres;
 	memset(&subres, 0, sizeof(D3D11_MAPPED_SUBRESOURCE));
 
@@ -1,9 +1,8 @@
 #include "Camera.h"
-#include <Engine/Core/Math/Mat3.h>
 #include <Engine/Platform/Window.h>
 #include <Windows.h>
 
-frostwave::Camera::Camera() : m_FOV(0), m_Far(0), m_Near(0), m_Position(0, 0, 0), m_View(), m_Projection()
+frostwave::Camera::Camera() : m_FOV(0), m_Far(0), m_Near(0), m_Position(0, 0, 0), m_View(), m_Projection(), m_InverseView(), m_InverseProjection()
 {
 }
 
@@ -16,28 +15,18 @@ void frostwave::Camera::Init(f32 fov, f32 aspect, f32 nearZ, f32 farZ)
 	m_FOV = fov;
 	m_Near = nearZ;
 	m_Far = farZ;
-	m_Projection = Mat4f::CreatePerspectiveProjection(m_FOV, aspect, m_Near, m_Far);
+	SetAspect(aspect);
 
 	Window::Get()->Subscribe(WM_SIZE, [&](auto, auto) {
-		m_Projection = Mat4f::CreatePerspectiveProjection(m_FOV, (f32)Window::Get()->GetWidth() / (f32)Window::Get()->GetHeight(), m_Near, m_Far);
+		SetAspect((f32)Window::Get()->GetWidth() / (f32)Window::Get()->GetHeight());
 	});
 }
 
 void frostwave::Camera::Update()
 {
-	Mat4f transform = Mat4f::CreateTransform(m_Position, m_Rotation, { 1.0f, 1.0f, 1.0f });
-
-	Mat3f transposed = transform;
-	transposed = Mat3f::Transpose(transposed);
-	Vec3f negated(-transform.m_Numbers[12], -transform.m_Numbers[13], -transform.m_Numbers[14]);
-	negated *= transposed;
-	
-	m_View = {
-		transposed.m_Numbers[0],	transposed.m_Numbers[1],	transposed.m_Numbers[2],	0,
-		transposed.m_Numbers[3],	transposed.m_Numbers[4],	transposed.m_Numbers[5],	0,
-		transposed.m_Numbers[6],	transposed.m_Numbers[7],	transposed.m_Numbers[8],	0,
-		negated.x,					negated.y,					negated.z,					1
-	};
+	// The camera transform is what the view inverts, so both come out of the rigid inverse for free.
+	m_InverseView = Mat4f::CreateTransform(m_Position, m_Rotation, { 1.0f, 1.0f, 1.0f });
+	m_View = Mat4f::InverseRigid(m_InverseView);
 }
 
 const fw::Mat4f& frostwave::Camera::GetProjection() const
@@ -50,6 +39,16 @@ const fw::Mat4f& frostwave::Camera::GetView() const
 	return m_View;
 }
 
+const fw::Mat4f& frostwave::Camera::GetInverseProjection() const
+{
+	return m_InverseProjection;
+}
+
+const fw::Mat4f& frostwave::Camera::GetInverseView() const
+{
+	return m_InverseView;
+}
+
 void frostwave::Camera::SetPosition(const Vec3f& position)
 {
 	m_Position = position;
@@ -79,3 +78,9 @@ f32 frostwave::Camera::GetFarPlane()
 {
 	return m_Far;
 }
+
+void frostwave::Camera::SetAspect(f32 aspect)
+{
+	m_Projection = Mat4f::CreatePerspectiveProjection(m_FOV, aspect, m_Near, m_Far);
+	m_InverseProjection = Mat4f::Inverse(m_Projection);
+}
@@ -4,6 +4,9 @@
 
 namespace frostwave
 {
+#pragma warning(push)
+	// The Mat4f and Quatf members are 16 byte aligned, so the class gets padded around them.
+#pragma warning(disable: 4324)
 	class Camera
 	{
 	public:
@@ -15,6 +18,8 @@ namespace frostwave
 
 		const Mat4f& GetProjection() const;
 		const Mat4f& GetView() const;
+		const Mat4f& GetInverseProjection() const;
+		const Mat4f& GetInverseView() const;
 
 		void SetPosition(const Vec3f& position);
 		const Vec3f& GetPosition() const;
@@ -25,10 +30,14 @@ namespace frostwave
 		f32 GetFarPlane();
 
 	private:
+		void SetAspect(f32 aspect);
+
 		Mat4f m_View, m_Projection;
+		Mat4f m_InverseView, m_InverseProjection;
 		Vec3f m_Position;
 		Quatf m_Rotation;
 		f32 m_FOV, m_Near, m_Far;
 	};
+#pragma warning(pop)
 }
 namespace fw = frostwave;
\ No newline at end of file
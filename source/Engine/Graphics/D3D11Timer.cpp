@@ -0,0 +1,97 @@
+#include "GpuTimer.h"
+#include <Engine/Graphics/Framework.h>
+#include <Engine/Graphics/Error.h>
+#include <d3d11.h>
+
+frostwave::D3D11Timer::D3D11Timer() : m_TimestampsPerFrame(0)
+{
+}
+
+frostwave::D3D11Timer::~D3D11Timer()
+{
+	Shutdown();
+}
+
+bool frostwave::D3D11Timer::Init(u32 frameCount, u32 timestampsPerFrame)
+{
+	m_TimestampsPerFrame = timestampsPerFrame;
+	m_Disjoint.assign(frameCount, nullptr);
+	m_Timestamps.assign((u64)frameCount * timestampsPerFrame, nullptr);
+
+	D3D11_QUERY_DESC disjointDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+	for (auto& query : m_Disjoint)
+	{
+		if (FAILED(Framework::GetDevice()->CreateQuery(&disjointDesc, &query)))
+		{
+			ERROR_LOG("Could not create timestamp disjoint query!");
+			Shutdown();
+			return false;
+		}
+	}
+
+	D3D11_QUERY_DESC timestampDesc = { D3D11_QUERY_TIMESTAMP, 0 };
+	for (auto& query : m_Timestamps)
+	{
+		if (FAILED(Framework::GetDevice()->CreateQuery(&timestampDesc, &query)))
+		{
+			ERROR_LOG("Could not create timestamp query!");
+			Shutdown();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void frostwave::D3D11Timer::Shutdown()
+{
+	for (auto& query : m_Disjoint)
+	{
+		if (query) SafeRelease(&query);
+	}
+	for (auto& query : m_Timestamps)
+	{
+		if (query) SafeRelease(&query);
+	}
+	m_Disjoint.clear();
+	m_Timestamps.clear();
+}
+
+void frostwave::D3D11Timer::BeginFrame(u32 frame)
+{
+	Framework::GetContext()->Begin(m_Disjoint[frame]);
+}
+
+void frostwave::D3D11Timer::Timestamp(u32 frame, u32 index)
+{
+	Framework::GetContext()->End(m_Timestamps[(u64)frame * m_TimestampsPerFrame + index]);
+}
+
+void frostwave::D3D11Timer::EndFrame(u32 frame)
+{
+	Framework::GetContext()->End(m_Disjoint[frame]);
+}
+
+frostwave::GPUTimer::Status frostwave::D3D11Timer::Resolve(u32 frame, u32 count, u64* timestamps, u64& frequency, bool wait)
+{
+	auto* context = Framework::GetContext();
+
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+	HRESULT result = context->GetData(m_Disjoint[frame], &disjoint, sizeof(disjoint), 0);
+	while (result == S_FALSE && wait)
+	{
+		result = context->GetData(m_Disjoint[frame], &disjoint, sizeof(disjoint), 0);
+	}
+	if (result == S_FALSE) return Status::Pending;
+	if (result != S_OK) return Status::Failed;
+	if (disjoint.Disjoint) return Status::Disjoint;
+
+	// The disjoint query ends after every timestamp of its frame, they are all available by now.
+	ID3D11Query** queries = m_Timestamps.data() + (u64)frame * m_TimestampsPerFrame;
+	for (u32 i = 0; i < count; ++i)
+	{
+		if (context->GetData(queries[i], &timestamps[i], sizeof(u64), 0) != S_OK) return Status::Failed;
+	}
+	frequency = disjoint.Frequency;
+	return Status::Ready;
+}
@@ -1,8 +1,38 @@
 #include "DeferredRenderer.h"
 #include <Engine/Graphics/Framework.h>
 #include <Engine/Core/Math/Vec.h>
+#include <Engine/Profiling/Metrics.h>
 #include <d3d11.h>
 
+namespace
+{
+	using frostwave::Mat4f;
+	using frostwave::Vec3f;
+
+	// View * projection through each face of a cube from its center, in the face order of cube textures.
+	// Worked out by the compiler, the cubemap passes only copy them.
+	constexpr Mat4f CubeFaceProjection = Mat4f::CreatePerspectiveProjection(90.0f, 1, 0.1f, 10.0f);
+	constexpr Mat4f CubeFaceViewProjections[6] = {
+		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(-1.0f, 0.0f, 0.0f),  Vec3f(0.0f, 1.0f, 0.0f)) * CubeFaceProjection,
+		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(1.0f, 0.0f, 0.0f),   Vec3f(0.0f, 1.0f, 0.0f)) * CubeFaceProjection,
+		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 1.0f, 0.0f),   Vec3f(0.0f, 0.0f, -1.0f)) * CubeFaceProjection,
+		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, -1.0f, 0.0f),  Vec3f(0.0f, 0.0f, 1.0f)) * CubeFaceProjection,
+		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 0.0f, 1.0f),   Vec3f(0.0f, 1.0f, 0.0f)) * CubeFaceProjection,
+		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 0.0f, -1.0f),  Vec3f(0.0f, 1.0f, 0.0f)) * CubeFaceProjection
+	};
+
+	// Constant buffer of the cubemap passes, only the prefilter pass reads roughness.
+#pragma warning(push)
+	// roughness is padded out to the 16 byte alignment of the matrices.
+#pragma warning(disable: 4324)
+	struct CubeFaceFrameBuffer
+	{
+		Mat4f VP[6];
+		f32 roughness;
+	};
+#pragma warning(pop)
+}
+
 frostwave::DeferredRenderer::DeferredRenderer()
 {
 }
@@ -44,28 +74,13 @@ frostwave::Texture* frostwave::DeferredRenderer::GenerateCubemap(Texture* hdriTe
 	cubemapTexture->Create(texInfo);
 	cubemapTexture->Clear({ 0, 0, 0, 0 });
 
-	Mat4f proj = Mat4f::CreatePerspectiveProjection(90.0f, 1, 0.1f, 10.0f);
-
-	Mat4f views[6] = {
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(-1.0f, 0.0f, 0.0f),   Vec3f(0.0f, 1.0f, 0.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(1.0f, 0.0f, 0.0f),  Vec3f(0.0f, 1.0f, 0.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 1.0f, 0.0f),   Vec3f(0.0f, 0.0f, -1.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, -1.0f, 0.0f),  Vec3f(0.0f, 0.0f, 1.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 0.0f, 1.0f),   Vec3f(0.0f, 1.0f, 0.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 0.0f, -1.0f),  Vec3f(0.0f, 1.0f, 0.0f))
-	};
-
-	struct FrameBuffer
-	{
-		Mat4f VP[6];
-		f32 roughness;
-	} frameBufferData;
+	CubeFaceFrameBuffer frameBufferData;
 
 	for (i32 i = 0; i < 6; i++)
-		frameBufferData.VP[i] = views[i] * proj;
+		frameBufferData.VP[i] = CubeFaceViewProjections[i];
 
 	Buffer* frameBuffer = Allocate();
-	frameBuffer->Init(sizeof(FrameBuffer), BufferUsage::Dynamic, BufferType::Constant, 0, &frameBufferData);
+	frameBuffer->Init(sizeof(CubeFaceFrameBuffer), BufferUsage::Dynamic, BufferType::Constant, 0, &frameBufferData);
 
 	Shader generateCubemapShader(Shader::Type::Pixel | Shader::Type::Vertex | Shader::Type::Geometry,
 		"../source/Engine/Shaders/generate_cubemap_ps.fx",
@@ -92,6 +107,8 @@ frostwave::Texture* frostwave::DeferredRenderer::GenerateCubemap(Texture* hdriTe
 	cubeMesh->indexBuffer.Bind();
 	context->IASetPrimitiveTopology((D3D11_PRIMITIVE_TOPOLOGY)cubeMesh->topology);
 	context->DrawIndexed(cubeMesh->indexCount, 0, 0);
+	FW_METRIC_ADD(metrics::DrawCalls, 1);
+	FW_METRIC_ADD(metrics::DrawnIndices, cubeMesh->indexCount);
 
 	context->GSSetShader(nullptr, nullptr, 0);
 
@@ -127,28 +144,13 @@ void frostwave::DeferredRenderer::ConvoluteCubemap(Texture* environmentMap)
 	m_IrradianceTexture->Create(texInfo);
 	m_IrradianceTexture->Clear({ 0, 0, 0, 0 });
 
-	Mat4f proj = Mat4f::CreatePerspectiveProjection(90.0f, 1, 0.1f, 10.0f);
-
-	Mat4f views[6] = {
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(-1.0f, 0.0f, 0.0f),   Vec3f(0.0f, 1.0f, 0.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(1.0f, 0.0f, 0.0f),  Vec3f(0.0f, 1.0f, 0.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 1.0f, 0.0f),   Vec3f(0.0f, 0.0f, -1.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, -1.0f, 0.0f),  Vec3f(0.0f, 0.0f, 1.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 0.0f, 1.0f),   Vec3f(0.0f, 1.0f, 0.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 0.0f, -1.0f),  Vec3f(0.0f, 1.0f, 0.0f))
-	};
-
-	struct FrameBuffer
-	{
-		Mat4f VP[6];
-		f32 roughness;
-	} frameBufferData;
+	CubeFaceFrameBuffer frameBufferData;
 
 	for (i32 i = 0; i < 6; i++)
-		frameBufferData.VP[i] = views[i] * proj;
+		frameBufferData.VP[i] = CubeFaceViewProjections[i];
 
 	Buffer* frameBuffer = Allocate();
-	frameBuffer->Init(sizeof(FrameBuffer), BufferUsage::Dynamic, BufferType::Constant, 0, &frameBufferData);
+	frameBuffer->Init(sizeof(CubeFaceFrameBuffer), BufferUsage::Dynamic, BufferType::Constant, 0, &frameBufferData);
 
 	Shader generateCubemapShader(Shader::Type::Pixel | Shader::Type::Vertex | Shader::Type::Geometry,
 		"../source/Engine/Shaders/generate_irradiance_map_ps.fx",
@@ -175,6 +177,8 @@ void frostwave::DeferredRenderer::ConvoluteCubemap(Texture* environmentMap)
 	cubeMesh->indexBuffer.Bind();
 	context->IASetPrimitiveTopology((D3D11_PRIMITIVE_TOPOLOGY)cubeMesh->topology);
 	context->DrawIndexed(cubeMesh->indexCount, 0, 0);
+	FW_METRIC_ADD(metrics::DrawCalls, 1);
+	FW_METRIC_ADD(metrics::DrawnIndices, cubeMesh->indexCount);
 
 	context->GSSetShader(nullptr, nullptr, 0);
 
@@ -200,28 +204,13 @@ void frostwave::DeferredRenderer::PrefilterSpecularCubemap(Texture* environmentM
 		});
 	m_PrefilteredTexture->Clear({ 0, 0, 0, 0 });
 
-	Mat4f proj = Mat4f::CreatePerspectiveProjection(90.0f, 1, 0.1f, 10.0f);
-
-	Mat4f views[6] = {
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(-1.0f, 0.0f, 0.0f),   Vec3f(0.0f, 1.0f, 0.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(1.0f, 0.0f, 0.0f),  Vec3f(0.0f, 1.0f, 0.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 1.0f, 0.0f),   Vec3f(0.0f, 0.0f, -1.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, -1.0f, 0.0f),  Vec3f(0.0f, 0.0f, 1.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 0.0f, 1.0f),   Vec3f(0.0f, 1.0f, 0.0f)),
-		Mat4f::CreateLookAt(Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 0.0f, -1.0f),  Vec3f(0.0f, 1.0f, 0.0f))
-	};
-
-	struct FrameBuffer
-	{
-		Mat4f VP[6];
-		f32 roughness;
-	} frameBufferData;
+	CubeFaceFrameBuffer frameBufferData;
 
 	for (i32 i = 0; i < 6; i++)
-		frameBufferData.VP[i] = views[i] * proj;
+		frameBufferData.VP[i] = CubeFaceViewProjections[i];
 
 	Buffer* frameBuffer = Allocate();
-	frameBuffer->Init(sizeof(FrameBuffer), BufferUsage::Dynamic, BufferType::Constant, 0, &frameBufferData);
+	frameBuffer->Init(sizeof(CubeFaceFrameBuffer), BufferUsage::Dynamic, BufferType::Constant, 0, &frameBufferData);
 
 	Shader generateCubemapShader(Shader::Type::Pixel | Shader::Type::Vertex | Shader::Type::Geometry,
 		"../source/Engine/Shaders/generate_prefiltered_map_ps.fx",
@@ -231,12 +220,13 @@ void frostwave::DeferredRenderer::PrefilterSpecularCubemap(Texture* environmentM
 	auto* context = Framework::GetContext();
 	Model* cube = Model::GetCube();
 
+	static constexpr GPUMarker mipMarkers[] = { "Mip: 128x128", "Mip: 64x64", "Mip: 32x32", "Mip: 16x16", "Mip: 8x8" };
 	u32 maxMipLevels = 5;
 	for (u32 mip = 0; mip < maxMipLevels; ++mip)
 	{
 		u32 mipWidth = (u32)(128 * std::pow(0.5, mip));
 		u32 mipHeight = (u32)(128 * std::pow(0.5, mip));
-		Framework::BeginEvent("Mip: " + std::to_string(mipWidth) + "x" + std::to_string(mipHeight));
+		Framework::BeginEvent(mipMarkers[mip]);
 
 		//Render the cubemap
 		auto* renderTarget = m_PrefilteredTexture->CreateRenderTargetViewForMip(mip, true);
@@ -259,6 +249,8 @@ void frostwave::DeferredRenderer::PrefilterSpecularCubemap(Texture* environmentM
 		cubeMesh->indexBuffer.Bind();
 		context->IASetPrimitiveTopology((D3D11_PRIMITIVE_TOPOLOGY)cubeMesh->topology);
 		context->DrawIndexed(cubeMesh->indexCount, 0, 0);
+		FW_METRIC_ADD(metrics::DrawCalls, 1);
+		FW_METRIC_ADD(metrics::DrawnIndices, cubeMesh->indexCount);
 		renderTarget->Release();
 		Framework::EndEvent();
 	}
@@ -294,16 +286,17 @@ void frostwave::DeferredRenderer::GenerateBRDFTexture()
 	context->IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
 	context->IASetIndexBuffer(nullptr, DXGI_FORMAT_UNKNOWN, 0);
 	context->Draw(3, 0);
+	FW_METRIC_ADD(metrics::DrawCalls, 1);
 
 	Framework::EndEvent();
 }
 
-void frostwave::DeferredRenderer::RenderGeometry(f32, Camera* camera)
+void frostwave::DeferredRenderer::RenderGeometry(f64, Camera* camera)
 {
 	m_GeometryFrameBufferData.view = camera->GetView();
 	m_GeometryFrameBufferData.projection = camera->GetProjection();
-	m_GeometryFrameBufferData.invProjection = Mat4f::Inverse(camera->GetProjection());
-	m_GeometryFrameBufferData.invView = Mat4f::Inverse(camera->GetView());
+	m_GeometryFrameBufferData.invProjection = camera->GetInverseProjection();
+	m_GeometryFrameBufferData.invView = camera->GetInverseView();
 	m_GeometryFrameBufferData.cameraPos = Vec4f(camera->GetPosition(), 1.0f);
 	m_GeometryFrameBufferData.nearZ = camera->GetNearPlane();
 	m_GeometryFrameBufferData.farZ = camera->GetFarPlane();
@@ -350,12 +343,14 @@ void frostwave::DeferredRenderer::RenderGeometry(f32, Camera* camera)
 
 			context->IASetPrimitiveTopology((D3D11_PRIMITIVE_TOPOLOGY)mesh->topology);
 			context->DrawIndexed(mesh->indexCount, 0, 0);
+			FW_METRIC_ADD(metrics::DrawCalls, 1);
+			FW_METRIC_ADD(metrics::DrawnIndices, mesh->indexCount);
 		}
 	}
 	m_Models.clear();
 }
 
-void frostwave::DeferredRenderer::RenderLighting(f32 totalTime, RenderStateManager* stateManager)
+void frostwave::DeferredRenderer::RenderLighting(f64 totalTime, RenderStateManager* stateManager)
 {
 	totalTime;
 	ID3D11DeviceContext* context = Framework::GetContext();
@@ -379,6 +374,7 @@ void frostwave::DeferredRenderer::RenderLighting(f32 totalTime, RenderStateManag
 		context->IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
 		context->IASetIndexBuffer(nullptr, DXGI_FORMAT_UNKNOWN, 0);
 		context->Draw(3, 0);
+		FW_METRIC_ADD(metrics::DrawCalls, 1);
 	}
 	Framework::EndEvent();
 
@@ -400,6 +396,7 @@ void frostwave::DeferredRenderer::RenderLighting(f32 totalTime, RenderStateManag
 		context->IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
 		context->IASetIndexBuffer(nullptr, DXGI_FORMAT_UNKNOWN, 0);
 		context->Draw(3, 0);
+		FW_METRIC_ADD(metrics::DrawCalls, 1);
 	}
 	Framework::EndEvent();
 	m_DirectionalLights.clear();
@@ -428,6 +425,8 @@ void frostwave::DeferredRenderer::RenderLighting(f32 totalTime, RenderStateManag
 
 			context->IASetPrimitiveTopology((D3D11_PRIMITIVE_TOPOLOGY)mesh->topology);
 			context->DrawIndexed(mesh->indexCount, 0, 0);
+			FW_METRIC_ADD(metrics::DrawCalls, 1);
+			FW_METRIC_ADD(metrics::DrawnIndices, mesh->indexCount);
 		}
 	}
 	Framework::EndEvent();
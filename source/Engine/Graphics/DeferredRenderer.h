@@ -10,6 +10,7 @@
 #include <Engine/Graphics/Lights.h>
 #include <Engine/Graphics/Material.h>
 #include <Engine/Graphics/RenderStateManager.h>
+#include <Engine/Memory/Arena.h>
 
 namespace frostwave
 {
@@ -24,8 +25,8 @@ namespace frostwave
 		Texture* GenerateCubemap(Texture* hdriTexture);
 		void PrefilterPBRTextures(Texture* environmentMap);
 
-		void RenderGeometry(f32 totalTime, Camera* camera);
-		void RenderLighting(f32 totalTime, RenderStateManager* stateManager);
+		void RenderGeometry(f64 totalTime, Camera* camera);
+		void RenderLighting(f64 totalTime, RenderStateManager* stateManager);
 
 		void Submit(Model* model);
 		void Submit(PointLight* light);
@@ -36,9 +37,9 @@ namespace frostwave
 		void PrefilterSpecularCubemap(Texture* environmentMap);
 		void GenerateBRDFTexture();
 
-		std::vector<Model*> m_Models;
-		std::vector<PointLight*> m_PointLights;
-		std::vector<DirectionalLight*> m_DirectionalLights;
+		FrameVector<Model*> m_Models;
+		FrameVector<PointLight*> m_PointLights;
+		FrameVector<DirectionalLight*> m_DirectionalLights;
 
 		Buffer m_GeometryFrameBuffer, m_ObjectBuffer, m_LightingBuffer;
 		Shader m_RenderGeometryShader, m_PointLightShader, m_AmbientLightShader, m_DirectionalLightShader;
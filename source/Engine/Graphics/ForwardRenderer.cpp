@@ -5,6 +5,7 @@
 #include <Engine/Graphics/Framework.h>
 #include <Engine/Graphics/imgui/imgui.h>
 #include <Engine/Graphics/imgui/imguizmo/ImGuizmo.h>
+#include <Engine/Profiling/Metrics.h>
 #include <algorithm>
 #include <d3d11.h>
 
@@ -22,7 +23,7 @@ void frostwave::ForwardRenderer::Init()
 	m_ObjectBuffer.Init(sizeof(ObjectBuffer), BufferUsage::Dynamic, BufferType::Constant, 0, &m_ObjectBufferData);
 }
 
-void frostwave::ForwardRenderer::Render(f32 totalTime, Camera* camera)
+void frostwave::ForwardRenderer::Render(f64 totalTime, Camera* camera)
 {
 	totalTime;
 	m_FrameBufferData.projection = camera->GetProjection();
@@ -31,13 +32,8 @@ void frostwave::ForwardRenderer::Render(f32 totalTime, Camera* camera)
 	m_FrameBufferData.lightColor = Vec4f(1, 1, 1, 1);
 	m_FrameBufferData.lightDir = Vec4f(1, 1, 1, 0);
 
-	memset(m_FrameBufferData.lights, 0, sizeof(PointLight) * 8);
+	memset(m_FrameBufferData.lights, 0, sizeof(m_FrameBufferData.lights));
 
-	for (size_t i = 0; i < m_Lights.size(); i++)
-	{
-		if (i >= 32) break;
-		m_FrameBufferData.lights[i] = m_Lights[i];
-	}
 	m_FrameBuffer.SetData(m_FrameBufferData);
 	m_FrameBuffer.Bind(0);
 
@@ -77,11 +73,12 @@ void frostwave::ForwardRenderer::Render(f32 totalTime, Camera* camera)
 
 			context->IASetPrimitiveTopology((D3D11_PRIMITIVE_TOPOLOGY)mesh->topology);
 			context->DrawIndexed(mesh->indexCount, 0, 0);
+			FW_METRIC_ADD(metrics::DrawCalls, 1);
+			FW_METRIC_ADD(metrics::DrawnIndices, mesh->indexCount);
 		}
 	}
 
 	m_Models.clear();
-	m_Lights.clear();
 }
 
 void frostwave::ForwardRenderer::Submit(Model* model)
@@ -89,11 +86,6 @@ void frostwave::ForwardRenderer::Submit(Model* model)
 	m_Models.push_back(model);
 }
 
-void frostwave::ForwardRenderer::Submit(const PointLight& light)
-{
-	m_Lights.push_back(light);
-}
-
 void frostwave::ForwardRenderer::Submit(Texture* envMap)
 {
 	m_EnvironmentMap = envMap;
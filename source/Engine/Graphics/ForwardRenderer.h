@@ -7,10 +7,13 @@
 #include <Engine/Graphics/Texture.h>
 #include <Engine/Graphics/Material.h>
 #include <Engine/Graphics/Lights.h>
-#include <vector>
+#include <Engine/Memory/Arena.h>
 
 namespace frostwave
 {
+#pragma warning(push)
+	// The constant buffer copies hold Mat4f and Vec4f, which pads the class to 16 bytes.
+#pragma warning(disable: 4324)
 	class ForwardRenderer
 	{
 	public:
@@ -18,14 +21,12 @@ namespace frostwave
 		virtual ~ForwardRenderer();
 
 		void Init();
-		void Render(f32 totalTime, Camera* camera);
+		void Render(f64 totalTime, Camera* camera);
 		void Submit(Model* model);
-		void Submit(const PointLight& light);
 		void Submit(Texture* envMap);
 
 	private:
-		std::vector<Model*> m_Models;
-		std::vector<PointLight> m_Lights;
+		FrameVector<Model*> m_Models;
 		Buffer m_FrameBuffer, m_ObjectBuffer;
 
 		Texture m_NullTexture;
@@ -49,4 +50,5 @@ namespace frostwave
 
 		Texture* m_EnvironmentMap;
 	};
+#pragma warning(pop)
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <Engine/Core/Types.h>
 #include <Engine/Memory/Allocator.h>
 #include <Engine/Graphics/Texture.h>
+#include <Engine/Profiling/Profiler.h>
 #include <Engine/Graphics/imgui/imgui.h>
 #include <Engine/Graphics/imgui/imgui_impl_dx11.h>
 #include <Engine/Graphics/imgui/imgui_impl_win32.h>
@@ -10,8 +11,6 @@
 #include <d3d11.h>
 #include <d3d11_1.h>
 #include <atlbase.h>
-#include <locale>
-#include <codecvt>
 #include <string>
 
 void* fw::Framework::s_Annot = nullptr;
@@ -19,6 +18,7 @@ ID3D11Debug* fw::Framework::s_Debug = nullptr;
 ID3D11Device* fw::Framework::s_Device = nullptr;
 ID3D11DeviceContext* fw::Framework::s_Context = nullptr;
 frostwave::GPUProfiler* fw::Framework::s_Profiler = nullptr;
+frostwave::GPUTimer* fw::Framework::s_GPUTimer = nullptr;
 
 struct frostwave::Framework::Data
 {
@@ -38,6 +38,7 @@ frostwave::Framework::~Framework()
 {
 	s_Profiler->Shutdown();
 	Free(s_Profiler);
+	Free(s_GPUTimer);
 
 	ImGui_ImplDX11_Shutdown();
 	ImGui_ImplWin32_Shutdown();
@@ -98,7 +99,7 @@ void frostwave::Framework::Init()
 		DXGI_ADAPTER_DESC adapterDescription;
 		a->GetDesc(&adapterDescription);
 
-		INFO_LOG("Found adapter: %ls VRAM: %umb", adapterDescription.Description, adapterDescription.DedicatedVideoMemory / (1024 * 1024));
+		INFO_LOG("Found adapter: %ls VRAM: %llumb", adapterDescription.Description, (u64)(adapterDescription.DedicatedVideoMemory / (1024 * 1024)));
 
 		if (adapter)
 		{
@@ -185,7 +186,14 @@ void frostwave::Framework::Init()
 	});
 
 	s_Profiler = Allocate();
-	s_Profiler->Init();
+	s_GPUTimer = Allocate<D3D11Timer>();
+	if (!s_Profiler->Init(s_GPUTimer))
+	{
+		WARNING_LOG("Timestamp queries are unavailable, GPU profiling falls back on CPU submission times");
+		Free(s_GPUTimer);
+		s_GPUTimer = Allocate<CPUClockTimer>();
+		s_Profiler->Init(s_GPUTimer);
+	}
 
 	VERBOSE_LOG("Finished Initializing Graphics Framework!");
 }
@@ -277,7 +285,7 @@ void frostwave::Framework::SetImGuiStyle()
 
 void frostwave::Framework::EndFrame()
 {
-	s_Profiler->WaitForDataAndUpdate();
+	s_Profiler->Collect();
 	s_Profiler->DrawDebug();
 
 	s_Profiler->EndFrame();
@@ -335,26 +343,37 @@ void frostwave::Framework::ReportLiveObjects()
 	}
 }
 
-void frostwave::Framework::BeginEvent(std::string name)
+void frostwave::Framework::BeginEvent(const GPUMarker& marker)
 {
+#if FW_PROFILE
+	// Every GPU event is a CPU scope as well, runtime names only have to be kept while a capture is running.
+	Profiler::BeginScope(marker.isLiteral ? marker.name : Profiler::IsCapturing() ? Profiler::Intern(marker.name) : "");
+#endif
 	if (!s_Annot)
 	{
 		ID3DUserDefinedAnnotation* annot = nullptr;
 		GetContext()->QueryInterface(__uuidof(ID3DUserDefinedAnnotation), (void**)&annot);
 		s_Annot = annot;
 	}
-	std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-	std::wstring wide = converter.from_bytes(name);
-	((ID3DUserDefinedAnnotation*)s_Annot)->BeginEvent(wide.c_str());
+	// Marker names are ASCII, longer ones are cut off.
+	wchar_t wide[GPUProfiler::MaxNameLength];
+	u32 length = 0;
+	for (; marker.name[length] && length < GPUProfiler::MaxNameLength - 1; ++length)
+		wide[length] = (wchar_t)marker.name[length];
+	wide[length] = L'\0';
+	((ID3DUserDefinedAnnotation*)s_Annot)->BeginEvent(wide);
 }
 
 void frostwave::Framework::EndEvent()
 {
+#if FW_PROFILE
+	Profiler::EndScope();
+#endif
 	if (!s_Annot) return;
 	((ID3DUserDefinedAnnotation*)s_Annot)->EndEvent();
 }
 
-void frostwave::Framework::Timestamp(std::string name)
+void frostwave::Framework::Timestamp(const GPUMarker& marker)
 {
-	s_Profiler->Timestamp(name);
+	s_Profiler->Timestamp(marker);
 }
@@ -30,9 +30,9 @@ namespace frostwave
 		static ID3D11DeviceContext* GetContext();
 		static void ReportLiveObjects();
 
-		static void BeginEvent(std::string name);
+		static void BeginEvent(const GPUMarker& marker);
 		static void EndEvent();
-		static void Timestamp(std::string name);
+		static void Timestamp(const GPUMarker& marker);
 
 	private:
 		struct Data;
@@ -42,6 +42,7 @@ namespace frostwave
 		static ID3D11Device* s_Device;
 		static ID3D11DeviceContext* s_Context;
 		static GPUProfiler* s_Profiler;
+		static GPUTimer* s_GPUTimer;
 
 		//void ptr because renderdoc bug?
 		static void* s_Annot;
@@ -1,160 +1,179 @@
 #include "GpuProfiler.h"
 #include <Engine/Logging/Logger.h>
-#include <Engine/Graphics/Framework.h>
 #include <Engine/Graphics/imgui/imgui.h>
-#include <Engine/Graphics/Error.h>
-#include <algorithm>
-#include <d3d11.h>
+#include <cstdio>
+#include <cstring>
 
 frostwave::GPUProfiler::GPUProfiler()
-	: m_FrameQuery(0),
-	m_FrameCollect(-1),
-	m_FrameCountAvg(0),
-	m_TBeginAvg(0.0f)
+	: m_Timer(nullptr),
+	m_Frames(),
+	m_Current(0),
+	m_Recording(false),
+	m_Markers(),
+	m_MarkerCount(0),
+	m_FrameSum(0.0),
+	m_FrameAverage(0.0),
+	m_WindowFrames(0),
+	m_ResolvedFrames(0),
+	m_DisjointFrames(0),
+	m_DroppedTimestamps(0)
 {
+	memset(m_Lookup, EmptyLookup, sizeof(m_Lookup));
 }
 
-bool frostwave::GPUProfiler::Init()
+bool frostwave::GPUProfiler::Init(GPUTimer* timer)
 {
-	D3D11_QUERY_DESC queryDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
-	if (FAILED(Framework::GetDevice()->CreateQuery(&queryDesc, &m_QueryDisjoint[0])))
-	{
-		ERROR_LOG("Could not create timestamp disjoint query for frame 0!");
-		return false;
-	}
-
-	if (FAILED(Framework::GetDevice()->CreateQuery(&queryDesc, &m_QueryDisjoint[1])))
-	{
-		ERROR_LOG("Could not create timestamp disjoint query for frame 1!");
-		return false;
-	}
-
+	if (!timer->Init(FrameLatency, TimestampsPerFrame)) return false;
+	m_Timer = timer;
 	return true;
 }
 
 void frostwave::GPUProfiler::Shutdown()
 {
-	if (m_QueryDisjoint[0])
-		SafeRelease(&m_QueryDisjoint[0]);
-
-	if (m_QueryDisjoint[1])
-		SafeRelease(&m_QueryDisjoint[1]);
-
-	for (auto& ts : m_TimeStamps)
-	{
-		auto& query = ts.query;
-		if (query[0])
-			SafeRelease(&query[0]);
-		if (query[1])
-			SafeRelease(&query[1]);
-	}
+	if (!m_Timer) return;
+	m_Timer->Shutdown();
+	m_Timer = nullptr;
 }
 
 void frostwave::GPUProfiler::BeginFrame()
 {
-	Framework::GetContext()->Begin(m_QueryDisjoint[m_FrameQuery]);
+	if (!m_Timer) return;
+
+	Frame& frame = m_Frames[m_Current];
+	if (frame.pending) Resolve(m_Current, true);
+
+	frame.count = 0;
+	m_Timer->BeginFrame(m_Current);
+	m_Recording = true;
 	Timestamp("Begin");
 }
 
-void frostwave::GPUProfiler::Timestamp(const std::string& id)
+void frostwave::GPUProfiler::Timestamp(const GPUMarker& marker)
 {
-	if(m_Indices.find(id) == m_Indices.end())
+	if (!m_Recording) return;
+
+	Frame& frame = m_Frames[m_Current];
+	u32 index = FindOrAddMarker(marker);
+	if (index == MaxMarkers || frame.count == TimestampsPerFrame)
 	{
-		m_TimeStamps.push_back({});
-		auto& info = m_TimeStamps.back();
-		info.id = id;
-		D3D11_QUERY_DESC queryDesc = { D3D11_QUERY_TIMESTAMP, 0 };
-		Framework::GetDevice()->CreateQuery(&queryDesc, &info.query[0]);
-		Framework::GetDevice()->CreateQuery(&queryDesc, &info.query[1]);
-		m_Indices[id] = m_TimeStamps.size() - 1;
+		m_DroppedTimestamps++;
+		return;
 	}
 
-	Framework::GetContext()->End(m_TimeStamps[m_Indices[id]].query[m_FrameQuery]);
+	m_Timer->Timestamp(m_Current, frame.count);
+	frame.markers[frame.count++] = (u8)index;
 }
 
 void frostwave::GPUProfiler::EndFrame()
 {
-	Framework::GetContext()->End(m_QueryDisjoint[m_FrameQuery]);
+	if (!m_Recording) return;
 
-	++m_FrameQuery &= 1;
+	m_Timer->EndFrame(m_Current);
+	m_Frames[m_Current].pending = true;
+	m_Current = (m_Current + 1) % FrameLatency;
+	m_Recording = false;
 }
 
-void frostwave::GPUProfiler::WaitForDataAndUpdate()
+void frostwave::GPUProfiler::Collect()
 {
-	if (m_FrameCollect < 0)
+	if (!m_Timer) return;
+
+	// Oldest first, a frame is never ready before the ones submitted ahead of it.
+	u32 open = m_Recording ? 1 : 0;
+	for (u32 i = open; i < FrameLatency; ++i)
 	{
-		// Haven't run enough frames yet to have data
-		m_FrameCollect = 0;
-		return;
+		u32 slot = (m_Current + i) % FrameLatency;
+		if (!m_Frames[slot].pending) continue;
+
+		Resolve(slot, false);
+		if (m_Frames[slot].pending) break;
 	}
+}
 
-	// Wait for data
-	while (Framework::GetContext()->GetData(m_QueryDisjoint[m_FrameCollect], NULL, 0, 0) == S_FALSE)
+void frostwave::GPUProfiler::DrawDebug()
+{
+	ImGui::Begin("GPU Profiling", 0, ImGuiWindowFlags_AlwaysAutoResize);
+	for (u32 i = 1; i < m_MarkerCount; ++i)
 	{
+		ImGui::Text("%s: %0.2f ms", m_Markers[i].name, 1000.0 * m_Markers[i].average);
 	}
+	ImGui::Text("GPU frame time: %0.2f ms", 1000.0 * m_FrameAverage);
+	if (m_DisjointFrames) ImGui::Text("Disjoint frames: %llu", m_DisjointFrames);
+	ImGui::End();
+}
 
-	int iFrame = m_FrameCollect;
-	++m_FrameCollect &= 1;
-
-	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT timestampDisjoint;
-	if (Framework::GetContext()->GetData(m_QueryDisjoint[iFrame], &timestampDisjoint, sizeof(timestampDisjoint), 0) != S_OK)
+const frostwave::GPUProfiler::Marker* frostwave::GPUProfiler::FindMarker(const GPUMarker& marker) const
+{
+	for (u32 i = (u32)(marker.id % LookupSize);; i = (i + 1) % LookupSize)
 	{
-		return;
+		if (m_Lookup[i] == EmptyLookup) return nullptr;
+		if (m_Markers[m_Lookup[i]].id == marker.id) return &m_Markers[m_Lookup[i]];
 	}
+}
 
-	if (timestampDisjoint.Disjoint)
+u32 frostwave::GPUProfiler::FindOrAddMarker(const GPUMarker& marker)
+{
+	// Twice as many slots as markers, the probe always reaches an empty one.
+	u32 i = (u32)(marker.id % LookupSize);
+	for (; m_Lookup[i] != EmptyLookup; i = (i + 1) % LookupSize)
 	{
-		// Throw out this frame's data
-		return;
+		if (m_Markers[m_Lookup[i]].id == marker.id) return m_Lookup[i];
 	}
 
-	UINT64 timestampPrev = 0;
-
-	for (auto& ts : m_TimeStamps)
+	if (m_MarkerCount == MaxMarkers)
 	{
-		UINT64 timestamp;
-		if (Framework::GetContext()->GetData(ts.query[iFrame], &timestamp, sizeof(UINT64), 0) != S_OK)
-		{
-			INFO_LOG("Couldn't retrieve timestamp query data for '%s'", ts.id.c_str());
-			return;
-		}
+		if (!m_DroppedTimestamps) WARNING_LOG("GPU profiler is out of markers, '%s' and any later ones are not timed", marker.name);
+		return MaxMarkers;
+	}
 
-		if (timestampPrev == 0) 
-			timestampPrev = timestamp;
+	Marker& info = m_Markers[m_MarkerCount];
+	info = { };
+	info.id = marker.id;
+	snprintf(info.name, sizeof(info.name), "%s", marker.name);
+	m_Lookup[i] = (u8)m_MarkerCount;
+	return m_MarkerCount++;
+}
 
-		f32 diff = f32(timestamp - timestampPrev);
-		ts.dt = diff / f32(timestampDisjoint.Frequency);
-		timestampPrev = timestamp;
+void frostwave::GPUProfiler::Resolve(u32 slot, bool wait)
+{
+	Frame& frame = m_Frames[slot];
+	u64 timestamps[TimestampsPerFrame];
+	u64 frequency = 0;
 
-		ts.totalAverage += ts.dt;
-	}
+	GPUTimer::Status status = m_Timer->Resolve(slot, frame.count, timestamps, frequency, wait);
+	if (status == GPUTimer::Status::Pending) return;
+	frame.pending = false;
 
-	++m_FrameCountAvg;
-	if (m_Timer.GetTotalTime() > m_TBeginAvg + 0.5f)
+	if (status != GPUTimer::Status::Ready || !frequency)
 	{
-		for (auto& ts : m_TimeStamps)
-		{
-			ts.average = ts.totalAverage / m_FrameCountAvg;
-			ts.totalAverage = 0.0f;
-		}
-
-		m_FrameCountAvg = 0;
-		m_TBeginAvg = m_Timer.GetTotalTime();
+		// Throw out this frame's data.
+		m_DisjointFrames++;
+		return;
 	}
 
-	m_Timer.Update();
-}
+	for (u32 i = 0; i < frame.count; ++i)
+		m_Markers[frame.markers[i]].last = 0.0;
 
-void frostwave::GPUProfiler::DrawDebug()
-{
-	ImGui::Begin("GPU Profiling", 0, ImGuiWindowFlags_AlwaysAutoResize);
-	float dTDrawTotal = 0.0f;
-	for (auto& ts : m_TimeStamps)
+	f64 secondsPerTick = 1.0 / (f64)frequency;
+	for (u32 i = 1; i < frame.count; ++i)
 	{
-		if (ts.id == "Begin") continue;
-		dTDrawTotal += ts.average;
-		ImGui::Text("%s: %0.2f ms", ts.id.c_str(), 1000.0f * ts.average);
+		Marker& marker = m_Markers[frame.markers[i]];
+		f64 dt = (f64)(timestamps[i] - timestamps[i - 1]) * secondsPerTick;
+		marker.last += dt;
+		marker.sum += dt;
+	}
+	m_FrameSum += frame.count ? (f64)(timestamps[frame.count - 1] - timestamps[0]) * secondsPerTick : 0.0;
+	m_ResolvedFrames++;
+
+	if (++m_WindowFrames == AverageFrames)
+	{
+		for (u32 i = 0; i < m_MarkerCount; ++i)
+		{
+			m_Markers[i].average = m_Markers[i].sum / AverageFrames;
+			m_Markers[i].sum = 0.0;
+		}
+		m_FrameAverage = m_FrameSum / AverageFrames;
+		m_FrameSum = 0.0;
+		m_WindowFrames = 0;
 	}
-	ImGui::Text("GPU frame time: %0.2f ms", 1000.0f * (dTDrawTotal));
-	ImGui::End();
 }
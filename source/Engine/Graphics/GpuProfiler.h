@@ -1,52 +1,115 @@
 #pragma once
-
-struct ID3D11DeviceContext;
-struct ID3D11Query;
-
-#include <Engine/Core/Timer.h>
-#include <unordered_map>
-#include <string>
-#include <vector>
+#include <Engine/Core/Types.h>
+#include <Engine/Graphics/GpuTimer.h>
 
 namespace frostwave
 {
+	// Names a GPU timestamp or event. A string literal is hashed at compile time, names built at runtime go
+	// through FromString and have to outlive the call they are passed to.
+	struct GPUMarker
+	{
+		template <u64 N>
+		consteval GPUMarker(const c8 (&literal)[N]) : id(Hash(literal)), name(literal), isLiteral(true) { }
+
+		static constexpr GPUMarker FromString(const c8* string) { return GPUMarker(Hash(string), string); }
+
+		// FNV-1a.
+		static constexpr u64 Hash(const c8* string)
+		{
+			u64 hash = 14695981039346656037ull;
+			for (; *string; ++string)
+				hash = (hash ^ (u8)*string) * 1099511628211ull;
+			return hash;
+		}
+
+		u64 id;
+		const c8* name;
+		bool isLiteral;
+
+	private:
+		constexpr GPUMarker(u64 id, const c8* name) : id(id), name(name), isLiteral(false) { }
+	};
+
+	// Times the GPU between markers. Frames are kept in a ring of FrameLatency so results are read a few
+	// frames late without stalling, a frame only waits when its slot in the ring comes around unresolved.
+	// Every marker, query and buffer is sized up front, recording a frame does not allocate.
 	class GPUProfiler
 	{
 	public:
+		static constexpr u32 FrameLatency = 3;
+		// Distinct markers, later ones are not timed.
+		static constexpr u32 MaxMarkers = 64;
+		// Timestamps per frame, later ones are dropped.
+		static constexpr u32 TimestampsPerFrame = 64;
+		// Averages are taken over this many resolved frames.
+		static constexpr u32 AverageFrames = 30;
+		static constexpr u32 MaxNameLength = 64;
+
+		// All times in seconds.
+		struct Marker
+		{
+			u64 id;
+			c8 name[MaxNameLength];
+			// Time since the previous timestamp of the frame, summed when a frame has the marker more than once.
+			f64 last;
+			f64 average;
+			f64 sum;
+		};
+
 		GPUProfiler();
 
-		bool Init();
+		// The profiler does not own the timer, it has to stay alive until Shutdown.
+		bool Init(GPUTimer* timer);
 		void Shutdown();
 
 		void BeginFrame();
-		void Timestamp(const std::string& gts);
+		void Timestamp(const GPUMarker& marker);
 		void EndFrame();
 
-		// Wait on GPU for last frame's data (not this frame's) to be available
-		void WaitForDataAndUpdate();
+		// Reads every frame that finished without waiting on the GPU.
+		void Collect();
 		void DrawDebug();
 
-	protected:
-		i32 m_FrameQuery;
-		i32 m_FrameCollect;
-		ID3D11Query* m_QueryDisjoint[2];
+		const Marker* FindMarker(const GPUMarker& marker) const;
+		const Marker* GetMarkers() const { return m_Markers; }
+		u32 GetMarkerCount() const { return m_MarkerCount; }
+		// Begin to the last timestamp of a frame.
+		f64 GetFrameAverage() const { return m_FrameAverage; }
+
+		u64 GetResolvedFrames() const { return m_ResolvedFrames; }
+		u64 GetDisjointFrames() const { return m_DisjointFrames; }
+		u64 GetDroppedTimestamps() const { return m_DroppedTimestamps; }
 
-		struct TimeStampInfo
+	private:
+		struct Frame
 		{
-			ID3D11Query* query[2];
-			std::string id;
-			f32 dt;
-			f32 average;
-			f32 totalAverage;
+			u8 markers[TimestampsPerFrame];
+			u32 count;
+			bool pending;
 		};
-		std::unordered_map<std::string, size_t> m_Indices;
-		std::vector<TimeStampInfo> m_TimeStamps;
 
-		i32 m_FrameCountAvg;
-		f32 m_TBeginAvg;
+		static constexpr u32 LookupSize = MaxMarkers * 2;
+		static constexpr u8 EmptyLookup = 0xff;
 
-		Timer m_Timer;
+		u32 FindOrAddMarker(const GPUMarker& marker);
+		void Resolve(u32 slot, bool wait);
+
+		GPUTimer* m_Timer;
+		Frame m_Frames[FrameLatency];
+		u32 m_Current;
+		bool m_Recording;
+
+		Marker m_Markers[MaxMarkers];
+		u8 m_Lookup[LookupSize];
+		u32 m_MarkerCount;
+
+		f64 m_FrameSum;
+		f64 m_FrameAverage;
+		u32 m_WindowFrames;
+
+		u64 m_ResolvedFrames;
+		u64 m_DisjointFrames;
+		u64 m_DroppedTimestamps;
 	};
 }
-
-namespace fw = frostwave;
\ No newline at end of file
+namespace fw = frostwave;
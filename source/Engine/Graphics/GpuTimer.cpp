@@ -0,0 +1,96 @@
+#include "GpuTimer.h"
+#include <chrono>
+
+frostwave::CPUClockTimer::CPUClockTimer() : m_TimestampsPerFrame(0)
+{
+}
+
+bool frostwave::CPUClockTimer::Init(u32 frameCount, u32 timestampsPerFrame)
+{
+	m_TimestampsPerFrame = timestampsPerFrame;
+	m_Timestamps.assign((u64)frameCount * timestampsPerFrame, 0);
+	return true;
+}
+
+void frostwave::CPUClockTimer::Shutdown()
+{
+	m_Timestamps.clear();
+}
+
+void frostwave::CPUClockTimer::BeginFrame([[maybe_unused]] u32 frame)
+{
+}
+
+void frostwave::CPUClockTimer::Timestamp(u32 frame, u32 index)
+{
+	m_Timestamps[(u64)frame * m_TimestampsPerFrame + index] = (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void frostwave::CPUClockTimer::EndFrame([[maybe_unused]] u32 frame)
+{
+}
+
+frostwave::GPUTimer::Status frostwave::CPUClockTimer::Resolve(u32 frame, u32 count, u64* timestamps, u64& frequency, [[maybe_unused]] bool wait)
+{
+	const u64* recorded = m_Timestamps.data() + (u64)frame * m_TimestampsPerFrame;
+	for (u32 i = 0; i < count; ++i)
+		timestamps[i] = recorded[i];
+	frequency = 1000000000;
+	return Status::Ready;
+}
+
+frostwave::FakeGPUTimer::FakeGPUTimer() : m_TimestampsPerFrame(0), m_Current(0), m_Clock(0), m_EndedFrames(0), m_Frequency(1000000000), m_TicksPerTimestamp(1000000), m_Latency(1)
+{
+}
+
+bool frostwave::FakeGPUTimer::Init(u32 frameCount, u32 timestampsPerFrame)
+{
+	m_TimestampsPerFrame = timestampsPerFrame;
+	m_Timestamps.assign((u64)frameCount * timestampsPerFrame, 0);
+	m_Frames.assign(frameCount, Frame{ });
+	return true;
+}
+
+void frostwave::FakeGPUTimer::Shutdown()
+{
+	m_Timestamps.clear();
+	m_Frames.clear();
+}
+
+void frostwave::FakeGPUTimer::BeginFrame(u32 frame)
+{
+	m_Current = frame;
+	m_Frames[frame] = Frame{ };
+}
+
+void frostwave::FakeGPUTimer::Timestamp(u32 frame, u32 index)
+{
+	m_Clock += m_TicksPerTimestamp;
+	m_Timestamps[(u64)frame * m_TimestampsPerFrame + index] = m_Clock;
+}
+
+void frostwave::FakeGPUTimer::EndFrame(u32 frame)
+{
+	m_Frames[frame].ended = true;
+	m_Frames[frame].endedAt = m_EndedFrames++;
+}
+
+void frostwave::FakeGPUTimer::MarkDisjoint()
+{
+	m_Frames[m_Current].disjoint = true;
+}
+
+frostwave::GPUTimer::Status frostwave::FakeGPUTimer::Resolve(u32 frame, u32 count, u64* timestamps, u64& frequency, bool wait)
+{
+	const Frame& info = m_Frames[frame];
+	if (!info.ended) return Status::Failed;
+	// Waiting stands in for the GPU catching up.
+	if (!wait && m_EndedFrames - info.endedAt <= m_Latency) return Status::Pending;
+	if (info.disjoint) return Status::Disjoint;
+
+	const u64* recorded = m_Timestamps.data() + (u64)frame * m_TimestampsPerFrame;
+	for (u32 i = 0; i < count; ++i)
+		timestamps[i] = recorded[i];
+	frequency = m_Frequency;
+	return Status::Ready;
+}
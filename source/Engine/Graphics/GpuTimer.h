@@ -0,0 +1,121 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <vector>
+
+struct ID3D11Query;
+
+namespace frostwave
+{
+	// Where GPUProfiler gets its timestamps from. Queries are addressed by the frame in flight and the
+	// position of the timestamp within that frame, all of them are created in Init so recording never allocates.
+	class GPUTimer
+	{
+	public:
+		enum class Status
+		{
+			// Not available yet, ask again later.
+			Pending,
+			Ready,
+			// The clock changed while the frame ran, its timestamps can not be compared.
+			Disjoint,
+			Failed,
+		};
+
+		virtual ~GPUTimer() = default;
+
+		virtual bool Init(u32 frameCount, u32 timestampsPerFrame) = 0;
+		virtual void Shutdown() = 0;
+
+		virtual void BeginFrame(u32 frame) = 0;
+		virtual void Timestamp(u32 frame, u32 index) = 0;
+		virtual void EndFrame(u32 frame) = 0;
+
+		// Reads the first count timestamps of an ended frame, frequency is in ticks per second.
+		virtual Status Resolve(u32 frame, u32 count, u64* timestamps, u64& frequency, bool wait) = 0;
+	};
+
+	// Timestamp and disjoint queries on the immediate context.
+	class D3D11Timer : public GPUTimer
+	{
+	public:
+		D3D11Timer();
+		~D3D11Timer() override;
+
+		bool Init(u32 frameCount, u32 timestampsPerFrame) override;
+		void Shutdown() override;
+
+		void BeginFrame(u32 frame) override;
+		void Timestamp(u32 frame, u32 index) override;
+		void EndFrame(u32 frame) override;
+
+		Status Resolve(u32 frame, u32 count, u64* timestamps, u64& frequency, bool wait) override;
+
+	private:
+		std::vector<ID3D11Query*> m_Disjoint;
+		std::vector<ID3D11Query*> m_Timestamps;
+		u32 m_TimestampsPerFrame;
+	};
+
+	// Falls back on the CPU clock when the device has no timestamp queries. What it measures is how long
+	// the CPU took to submit the work between two markers, not how long the GPU took to run it.
+	class CPUClockTimer : public GPUTimer
+	{
+	public:
+		CPUClockTimer();
+
+		bool Init(u32 frameCount, u32 timestampsPerFrame) override;
+		void Shutdown() override;
+
+		void BeginFrame(u32 frame) override;
+		void Timestamp(u32 frame, u32 index) override;
+		void EndFrame(u32 frame) override;
+
+		Status Resolve(u32 frame, u32 count, u64* timestamps, u64& frequency, bool wait) override;
+
+	private:
+		std::vector<u64> m_Timestamps;
+		u32 m_TimestampsPerFrame;
+	};
+
+	// Scripted timestamps for running the profiler without a device. Every timestamp advances the clock
+	// by the set amount of ticks and frames only resolve after the set number of later frames have ended.
+	class FakeGPUTimer : public GPUTimer
+	{
+	public:
+		FakeGPUTimer();
+
+		bool Init(u32 frameCount, u32 timestampsPerFrame) override;
+		void Shutdown() override;
+
+		void BeginFrame(u32 frame) override;
+		void Timestamp(u32 frame, u32 index) override;
+		void EndFrame(u32 frame) override;
+
+		Status Resolve(u32 frame, u32 count, u64* timestamps, u64& frequency, bool wait) override;
+
+		void SetFrequency(u64 frequency) { m_Frequency = frequency; }
+		void SetTicksPerTimestamp(u64 ticks) { m_TicksPerTimestamp = ticks; }
+		void SetLatency(u32 frames) { m_Latency = frames; }
+		// Reports the frame currently being recorded as disjoint.
+		void MarkDisjoint();
+
+	private:
+		struct Frame
+		{
+			u64 endedAt;
+			bool ended;
+			bool disjoint;
+		};
+
+		std::vector<u64> m_Timestamps;
+		std::vector<Frame> m_Frames;
+		u32 m_TimestampsPerFrame;
+		u32 m_Current;
+		u64 m_Clock;
+		u64 m_EndedFrames;
+		u64 m_Frequency;
+		u64 m_TicksPerTimestamp;
+		u32 m_Latency;
+	};
+}
+namespace fw = frostwave;
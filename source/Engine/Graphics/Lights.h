@@ -50,6 +50,9 @@ namespace frostwave
 		Texture* depth = nullptr;
 	};
 
+#pragma warning(push)
+	// m_ShadowData holds a Mat4f and starts on a 16 byte boundary.
+#pragma warning(disable: 4324)
 	class DirectionalLight : public BaseLight
 	{
 	public:
@@ -69,4 +72,9 @@ namespace frostwave
 		friend class ShadowRenderer;
 		DirectionalLightShadowData m_ShadowData;
 	};
-}
\ No newline at end of file
+#pragma warning(pop)
+}
+namespace fw = frostwave;
+
+FW_REGISTER_POOL(fw::PointLight, 64)
+FW_REGISTER_POOL(fw::DirectionalLight, 16)
\ No newline at end of file
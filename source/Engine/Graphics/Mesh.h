@@ -4,6 +4,7 @@
 #include <Engine/Graphics/Buffer.h>
 #include <Engine/Graphics/Texture.h>
 #include <Engine/Graphics/Shader.h>
+#include <Engine/Memory/Allocator.h>
 #include <vector>
 #include <array>
 
@@ -23,6 +24,9 @@ namespace frostwave
 		};
 	}
 
+#pragma warning(push)
+	// Padded out to a multiple of 16 bytes by the Vec4f members, the vertex stride is sizeof(Vertex).
+#pragma warning(disable: 4324)
 	struct Vertex
 	{
 		Vec4f position;
@@ -32,16 +36,20 @@ namespace frostwave
 		Vec4f color;
 		Vec2f uv;
 	};
+#pragma warning(pop)
 
 	struct Mesh
 	{
 		Mesh(std::vector<Vertex> vertices, std::vector<u32> indices, std::array<Texture*, (i32)MeshTextures::Count> inTextures) :
-			vertexCount((u32)vertices.size()),
-			indexCount((u32)indices.size()),
+			Mesh(vertices.data(), (u32)vertices.size(), indices.data(), (u32)indices.size(), inTextures) { }
+
+		Mesh(Vertex* vertices, u32 inVertexCount, u32* indices, u32 inIndexCount, std::array<Texture*, (i32)MeshTextures::Count> inTextures) :
+			vertexCount(inVertexCount),
+			indexCount(inIndexCount),
 			topology(4), //D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST
 			shader(),
-			vertexBuffer((u32)vertices.size() * sizeof(Vertex), BufferUsage::Immutable, BufferType::Vertex, sizeof(Vertex), vertices.data()),
-			indexBuffer((u32)indices.size() * sizeof(u32), BufferUsage::Immutable, BufferType::Index, sizeof(u32), indices.data()),
+			vertexBuffer(inVertexCount * sizeof(Vertex), BufferUsage::Immutable, BufferType::Vertex, sizeof(Vertex), vertices),
+			indexBuffer(inIndexCount * sizeof(u32), BufferUsage::Immutable, BufferType::Index, sizeof(u32), indices),
 			textures(inTextures) { }
 
 		std::array<Texture*, MeshTextures::Count> textures;
@@ -49,4 +57,7 @@ namespace frostwave
 		Shader shader;
 		u32 vertexCount, indexCount, topology;
 	};
-}
\ No newline at end of file
+}
+namespace fw = frostwave;
+
+FW_REGISTER_POOL(fw::Mesh, 128)
\ No newline at end of file
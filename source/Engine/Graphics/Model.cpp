@@ -5,7 +5,10 @@
 #include <Engine/Graphics/Framework.h>
 #include <Engine/Core/Common.h>
 #include <Engine/Memory/Allocator.h>
+#include <Engine/Memory/Arena.h>
+#include <Engine/Profiling/Profiler.h>
 #include <filesystem>
+#include <cstring>
 
 frostwave::Model::Model() : m_Scale(1, 1, 1)
 {
@@ -18,7 +21,7 @@ frostwave::Model::Model(const std::string& path) : m_Scale(1, 1, 1)
 
 frostwave::Model::~Model()
 {
-	for (auto* mesh : m_Meshes)
+	for (auto* mesh : GetMeshes())
 	{
 		for (auto* tex : mesh->textures)
 		{
@@ -27,10 +30,12 @@ frostwave::Model::~Model()
 		}
 		Free(mesh);
 	}
+	Allocator::Get()->FreeMovable(m_Meshes);
 }
 
 void frostwave::Model::Load(const std::string& path)
 {
+	FW_PROFILE_FUNCTION();
 	Assimp::Importer importer;
 	const aiScene* scene = importer.ReadFile(path, aiProcess_GenNormals | aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
 
@@ -49,7 +54,18 @@ void frostwave::Model::Load(const std::string& path)
 
 void frostwave::Model::AddMesh(Mesh* mesh)
 {
-	m_Meshes.push_back(mesh);
+	Allocator* allocator = Allocator::Get();
+	if (m_MeshCount == m_MeshCapacity)
+	{
+		u32 capacity = m_MeshCapacity ? m_MeshCapacity * 2 : 4;
+		MovableHandle meshes = allocator->AllocateMovable(Size::Bytes(capacity * sizeof(Mesh*)), typeid(Mesh*).name());
+		if (m_MeshCount)
+			memcpy(allocator->Resolve(meshes), allocator->Resolve(m_Meshes), m_MeshCount * sizeof(Mesh*));
+		allocator->FreeMovable(m_Meshes);
+		m_Meshes = meshes;
+		m_MeshCapacity = capacity;
+	}
+	((Mesh**)allocator->Resolve(m_Meshes))[m_MeshCount++] = mesh;
 }
 
 void frostwave::Model::SetPosition(const Vec3f& position)
@@ -86,9 +102,9 @@ void frostwave::Model::SetTransform(const Mat4f& transform)
 	m_Dirty = false;
 }
 
-const std::vector<frostwave::Mesh*>& frostwave::Model::GetMeshes() const
+std::span<frostwave::Mesh* const> frostwave::Model::GetMeshes() const
 {
-	return m_Meshes;
+	return { (Mesh**)Allocator::Get()->Resolve(m_Meshes), m_MeshCount };
 }
 
 const frostwave::Mat4f& frostwave::Model::GetTransform()
@@ -301,7 +317,7 @@ void frostwave::Model::ProcessNode(aiNode* node, const aiScene* scene)
 	for (u32 i = 0; i < node->mNumMeshes; ++i)
 	{
 		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		m_Meshes.push_back(ProcessMesh(mesh, scene));
+		AddMesh(ProcessMesh(mesh, scene));
 	}
 
 	for (u32 i = 0; i < node->mNumChildren; ++i)
@@ -312,13 +328,33 @@ void frostwave::Model::ProcessNode(aiNode* node, const aiScene* scene)
 
 frostwave::Mesh* frostwave::Model::ProcessMesh(aiMesh* mesh, const aiScene* scene)
 {
-	std::vector<Vertex> vertices;
-	std::vector<u32> indices;
 	std::array<Texture*, (i32)MeshTextures::Count> textures = { };
 
+	u32 indexCount = 0;
+	for (u32 i = 0; i < mesh->mNumFaces; ++i)
+	{
+		indexCount += mesh->mFaces[i].mNumIndices;
+	}
+
+	// Import scratch lives on the level arena and is gone once the buffers are created, meshes too large for it use the heap.
+	LinearArena* arena = LinearArena::Get(LinearArena::Scope::Level);
+	ArenaScope scope(arena);
+	Vertex* vertices = arena->TryPush<Vertex>(mesh->mNumVertices);
+	u32* indices = vertices ? arena->TryPush<u32>(indexCount) : nullptr;
+
+	std::vector<Vertex> heapVertices;
+	std::vector<u32> heapIndices;
+	if (!vertices || !indices)
+	{
+		heapVertices.resize(mesh->mNumVertices);
+		heapIndices.resize(indexCount);
+		vertices = heapVertices.data();
+		indices = heapIndices.data();
+	}
+
 	for (u32 i = 0; i < mesh->mNumVertices; ++i)
 	{
-		Vertex vertex;
+		Vertex& vertex = *new (&vertices[i]) Vertex();
 
 		vertex.position = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z, 1 };
 		vertex.normal = { mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z };
@@ -338,16 +374,15 @@ frostwave::Mesh* frostwave::Model::ProcessMesh(aiMesh* mesh, const aiScene* scen
 			vertex.color = Vec4f(mesh->mColors[0][i].r, mesh->mColors[0][i].g, mesh->mColors[0][i].b, mesh->mColors[0][i].a);
 		else
 			vertex.color = Vec4f(1, 1, 1, 1);
-
-		vertices.push_back(vertex);
 	}
 
+	u32 index = 0;
 	for (u32 i = 0; i < mesh->mNumFaces; ++i)
 	{
-		aiFace face = mesh->mFaces[i];
+		const aiFace& face = mesh->mFaces[i];
 		for (u32 j = 0; j < face.mNumIndices; ++j)
 		{
-			indices.push_back(face.mIndices[j]);
+			indices[index++] = face.mIndices[j];
 		}
 	}
 
@@ -364,7 +399,7 @@ frostwave::Mesh* frostwave::Model::ProcessMesh(aiMesh* mesh, const aiScene* scen
 		textures[MeshTextures::Emissive] = LoadMaterialTexture(material, aiTextureType_EMISSIVE);	// TEXTURE_DEFINITION_EMISSIVE
 	}
 
-	return Allocate<Mesh>(vertices, indices, textures);
+	return Allocate<Mesh>(vertices, mesh->mNumVertices, indices, indexCount, textures);
 }
 
 frostwave::Shader* frostwave::Model::GetShader()
@@ -3,9 +3,13 @@
 #include <Engine/Graphics/Material.h>
 #include <Engine/Core/Math/Mat4.h>
 #include <assimp/scene.h>
+#include <span>
 
 namespace frostwave
 {
+#pragma warning(push)
+	// m_Transform and m_Rotation are 16 byte aligned and padded to it.
+#pragma warning(disable: 4324)
 	class Model
 	{
 	public:
@@ -25,7 +29,8 @@ namespace frostwave
 
 		Shader* GetShader();
 
-		const std::vector<Mesh*>& GetMeshes() const;
+		// Only valid until the next Defragment, don't hold on to it across frames.
+		std::span<Mesh* const> GetMeshes() const;
 
 		const Mat4f& GetTransform();
 		Material& GetMaterial() { return m_Material; }
@@ -41,12 +46,17 @@ namespace frostwave
 		Material m_Material;
 		Shader m_Shader;
 
-		std::vector<Mesh*> m_Meshes;
+		// Movable so the allocator can compact it, grown by reallocating like a vector.
+		MovableHandle m_Meshes;
+		u32 m_MeshCount = 0, m_MeshCapacity = 0;
 		std::string m_Path, m_Name;
 		Mat4f m_Transform;
 		Vec3f m_Position, m_Scale;
 		Quatf m_Rotation;
 		bool m_Dirty;
 	};
+#pragma warning(pop)
 }
-namespace fw = frostwave;
\ No newline at end of file
+namespace fw = frostwave;
+
+FW_REGISTER_POOL(fw::Model, 64)
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "PostProcessor.h"
 #include <Engine/Graphics/Framework.h>
 #include <Engine/Memory/Allocator.h>
+#include <Engine/Profiling/Metrics.h>
 #include <cassert>
 #include <d3d11.h>
 
@@ -50,9 +51,9 @@ void frostwave::PostProcessor::Render(Texture* backBuffer, Camera* camera, Direc
 
 	m_FrameBufferData.view = camera->GetView();
 	m_FrameBufferData.projection = camera->GetProjection();
-	m_FrameBufferData.invProjection = Mat4f::Inverse(camera->GetProjection());
-	m_FrameBufferData.invView = Mat4f::Inverse(camera->GetView());
-	m_FrameBufferData.lightMatrix = light ? light->GetShadowData().viewProj : Mat4f();
+	m_FrameBufferData.invProjection = camera->GetInverseProjection();
+	m_FrameBufferData.invView = camera->GetInverseView();
+	m_FrameBufferData.lightMatrix = light ? light->GetShadowData().viewProj : Mat4f::Identity;
 	m_FrameBufferData.cameraPos = camera->GetPosition();
 	m_FrameBufferData.lightDirection = light ? light->GetDirection().GetNormalized() : Vec4f();
 	m_FrameBufferData.lightColor = light ? Vec4f(light->GetColor(), light->GetIntensity()) : Vec4f();
@@ -66,19 +67,20 @@ void frostwave::PostProcessor::Render(Texture* backBuffer, Camera* camera, Direc
 
 	for (auto&& tech : m_Techniques)
 	{
-		Framework::BeginEvent(tech.name);
+		GPUMarker marker = GPUMarker::FromString(tech.name.c_str());
+		Framework::BeginEvent(marker);
 		for (auto&& stage : tech.stages)
 		{
-			Framework::BeginEvent(stage.name);
+			Framework::BeginEvent(GPUMarker::FromString(stage.name.c_str()));
 			RenderStage(stage, backBuffer);
 			Framework::EndEvent();
 		}
-		Framework::Timestamp(tech.name);
+		Framework::Timestamp(marker);
 		Framework::EndEvent();
 	}
 }
 
-void frostwave::PostProcessor::Push(PostProcessStage stage)
+void frostwave::PostProcessor::Push(const PostProcessStage& stage)
 {
 	Technique technique;
 	technique.name = stage.name;
@@ -86,7 +88,7 @@ void frostwave::PostProcessor::Push(PostProcessStage stage)
 	m_Techniques.push_back(technique);
 }
 
-void frostwave::PostProcessor::Push(Technique tech)
+void frostwave::PostProcessor::Push(const Technique& tech)
 {
 	m_Techniques.push_back(tech);
 }
@@ -96,7 +98,7 @@ void frostwave::PostProcessor::Clear()
 	m_Techniques.clear();
 }
 
-void frostwave::PostProcessor::RenderStage(PostProcessStage stage, Texture* backBuffer)
+void frostwave::PostProcessor::RenderStage(const PostProcessStage& stage, Texture* backBuffer)
 {
 	if (!stage.renderToBackbuffer)
 	{
@@ -127,6 +129,7 @@ void frostwave::PostProcessor::RenderStage(PostProcessStage stage, Texture* back
 	context->IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
 	context->IASetIndexBuffer(nullptr, DXGI_FORMAT_UNKNOWN, 0);
 	context->Draw(3, 0);
+	FW_METRIC_ADD(metrics::DrawCalls, 1);
 
 	for (i32 i = 0; i < shaderResourceIndex; ++i)
 	{
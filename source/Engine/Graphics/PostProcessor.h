@@ -7,6 +7,7 @@
 #include <Engine/Graphics/Camera.h>
 #include <string>
 #include <vector>
+#include <memory_resource>
 
 namespace frostwave
 {
@@ -26,12 +27,12 @@ namespace frostwave
 	class Technique
 	{
 	public:
-		void Push(PostProcessStage stage) { stages.push_back(stage); }
+		void Push(const PostProcessStage& stage) { stages.push_back(stage); }
 
 		std::string name;
 	private:
 		friend class PostProcessor;
-		std::vector<PostProcessStage> stages;
+		std::pmr::vector<PostProcessStage> stages;
 	};
 
 	class PostProcessor
@@ -42,13 +43,13 @@ namespace frostwave
 
 		void Init();
 		void Render(Texture* backBuffer, Camera* camera, DirectionalLight* light);
-		void Push(PostProcessStage stage);
-		void Push(Technique tech);
+		void Push(const PostProcessStage& stage);
+		void Push(const Technique& tech);
 
 		void Clear();
 
 	private:
-		void RenderStage(PostProcessStage stage, Texture* backBuffer);
+		void RenderStage(const PostProcessStage& stage, Texture* backBuffer);
 
 		struct FrameBuffer
 		{
@@ -70,7 +71,7 @@ namespace frostwave
 
 		Buffer m_FrameBuffer;
 		Shader* m_FullscreenVertexShader;
-		std::vector<Technique> m_Techniques;
+		std::pmr::vector<Technique> m_Techniques;
 		std::vector<Vec4f> m_SSAOKernel;
 	};
 }
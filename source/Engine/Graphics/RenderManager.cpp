@@ -7,6 +7,8 @@
 #include <Engine/Graphics/ShadowRenderer.h>
 #include <Engine/Graphics/PostProcessor.h>
 #include <Engine/Graphics/Error.h>
+#include <Engine/Profiling/Profiler.h>
+#include <Engine/Profiling/Metrics.h>
 //#define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include <windows.h>
@@ -78,6 +80,7 @@ frostwave::RenderManager::~RenderManager()
 
 void frostwave::RenderManager::Init()
 {
+	FW_PROFILE_FUNCTION();
 	m_Framework->Init();
 
 	m_LinearClampSampler = Allocate<Sampler>(Sampler::Filter::Linear, Sampler::Address::Clamp, Vec4f());
@@ -158,8 +161,9 @@ void frostwave::RenderManager::Init()
 	m_SkyboxRenderer->SetTexture(m_EnvironmentMap);
 }
 
-void frostwave::RenderManager::Render(f32 totalTime, Camera* camera, bool renderToBackbuffer)
+void frostwave::RenderManager::Render(f64 totalTime, Camera* camera, bool renderToBackbuffer)
 {
+	FW_PROFILE_FUNCTION();
 	if (camera)
 	{
 
@@ -307,6 +311,7 @@ frostwave::Texture* frostwave::RenderManager::GetRenderedScene() const
 void frostwave::RenderManager::Submit(Model* model)
 {
 	if (!model) return;
+	FW_METRIC_ADD(metrics::SubmittedModels, 1);
 	m_ForwardRenderer->Submit(model);
 	m_DeferredRenderer->Submit(model);
 	m_ShadowRenderer->Submit(model);
@@ -323,7 +328,6 @@ void frostwave::RenderManager::Submit(DirectionalLight* light)
 void frostwave::RenderManager::Submit(PointLight* light)
 {
 	if (!light) return;
-	//m_ForwardRenderer->Submit(light);
 	m_DeferredRenderer->Submit(light);
 }
 
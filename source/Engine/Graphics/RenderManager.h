@@ -24,7 +24,7 @@ namespace frostwave
 
 		void Init();
 		void InitCubemap();
-		void Render(f32 totalTime, Camera* camera, bool renderToBackbuffer = true);
+		void Render(f64 totalTime, Camera* camera, bool renderToBackbuffer = true);
 
 		void BeginFrame();
 		void EndFrame();
@@ -1,5 +1,7 @@
 #include "Scene.h"
 #include <Engine/Memory/Allocator.h>
+#include <Engine/Profiling/Profiler.h>
+#include <Engine/Profiling/Metrics.h>
 
 frostwave::Scene::Scene()
 {
@@ -46,6 +48,8 @@ void frostwave::Scene::SetCamera(Camera* camera)
 
 void frostwave::Scene::Submit(RenderManager* renderer)
 {
+	FW_PROFILE_FUNCTION();
+	FW_METRIC_SET(metrics::SceneModels, m_Models.size());
 	for (auto* model : m_Models)
 		renderer->Submit(model);
 	for (auto* light : m_PointLights)
@@ -3,6 +3,8 @@
 #include <Engine/Graphics/Camera.h>
 #include <Engine/Graphics/RenderManager.h>
 #include <Engine/Graphics/Lights.h>
+#include <memory_resource>
+#include <vector>
 
 namespace frostwave
 {
@@ -23,9 +25,9 @@ namespace frostwave
 
 	private:
 		Camera* m_Camera;
-		std::vector<Model*> m_Models;
-		std::vector<PointLight*> m_PointLights;
-		std::vector<DirectionalLight*> m_DirectionalLights;
+		std::pmr::vector<Model*> m_Models;
+		std::pmr::vector<PointLight*> m_PointLights;
+		std::pmr::vector<DirectionalLight*> m_DirectionalLights;
 	};
 }
 namespace fw = frostwave;
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include <unordered_map>
 #include <Windows.h>
 #include <Engine/FileWatcher.h>
+#include <Engine/Profiling/Profiler.h>
+#include <Engine/Profiling/Metrics.h>
 #pragma comment(lib,"d3dcompiler.lib")
 #pragma comment(lib,"dxguid.lib")
 
@@ -23,6 +25,7 @@ struct frostwave::Shader::Data
 
 	D3D_SHADER_MACRO defines[16] = { };
 };
+FW_REGISTER_POOL(frostwave::Shader::Data, 64)
 
 bool CompileShader(const std::string& source, const std::string& entry, const std::string& profile, D3D_SHADER_MACRO* macros, ID3DBlob** blob)
 {
@@ -159,6 +162,7 @@ frostwave::Shader::~Shader()
 	if (!m_Data) return;
 	FileWatcher::Get()->Unregister(this, m_Data->sourcePS);
 	FileWatcher::Get()->Unregister(this, m_Data->sourceVS);
+	FileWatcher::Get()->Unregister(this, m_Data->sourceGS);
 	if (m_Data->type & Type::Vertex)
 	{
 		if (m_Data->vertex)
@@ -181,6 +185,7 @@ frostwave::Shader::~Shader()
 
 void frostwave::Shader::Load(u32 type, const std::string& pixel, const std::string& vertex, const std::string& geometry)
 {
+	FW_PROFILE_FUNCTION();
 	if(!m_Data)
 		m_Data = Allocate();
 
@@ -264,6 +269,7 @@ void frostwave::Shader::Load(u32 type, const std::string& pixel, const std::stri
 
 void frostwave::Shader::Bind(u32 mask) const
 {
+	FW_METRIC_ADD(metrics::ShaderBinds, 1);
 	if (m_Data->type & Type::Vertex && !(mask & Type::Vertex))
 	{
 		Framework::GetContext()->IASetInputLayout(m_Data->layout);
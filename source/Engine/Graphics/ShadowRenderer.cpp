@@ -1,5 +1,6 @@
 #include "ShadowRenderer.h"
 #include <Engine/Graphics/Framework.h>
+#include <Engine/Profiling/Metrics.h>
 #include <d3d11.h>
 
 frostwave::ShadowRenderer::ShadowRenderer()
@@ -19,7 +20,7 @@ void frostwave::ShadowRenderer::Init()
 
 void frostwave::ShadowRenderer::Render(Camera* camera)
 {
-	auto dirProjection = Mat4f::CreateOrthographicProjection(100, 100, -100, 100);
+	static constexpr Mat4f dirProjection = Mat4f::CreateOrthographicProjection(100, 100, -100, 100);
 	for (auto* light : m_DirectionalLights)
 	{
 		auto& shadowData = light->GetShadowData();
@@ -46,7 +47,7 @@ void frostwave::ShadowRenderer::Render(Camera* camera)
 		f = Vec3f(f.x, 0, f.z).GetNormalized();
 
 		auto v = Mat4f::CreateTransform(pos/* + f * 25.0f*/, rot, 1);
-		auto vp = v.FastInverse(v) * dirProjection;
+		auto vp = Mat4f::InverseRigid(v) * dirProjection;
 
 		//
 		Vec3f shadowOrigin = Vec3f() * vp;
@@ -88,6 +89,8 @@ void frostwave::ShadowRenderer::Render(Camera* camera)
 				mesh->indexBuffer.Bind();
 				context->IASetPrimitiveTopology((D3D11_PRIMITIVE_TOPOLOGY)mesh->topology);
 				context->DrawIndexed(mesh->indexCount, 0, 0);
+				FW_METRIC_ADD(metrics::DrawCalls, 1);
+				FW_METRIC_ADD(metrics::DrawnIndices, mesh->indexCount);
 			}
 		}
 	}
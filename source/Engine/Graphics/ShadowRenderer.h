@@ -3,7 +3,7 @@
 #include <Engine/Graphics/Model.h>
 #include <Engine/Graphics/Camera.h>
 #include <Engine/Graphics/Lights.h>
-#include <vector>
+#include <Engine/Memory/Arena.h>
 
 namespace frostwave
 {
@@ -19,8 +19,8 @@ namespace frostwave
 		void Submit(DirectionalLight* light);
 
 	private:
-		std::vector<Model*> m_Models;
-		std::vector<DirectionalLight*> m_DirectionalLights;
+		FrameVector<Model*> m_Models;
+		FrameVector<DirectionalLight*> m_DirectionalLights;
 		Buffer m_FrameBuffer, m_ObjectBuffer;
 		Shader m_ShadowShader;
 
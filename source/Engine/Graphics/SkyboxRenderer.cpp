@@ -1,6 +1,7 @@
 #include "SkyboxRenderer.h"
 #include <Engine/Memory/Allocator.h>
 #include <Engine/Graphics/Framework.h>
+#include <Engine/Profiling/Metrics.h>
 #include <d3d11.h>
 
 frostwave::SkyboxRenderer::SkyboxRenderer()
@@ -29,7 +30,7 @@ void frostwave::SkyboxRenderer::SetTexture(Texture* skyboxTexture)
 	m_SkyboxTexture = skyboxTexture;
 }
 
-void frostwave::SkyboxRenderer::Render(f32, Camera* camera)
+void frostwave::SkyboxRenderer::Render(f64, Camera* camera)
 {
 	m_FrameBufferData.projection = camera->GetProjection();
 	m_FrameBufferData.view = camera->GetView();
@@ -45,5 +46,7 @@ void frostwave::SkyboxRenderer::Render(f32, Camera* camera)
 		mesh->indexBuffer.Bind();
 		context->IASetPrimitiveTopology((D3D11_PRIMITIVE_TOPOLOGY)mesh->topology);
 		context->DrawIndexed(mesh->indexCount, 0, 0);
+		FW_METRIC_ADD(metrics::DrawCalls, 1);
+		FW_METRIC_ADD(metrics::DrawnIndices, mesh->indexCount);
 	}
 }
\ No newline at end of file
@@ -8,6 +8,9 @@
 
 namespace frostwave
 {
+#pragma warning(push)
+	// The frame buffer data is made of Mat4f, which pads the class to 16 bytes.
+#pragma warning(disable: 4324)
 	class SkyboxRenderer
 	{
 	public:
@@ -16,7 +19,7 @@ namespace frostwave
 
 		void Init();
 		void SetTexture(Texture* skyboxTexture);
-		void Render(f32 totalTime, Camera* camera);
+		void Render(f64 totalTime, Camera* camera);
 
 	private:
 		Texture* m_SkyboxTexture;
@@ -31,4 +34,5 @@ namespace frostwave
 			Mat4f projection;
 		} m_FrameBufferData;
 	};
+#pragma warning(pop)
 }
\ No newline at end of file
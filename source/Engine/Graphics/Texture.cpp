@@ -4,14 +4,17 @@
 #include <Engine/Graphics/Framework.h>
 #include <Engine/Graphics/Error.h>
 #include <Engine/Core/Math/Vec2.h>
+#include <Engine/Profiling/Profiler.h>
+#include <Engine/Profiling/Metrics.h>
 #include <filesystem>
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include <d3d11.h>
 
+// Lives in movable memory and gets moved with memmove when the heap is compacted,
+// so nothing in here may point back into itself. The path is kept on the Texture for that reason.
 struct frostwave::Texture::Data
 {
-	std::string path = "";
 	ID3D11Texture2D* texture = nullptr;
 	ID3D11ShaderResourceView* shaderResource = nullptr;
 	ID3D11DepthStencilView* depth = nullptr;
@@ -23,32 +26,32 @@ struct frostwave::Texture::Data
 	bool isRenderTarget = true;
 };
 
-frostwave::Texture::Texture() : m_Data(nullptr)
+frostwave::Texture::Texture()
 {
-	m_Data = Allocate();
+	AllocateData();
 }
 
-frostwave::Texture::Texture(const std::string& path) : m_Data(nullptr)
+frostwave::Texture::Texture(const std::string& path)
 {
 	Load(path);
 }
 
-frostwave::Texture::Texture(Vec2i size, ImageFormat format, void* data) : m_Data(nullptr)
+frostwave::Texture::Texture(Vec2i size, ImageFormat format, void* data)
 {
 	Create(size, format, data);
 }
 
-frostwave::Texture::Texture(const TextureCreateInfo& info) : m_Data(nullptr)
+frostwave::Texture::Texture(const TextureCreateInfo& info)
 {
 	Create(info);
 }
 
-frostwave::Texture::Texture(const Texture& other) : m_Data(nullptr)
+frostwave::Texture::Texture(const Texture& other)
 {
 	operator=(other);
 }
 
-frostwave::Texture::Texture(Texture&& other) : m_Data(nullptr)
+frostwave::Texture::Texture(Texture&& other)
 {
 	operator=(std::forward<Texture>(other));
 }
@@ -58,9 +61,9 @@ frostwave::Texture& frostwave::Texture::operator=(const Texture& other)
 	if (m_Data)
 	{
 		Release();
-		Free(m_Data);
+		FreeData();
 	}
-	Load(other.m_Data->path);
+	Load(other.m_Path);
 	return *this;
 }
 
@@ -69,30 +72,29 @@ frostwave::Texture& frostwave::Texture::operator=(Texture&& other)
 	if (m_Data)
 	{
 		Release();
-		Free(m_Data);
+		FreeData();
 	}
 	m_Data = other.m_Data;
-	other.m_Data = nullptr;
+	m_Path = std::move(other.m_Path);
+	other.m_Data = MovableHandle{ };
 	return *this;
 }
 
 frostwave::Texture::~Texture()
 {
 	Release();
-	if (m_Data)
-	{
-		Free(m_Data);
-	}
+	FreeData();
 }
 
 bool frostwave::Texture::Valid()
 {
-	return m_Data && (m_Data->shaderResource || m_Data->texture || m_Data->depth|| m_Data->renderTarget);
+	Data* data = GetData();
+	return data && (data->shaderResource || data->texture || data->depth || data->renderTarget);
 }
 
 void frostwave::Texture::SetAsActiveTarget(frostwave::Texture* depthStencil)
 {
-	Framework::GetContext()->OMSetRenderTargets(1, &m_Data->renderTarget, depthStencil ? depthStencil->m_Data->depth : nullptr);
+	Framework::GetContext()->OMSetRenderTargets(1, &GetData()->renderTarget, depthStencil ? depthStencil->GetData()->depth : nullptr);
 	SetViewport();
 }
 
@@ -111,7 +113,7 @@ void frostwave::Texture::SetCustomViewport(f32 topLeftX, f32 topLeftY, f32 width
 										    
 void frostwave::Texture::SetViewport()	    
 {
-	Framework::GetContext()->RSSetViewports(1, &m_Data->viewport);
+	Framework::GetContext()->RSSetViewports(1, &GetData()->viewport);
 }
 
 void frostwave::Texture::UnsetActiveTarget()
@@ -135,6 +137,7 @@ void frostwave::Texture::UnbindAll()
 
 bool frostwave::Texture::Load(const std::string& path)
 {
+	FW_PROFILE_FUNCTION();
 	if (path.length() <= 0) return false;
 	if (!std::filesystem::exists(std::filesystem::path(path)))
 	{
@@ -142,23 +145,23 @@ bool frostwave::Texture::Load(const std::string& path)
 		return false;
 	}
 	if (!m_Data)
-		m_Data = Allocate();
+		AllocateData();
 
-	m_Data->path = path;
+	m_Path = path;
 
-	if (m_Data->path.find(".dds") != std::string::npos || m_Data->path.find(".DDS") != std::string::npos)
+	if (m_Path.find(".dds") != std::string::npos || m_Path.find(".DDS") != std::string::npos)
 	{
-		ErrorCheck(DirectX::CreateDDSTextureFromFile(Framework::GetDevice(), std::wstring(m_Data->path.begin(), m_Data->path.end()).c_str(), nullptr, &m_Data->shaderResource));
+		ErrorCheck(DirectX::CreateDDSTextureFromFile(Framework::GetDevice(), std::wstring(m_Path.begin(), m_Path.end()).c_str(), nullptr, &GetData()->shaderResource));
 	}
 	else
 	{
 		i32 w, h, channels;
-		unsigned char* image = stbi_load(m_Data->path.c_str(), &w, &h, &channels, STBI_rgb_alpha);
+		unsigned char* image = stbi_load(m_Path.c_str(), &w, &h, &channels, STBI_rgb_alpha);
 		if (image != nullptr)
 			Create({ w, h }, ImageFormat::DXGI_FORMAT_R8G8B8A8_UNORM, image);
 		else
 		{
-			ERROR_LOG("Failed to load %s", m_Data->path.c_str());
+			ERROR_LOG("Failed to load %s", m_Path.c_str());
 			return false;
 		}
 		stbi_image_free(image);
@@ -178,22 +181,23 @@ void frostwave::Texture::Create(Vec2i size, ImageFormat format, void* data)
 void frostwave::Texture::Create(const TextureCreateInfo& info)
 {
 	if (!m_Data)
-		m_Data = Allocate();
+		AllocateData();
 
-	m_Data->isRenderTarget = info.renderTarget;
-	m_Data->format = (DXGI_FORMAT)info.format;
+	Data* data = GetData();
+	data->isRenderTarget = info.renderTarget;
+	data->format = (DXGI_FORMAT)info.format;
 
 	D3D11_TEXTURE2D_DESC desc = { };
 	desc.Width = (u32)info.size.x;
 	desc.Height = (u32)info.size.y;
 	desc.MipLevels = info.numMips;
 	desc.ArraySize = info.cubemap ? 6 : 1;
-	desc.Format = m_Data->format;
+	desc.Format = data->format;
 	desc.SampleDesc.Count = 1;
 	desc.SampleDesc.Quality = 0;
 	desc.Usage = D3D11_USAGE_DEFAULT;
 
-	if (m_Data->isRenderTarget)
+	if (data->isRenderTarget)
 		desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
 	else
 		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
@@ -212,23 +216,24 @@ void frostwave::Texture::Create(const TextureCreateInfo& info)
 	ErrorCheck(Framework::GetDevice()->CreateTexture2D(&desc, info.data ? &initialData : nullptr, &texture));
 
 	CreateFromTexture(texture);
-	m_Data->size = info.size;
+	data->size = info.size;
 }
 
 void frostwave::Texture::CreateFromTexture(ID3D11Texture2D* texture)
 {
-	if (m_Data->isRenderTarget)
-		ErrorCheck(Framework::GetDevice()->CreateRenderTargetView(texture, nullptr, &m_Data->renderTarget));
+	Data* data = GetData();
+	if (data->isRenderTarget)
+		ErrorCheck(Framework::GetDevice()->CreateRenderTargetView(texture, nullptr, &data->renderTarget));
 
 	if (texture)
 	{
 		D3D11_TEXTURE2D_DESC desc;
 		texture->GetDesc(&desc);
-		m_Data->viewport = { 0.0f, 0.0f, (f32)desc.Width, (f32)desc.Height, 0.0f, 1.0f };
-		m_Data->size = { (i32)desc.Width, (i32)desc.Height };
+		data->viewport = { 0.0f, 0.0f, (f32)desc.Width, (f32)desc.Height, 0.0f, 1.0f };
+		data->size = { (i32)desc.Width, (i32)desc.Height };
 	}
-	m_Data->texture = texture;
-	ErrorCheck(Framework::GetDevice()->CreateShaderResourceView(texture, nullptr, &m_Data->shaderResource));
+	data->texture = texture;
+	ErrorCheck(Framework::GetDevice()->CreateShaderResourceView(texture, nullptr, &data->shaderResource));
 }
 
 void frostwave::Texture::CreateDepth(Vec2i size, ImageFormat format)
@@ -258,56 +263,59 @@ void frostwave::Texture::CreateDepth(Vec2i size, ImageFormat format)
 	sr_desc.Texture2D.MostDetailedMip = 0;
 	sr_desc.Texture2D.MipLevels = 1;
 
+	Data* data = GetData();
 	ID3D11Texture2D* texture = nullptr;
 	ErrorCheck(Framework::GetDevice()->CreateTexture2D(&desc, nullptr, &texture));
-	ErrorCheck(Framework::GetDevice()->CreateDepthStencilView(texture, &dsv_desc, &m_Data->depth));
-	ErrorCheck(Framework::GetDevice()->CreateShaderResourceView(texture, &sr_desc, &m_Data->shaderResource));
+	ErrorCheck(Framework::GetDevice()->CreateDepthStencilView(texture, &dsv_desc, &data->depth));
+	ErrorCheck(Framework::GetDevice()->CreateShaderResourceView(texture, &sr_desc, &data->shaderResource));
 
-	m_Data->isDepth = true;
-	m_Data->texture = texture;
-	m_Data->viewport = { 0.0f, 0.0f, (f32)size.x, (f32)size.y, 0.0f, 1.0f };
-	m_Data->size = size;
+	data->isDepth = true;
+	data->texture = texture;
+	data->viewport = { 0.0f, 0.0f, (f32)size.x, (f32)size.y, 0.0f, 1.0f };
+	data->size = size;
 }
 
 void frostwave::Texture::Clear(Vec4f color)
 {
-	Framework::GetContext()->ClearRenderTargetView(m_Data->renderTarget, &color.x);
+	Framework::GetContext()->ClearRenderTargetView(GetData()->renderTarget, &color.x);
 }
 
 void frostwave::Texture::ClearDepth(f32 depth, u32 stencil)
 {
-	Framework::GetContext()->ClearDepthStencilView(m_Data->depth, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, depth, (UINT8)stencil);
+	Framework::GetContext()->ClearDepthStencilView(GetData()->depth, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, depth, (UINT8)stencil);
 }
 
 void frostwave::Texture::Bind(u32 slot) const
 {
-	Framework::GetContext()->PSSetShaderResources(slot, 1, &m_Data->shaderResource);
+	FW_METRIC_ADD(metrics::TextureBinds, 1);
+	Framework::GetContext()->PSSetShaderResources(slot, 1, &GetData()->shaderResource);
 }
 
 void frostwave::Texture::Release()
 {
-	if (m_Data)
+	if (Data* data = GetData())
 	{
-		if (m_Data->depth)
-			SafeRelease(&m_Data->depth);
+		if (data->depth)
+			SafeRelease(&data->depth);
 
-		if (m_Data->renderTarget)
-			SafeRelease(&m_Data->renderTarget);
+		if (data->renderTarget)
+			SafeRelease(&data->renderTarget);
 
-		if (m_Data->shaderResource)
-			SafeRelease(&m_Data->shaderResource);
+		if (data->shaderResource)
+			SafeRelease(&data->shaderResource);
 
-		if (m_Data->texture)
-			SafeRelease(&m_Data->texture);
+		if (data->texture)
+			SafeRelease(&data->texture);
 	}
 }
 
 ID3D11RenderTargetView* frostwave::Texture::CreateRenderTargetViewForMip(i32 mipLevel, bool cubemap)
 {
+	Data* data = GetData();
 	ID3D11RenderTargetView* rtv;
 
 	D3D11_RENDER_TARGET_VIEW_DESC rtvDesc = { };
-	rtvDesc.Format = m_Data->format;
+	rtvDesc.Format = data->format;
 	rtvDesc.ViewDimension = cubemap ? D3D11_RTV_DIMENSION_TEXTURE2DARRAY : D3D11_RTV_DIMENSION_TEXTURE2D;
 	if (cubemap)
 	{
@@ -320,32 +328,51 @@ ID3D11RenderTargetView* frostwave::Texture::CreateRenderTargetViewForMip(i32 mip
 		rtvDesc.Texture2D.MipSlice = mipLevel;
 	}
 
-	ErrorCheck(Framework::GetDevice()->CreateRenderTargetView(m_Data->texture, &rtvDesc, &rtv));
+	ErrorCheck(Framework::GetDevice()->CreateRenderTargetView(data->texture, &rtvDesc, &rtv));
 
 	return rtv;
 }
 
 ID3D11Texture2D* frostwave::Texture::GetTexture() const
 {
-	return m_Data->texture;
+	return GetData()->texture;
 }
 
 ID3D11DepthStencilView* frostwave::Texture::GetDepth() const
 {
-	return m_Data->depth;
+	return GetData()->depth;
 }
 
 ID3D11RenderTargetView* frostwave::Texture::GetRenderTarget() const
 {
-	return m_Data->renderTarget;
+	return GetData()->renderTarget;
 }
 
 ID3D11ShaderResourceView* frostwave::Texture::GetShaderResourceView() const
 {
-	return m_Data->shaderResource;
+	return GetData()->shaderResource;
 }
 
 frostwave::Vec2i frostwave::Texture::GetSize() const
 {
-	return m_Data->size;
+	return GetData()->size;
+}
+
+frostwave::Texture::Data* frostwave::Texture::GetData() const
+{
+	return (Data*)Allocator::Get()->Resolve(m_Data);
+}
+
+void frostwave::Texture::AllocateData()
+{
+	m_Data = Allocator::Get()->AllocateMovable(Size::Bytes(sizeof(Data)), typeid(Data).name());
+	new (GetData()) Data();
+}
+
+void frostwave::Texture::FreeData()
+{
+	if (!m_Data) return;
+	GetData()->~Data();
+	Allocator::Get()->FreeMovable(m_Data);
+	m_Data = MovableHandle{ };
 }
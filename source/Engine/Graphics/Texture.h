@@ -2,6 +2,7 @@
 #include <Engine/Core/Types.h>
 #include <Engine/Core/Math/Vec.h>
 #include <Engine/Graphics/ImageFormat.h>
+#include <Engine/Memory/Allocator.h>
 #include <string>
 
 struct ID3D11Texture2D;
@@ -68,7 +69,15 @@ namespace frostwave
 
 	private:
 		struct Data;
-		Data* m_Data;
+		Data* GetData() const;
+		void AllocateData();
+		void FreeData();
+
+		// Movable so the allocator can compact it, only resolved for the duration of a call.
+		MovableHandle m_Data;
+		std::string m_Path;
 	};
 }
-namespace fw = frostwave;
\ No newline at end of file
+namespace fw = frostwave;
+
+FW_REGISTER_POOL(fw::Texture, 256)
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <atomic>
+#include <cstring>
+
+// Layout of the files written by BinaryFileSink and FlightRecorder, shared with the LogDecoder tool.
+//
+// The file starts with a BinaryLogHeader, followed by records that each begin with a BinaryLogRecordType byte:
+//  Site:    varint id, u8 level, varint line, then file, function, format and signature as varint length + bytes.
+//           Written once, before the first message from that call site.
+//  Message: varint site id, varint thread, zigzag varint nanoseconds since the previous message,
+//           varint argument size, then the arguments packed by their signature entry.
+//
+// The site signature holds a kind and a byte size character per argument, packed as:
+//  'i' zigzag varint, 'u' and 'p' varint, 'f' the raw value of the given size,
+//  's' and 'w' varint character count followed by the characters of the given size, without terminator.
+namespace frostwave
+{
+	struct BinaryLogHeader
+	{
+		static constexpr c8 Magic[8] = { 'F', 'W', 'B', 'I', 'N', 'L', 'O', 'G' };
+		static constexpr u32 CurrentVersion = 1;
+
+		c8 magic[8];
+		u32 version;
+		u8 pointerSize;
+		u8 wideCharSize;
+		u16 reserved;
+	};
+	static_assert(sizeof(BinaryLogHeader) == 16);
+
+	enum class BinaryLogRecordType : u8
+	{
+		Site = 1,
+		Message = 2
+	};
+
+	inline u8* WriteVarint(u8* cursor, u64 value)
+	{
+		while (value >= 0x80)
+		{
+			*cursor++ = (u8)(value | 0x80);
+			value >>= 7;
+		}
+		*cursor++ = (u8)value;
+		return cursor;
+	}
+
+	// Returns false when the value runs past end.
+	inline bool ReadVarint(const u8*& cursor, const u8* end, u64& value)
+	{
+		value = 0;
+		for (u32 shift = 0; cursor < end && shift < 64; shift += 7)
+		{
+			u8 byte = *cursor++;
+			value |= (u64)(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) return true;
+		}
+		return false;
+	}
+
+	// A flight recorder file is the header, a table of u32 offsets into the string area per site id,
+	// the string area and then the ring of fixed size slots. A site entry in the string area is the
+	// level byte, a u32 line and then file, function, format and signature as null terminated strings.
+	// Slot payloads hold the arguments in the logger's ring layout: values padded to 8 bytes, strings as a
+	// u64 length, the characters and a terminator, padded to 8 bytes. Arguments that did not fit are missing.
+	struct FlightRecorderHeader
+	{
+		static constexpr c8 Magic[8] = { 'F', 'W', 'F', 'L', 'I', 'G', 'H', 'T' };
+		static constexpr u32 CurrentVersion = 1;
+
+		c8 magic[8];
+		u32 version;
+		u32 siteCapacity;
+		u64 slotCount;
+		u32 stringCapacity;
+		u8 pointerSize;
+		u8 wideCharSize;
+		// Set when the recorder was shut down normally, a file without it ends in a crash.
+		u8 clean;
+		u8 reserved;
+		// Slot timestamps are nanoseconds on the same clock, the dump shows them relative to this.
+		u64 startTimestamp;
+
+		std::atomic<u64> write;
+		std::atomic<u32> siteCount;
+		std::atomic<u32> stringSize;
+	};
+
+	enum class FlightRecordType : u8
+	{
+		Log = 1,
+		Frame = 2
+	};
+
+	struct FlightRecorderSlot
+	{
+		static constexpr u64 PayloadSize = 96;
+
+		// Index of the record plus one, stored last. A slot whose sequence does not match its position
+		// in the ring was torn by a crash or is being rewritten and is skipped.
+		std::atomic<u64> sequence;
+		u64 timestamp;
+		// Frame markers carry the frame index in place of a site.
+		u32 site;
+		u32 thread;
+		u16 size;
+		FlightRecordType type;
+		u8 reserved[5];
+		u8 payload[PayloadSize];
+	};
+	static_assert(sizeof(FlightRecorderSlot) == 128);
+
+	struct FlightRecorderLayout
+	{
+		u64 sites;
+		u64 strings;
+		u64 slots;
+		u64 size;
+	};
+
+	inline FlightRecorderLayout GetFlightRecorderLayout(u64 slotCount, u32 siteCapacity, u32 stringCapacity)
+	{
+		FlightRecorderLayout layout;
+		layout.sites = (sizeof(FlightRecorderHeader) + 63) & ~63ull;
+		layout.strings = layout.sites + siteCapacity * sizeof(u32);
+		layout.slots = (layout.strings + stringCapacity + 63) & ~63ull;
+		layout.size = layout.slots + slotCount * sizeof(FlightRecorderSlot);
+		return layout;
+	}
+
+	inline u64 ZigZagEncode(i64 value) { return ((u64)value << 1) ^ (u64)(value >> 63); }
+	inline i64 ZigZagDecode(u64 value) { return (i64)(value >> 1) ^ -(i64)(value & 1); }
+}
+namespace fw = frostwave;
@@ -0,0 +1,133 @@
+#include "FlightRecorder.h"
+#include <Engine/Logging/Logger.h>
+#include <Engine/Memory/Allocator.h>
+#include <Engine/Platform/VirtualMemory.h>
+#include <chrono>
+
+std::atomic<frostwave::FlightRecorder*> frostwave::FlightRecorder::m_Instance = nullptr;
+u32 frostwave::FlightRecorder::s_Generation = 0;
+std::atomic<u32> frostwave::FlightRecorder::s_NextThreadIndex = 0;
+
+bool frostwave::FlightRecorder::Create(const c8* path, u64 slotCount)
+{
+	assert(!m_Instance && "Flight recorder already created!");
+
+	u64 count = 1;
+	while (count < slotCount) count <<= 1;
+
+	FlightRecorderLayout layout = GetFlightRecorderLayout(count, SiteCapacity, StringCapacity);
+	u8* file = (u8*)VirtualMemory::MapFile(path, layout.size);
+	if (!file)
+	{
+		ERROR_LOG("Failed to map flight recorder file %s", path);
+		return false;
+	}
+
+	// A recording left over from the last run is overwritten, the mapping is reused as is.
+	memset(file, 0, layout.slots);
+
+	FlightRecorderHeader* header = (FlightRecorderHeader*)file;
+	memcpy(header->magic, FlightRecorderHeader::Magic, sizeof(header->magic));
+	header->version = FlightRecorderHeader::CurrentVersion;
+	header->siteCapacity = SiteCapacity;
+	header->slotCount = count;
+	header->stringCapacity = StringCapacity;
+	header->pointerSize = sizeof(void*);
+	header->wideCharSize = sizeof(wchar_t);
+	header->startTimestamp = (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	FlightRecorder* recorder = Allocate();
+	// Zero is reserved for sites that never registered.
+	s_Generation = s_Generation % (0xffffffffu >> SiteIdBits) + 1;
+	recorder->m_Generation = s_Generation;
+	recorder->m_File = file;
+	recorder->m_FileSize = layout.size;
+	recorder->m_Header = header;
+	recorder->m_Sites = (u32*)(file + layout.sites);
+	recorder->m_Strings = (c8*)(file + layout.strings);
+	recorder->m_Slots = (FlightRecorderSlot*)(file + layout.slots);
+	recorder->m_SlotMask = count - 1;
+
+	// Slots of the previous run only need their sequence cleared, the rest is overwritten before it is read.
+	for (u64 i = 0; i < count; ++i)
+		recorder->m_Slots[i].sequence.store(0, std::memory_order_relaxed);
+
+	m_Instance = recorder;
+	return true;
+}
+
+void frostwave::FlightRecorder::Destroy()
+{
+	// Log calls that loaded the recorder before it was cleared may still be writing slots.
+	FlightRecorder* recorder = m_Instance.exchange(nullptr);
+	Logger::WaitForProducers();
+
+	recorder->m_Header->clean = 1;
+	VirtualMemory::UnmapFile(recorder->m_File, recorder->m_FileSize);
+	Free(recorder);
+}
+
+void frostwave::FlightRecorder::MarkFrame(u64 frame)
+{
+	u64 index;
+	FlightRecorderSlot& slot = BeginSlot(index);
+	slot.timestamp = (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	slot.site = (u32)frame;
+	slot.type = FlightRecordType::Frame;
+	EndSlot(slot, index, slot.payload);
+}
+
+void frostwave::FlightRecorder::Sync()
+{
+	VirtualMemory::FlushFile(m_File, m_FileSize);
+}
+
+frostwave::FlightRecorder::FlightRecorder() : m_Generation(0), m_File(nullptr), m_FileSize(0), m_Header(nullptr), m_Sites(nullptr), m_Strings(nullptr), m_Slots(nullptr), m_SlotMask(0)
+{
+}
+
+frostwave::FlightRecorder::~FlightRecorder()
+{
+}
+
+u32 frostwave::FlightRecorder::RegisterSite(const LogSite& site, const LogArgumentCodec* codec)
+{
+	std::lock_guard<std::mutex> lock(m_SiteMutex);
+
+	// Another thread may have registered the site while this one waited.
+	u32 id = site.recorderId->load(std::memory_order_relaxed);
+	if ((id >> SiteIdBits) == m_Generation) return id;
+
+	const c8* strings[] = { site.file, site.function, site.format, codec->signature };
+	u64 lengths[4];
+	u64 size = sizeof(u8) + sizeof(u32);
+	for (u64 i = 0; i < 4; ++i)
+	{
+		lengths[i] = strlen(strings[i]) + 1;
+		size += lengths[i];
+	}
+
+	// Site 0 stays unused so a zeroed slot never names a site.
+	u32 index = m_Header->siteCount.load(std::memory_order_relaxed) + 1;
+	u32 offset = m_Header->stringSize.load(std::memory_order_relaxed);
+	if (index >= SiteCapacity || offset + size > StringCapacity) return 0;
+
+	c8* cursor = m_Strings + offset;
+	*cursor++ = (c8)site.level;
+	memcpy(cursor, &site.line, sizeof(u32));
+	cursor += sizeof(u32);
+	for (u64 i = 0; i < 4; ++i)
+	{
+		memcpy(cursor, strings[i], lengths[i]);
+		cursor += lengths[i];
+	}
+
+	// The strings are in place before anything points at them.
+	m_Header->stringSize.store(offset + (u32)size, std::memory_order_release);
+	m_Sites[index] = offset;
+	m_Header->siteCount.store(index, std::memory_order_release);
+
+	id = (m_Generation << SiteIdBits) | index;
+	site.recorderId->store(id, std::memory_order_release);
+	return id;
+}
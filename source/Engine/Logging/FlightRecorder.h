@@ -0,0 +1,105 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <Engine/Logging/LogArgument.h>
+#include <Engine/Logging/BinaryLog.h>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+
+namespace frostwave
+{
+	// Keeps the most recent log records and frame markers in a ring of fixed size slots inside a memory mapped file.
+	// The thread that logs claims a slot and writes the record straight into the mapping, so whatever was recorded before
+	// a crash is left in the file by the OS without anyone flushing it. LogDecoder dumps the file.
+	// Recording is a slot claim and a copy, it does not format, lock or wait on the logging thread.
+	class FlightRecorder
+	{
+	public:
+		// Rounded up to a power of two. 32768 slots is a 4mb ring.
+		static constexpr u64 DefaultSlotCount = 32768;
+		static constexpr u32 SiteCapacity = 16384;
+		static constexpr u32 StringCapacity = 1024 * 1024;
+
+		// Replaces whatever was recorded in path before, returns false if the file could not be mapped.
+		static bool Create(const c8* path, u64 slotCount = DefaultSlotCount);
+		static void Destroy();
+		// Only stays valid during a log call or on the thread that calls Destroy.
+		static FlightRecorder* Get() { return m_Instance.load(); }
+
+		template <typename... Args>
+		void Record(const LogSite& site, const LogArgumentCodec* codec, u64 timestamp, const Args&... args)
+		{
+			u32 id = site.recorderId->load(std::memory_order_acquire);
+			if ((id >> SiteIdBits) != m_Generation)
+			{
+				id = RegisterSite(site, codec);
+				if (!id) return;
+			}
+
+			u64 index;
+			FlightRecorderSlot& slot = BeginSlot(index);
+			slot.timestamp = timestamp;
+			slot.site = id & SiteIdMask;
+			slot.type = FlightRecordType::Log;
+
+			u8* cursor = slot.payload;
+			// Arguments past the payload are left out, the dump marks them as missing.
+			(void)(... && LogArgument<std::decay_t<Args>>::WriteBounded(cursor, slot.payload + FlightRecorderSlot::PayloadSize, args));
+			EndSlot(slot, index, cursor);
+		}
+
+		void MarkFrame(u64 frame);
+		// Forces the recorded pages to disk, only needed when the machine itself might go down.
+		void Sync();
+
+	private:
+		// Site ids carry the generation of the recorder that assigned them, so call sites register again with a new recorder.
+		static constexpr u32 SiteIdBits = 20;
+		static constexpr u32 SiteIdMask = (1u << SiteIdBits) - 1;
+
+		friend class Allocator;
+		FlightRecorder();
+		~FlightRecorder();
+
+		// Returns 0 if the site does not fit in the file.
+		u32 RegisterSite(const LogSite& site, const LogArgumentCodec* codec);
+		static u32 GetThreadIndex()
+		{
+			if (!t_ThreadIndex) t_ThreadIndex = ++s_NextThreadIndex;
+			return t_ThreadIndex;
+		}
+
+		FlightRecorderSlot& BeginSlot(u64& index)
+		{
+			index = m_Header->write.fetch_add(1, std::memory_order_relaxed);
+			FlightRecorderSlot& slot = m_Slots[index & m_SlotMask];
+			// Invalidates the slot first, a crash halfway through leaves a slot the dump skips.
+			slot.sequence.store(0, std::memory_order_relaxed);
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+			slot.thread = GetThreadIndex();
+			return slot;
+		}
+
+		void EndSlot(FlightRecorderSlot& slot, u64 index, const u8* cursor)
+		{
+			slot.size = (u16)(cursor - slot.payload);
+			slot.sequence.store(index + 1, std::memory_order_release);
+		}
+
+		static std::atomic<FlightRecorder*> m_Instance;
+		static u32 s_Generation;
+		static std::atomic<u32> s_NextThreadIndex;
+		static inline thread_local u32 t_ThreadIndex = 0;
+
+		u32 m_Generation;
+		u8* m_File;
+		u64 m_FileSize;
+		FlightRecorderHeader* m_Header;
+		u32* m_Sites;
+		c8* m_Strings;
+		FlightRecorderSlot* m_Slots;
+		u64 m_SlotMask;
+		std::mutex m_SiteMutex;
+	};
+}
+namespace fw = frostwave;
@@ -0,0 +1,167 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <Engine/Logging/LogFormat.h>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+namespace frostwave
+{
+	enum class LogLevel : char
+	{
+		All,
+		Verbose,
+		Info,
+		Warning,
+		Error,
+		Fatal,
+		Count
+	};
+
+	// Everything about a log call that is known while compiling, one static instance per call site.
+	struct LogSite
+	{
+		LogLevel level;
+		u32 line;
+		const c8* file;
+		const c8* function;
+		const c8* format;
+		// Per call site storage for the flight recorder's id of the site, 0 until it first records.
+		std::atomic<u32>* recorderId;
+	};
+
+	template <typename... Args>
+	struct CheckedLogSite
+	{
+		consteval CheckedLogSite(const LogSite& logSite) : site(&logSite)
+		{
+			CheckLogFormat<std::decay_t<Args>...>(logSite.format);
+		}
+
+		const LogSite* site;
+	};
+
+	// How a log argument is copied into the ring buffer and read back on the logging thread.
+	// Values are copied as they are, character pointers are treated as strings and copied inline,
+	// so the caller's buffers can go away right after the call.
+	template <typename T>
+	struct LogArgument
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Log arguments have to be trivially copyable, pass strings with c_str()!");
+		using Type = T;
+
+		static constexpr c8 GetKind()
+		{
+			if constexpr (std::is_floating_point_v<T>) return 'f';
+			else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) return 'p';
+			else if constexpr (std::is_enum_v<T>) return std::is_signed_v<std::underlying_type_t<T>> ? 'i' : 'u';
+			else if constexpr (std::is_integral_v<T>) return std::is_signed_v<T> ? 'i' : 'u';
+			else return 'x';
+		}
+		// Kind and byte size, enough for a reader of the raw bytes to format them without knowing T.
+		static constexpr c8 Signature[2] = { GetKind(), (c8)('0' + sizeof(T)) };
+
+		static u64 GetSize(const T&) { return (sizeof(T) + 7) & ~7ull; }
+		static void Write(u8*& cursor, const T& value) { memcpy(cursor, &value, sizeof(T)); cursor += GetSize(value); }
+		// Writes nothing and returns false if the value does not fit before end.
+		static bool WriteBounded(u8*& cursor, const u8* end, const T& value)
+		{
+			if ((u64)(end - cursor) < GetSize(value)) return false;
+			Write(cursor, value);
+			return true;
+		}
+		static T Read(const u8*& cursor) { T value; memcpy(&value, cursor, sizeof(T)); cursor += (sizeof(T) + 7) & ~7ull; return value; }
+	};
+
+	template <typename C>
+	struct LogStringArgument
+	{
+		using Type = const C*;
+		static constexpr c8 Signature[2] = { sizeof(C) == 1 ? 's' : 'w', (c8)('0' + sizeof(C)) };
+		// Longer strings are cut, a record has to fit comfortably in a thread's ring.
+		static constexpr u64 MaxLength = 4096;
+
+		static u64 GetLength(const C* value)
+		{
+			if (!value) return 0;
+			u64 length = 0;
+			while (length < MaxLength && value[length]) ++length;
+			return length;
+		}
+		static u64 GetSize(const C* value) { return (sizeof(u64) + (GetLength(value) + 1) * sizeof(C) + 7) & ~7ull; }
+		static void Write(u8*& cursor, const C* value)
+		{
+			u64 length = GetLength(value);
+			memcpy(cursor, &length, sizeof(u64));
+			if (length) memcpy(cursor + sizeof(u64), value, length * sizeof(C));
+			memset(cursor + sizeof(u64) + length * sizeof(C), 0, sizeof(C));
+			cursor += (sizeof(u64) + (length + 1) * sizeof(C) + 7) & ~7ull;
+		}
+		// Cuts the string to what fits before end rather than dropping it.
+		static bool WriteBounded(u8*& cursor, const u8* end, const C* value)
+		{
+			u64 available = (u64)(end - cursor);
+			if (available < sizeof(u64) + 8) return false;
+
+			u64 length = GetLength(value);
+			u64 fits = ((available - sizeof(u64)) & ~7ull) / sizeof(C) - 1;
+			if (length > fits) length = fits;
+
+			memcpy(cursor, &length, sizeof(u64));
+			if (length) memcpy(cursor + sizeof(u64), value, length * sizeof(C));
+			memset(cursor + sizeof(u64) + length * sizeof(C), 0, sizeof(C));
+			cursor += (sizeof(u64) + (length + 1) * sizeof(C) + 7) & ~7ull;
+			return true;
+		}
+		static const C* Read(const u8*& cursor)
+		{
+			u64 length;
+			memcpy(&length, cursor, sizeof(u64));
+			const C* value = (const C*)(cursor + sizeof(u64));
+			cursor += (sizeof(u64) + (length + 1) * sizeof(C) + 7) & ~7ull;
+			return value;
+		}
+	};
+
+	template <> struct LogArgument<c8*> : LogStringArgument<c8> { };
+	template <> struct LogArgument<const c8*> : LogStringArgument<c8> { };
+	template <> struct LogArgument<wchar_t*> : LogStringArgument<wchar_t> { };
+	template <> struct LogArgument<const wchar_t*> : LogStringArgument<wchar_t> { };
+
+	using LogFormatFunction = i32(*)(const u8* arguments, const c8* format, c8* buffer, u64 capacity);
+
+	struct LogArgumentCodec
+	{
+		LogFormatFunction format;
+		// Two characters per argument from LogArgument::Signature.
+		const c8* signature;
+	};
+
+	// Reads back and formats the arguments of one combination of types, a record points at the codec matching its arguments.
+	template <typename... Args>
+	struct LogCodec
+	{
+		static i32 Format(const u8* arguments, const c8* format, c8* buffer, u64 capacity)
+		{
+			// Braced initialization reads the arguments in order.
+			std::tuple<typename LogArgument<Args>::Type...> values{ LogArgument<Args>::Read(arguments)... };
+			(void)arguments;
+			return std::apply([&](const auto&... value) { return snprintf(buffer, capacity, format, value...); }, values);
+		}
+
+		static constexpr std::array<c8, sizeof...(Args) * 2 + 1> MakeSignature()
+		{
+			std::array<c8, sizeof...(Args) * 2 + 1> signature = { };
+			u64 i = 0;
+			((signature[i++] = LogArgument<Args>::Signature[0], signature[i++] = LogArgument<Args>::Signature[1]), ...);
+			return signature;
+		}
+
+		static constexpr std::array<c8, sizeof...(Args) * 2 + 1> Signature = MakeSignature();
+		static constexpr LogArgumentCodec Codec = { &Format, Signature.data() };
+	};
+}
+namespace fw = frostwave;
@@ -0,0 +1,217 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <type_traits>
+
+namespace frostwave
+{
+	// Never defined, the format check calls these to stop compilation and their names end up in the error.
+	void LogFormatTooFewArguments();
+	void LogFormatTooManyArguments();
+	void LogFormatArgumentMismatch();
+	void LogFormatUnsupportedConversion();
+
+	enum class LogArgumentKind : u8
+	{
+		Integer,
+		Float,
+		String,
+		WideString,
+		Pointer,
+		Other
+	};
+
+	struct LogArgumentInfo
+	{
+		LogArgumentKind kind;
+		u8 size;
+	};
+
+	template <typename T>
+	consteval LogArgumentInfo GetLogArgumentInfo()
+	{
+		if constexpr (std::is_same_v<T, c8*> || std::is_same_v<T, const c8*>)
+			return { LogArgumentKind::String, sizeof(T) };
+		else if constexpr (std::is_same_v<T, wchar_t*> || std::is_same_v<T, const wchar_t*>)
+			return { LogArgumentKind::WideString, sizeof(T) };
+		else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+			return { LogArgumentKind::Pointer, sizeof(T) };
+		else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+			return { LogArgumentKind::Integer, sizeof(T) };
+		else if constexpr (std::is_floating_point_v<T>)
+			return { LogArgumentKind::Float, sizeof(T) };
+		else
+			return { LogArgumentKind::Other, sizeof(T) };
+	}
+
+	// Walks a printf format and checks every conversion against the type of its argument,
+	// including the MSVC I, I32 and I64 length prefixes. Arguments are expected to be decayed.
+	template <typename... Args>
+	consteval void CheckLogFormat(const c8* format)
+	{
+		enum class Length { None, Char, Short, Long, LongLong, Size, Int32, LongDouble };
+
+		// The trailing entry only keeps the array from being empty.
+		constexpr LogArgumentInfo arguments[] = { GetLogArgumentInfo<Args>()..., { LogArgumentKind::Other, 0 } };
+		constexpr u64 count = sizeof...(Args);
+		u64 next = 0;
+
+		auto take = [&]() -> LogArgumentInfo
+		{
+			if (next >= count) LogFormatTooFewArguments();
+			return arguments[next++];
+		};
+		auto checkInteger = [](LogArgumentInfo argument, Length length)
+		{
+			if (argument.kind != LogArgumentKind::Integer) LogFormatArgumentMismatch();
+
+			u64 expected = 0;
+			switch (length)
+			{
+			case Length::Long: expected = sizeof(long); break;
+			case Length::LongLong: expected = sizeof(long long); break;
+			case Length::Size: expected = sizeof(void*); break;
+			case Length::Int32: expected = sizeof(i32); break;
+			default: break;
+			}
+
+			// Without a length everything up to int is promoted, anything wider is read back truncated.
+			if (expected ? argument.size != expected : argument.size > sizeof(i32)) LogFormatArgumentMismatch();
+		};
+		auto isDigit = [](c8 c) { return c >= '0' && c <= '9'; };
+
+		for (const c8* c = format; *c; ++c)
+		{
+			if (*c != '%') continue;
+			if (*++c == '%') continue;
+
+			while (*c == '-' || *c == '+' || *c == ' ' || *c == '#' || *c == '0') ++c;
+
+			if (*c == '*')
+			{
+				checkInteger(take(), Length::None);
+				++c;
+			}
+			while (isDigit(*c)) ++c;
+
+			if (*c == '.')
+			{
+				if (*++c == '*')
+				{
+					checkInteger(take(), Length::None);
+					++c;
+				}
+				while (isDigit(*c)) ++c;
+			}
+
+			Length length = Length::None;
+			switch (*c)
+			{
+			case 'h':
+				length = c[1] == 'h' ? Length::Char : Length::Short;
+				c += length == Length::Char ? 2 : 1;
+				break;
+			case 'l':
+				length = c[1] == 'l' ? Length::LongLong : Length::Long;
+				c += length == Length::LongLong ? 2 : 1;
+				break;
+			case 'w':
+				length = Length::Long;
+				++c;
+				break;
+			case 'j':
+				length = Length::LongLong;
+				++c;
+				break;
+			case 'z':
+			case 't':
+				length = Length::Size;
+				++c;
+				break;
+			case 'L':
+				length = Length::LongDouble;
+				++c;
+				break;
+			case 'I':
+				if (c[1] == '6' && c[2] == '4')
+				{
+					length = Length::LongLong;
+					c += 3;
+				}
+				else if (c[1] == '3' && c[2] == '2')
+				{
+					length = Length::Int32;
+					c += 3;
+				}
+				else
+				{
+					length = Length::Size;
+					++c;
+				}
+				break;
+			default:
+				break;
+			}
+
+			switch (*c)
+			{
+			case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+				checkInteger(take(), length);
+				break;
+			case 'c':
+				checkInteger(take(), length == Length::Long ? Length::None : length);
+				break;
+			case 'C':
+				checkInteger(take(), Length::None);
+				break;
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+			{
+				LogArgumentInfo argument = take();
+				if (argument.kind != LogArgumentKind::Float) LogFormatArgumentMismatch();
+				if (length == Length::LongDouble ? argument.size != sizeof(long double) : argument.size > sizeof(f64)) LogFormatArgumentMismatch();
+				break;
+			}
+			case 's':
+				if (take().kind != (length == Length::Long ? LogArgumentKind::WideString : LogArgumentKind::String)) LogFormatArgumentMismatch();
+				break;
+			case 'S':
+				if (take().kind != (length == Length::Short ? LogArgumentKind::String : LogArgumentKind::WideString)) LogFormatArgumentMismatch();
+				break;
+			case 'p':
+			{
+				LogArgumentKind kind = take().kind;
+				if (kind != LogArgumentKind::Pointer && kind != LogArgumentKind::String && kind != LogArgumentKind::WideString) LogFormatArgumentMismatch();
+				break;
+			}
+			default:
+				// %n included, nothing logged should write through its arguments.
+				LogFormatUnsupportedConversion();
+				break;
+			}
+		}
+
+		if (next != count) LogFormatTooManyArguments();
+	}
+
+	// Reduce __FILE__ and __FUNCTION__ to what the log shows while compiling, so nothing is parsed per call.
+	consteval const c8* GetLogFileName(const c8* path)
+	{
+		const c8* name = path;
+		for (const c8* c = path; *c; ++c)
+		{
+			if (*c == '/' || *c == '\\') name = c + 1;
+		}
+		return name;
+	}
+
+	consteval const c8* GetLogFunctionName(const c8* function)
+	{
+		const c8* name = function;
+		for (const c8* c = function; *c; ++c)
+		{
+			if (c[0] == 'l' && c[1] == 'a' && c[2] == 'm' && c[3] == 'b' && c[4] == 'd' && c[5] == 'a') return "<lambda>";
+			if (*c == ':') name = c + 1;
+		}
+		return name;
+	}
+}
+namespace fw = frostwave;
@@ -0,0 +1,274 @@
+#include "LogSink.h"
+#include "BinaryLog.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace
+{
+	constexpr const c8* DarkTextColor = "\x1b[38;2;150;150;150m";
+	constexpr const c8* WhiteTextColor = "\x1b[38;2;219;221;231m";
+	constexpr const c8* ResetColor = "\x1b[0m";
+}
+
+frostwave::ConsoleSink::ConsoleSink() : m_FlashWindow(false)
+{
+#ifdef _WIN32
+#pragma warning( push )
+#pragma warning( disable : 4996 )
+	AllocConsole();
+	FILE* f = nullptr;
+	f = freopen("CONIN$", "r", stdin);
+	f = freopen("CONOUT$", "w", stdout);
+	f = freopen("CONOUT$", "w", stderr);
+
+	setbuf(stdin, NULL);
+	setbuf(stdout, NULL);
+	setbuf(stderr, NULL);
+#pragma warning( pop )
+
+	HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+
+	DWORD mode = 0;
+	GetConsoleMode(console, &mode);
+	SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+
+	_CONSOLE_SCREEN_BUFFER_INFOEX csbi;
+	csbi.cbSize = sizeof(_CONSOLE_SCREEN_BUFFER_INFOEX);
+	GetConsoleScreenBufferInfoEx(console, &csbi);
+	csbi.ColorTable[0] = (25 << 0) | (25 << 8) | (30 << 16);
+	csbi.cbSize = sizeof(csbi);
+	SetConsoleScreenBufferInfoEx(console, &csbi);
+
+	HWND hwnd = GetConsoleWindow();
+
+	SetConsoleTitle(L"Frostwave Console");
+	SetWindowLong(hwnd, GWL_EXSTYLE, GetWindowLong(hwnd, GWL_EXSTYLE) | WS_EX_LAYERED);
+	SetLayeredWindowAttributes(hwnd, 0, ConsoleAlpha, LWA_ALPHA);
+
+	MoveWindow(hwnd, 0, 0, 1250, 600, true);
+#endif
+}
+
+void frostwave::ConsoleSink::Write(const LogRecord& record)
+{
+	c8 line[16];
+	snprintf(line, sizeof(line), ":%u:", record.line);
+
+	m_Batch += DarkTextColor;
+	m_Batch += "[";
+	m_Batch += GetLevelColor(record.level);
+	m_Batch += Logger::GetLevelString(record.level);
+	m_Batch += DarkTextColor;
+	m_Batch += "] ";
+	m_Batch += record.file;
+	m_Batch += line;
+	m_Batch += record.function;
+	m_Batch += ": ";
+	m_Batch += WhiteTextColor;
+	m_Batch += record.message;
+	m_Batch += ResetColor;
+	m_Batch += '\n';
+
+	if (record.level >= Logger::Level::Error) m_FlashWindow = true;
+}
+
+void frostwave::ConsoleSink::Flush()
+{
+	if (m_Batch.empty()) return;
+
+	fwrite(m_Batch.data(), 1, m_Batch.size(), stdout);
+	fflush(stdout);
+	m_Batch.clear();
+
+#ifdef _WIN32
+	if (m_FlashWindow) FlashWindow(GetConsoleWindow(), false);
+#endif
+	m_FlashWindow = false;
+}
+
+const c8* frostwave::ConsoleSink::GetLevelColor(Logger::Level level)
+{
+	switch (level)
+	{
+	case Logger::Level::Info:
+		return "\x1b[38;2;0;150;75m";
+	case Logger::Level::Warning:
+		return "\x1b[38;2;200;200;50m";
+	case Logger::Level::Error:
+		return "\x1b[38;2;255;50;50m";
+	case Logger::Level::Fatal:
+		return "\x1b[38;2;200;50;200m";
+	default:
+		return WhiteTextColor;
+	}
+}
+
+frostwave::FileSink::FileSink(const std::string& path) : m_File(nullptr)
+{
+	if (fopen_s(&m_File, path.c_str(), "w") != 0)
+		m_File = nullptr;
+}
+
+frostwave::FileSink::~FileSink()
+{
+	if (m_File) fclose(m_File);
+}
+
+void frostwave::FileSink::Write(const LogRecord& record)
+{
+	if (!m_File) return;
+
+	c8 prefix[64];
+	snprintf(prefix, sizeof(prefix), "[%.6f][%u][%s] ", record.time, record.thread, Logger::GetLevelString(record.level));
+	c8 line[16];
+	snprintf(line, sizeof(line), ":%u:", record.line);
+
+	m_Batch += prefix;
+	m_Batch += record.file;
+	m_Batch += line;
+	m_Batch += record.function;
+	m_Batch += ": ";
+	m_Batch += record.message;
+	m_Batch += '\n';
+}
+
+void frostwave::FileSink::Flush()
+{
+	if (!m_File || m_Batch.empty()) return;
+
+	fwrite(m_Batch.data(), 1, m_Batch.size(), m_File);
+	fflush(m_File);
+	m_Batch.clear();
+}
+
+frostwave::BinaryFileSink::BinaryFileSink(const std::string& path) : m_File(nullptr), m_LastTime(0)
+{
+	if (fopen_s(&m_File, path.c_str(), "wb") != 0)
+	{
+		m_File = nullptr;
+		return;
+	}
+
+	BinaryLogHeader header = { };
+	memcpy(header.magic, BinaryLogHeader::Magic, sizeof(header.magic));
+	header.version = BinaryLogHeader::CurrentVersion;
+	header.pointerSize = (u8)sizeof(void*);
+	header.wideCharSize = (u8)sizeof(wchar_t);
+	fwrite(&header, sizeof(header), 1, m_File);
+}
+
+frostwave::BinaryFileSink::~BinaryFileSink()
+{
+	if (m_File) fclose(m_File);
+}
+
+void frostwave::BinaryFileSink::WriteBinary(const BinaryLogRecord& record)
+{
+	if (!m_File) return;
+
+	// Worst case for the fixed part of a record, one type byte and five varints.
+	constexpr u64 MaxMessageHeader = 1 + 5 * 10;
+
+	auto [site, inserted] = m_SiteIds.try_emplace(record.site, (u32)m_SiteIds.size());
+	if (inserted)
+	{
+		u64 offset = m_Batch.size();
+		m_Batch.resize(offset + 1 + 3 * 10);
+		u8* cursor = m_Batch.data() + offset;
+		*cursor++ = (u8)BinaryLogRecordType::Site;
+		cursor = WriteVarint(cursor, site->second);
+		*cursor++ = (u8)record.site->level;
+		cursor = WriteVarint(cursor, record.site->line);
+		m_Batch.resize((u64)(cursor - m_Batch.data()));
+
+		WriteString(record.site->file);
+		WriteString(record.site->function);
+		WriteString(record.site->format);
+		WriteString(record.codec->signature);
+	}
+
+	PackArguments(record);
+
+	u64 offset = m_Batch.size();
+	m_Batch.resize(offset + MaxMessageHeader + m_Packed.size());
+	u8* cursor = m_Batch.data() + offset;
+	*cursor++ = (u8)BinaryLogRecordType::Message;
+	cursor = WriteVarint(cursor, site->second);
+	cursor = WriteVarint(cursor, record.thread);
+	cursor = WriteVarint(cursor, ZigZagEncode((i64)(record.time - m_LastTime)));
+	cursor = WriteVarint(cursor, m_Packed.size());
+	if (!m_Packed.empty()) memcpy(cursor, m_Packed.data(), m_Packed.size());
+	cursor += m_Packed.size();
+	m_Batch.resize((u64)(cursor - m_Batch.data()));
+
+	m_LastTime = record.time;
+}
+
+void frostwave::BinaryFileSink::Flush()
+{
+	if (!m_File || m_Batch.empty()) return;
+
+	fwrite(m_Batch.data(), 1, m_Batch.size(), m_File);
+	fflush(m_File);
+	m_Batch.clear();
+}
+
+void frostwave::BinaryFileSink::PackArguments(const BinaryLogRecord& record)
+{
+	m_Packed.clear();
+
+	// The ring keeps every value padded to 8 bytes, most of which is zeros worth dropping from the file.
+	const u8* arguments = record.arguments;
+	for (const c8* signature = record.codec->signature; signature[0]; signature += 2)
+	{
+		c8 kind = signature[0];
+		u64 size = (u64)(signature[1] - '0');
+
+		u64 offset = m_Packed.size();
+		m_Packed.resize(offset + 10 + size);
+		u8* cursor = m_Packed.data() + offset;
+
+		if (kind == 's' || kind == 'w')
+		{
+			u64 length;
+			memcpy(&length, arguments, sizeof(u64));
+			m_Packed.resize(offset + 10 + length * size);
+			cursor = WriteVarint(m_Packed.data() + offset, length);
+			memcpy(cursor, arguments + sizeof(u64), length * size);
+			cursor += length * size;
+			arguments += (sizeof(u64) + (length + 1) * size + 7) & ~7ull;
+		}
+		else if (kind == 'f')
+		{
+			memcpy(cursor, arguments, size);
+			cursor += size;
+			arguments += (size + 7) & ~7ull;
+		}
+		else
+		{
+			u64 value = 0;
+			memcpy(&value, arguments, size < sizeof(u64) ? size : sizeof(u64));
+			if (kind == 'i')
+			{
+				if (size < sizeof(u64) && (value >> (size * 8 - 1)) & 1) value |= ~0ull << (size * 8);
+				value = ZigZagEncode((i64)value);
+			}
+			cursor = WriteVarint(cursor, value);
+			arguments += (size + 7) & ~7ull;
+		}
+
+		m_Packed.resize((u64)(cursor - m_Packed.data()));
+	}
+}
+
+void frostwave::BinaryFileSink::WriteString(const c8* string)
+{
+	u64 length = strlen(string);
+	u64 offset = m_Batch.size();
+	m_Batch.resize(offset + 10 + length);
+	u8* cursor = WriteVarint(m_Batch.data() + offset, length);
+	memcpy(cursor, string, length);
+	m_Batch.resize((u64)(cursor + length - m_Batch.data()));
+}
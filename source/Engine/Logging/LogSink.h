@@ -0,0 +1,114 @@
+#pragma once
+#include <Engine/Logging/Logger.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Makes Engine capture logs through BinaryFileSink instead of formatting them to frostwave.log.
+#ifndef FW_BINARY_LOG
+	#define FW_BINARY_LOG 0
+#endif
+
+namespace frostwave
+{
+	struct LogRecord
+	{
+		Logger::Level level;
+		// Seconds since the logger was created.
+		f64 time;
+		u32 thread;
+		std::string_view file;
+		u32 line;
+		std::string_view function;
+		std::string_view message;
+	};
+
+	// A record before formatting, the arguments are only valid during the call.
+	struct BinaryLogRecord
+	{
+		const LogSite* site;
+		const LogArgumentCodec* codec;
+		// Nanoseconds since the logger was created.
+		u64 time;
+		u32 thread;
+		const u8* arguments;
+		u64 argumentSize;
+	};
+
+	// Receives records on the logging thread one batch at a time. Records are sorted by timestamp within a batch,
+	// a record that reached its ring late can still come in a later batch than newer records of other threads.
+	// Flush is called after every batch, sinks are free to buffer until then.
+	// Records are only formatted if a text sink wants their level, binary sinks never pay for it.
+	class LogSink
+	{
+	public:
+		virtual ~LogSink() { }
+		virtual bool IsBinary() const { return false; }
+		virtual void Write(const LogRecord&) { }
+		virtual void WriteBinary(const BinaryLogRecord&) { }
+		virtual void Flush() { }
+
+		void SetLevel(Logger::Level level) { m_Level = level; }
+		Logger::Level GetLevel() const { return m_Level; }
+
+	private:
+		Logger::Level m_Level = Logger::Level::All;
+	};
+
+	// Colored output through ANSI escape sequences, also opens and styles the console window on Windows.
+	class ConsoleSink : public LogSink
+	{
+	public:
+		static constexpr i32 ConsoleAlpha = 245;
+
+		ConsoleSink();
+
+		void Write(const LogRecord& record) override;
+		void Flush() override;
+
+	private:
+		static const c8* GetLevelColor(Logger::Level level);
+
+		std::string m_Batch;
+		bool m_FlashWindow;
+	};
+
+	class FileSink : public LogSink
+	{
+	public:
+		FileSink(const std::string& path);
+		~FileSink();
+
+		void Write(const LogRecord& record) override;
+		void Flush() override;
+
+	private:
+		FILE* m_File;
+		std::string m_Batch;
+	};
+
+	// Writes call sites once and then only their id, a time delta and the raw argument bytes per record.
+	// The capture is turned back into text or JSON by the LogDecoder tool, see BinaryLog.h for the layout.
+	class BinaryFileSink : public LogSink
+	{
+	public:
+		BinaryFileSink(const std::string& path);
+		~BinaryFileSink();
+
+		bool IsBinary() const override { return true; }
+		void WriteBinary(const BinaryLogRecord& record) override;
+		void Flush() override;
+
+	private:
+		void PackArguments(const BinaryLogRecord& record);
+		void WriteString(const c8* string);
+
+		FILE* m_File;
+		std::vector<u8> m_Batch;
+		std::vector<u8> m_Packed;
+		std::unordered_map<const LogSite*, u32> m_SiteIds;
+		u64 m_LastTime;
+	};
+}
+namespace fw = frostwave;
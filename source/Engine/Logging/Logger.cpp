@@ -1,149 +1,367 @@
 #include "Logger.h"
+#include "LogSink.h"
 #include <Engine/Memory/Allocator.h>
-#include <Windows.h>
-#include <filesystem>
-#include <iostream>
-#include <cstdarg>
+#include <algorithm>
+#include <chrono>
+
+std::atomic<frostwave::Logger*> frostwave::Logger::m_Instance = nullptr;
+std::atomic<u64> frostwave::Logger::s_NextId = 1;
+std::atomic<frostwave::Logger::Level> frostwave::Logger::s_Level = frostwave::Logger::Level::All;
+std::atomic<u32> frostwave::Logger::s_ProducerEpoch = 0;
+std::atomic<u32> frostwave::Logger::s_Producers[2] = { };
+
+#pragma warning(push)
+// Padding is the point of the cache line alignment.
+#pragma warning(disable : 4324)
+// Single producer, single consumer byte ring. The owning thread writes records and publishes them by
+// advancing write, the logging thread reads them and hands the space back by advancing read.
+struct frostwave::Logger::ThreadBuffer
+{
+	alignas(Allocator::CacheLineSize) std::atomic<u64> write = 0;
+	u64 cachedRead = 0;
+
+	alignas(Allocator::CacheLineSize) std::atomic<u64> read = 0;
+	ThreadBuffer* next = nullptr;
+	std::atomic<bool> orphaned = false;
+	u32 index = 0;
 
-namespace fs = std::filesystem;
+	alignas(Allocator::CacheLineSize) u8 data[ThreadBufferSize];
+};
+#pragma warning(pop)
 
-frostwave::Logger* frostwave::Logger::m_Instance = nullptr;
+struct frostwave::Logger::PendingRecord
+{
+	u64 timestamp;
+	u32 thread;
+	const LogSite* site;
+	const LogArgumentCodec* codec;
+	const u8* arguments;
+	u64 argumentSize;
+	u64 textOffset;
+	u64 textLength;
+};
+
+namespace
+{
+	struct ThreadBufferSlot
+	{
+		void* buffer = nullptr;
+		u64 loggerId = 0;
+
+		~ThreadBufferSlot() { frostwave::Logger::ReleaseThreadBuffer(); }
+	};
+	thread_local ThreadBufferSlot t_BufferSlot;
+}
 
 void frostwave::Logger::Create()
 {
-	m_Instance = Allocate();
-	m_Instance->InitConsole();
-	m_Instance->m_Buffer = Allocate(10KB);
+	Logger* logger = Allocate();
+	logger->m_Buffer = Allocate(MessageBufferSize);
+	logger->m_Running = true;
+	logger->m_Thread = std::thread(&Logger::Run, logger);
+	s_Level = Level::All;
+	m_Instance = logger;
 }
 
 void frostwave::Logger::Destroy()
 {
-	Free(m_Instance->m_Buffer);
-	Free(m_Instance);
-	m_Instance = nullptr;
+	// Logging from here on goes straight to stdout. Threads that got the logger before are still writing
+	// their records, the logging thread keeps draining until they are done.
+	Logger* logger = m_Instance.exchange(nullptr);
+	WaitForProducers();
+
+	{
+		std::lock_guard<std::mutex> lock(logger->m_WakeMutex);
+		logger->m_Running = false;
+	}
+	logger->m_Wake.notify_one();
+	logger->m_Thread.join();
+
+	ThreadBuffer* buffer = logger->m_Buffers.exchange(nullptr);
+	while (buffer)
+	{
+		ThreadBuffer* next = buffer->next;
+		delete buffer;
+		buffer = next;
+	}
+
+	for (LogSink* sink : logger->m_Sinks)
+		Free(sink);
+	logger->m_Sinks.clear();
+
+	Free(logger->m_Buffer);
+	Free(logger);
 }
 
 void frostwave::Logger::SetLevel(Level level)
 {
-	m_Instance->m_Level = level;
+	s_Level = level;
 }
 
-void frostwave::Logger::Log(Level level, const c8* file, u32 line, const c8* function, const c8* format, ...)
+void frostwave::Logger::AddSink(LogSink* sink)
 {
-#ifdef _RETAIL
-	level; file; line; function; format;
-	return;
-#else
-	if (!m_Instance)
-	{
-		c8 buffer[512];
-
-		va_list args;
-		va_start(args, format);
-		vsprintf_s(buffer, 512, format, args);
-		va_end(args);
+	ProducerScope producer;
+	Logger* logger = m_Instance.load();
+	std::lock_guard<std::mutex> lock(logger->m_SinkMutex);
+	logger->m_Sinks.push_back(sink);
+	logger->m_HasSinks = true;
+}
 
-		printf("%s\n", buffer);
+void frostwave::Logger::Flush()
+{
+	ProducerScope producer;
+	Logger* logger = m_Instance.load();
+	if (!logger || std::this_thread::get_id() == logger->m_Thread.get_id()) return;
 
-		return;
+	// New threads can only add records after the call, so the buffers seen now are all that has to drain.
+	for (ThreadBuffer* buffer = logger->m_Buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+	{
+		u64 target = buffer->write.load(std::memory_order_acquire);
+		while (buffer->read.load(std::memory_order_acquire) < target)
+		{
+			logger->m_Wake.notify_one();
+			std::this_thread::yield();
+		}
 	}
+}
 
-	if ((c8)level < (c8)m_Instance->m_Level) return;
-	if (level == Level::All || level == Level::Count) return;
-
-	std::string filename = fs::path(file).filename().string();
+void frostwave::Logger::WaitForProducers()
+{
+	// A thread may have read the epoch just before a flip, flipping twice waits out both counts.
+	for (u32 i = 0; i < 2; ++i)
+	{
+		u32 epoch = s_ProducerEpoch.fetch_add(1) & 1;
+		while (s_Producers[epoch].load() != 0)
+			std::this_thread::yield();
+	}
+}
 
-	std::string func(function);
-	if (func.find("lambda") != std::string::npos) func = func.substr(0, func.find("lambda") + 6) + ">";
+bool frostwave::Logger::Valid()
+{
+	ProducerScope producer;
+	Logger* logger = m_Instance.load();
+	return logger && logger->m_Buffer;
+}
 
-	if (u64 pos = func.find_last_of(":"); pos != std::string::npos)
+void frostwave::Logger::ReleaseThreadBuffer()
+{
+	ThreadBufferSlot& slot = t_BufferSlot;
+	ProducerScope producer;
+	Logger* logger = m_Instance.load();
+	if (slot.buffer && logger && logger->m_Id == slot.loggerId)
 	{
-		func = func.substr(pos + 1);
+		((ThreadBuffer*)slot.buffer)->orphaned.store(true, std::memory_order_release);
 	}
+	slot.buffer = nullptr;
+	slot.loggerId = 0;
+}
+
+frostwave::Logger::Logger() : m_Id(s_NextId++), m_StartTimestamp(GetTimestamp()), m_Buffers(nullptr), m_NextThreadIndex(0), m_Running(false), m_HasSinks(false), m_Buffer(nullptr)
+{
+}
+
+frostwave::Logger::~Logger()
+{
+}
 
-	c8* buffer = m_Instance->m_Buffer;
+u64 frostwave::Logger::GetTimestamp()
+{
+	return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-	va_list args;
-	va_start(args, format);
-	vsprintf_s(buffer, 10KB, format, args);
-	va_end(args);
+void frostwave::Logger::Abort()
+{
+	Flush();
+	if (FlightRecorder* recorder = FlightRecorder::Get()) recorder->Sync();
+	abort();
+}
 
-	HWND hwnd = GetConsoleWindow();
-	if (level >= Level::Error)
+u8* frostwave::Logger::BeginRecord(u64 size)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+	u64 write = buffer->write.load(std::memory_order_relaxed);
+	u64 offset = write & (ThreadBufferSize - 1);
+	u64 contiguous = ThreadBufferSize - offset;
+
+	// Records never wrap, a record that does not fit before the end skips the rest of the ring.
+	u64 needed = contiguous < size ? contiguous + size : size;
+	if (ThreadBufferSize - (write - buffer->cachedRead) < needed)
 	{
-		FlashWindow(hwnd, false);
+		buffer->cachedRead = buffer->read.load(std::memory_order_acquire);
+		while (ThreadBufferSize - (write - buffer->cachedRead) < needed)
+		{
+			m_Wake.notify_one();
+			std::this_thread::yield();
+			buffer->cachedRead = buffer->read.load(std::memory_order_acquire);
+		}
 	}
 
-	HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
-	SetConsoleTextAttribute(console, DarkTextColorIndex);
-	printf("[");
-	SetConsoleTextAttribute(console, (c8)level);
-	printf("%s", GetLevelString(level));
-	SetConsoleTextAttribute(console, DarkTextColorIndex);
-	printf("] %s:%d:%s: ", filename.c_str(), line, func.c_str());
-	SetConsoleTextAttribute(console, WhiteTextColorIndex);
-	printf("%s\n", buffer);
-
-
+	if (contiguous < size)
+	{
+		// Too little room for a header is skipped without one, the reader knows to do the same.
+		if (contiguous >= sizeof(RecordHeader))
+		{
+			RecordHeader* padding = (RecordHeader*)(buffer->data + offset);
+			padding->size = (u32)contiguous;
+			padding->site = nullptr;
+		}
+		write += contiguous;
+		buffer->write.store(write, std::memory_order_release);
+		offset = 0;
+	}
 
-	if (level == Level::Fatal) abort();
-#endif
+	return buffer->data + offset;
 }
 
-bool frostwave::Logger::Valid()
+void frostwave::Logger::EndRecord(u64 size)
 {
-	return m_Instance && m_Instance->m_Buffer;
+	ThreadBuffer* buffer = (ThreadBuffer*)t_BufferSlot.buffer;
+	buffer->write.store(buffer->write.load(std::memory_order_relaxed) + size, std::memory_order_release);
 }
 
-frostwave::Logger::Logger() : m_Buffer(nullptr), m_Level(Level::All)
+frostwave::Logger::ThreadBuffer* frostwave::Logger::GetThreadBuffer()
 {
+	ThreadBufferSlot& slot = t_BufferSlot;
+	if (slot.buffer && slot.loggerId == m_Id) return (ThreadBuffer*)slot.buffer;
+
+	// Buffers are never freed while the logger runs, a new thread takes over the buffer of one that has exited.
+	for (ThreadBuffer* buffer = m_Buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+	{
+		bool orphaned = true;
+		if (buffer->orphaned.load(std::memory_order_relaxed) && buffer->orphaned.compare_exchange_strong(orphaned, false, std::memory_order_acquire))
+		{
+			slot.buffer = buffer;
+			slot.loggerId = m_Id;
+			return buffer;
+		}
+	}
+
+	ThreadBuffer* buffer = new ThreadBuffer;
+	buffer->index = m_NextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+
+	ThreadBuffer* head = m_Buffers.load(std::memory_order_relaxed);
+	do
+	{
+		buffer->next = head;
+	} while (!m_Buffers.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+
+	slot.buffer = buffer;
+	slot.loggerId = m_Id;
+	return buffer;
 }
 
-frostwave::Logger::~Logger()
+void frostwave::Logger::Run()
 {
+	static constexpr auto IdleWait = std::chrono::milliseconds(2);
+
+	while (m_Running.load(std::memory_order_acquire))
+	{
+		if (Drain()) continue;
+
+		std::unique_lock<std::mutex> lock(m_WakeMutex);
+		m_Wake.wait_for(lock, IdleWait);
+	}
+
+	while (Drain()) { }
 }
 
-void frostwave::Logger::InitConsole()
+bool frostwave::Logger::Drain()
 {
-#ifdef _RETAIL
-	return;
-#else
-#pragma warning( push )
-#pragma warning( disable : 4996 )
-	AllocConsole();
-	FILE* f = nullptr;
-	f = freopen("CONIN$", "r", stdin);
-	f = freopen("CONOUT$", "w", stdout);
-	f = freopen("CONOUT$", "w", stderr);
+	m_Pending.clear();
+	m_Consumed.clear();
+	m_Text.clear();
 
-	setbuf(stdin, NULL);
-	setbuf(stdout, NULL);
-	setbuf(stderr, NULL);
-#pragma warning( pop )
+	std::lock_guard<std::mutex> lock(m_SinkMutex);
 
-	HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+	// Formatting is the expensive part, records below every text sink's level skip it.
+	Level textLevel = Level::Count;
+	for (LogSink* sink : m_Sinks)
+	{
+		if (!sink->IsBinary()) textLevel = std::min(textLevel, sink->GetLevel());
+	}
+
+	for (ThreadBuffer* buffer = m_Buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+	{
+		u64 read = buffer->read.load(std::memory_order_relaxed);
+		u64 write = buffer->write.load(std::memory_order_acquire);
+		if (read == write) continue;
+
+		while (read != write)
+		{
+			u64 offset = read & (ThreadBufferSize - 1);
+			if (ThreadBufferSize - offset < sizeof(RecordHeader))
+			{
+				read += ThreadBufferSize - offset;
+				continue;
+			}
+
+			const RecordHeader* header = (const RecordHeader*)(buffer->data + offset);
+			read += header->size;
+			if (!header->site) continue;
+
+			PendingRecord& record = m_Pending.emplace_back();
+			record.timestamp = header->timestamp;
+			record.thread = buffer->index;
+			record.site = header->site;
+			record.codec = header->codec;
+			record.arguments = buffer->data + offset + sizeof(RecordHeader);
+			record.argumentSize = header->size - sizeof(RecordHeader);
+			record.textOffset = m_Text.size();
+			record.textLength = 0;
+
+			if (header->site->level >= textLevel)
+			{
+				i32 length = header->codec->format(record.arguments, header->site->format, m_Buffer, MessageBufferSize);
+				length = std::clamp(length, 0, (i32)MessageBufferSize - 1);
+				record.textLength = (u64)length;
+				m_Text.insert(m_Text.end(), m_Buffer, m_Buffer + length);
+			}
+		}
+		m_Consumed.push_back({ buffer, read });
+	}
 
-	_CONSOLE_SCREEN_BUFFER_INFOEX csbi;
-	csbi.cbSize = sizeof(_CONSOLE_SCREEN_BUFFER_INFOEX);
-	GetConsoleScreenBufferInfoEx(console, &csbi);
+	if (m_Consumed.empty()) return false;
 
-	csbi.ColorTable[0] = (25 << 0) | (25 << 8) | (30 << 16);
-	csbi.ColorTable[DarkTextColorIndex] = (150 << 0) | (150 << 8) | (150 << 16);
-	csbi.ColorTable[InfoColorIndex] = (0 << 0) | (150 << 8) | (75 << 16);
-	csbi.ColorTable[WarningColorIndex] = (200 << 0) | (200 << 8) | (50 << 16);
-	csbi.ColorTable[ErrorColorIndex] = (255 << 0) | (50 << 8) | (50 << 16);
-	csbi.ColorTable[WhiteTextColorIndex] = (219 << 0) | (221 << 8) | (231 << 16);
-	csbi.cbSize = sizeof(csbi);
-	SetConsoleScreenBufferInfoEx(console, &csbi);
+	std::stable_sort(m_Pending.begin(), m_Pending.end(), [](const PendingRecord& a, const PendingRecord& b) { return a.timestamp < b.timestamp; });
 
-	HWND hwnd = GetConsoleWindow();
+	for (const PendingRecord& pending : m_Pending)
+	{
+		LogRecord record;
+		record.level = pending.site->level;
+		record.time = (f64)(pending.timestamp - m_StartTimestamp) * 1e-9;
+		record.thread = pending.thread;
+		record.file = pending.site->file;
+		record.line = pending.site->line;
+		record.function = pending.site->function;
+		record.message = std::string_view(m_Text.data() + pending.textOffset, pending.textLength);
+
+		BinaryLogRecord binary;
+		binary.site = pending.site;
+		binary.codec = pending.codec;
+		binary.time = pending.timestamp - m_StartTimestamp;
+		binary.thread = pending.thread;
+		binary.arguments = pending.arguments;
+		binary.argumentSize = pending.argumentSize;
+
+		for (LogSink* sink : m_Sinks)
+		{
+			if (record.level < sink->GetLevel()) continue;
+
+			if (sink->IsBinary())
+				sink->WriteBinary(binary);
+			else
+				sink->Write(record);
+		}
+	}
 
-	SetConsoleTitle(L"Frostwave Console");
-	SetWindowLong(hwnd, GWL_EXSTYLE, GetWindowLong(hwnd, GWL_EXSTYLE) | WS_EX_LAYERED);
-	SetLayeredWindowAttributes(hwnd, 0, ConsoleAlpha, LWA_ALPHA);
+	for (LogSink* sink : m_Sinks)
+		sink->Flush();
 
-	MoveWindow(hwnd, 0, 0, 1250, 600, true);
-#endif
+	// Space is handed back only once the records are out, so Flush can wait on the read positions.
+	for (auto& [buffer, read] : m_Consumed)
+		buffer->read.store(read, std::memory_order_release);
+
+	return true;
 }
 
 const char* frostwave::Logger::GetLevelString(Level level)
@@ -169,4 +387,4 @@ const char* frostwave::Logger::GetLevelString(Level level)
 		return "???";
 		break;
 	}
-}
\ No newline at end of file
+}
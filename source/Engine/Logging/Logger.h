@@ -1,50 +1,199 @@
 #pragma once
 #include <Engine/Core/Types.h>
+#include <Engine/Logging/LogArgument.h>
+#include <Engine/Logging/FlightRecorder.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 
-#define VERBOSE_LOG(...) fw::Logger::Log(fw::Logger::Level::Verbose, __FILE__, __LINE__, __FUNCTION__, __VA_ARGS__);
-#define INFO_LOG(...) fw::Logger::Log(fw::Logger::Level::Info, __FILE__, __LINE__, __FUNCTION__, __VA_ARGS__);
-#define WARNING_LOG(...) fw::Logger::Log(fw::Logger::Level::Warning, __FILE__, __LINE__, __FUNCTION__, __VA_ARGS__);
-#define ERROR_LOG(...) fw::Logger::Log(fw::Logger::Level::Error, __FILE__, __LINE__, __FUNCTION__, __VA_ARGS__);
-#define FATAL_LOG(...) fw::Logger::Log(fw::Logger::Level::Fatal, __FILE__, __LINE__, __FUNCTION__, __VA_ARGS__);
+// Levels below this are compiled out, their arguments are never evaluated. Can be overridden per project.
+#ifndef FW_LOG_MIN_LEVEL
+#if defined(_RELEASE) || defined(_RETAIL)
+#define FW_LOG_MIN_LEVEL Info
+#else
+#define FW_LOG_MIN_LEVEL All
+#endif
+#endif
+
+// Every call site gets a constant descriptor, the runtime level is checked before any argument is evaluated.
+#define FW_LOG(level, format, ...) \
+	if constexpr (fw::Logger::Level::level >= fw::Logger::CompiledLevel) \
+	{ \
+		if (fw::Logger::IsEnabled(fw::Logger::Level::level)) \
+		{ \
+			static std::atomic<u32> fwLogSiteId; \
+			static constexpr fw::LogSite fwLogSite{ fw::Logger::Level::level, __LINE__, fw::GetLogFileName(__FILE__), fw::GetLogFunctionName(__FUNCTION__), format, &fwLogSiteId }; \
+			fw::Logger::Log(fwLogSite, ##__VA_ARGS__); \
+		} \
+	}
+
+#define VERBOSE_LOG(format, ...) FW_LOG(Verbose, format, ##__VA_ARGS__);
+#define INFO_LOG(format, ...) FW_LOG(Info, format, ##__VA_ARGS__);
+#define WARNING_LOG(format, ...) FW_LOG(Warning, format, ##__VA_ARGS__);
+#define ERROR_LOG(format, ...) FW_LOG(Error, format, ##__VA_ARGS__);
+#define FATAL_LOG(format, ...) FW_LOG(Fatal, format, ##__VA_ARGS__);
 
 namespace frostwave
 {
+	class LogSink;
+
+	// Log calls only copy their arguments into a ring buffer owned by the calling thread.
+	// A background thread collects them in batches, formats them sorted by timestamp and hands them to the sinks,
+	// so logging never waits on the console and is safe from any thread.
 	class Logger
 	{
 	public:
-		enum class Level : char
-		{
-			All,
-			Verbose,
-			Info,
-			Warning,
-			Error,
-			Fatal,
-			Count
-		}; 
-
-		static constexpr i32 WhiteTextColorIndex = 1;
-		static constexpr i32 InfoColorIndex = 2;
-		static constexpr i32 WarningColorIndex = 3;
-		static constexpr i32 ErrorColorIndex = 4;
-		static constexpr i32 FatalColorIndex = 5;
-		static constexpr i32 DarkTextColorIndex = 7;
-		static constexpr i32 ConsoleAlpha = 245;
+		using Level = LogLevel;
+
+		// Bytes of ring buffer every logging thread gets, a thread that fills it waits for the logging thread.
+		static constexpr u64 ThreadBufferSize = 64 * 1024;
+		static constexpr u64 MaxRecordSize = ThreadBufferSize / 4;
+		static constexpr u64 MessageBufferSize = 10 * 1024;
+		static constexpr Level CompiledLevel = Level::FW_LOG_MIN_LEVEL;
 
 		static void Create();
 		static void Destroy();
 		static void SetLevel(Level level);
-		static void Log(Level level, const c8* file, u32 line, const c8* function, const c8* format, ...);
+		// The logger takes ownership of the sink and frees it in Destroy.
+		static void AddSink(LogSink* sink);
+		// Blocks until everything logged before the call has reached the sinks.
+		static void Flush();
 		static bool Valid();
+		// True before Create as well, early messages go straight to stdout.
+		static bool IsEnabled(Level level) { return level >= s_Level.load(std::memory_order_relaxed); }
+		// Blocks until no thread is inside Log, Destroy of the logger and the flight recorder wait on it before freeing.
+		static void WaitForProducers();
+		// Lets another thread adopt the calling thread's buffer, runs automatically when a thread exits.
+		static void ReleaseThreadBuffer();
+
+		static const char* GetLevelString(Level level);
+
+		// Called through the *_LOG macros, which check the format against the arguments while compiling.
+		template <typename... Args>
+		static void Log(CheckedLogSite<std::type_identity_t<Args>...> checked, const Args&... args)
+		{
+			const LogSite& site = *checked.site;
+			ProducerScope producer;
+			Logger* logger = m_Instance.load();
+			FlightRecorder* recorder = FlightRecorder::Get();
+			// Without sinks nothing would read the ring, the flight recorder is all there is.
+			bool buffered = logger && logger->m_HasSinks.load(std::memory_order_relaxed);
+			u64 timestamp = recorder || buffered ? GetTimestamp() : 0;
+			if (recorder)
+				recorder->Record(site, &LogCodec<std::decay_t<Args>...>::Codec, timestamp, args...);
+
+			if (!buffered)
+			{
+				if (!logger) LogUnbuffered(site, args...);
+				if (site.level == Level::Fatal) Abort();
+				return;
+			}
+
+			u64 size = sizeof(RecordHeader) + (0 + ... + LogArgument<std::decay_t<Args>>::GetSize(args));
+			bool fits = size <= MaxRecordSize;
+			// A record that can not fit is logged as its bare format string rather than dropped.
+			if (!fits) size = sizeof(RecordHeader);
+			u8* record = logger->BeginRecord(size);
+
+			RecordHeader* header = (RecordHeader*)record;
+			header->size = (u32)size;
+			header->site = &site;
+			header->codec = fits ? &LogCodec<std::decay_t<Args>...>::Codec : &LogCodec<>::Codec;
+			header->timestamp = timestamp;
+
+			if (fits)
+			{
+				u8* cursor = record + sizeof(RecordHeader);
+				(LogArgument<std::decay_t<Args>>::Write(cursor, args), ...);
+			}
+
+			logger->EndRecord(size);
+
+			if (site.level == Level::Fatal) Abort();
+		}
+
 	private:
+		struct RecordHeader
+		{
+			// A record without a site only pads the ring up to its end.
+			u32 size;
+			const LogSite* site;
+			const LogArgumentCodec* codec;
+			u64 timestamp;
+		};
+		static_assert(sizeof(RecordHeader) % 8 == 0);
+
+		struct ThreadBuffer;
+
+		// Counts the threads that may be using the instances, the count goes up before either instance pointer is loaded.
+		// Threads count themselves in the current epoch, so WaitForProducers is not starved by threads that keep logging.
+		struct ProducerScope
+		{
+			ProducerScope() : epoch(s_ProducerEpoch.load() & 1) { s_Producers[epoch].fetch_add(1); }
+			~ProducerScope() { s_Producers[epoch].fetch_sub(1, std::memory_order_release); }
+			ProducerScope(const ProducerScope&) = delete;
+			ProducerScope& operator=(const ProducerScope&) = delete;
+
+			u32 epoch;
+		};
+
+		template <typename... Args>
+		static void LogUnbuffered(const LogSite& site, const Args&... args)
+		{
+			c8 buffer[512];
+			snprintf(buffer, sizeof(buffer), site.format, args...);
+			printf("%s\n", buffer);
+		}
+
 		friend class Allocator;
 		Logger();
 		~Logger();
-		static void InitConsole();
-		static const char* GetLevelString(Level level);
-		static Logger* m_Instance;
+
+		static u64 GetTimestamp();
+		// Gets everything logged so far to the sinks and the flight recorder file to disk, then aborts.
+		[[noreturn]] static void Abort();
+		u8* BeginRecord(u64 size);
+		void EndRecord(u64 size);
+		ThreadBuffer* GetThreadBuffer();
+
+		void Run();
+		bool Drain();
+
+		static std::atomic<Logger*> m_Instance;
+		static std::atomic<u64> s_NextId;
+		static std::atomic<Level> s_Level;
+		static std::atomic<u32> s_ProducerEpoch;
+		static std::atomic<u32> s_Producers[2];
+
+		u64 m_Id;
+		u64 m_StartTimestamp;
+		std::atomic<ThreadBuffer*> m_Buffers;
+		std::atomic<u32> m_NextThreadIndex;
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Running;
+		std::mutex m_WakeMutex;
+		std::condition_variable m_Wake;
+
+		std::vector<LogSink*> m_Sinks;
+		std::mutex m_SinkMutex;
+		std::atomic<bool> m_HasSinks;
+
+		// Only touched by the logging thread.
+		struct PendingRecord;
+		std::vector<PendingRecord> m_Pending;
+		std::vector<std::pair<ThreadBuffer*, u64>> m_Consumed;
+		std::vector<c8> m_Text;
 		c8* m_Buffer;
-		Level m_Level;
 	};
 }
-namespace fw = frostwave;
\ No newline at end of file
+namespace fw = frostwave;
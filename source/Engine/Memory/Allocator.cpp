@@ -1,48 +1,207 @@
 #include "Allocator.h"
-#include <malloc.h>
+#include <Engine/Platform/VirtualMemory.h>
 #include <cstring>
 #include <cassert>
+#include <bit>
+#include <new>
+#include <chrono>
 
 frostwave::Allocator* frostwave::Allocator::s_Instance = nullptr;
+std::atomic<u64> frostwave::Allocator::s_NextId = 1;
 
-frostwave::Allocator::Allocator(const Size size) : m_Memory(nullptr), m_Size(size), m_UsedSize(0_B)
+#pragma warning(push)
+// Padding is the point of the cache line alignment.
+#pragma warning(disable : 4324)
+struct alignas(frostwave::Allocator::CacheLineSize) frostwave::Allocator::ThreadCache
 {
-	m_Memory = malloc(size);
+	Block* freeLists[CachedClassCount] = { };
+	u32 counts[CachedClassCount] = { };
+
+	ThreadCache* nextCache = nullptr;
+	ThreadCache* nextOrphan = nullptr;
+
+	std::atomic<u64> hits = 0, refills = 0, remoteFrees = 0;
+
+	// Pushed to by other threads, kept on its own cache line.
+	alignas(CacheLineSize) std::atomic<Block*> remoteQueue = nullptr;
+};
+#pragma warning(pop)
+
+namespace
+{
+	struct ThreadCacheSlot
+	{
+		void* cache = nullptr;
+		u64 allocatorId = 0;
+
+		~ThreadCacheSlot() { frostwave::Allocator::ReleaseThreadCache(); }
+	};
+	thread_local ThreadCacheSlot t_CacheSlot;
 }
 
-frostwave::Allocator::~Allocator()
+frostwave::Allocator::Allocator(const Size size, Mode mode, PageMode pageMode) : m_Memory(nullptr), m_Reserved(0), m_MinCommitted(0), m_PageSize(0), m_HugePageSize(0), m_Growable(true), m_Size(0_B), m_UsedSize(0_B),
+	m_FirstBlock(nullptr), m_Sentinel(nullptr), m_FirstLevelBitmap(0), m_Pools(nullptr),
+	m_Handles(nullptr), m_HandleCount(1), m_CommittedHandles(0), m_FreeHandle(0), m_LiveHandles(0), m_DefragCursor(nullptr), m_DefragMoves(0), m_DefragMovedBytes(0), m_DefragPasses(0),
+	m_GuardFlags(GuardNone), m_GuardedLive(0), m_QuarantineLimit(0), m_QuarantineSize(0), m_QuarantineHead(nullptr), m_QuarantineTail(nullptr), m_GuardPageTypeCount(0),
+	m_Id(s_NextId++), m_Concurrent(mode == Mode::Concurrent), m_Caches(nullptr), m_OrphanedCaches(nullptr), m_LockAcquisitions(0), m_ContendedLocks(0)
 {
-	if (m_Blocks.size() > 0)
+	memset(m_SecondLevelBitmap, 0, sizeof(m_SecondLevelBitmap));
+	memset(m_FreeLists, 0, sizeof(m_FreeLists));
+
+	m_PageSize = VirtualMemory::GetPageSize();
+	m_HugePageSize = m_PageSize;
+
+	// Entry 0 is never handed out, so the null handle resolves without a range check.
+	m_Handles = (HandleEntry*)VirtualMemory::Reserve(MaxMovableHandles * sizeof(HandleEntry));
+	if (!m_Handles || !VirtualMemory::Commit(m_Handles, m_PageSize))
 	{
-		assert(false && "Trying to kill allocator with active subregions!");
-		i64 bytes = 0;
-		for (i32 i = 0; i < m_Blocks.size(); ++i)
+		FATAL_LOG("Failed to reserve the movable handle table!");
+		return;
+	}
+	m_CommittedHandles = (u32)(m_PageSize / sizeof(HandleEntry));
+
+	u64 committed = AlignUp(size.AsBytes(), m_PageSize);
+
+	if (pageMode == PageMode::ExplicitHuge)
+	{
+		u64 largePageSize = VirtualMemory::GetLargePageSize();
+		if (largePageSize)
+			m_Memory = (u8*)VirtualMemory::AllocateLarge(committed);
+
+		if (m_Memory)
+		{
+			committed = AlignUp(committed, largePageSize);
+			m_Reserved = committed;
+			m_HugePageSize = largePageSize;
+			m_Growable = false;
+		}
+		else
+		{
+			WARNING_LOG("Large pages are not available, falling back to regular pages for the allocator.");
+		}
+	}
+
+	if (!m_Memory)
+	{
+		m_Reserved = AlignUp(size.AsBytes() > DefaultReserveSize ? size.AsBytes() : DefaultReserveSize, m_PageSize);
+		m_Memory = (u8*)VirtualMemory::Reserve(m_Reserved);
+		if (!m_Memory)
+		{
+			FATAL_LOG("Failed to reserve %llu bytes of address space for the allocator!", m_Reserved);
+			return;
+		}
+
+		if (pageMode == PageMode::TransparentHuge)
 		{
-			bytes += m_Blocks[i].size;
-		#ifdef _DEBUG
-			INFO_LOG("Active region of type '%s'", m_Blocks[i].type.c_str());
-		#endif
+			if (VirtualMemory::AdviseHugePages(m_Memory, m_Reserved))
+			{
+				// Committing in huge page steps keeps the kernel from having to split them again.
+				m_HugePageSize = VirtualMemory::GetLargePageSize();
+				committed = AlignUp(committed, m_HugePageSize);
+				if (committed > m_Reserved) committed = m_Reserved;
+			}
+			else
+			{
+				WARNING_LOG("Transparent huge pages are not supported, the allocator uses regular pages.");
+			}
 		}
-		
-		INFO_LOG("Trying to kill allocator with %llu active subregions (%lluB/%lluB, %f%% full)", m_Blocks.size(), bytes, m_Size.AsBytes(), ((f32)bytes / (f32)m_Size.AsBytes())*(f64)100.0f);
+
+		if (!VirtualMemory::Commit(m_Memory, committed))
+		{
+			FATAL_LOG("Failed to commit %llu bytes for the allocator!", committed);
+			return;
+		}
+	}
+
+	assert(m_Reserved < (1ull << FirstLevelMax) && "Allocator heap is larger than the largest size class!");
+
+	m_Size = Size(committed);
+	m_MinCommitted = committed;
+
+	// The sentinel takes the last header of the committed range, so growing only has to move it.
+	u64 usable = committed - sizeof(Block);
+
+	m_FirstBlock = (Block*)m_Memory;
+	m_FirstBlock->prevPhysical = nullptr;
+	m_FirstBlock->size = usable | FreeFlag;
+
+	// Zero sized block marked as used, so the last real block always has a physical neighbour.
+	m_Sentinel = (Block*)(m_Memory + usable);
+	m_Sentinel->prevPhysical = m_FirstBlock;
+	m_Sentinel->size = PrevFreeFlag;
+
+	InsertFree(m_FirstBlock);
+}
+
+frostwave::Allocator::~Allocator()
+{
+	// Blocks sitting unused in thread caches are not leaks, hand them back before counting.
+	ThreadCache* cache = m_Caches.load(std::memory_order_acquire);
+	while (cache)
+	{
+		ThreadCache* next = cache->nextCache;
+		DrainRemoteFrees(cache);
+		for (u32 i = 0; i < CachedClassCount; ++i)
+			ReleaseCachedBlocks(cache, i, cache->counts[i]);
+
+		cache->~ThreadCache();
+		FreeBlock(GetBlock(cache));
+		cache = next;
+	}
+	m_Caches = nullptr;
+	m_OrphanedCaches = nullptr;
+
+	EvictQuarantine(0);
+	for (GuardPageRegion& region : m_GuardPageQuarantine)
+		VirtualMemory::Release(region.base, region.committed + m_PageSize);
+	m_GuardPageQuarantine.clear();
+
+	u64 count = m_GuardPages.size();
+	i64 bytes = 0;
+	for (Block* block = m_FirstBlock; block && block != m_Sentinel; block = GetNextPhysical(block))
+	{
+		if (IsFree(block)) continue;
+
+		count++;
+		bytes += GetBlockSize(block);
+	}
+
+	if (count > 0)
+	{
+		assert(false && "Trying to kill allocator with active subregions!");
+		INFO_LOG("Trying to kill allocator with %llu active subregions (%lluB/%lluB, %f%% full)", count, bytes, m_Size.AsBytes(), ((f32)bytes / (f32)m_Size.AsBytes())*(f64)100.0f);
 		return;
 	}
-	free(m_Memory);
+	VirtualMemory::Release(m_Handles, MaxMovableHandles * sizeof(HandleEntry));
+	VirtualMemory::Release(m_Memory, m_Reserved);
+	m_Memory = nullptr;
 	m_Size = 0_B;
 }
 
-void frostwave::Allocator::Create(Size maxSize)
+void frostwave::Allocator::Create(Size initialSize, Mode mode, PageMode pageMode)
 {
 	if (s_Instance)
 	{
 		FATAL_LOG("Already called Create on Allocator.");
 	}
 
-	s_Instance = new Allocator(maxSize);
+	s_Instance = new Allocator(initialSize, mode, pageMode);
 }
 
 void frostwave::Allocator::Destroy()
 {
+	if (!s_Instance) return;
+
+	while (PoolBase* pool = s_Instance->m_Pools)
+	{
+		s_Instance->m_Pools = pool->m_NextPool;
+		pool->Release();
+	}
+
+#if FW_MEMORY_TELEMETRY
+	s_Instance->m_Telemetry.ReportLeaks();
+#endif
+
 	delete s_Instance;
 	s_Instance = nullptr;
 }
@@ -52,71 +211,1054 @@ frostwave::Allocator* frostwave::Allocator::Get()
 	return s_Instance;
 }
 
+void frostwave::Allocator::ReleaseThreadCache()
+{
+	ThreadCacheSlot& slot = t_CacheSlot;
+	if (slot.cache && s_Instance && s_Instance->m_Id == slot.allocatorId)
+	{
+		s_Instance->OrphanCache((ThreadCache*)slot.cache);
+	}
+	slot.cache = nullptr;
+	slot.allocatorId = 0;
+}
+
+frostwave::Allocator::ConcurrencyStats frostwave::Allocator::GetConcurrencyStats() const
+{
+	ConcurrencyStats stats = { };
+	stats.lockAcquisitions = m_LockAcquisitions.load(std::memory_order_relaxed);
+	stats.contendedLocks = m_ContendedLocks.load(std::memory_order_relaxed);
+
+	for (ThreadCache* cache = m_Caches.load(std::memory_order_acquire); cache; cache = cache->nextCache)
+	{
+		stats.cacheHits += cache->hits.load(std::memory_order_relaxed);
+		stats.cacheRefills += cache->refills.load(std::memory_order_relaxed);
+		stats.remoteFrees += cache->remoteFrees.load(std::memory_order_relaxed);
+		stats.threadCaches++;
+	}
+	return stats;
+}
+
 #ifdef _DEBUG
 frostwave::Allocator::MemoryStats frostwave::Allocator::GetStats()
 {
-	return MemoryStats{m_Size, m_UsedSize};
+	return MemoryStats{m_Size, m_UsedSize, Size(m_Reserved)};
 }
-
-frostwave::AllocResult frostwave::Allocator::Allocate(const Size size, std::string type)
-#else
-frostwave::AllocResult frostwave::Allocator::Allocate(const Size size)
 #endif
+
+frostwave::AllocResult frostwave::Allocator::Allocate(const Size size, const c8* type, u64 alignment, const std::source_location& location)
 {
-	u64 current = 0;
-	u64 next = m_Size;
+	assert((alignment & (alignment - 1)) == 0 && "Alignment has to be a power of two!");
 
-	i32 index = 0;
-	for (; index < m_Blocks.size(); ++index)
+	if (m_GuardFlags != GuardNone)
 	{
-		next = m_Blocks[index].offset;
+		void* memory = AllocateGuarded(size.AsBytes(), type, alignment, location);
+		if (!memory) FATAL_LOG("Failed to get memory cause ran out!");
+		return AllocResult{ memory, size };
+	}
 
-		if (next - current >= size) break;
+	u64 blockSize = (size.AsBytes() + sizeof(Block) + Alignment - 1) & ~(Alignment - 1);
+	if (blockSize < MinBlockSize) blockSize = MinBlockSize;
 
-		current = next + m_Blocks[index].size;
+	Block* block = nullptr;
+	if (m_Concurrent && alignment <= Alignment && blockSize <= MaxCachedBlockSize)
+	{
+		block = AllocateCached(blockSize);
+	}
+	else
+	{
+		Lock();
+		block = AllocateBlock(blockSize, alignment);
+		Unlock();
 	}
 
-	if (current + size > m_Size)
+	if (!block)
 	{
 		FATAL_LOG("Failed to get memory cause ran out!");
 		return AllocResult{ nullptr, 0_B };
 	}
 
-	void* memory = (i8*)m_Memory + current;
-#ifdef _DEBUG
-	m_Blocks.insert(m_Blocks.begin() + index, { current, size, type, memory });
+	block->telemetry = MakeTelemetry(size.AsBytes(), type, location);
+
+	return AllocResult{ GetPayload(block), size };
+}
+
+void frostwave::Allocator::Free(void* memory)
+{
+	// The sentinel moves as the heap grows, so the unlocked check goes by the reserved range instead.
+	if (m_Concurrent && m_GuardedLive.load(std::memory_order_relaxed) == 0 && memory >= GetPayload(m_FirstBlock) && memory < (void*)(m_Memory + m_Reserved) && ((u64)memory & (Alignment - 1)) == 0)
+	{
+		// The owner tag is only written by whoever holds the block, so it can be read without the lock. It shares
+		// the free list link though, a block on the heap's free lists (a double free) has to be told apart first.
+		// The free flag of a block the caller holds never changes, neighbours only touch PrevFreeFlag.
+		if (Block* block = GetBlock(memory); !IsFree(block) && block->owner)
+		{
+			FreeCached(block);
+			return;
+		}
+	}
+
+	Lock();
+	Block* block = FindBlock(memory);
+	if (!block || IsFree(block) || IsGuarded(block))
+	{
+		if (m_GuardedLive.load(std::memory_order_relaxed) > 0 && (FreeGuarded(memory) || FreeGuardPages(memory)))
+		{
+			Unlock();
+			return;
+		}
+
+		Unlock();
+		FATAL_LOG("Tried to free memory not owned by this allocator!");
+		return;
+	}
+
+	if (block->owner)
+	{
+		// Cached blocks land here while guarded allocations are alive.
+		Unlock();
+		FreeCached(block);
+		return;
+	}
+
+	TrackFree(block);
+	FreeBlock(block);
+	Unlock();
+}
+
+void frostwave::Allocator::SetGuards(u32 flags, Size quarantineSize)
+{
+	if (flags & GuardQuarantine) flags |= GuardFill;
+
+	Lock();
+	m_GuardFlags = flags;
+	m_QuarantineLimit = (flags & GuardQuarantine) ? quarantineSize.AsBytes() : 0;
+	EvictQuarantine(m_QuarantineLimit);
+	Unlock();
+}
+
+void frostwave::Allocator::AddGuardPageType(const c8* type)
+{
+	Lock();
+	if (m_GuardPageTypeCount < MaxGuardPageTypes)
+		m_GuardPageTypes[m_GuardPageTypeCount++] = type;
+	else
+		ERROR_LOG("Too many guard page types, ignoring '%s'", type);
+	Unlock();
+}
+
+frostwave::MovableHandle frostwave::Allocator::AllocateMovable(const Size size, const c8* type, const std::source_location& location)
+{
+	u64 blockSize = AlignUp(size.AsBytes() + sizeof(Block) + sizeof(MovableHeader), Alignment);
+
+	Lock();
+	u32 index = AcquireHandle();
+	Block* block = index ? AllocateBlock(blockSize, Alignment) : nullptr;
+	if (!block)
+	{
+		Unlock();
+		FATAL_LOG("Failed to get movable memory cause ran out!");
+		return MovableHandle{ };
+	}
+
+	block->size |= MovableFlag;
+	MovableHeader* header = (MovableHeader*)GetPayload(block);
+	header->reserved = 0;
+	header->handleIndex = index;
+
+	HandleEntry& entry = m_Handles[index];
+	entry.memory = header + 1;
+	MovableHandle handle = { index, entry.generation };
+	m_LiveHandles++;
+	Unlock();
+
+	block->telemetry = MakeTelemetry(size.AsBytes(), type, location);
+
+	return handle;
+}
+
+void frostwave::Allocator::FreeMovable(MovableHandle handle)
+{
+	if (!handle) return;
+
+	Lock();
+	HandleEntry& entry = m_Handles[handle.index];
+	if (entry.generation != handle.generation)
+	{
+		Unlock();
+		FATAL_LOG("Tried to free a movable allocation that was already freed!");
+		return;
+	}
+
+	Block* block = GetBlock((MovableHeader*)entry.memory - 1);
+	TrackFree(block);
+	FreeBlock(block);
+
+	// Generation 0 is the null handle, skip it when the counter wraps.
+	if (++entry.generation == 0) entry.generation = 1;
+	entry.memory = nullptr;
+	entry.nextFree = m_FreeHandle;
+	m_FreeHandle = handle.index;
+	m_LiveHandles--;
+	Unlock();
+}
+
+void frostwave::Allocator::Defragment(f64 budgetMilliseconds)
+{
+	using Clock = std::chrono::steady_clock;
+	static constexpr u32 BlocksPerClockCheck = 64;
+
+	Lock();
+	if (m_LiveHandles == 0)
+	{
+		m_DefragCursor = nullptr;
+		Unlock();
+		return;
+	}
+
+	Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<f64, std::milli>(budgetMilliseconds));
+	Block* block = m_DefragCursor ? m_DefragCursor : m_FirstBlock;
+	for (u32 visited = 1; block != m_Sentinel; ++visited)
+	{
+		if (IsMovable(block) && IsPrevFree(block))
+			block = MoveBlock(block);
+
+		block = GetNextPhysical(block);
+		if (visited % BlocksPerClockCheck == 0 && Clock::now() >= deadline)
+			break;
+	}
+
+	if (block == m_Sentinel)
+	{
+		m_DefragCursor = nullptr;
+		m_DefragPasses++;
+		// Compaction leaves the free space at the tail, where it can be decommitted.
+		Shrink();
+	}
+	else
+	{
+		m_DefragCursor = block;
+	}
+	Unlock();
+}
+
+frostwave::Allocator::DefragStats frostwave::Allocator::GetDefragStats() const
+{
+	return DefragStats{ m_LiveHandles, m_DefragMoves, m_DefragMovedBytes, m_DefragPasses };
+}
+
+bool frostwave::Allocator::IsAllocated(void* memory)
+{
+	Lock();
+	Block* block = FindBlock(memory);
+	bool allocated = block && !IsFree(block) && !IsGuarded(block) && !(block->owner & OwnerCachedFlag);
+	if (!allocated && m_GuardedLive.load(std::memory_order_relaxed) > 0)
+	{
+		// Guarded user pointers sit behind the front padding, quarantined ones are already freed.
+		if (FindGuardedBlock(memory))
+			allocated = ((GuardHeader*)memory - 1)->canary != GuardFreedMarker;
+		else
+			allocated = m_GuardPages.contains(memory);
+	}
+	Unlock();
+	return allocated;
+}
+
+void frostwave::Allocator::RegisterPool(PoolBase* pool)
+{
+	// Pools of different types can add their first slab from different threads at the same time.
+	Lock();
+	pool->m_NextPool = m_Pools;
+	pool->m_Registered = true;
+	m_Pools = pool;
+	Unlock();
+}
+
+frostwave::Allocator::Block* frostwave::Allocator::AllocateBlock(u64 blockSize, u64 alignment)
+{
+	// Over-aligned requests search for enough room to cut off a leading gap that is large enough to be a free block.
+	u64 searchSize = alignment > Alignment ? blockSize + alignment + MinBlockSize : blockSize;
+
+	u32 firstLevel, secondLevel;
+	Block* block = FindFreeBlock(searchSize, firstLevel, secondLevel);
+	if (!block && Grow(searchSize))
+		block = FindFreeBlock(searchSize, firstLevel, secondLevel);
+
+	if (!block) return nullptr;
+
+	RemoveFree(block, firstLevel, secondLevel);
+
+	if (alignment > Alignment)
+	{
+		u64 payload = (u64)GetPayload(block);
+		u64 aligned = (payload + alignment - 1) & ~(alignment - 1);
+		if (aligned != payload && aligned - payload < MinBlockSize)
+			aligned = (payload + MinBlockSize + alignment - 1) & ~(alignment - 1);
+
+		if (u64 gap = aligned - payload; gap > 0)
+		{
+			Block* alignedBlock = GetBlock((void*)aligned);
+			alignedBlock->prevPhysical = block;
+			alignedBlock->size = (GetBlockSize(block) - gap) | PrevFreeFlag;
+			GetNextPhysical(alignedBlock)->prevPhysical = alignedBlock;
+
+			SetBlockSize(block, gap);
+			block->size |= FreeFlag;
+			InsertFree(block);
+
+			block = alignedBlock;
+		}
+	}
+
+	if (u64 remaining = GetBlockSize(block) - blockSize; remaining >= MinBlockSize)
+	{
+		Block* rest = (Block*)((u8*)block + blockSize);
+		rest->prevPhysical = block;
+		rest->size = remaining | FreeFlag;
+		GetNextPhysical(rest)->prevPhysical = rest;
+		SetBlockSize(block, blockSize);
+		InsertFree(rest);
+	}
+	else
+	{
+		GetNextPhysical(block)->size &= ~PrevFreeFlag;
+	}
+
+	block->size &= ~FreeFlag;
+	block->owner = 0;
+	block->nextCached = nullptr;
+
+	m_UsedSize = Size(m_UsedSize.AsBytes() + GetBlockSize(block));
+
+	return block;
+}
+
+void frostwave::Allocator::FreeBlock(Block* block)
+{
+	m_UsedSize = Size(m_UsedSize.AsBytes() - GetBlockSize(block));
+	block->size = (block->size | FreeFlag) & ~(MovableFlag | GuardedFlag);
+
+	// The defragment cursor has to stay on a block header, follow it when its block is merged away.
+	if (IsPrevFree(block))
+	{
+		Block* prev = block->prevPhysical;
+		RemoveFree(prev);
+		SetBlockSize(prev, GetBlockSize(prev) + GetBlockSize(block));
+		if (m_DefragCursor == block) m_DefragCursor = prev;
+		block = prev;
+	}
+
+	if (Block* next = GetNextPhysical(block); IsFree(next))
+	{
+		RemoveFree(next);
+		SetBlockSize(block, GetBlockSize(block) + GetBlockSize(next));
+		if (m_DefragCursor == next) m_DefragCursor = block;
+	}
+
+	Block* next = GetNextPhysical(block);
+	next->prevPhysical = block;
+	next->size |= PrevFreeFlag;
+
+	InsertFree(block);
+
+	if (next == m_Sentinel) Shrink();
+}
+
+frostwave::Allocator::Block* frostwave::Allocator::MoveBlock(Block* block)
+{
+	// Slides the block down to the start of the free block in front of it, the hole ends up behind it.
+	Block* prev = block->prevPhysical;
+	Block* next = GetNextPhysical(block);
+	u64 size = GetBlockSize(block);
+	u64 holeSize = GetBlockSize(prev);
+	u64 telemetry = block->telemetry;
+
+	RemoveFree(prev);
+	memmove(GetPayload(prev), GetPayload(block), size - sizeof(Block));
+
+	prev->size = size | MovableFlag | (prev->size & PrevFreeFlag);
+	prev->owner = 0;
+	prev->telemetry = telemetry;
+
+	Block* hole = (Block*)((u8*)prev + size);
+	hole->prevPhysical = prev;
+	hole->size = holeSize | FreeFlag;
+	if (IsFree(next))
+	{
+		RemoveFree(next);
+		SetBlockSize(hole, holeSize + GetBlockSize(next));
+	}
+
+	Block* after = GetNextPhysical(hole);
+	after->prevPhysical = hole;
+	after->size |= PrevFreeFlag;
+	InsertFree(hole);
+
+	MovableHeader* header = (MovableHeader*)GetPayload(prev);
+	m_Handles[header->handleIndex].memory = header + 1;
+
+	m_DefragMoves++;
+	m_DefragMovedBytes += size;
+	return prev;
+}
+
+u32 frostwave::Allocator::AcquireHandle()
+{
+	if (u32 index = m_FreeHandle; index != 0)
+	{
+		m_FreeHandle = m_Handles[index].nextFree;
+		return index;
+	}
+
+	if (m_HandleCount == MaxMovableHandles) return 0;
+
+	if (m_HandleCount == m_CommittedHandles)
+	{
+		if (!VirtualMemory::Commit(m_Handles + m_CommittedHandles, m_PageSize)) return 0;
+		m_CommittedHandles += (u32)(m_PageSize / sizeof(HandleEntry));
+	}
+
+	HandleEntry& entry = m_Handles[m_HandleCount];
+	entry.memory = nullptr;
+	entry.generation = 1;
+	entry.nextFree = 0;
+	return m_HandleCount++;
+}
+
+u64 frostwave::Allocator::MakeTelemetry(u64 size, const c8* type, const std::source_location& location)
+{
+#if FW_MEMORY_TELEMETRY
+	u32 site = m_Telemetry.Intern(type, location.file_name(), location.line());
+	m_Telemetry.OnAllocate(site, size);
+	return (size << TelemetrySiteBits) | site;
 #else
-	m_Blocks.insert(m_Blocks.begin() + index, { current, size });
+	(void)size; (void)type; (void)location;
+	return 0;
 #endif
+}
+
+void* frostwave::Allocator::AllocateGuarded(u64 size, const c8* type, u64 alignment, const std::source_location& location)
+{
+	for (u32 i = 0; i < m_GuardPageTypeCount; ++i)
+	{
+		if (m_GuardPageTypes[i] == type)
+			return AllocateGuardPages(size, type, alignment, location);
+	}
+
+	// The front padding keeps the user pointer aligned and holds the header, the tail up to the block end is back canary.
+	u64 frontPad = alignment > Alignment ? alignment : Alignment;
+	u64 blockSize = AlignUp(sizeof(Block) + frontPad + size + BackCanarySize, Alignment);
+
+	Lock();
+	Block* block = AllocateBlock(blockSize, alignment);
+	if (block) block->size |= GuardedFlag;
+	Unlock();
+	if (!block) return nullptr;
 
-	m_UsedSize = Size(m_UsedSize.AsBytes() + size.AsBytes());
+	m_GuardedLive.fetch_add(1, std::memory_order_relaxed);
+	block->telemetry = MakeTelemetry(size, type, location);
 
-	return AllocResult{ memory, size };
+	u8* payload = (u8*)GetPayload(block);
+	u8* memory = payload + frontPad;
+	u8* end = (u8*)GetNextPhysical(block);
+
+	GuardHeader* header = (GuardHeader*)memory - 1;
+	memset(payload, CanaryFill, (u8*)header - payload);
+	header->requestedSize = size;
+	header->frontPad = (u32)frontPad;
+	header->canary = GuardCanary;
+
+	if (m_GuardFlags & GuardFill) memset(memory, FreshFill, size);
+	memset(memory + size, CanaryFill, end - (memory + size));
+
+	return memory;
 }
 
-void frostwave::Allocator::Free(void* memory)
+void* frostwave::Allocator::AllocateGuardPages(u64 size, const c8* type, u64 alignment, const std::source_location& location)
+{
+	// The allocation ends right at an inaccessible page, up to alignment - 1 bytes of slack are covered by canaries instead.
+	u64 committed = AlignUp(size ? size : 1, m_PageSize);
+	u8* base = (u8*)VirtualMemory::Reserve(committed + m_PageSize);
+	if (!base) return nullptr;
+	if (!VirtualMemory::Commit(base, committed))
+	{
+		VirtualMemory::Release(base, committed + m_PageSize);
+		return nullptr;
+	}
+
+	u8* memory = (u8*)((u64)(base + committed - size) & ~(alignment - 1));
+	if (m_GuardFlags & GuardFill) memset(memory, FreshFill, size);
+	memset(memory + size, CanaryFill, base + committed - (memory + size));
+
+	Lock();
+	m_GuardPages[memory] = GuardPageRegion{ base, committed, size, MakeTelemetry(size, type, location) };
+	Unlock();
+	m_GuardedLive.fetch_add(1, std::memory_order_relaxed);
+
+	return memory;
+}
+
+frostwave::Allocator::Block* frostwave::Allocator::FindGuardedBlock(void* memory) const
+{
+	u8* ptr = (u8*)memory;
+	if (ptr < (u8*)GetPayload(m_FirstBlock) + sizeof(GuardHeader) || ptr >= (u8*)m_Sentinel || ((u64)ptr & (Alignment - 1)) != 0)
+		return nullptr;
+
+	// Anything not pointing at a real guarded block header is rejected before its contents are trusted.
+	const GuardHeader* header = (const GuardHeader*)ptr - 1;
+	u64 frontPad = header->frontPad;
+	if (frontPad < Alignment || (frontPad & (frontPad - 1)) != 0 || frontPad > (u64)(ptr - (u8*)m_Memory))
+		return nullptr;
+
+	Block* block = FindBlock(ptr - frontPad);
+	if (!block || IsFree(block) || !IsGuarded(block))
+		return nullptr;
+
+	return block;
+}
+
+bool frostwave::Allocator::FreeGuarded(void* memory)
+{
+	Block* block = FindGuardedBlock(memory);
+	if (!block)
+		return false;
+
+	GuardHeader* header = (GuardHeader*)memory - 1;
+	u64 frontPad = header->frontPad;
+
+	if (header->canary == GuardFreedMarker)
+	{
+		FATAL_LOG("Double free of %llu bytes at %p, the memory is still in quarantine!", header->requestedSize, memory);
+		return true;
+	}
+
+	CheckCanaries(block, header);
+	TrackFree(block);
+
+	if (m_GuardFlags & GuardFill) memset(memory, FreedFill, header->requestedSize);
+
+	if (m_QuarantineLimit == 0)
+	{
+		FreeBlock(block);
+		m_GuardedLive.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// While quarantined the owner word remembers where the allocation started.
+	header->canary = GuardFreedMarker;
+	block->owner = frontPad;
+	block->nextCached = nullptr;
+	if (m_QuarantineTail) m_QuarantineTail->nextCached = block;
+	else m_QuarantineHead = block;
+	m_QuarantineTail = block;
+	m_QuarantineSize += GetBlockSize(block);
+
+	EvictQuarantine(m_QuarantineLimit);
+	return true;
+}
+
+bool frostwave::Allocator::FreeGuardPages(void* memory)
+{
+	auto it = m_GuardPages.find(memory);
+	if (it == m_GuardPages.end()) return false;
+
+	GuardPageRegion region = it->second;
+	m_GuardPages.erase(it);
+
+	u8* ptr = (u8*)memory;
+	for (u8* canary = ptr + region.requestedSize; canary < region.base + region.committed; ++canary)
+	{
+		if (*canary != CanaryFill)
+		{
+			FATAL_LOG("Buffer overrun past %llu bytes at %p, canary broken at offset %llu!", region.requestedSize, memory, (u64)(canary - ptr));
+			break;
+		}
+	}
+
+#if FW_MEMORY_TELEMETRY
+	m_Telemetry.OnFree((u32)(region.telemetry & ((1ull << TelemetrySiteBits) - 1)), region.telemetry >> TelemetrySiteBits);
+#endif
+
+	// Decommitted pages fault on any access, which is the quarantine for guard page regions.
+	VirtualMemory::Decommit(region.base, region.committed);
+	m_GuardPageQuarantine.push_back(region);
+	if (m_GuardPageQuarantine.size() > GuardPageQuarantineCount)
+	{
+		GuardPageRegion& oldest = m_GuardPageQuarantine.front();
+		VirtualMemory::Release(oldest.base, oldest.committed + m_PageSize);
+		m_GuardPageQuarantine.pop_front();
+	}
+
+	m_GuardedLive.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+void frostwave::Allocator::CheckCanaries(const Block* block, const GuardHeader* header)
+{
+	if (!(m_GuardFlags & GuardCanaries)) return;
+
+	const u8* payload = (const u8*)GetPayload(block);
+	const u8* memory = (const u8*)(header + 1);
+	const u8* end = (const u8*)GetNextPhysical(block);
+
+	bool front = header->canary == GuardCanary;
+	for (const u8* canary = payload; front && canary < (const u8*)header; ++canary)
+		front = *canary == CanaryFill;
+	if (!front)
+		FATAL_LOG("Buffer underrun in front of %llu bytes at %p!", header->requestedSize, memory);
+
+	for (const u8* canary = memory + header->requestedSize; canary < end; ++canary)
+	{
+		if (*canary != CanaryFill)
+		{
+			FATAL_LOG("Buffer overrun past %llu bytes at %p, canary broken at offset %llu!", header->requestedSize, memory, (u64)(canary - memory));
+			break;
+		}
+	}
+}
+
+void frostwave::Allocator::EvictQuarantine(u64 targetSize)
+{
+	while (m_QuarantineHead && m_QuarantineSize > targetSize)
+	{
+		Block* block = m_QuarantineHead;
+		m_QuarantineHead = block->nextCached;
+		if (!m_QuarantineHead) m_QuarantineTail = nullptr;
+		m_QuarantineSize -= GetBlockSize(block);
+
+		// Anything but the freed pattern means the memory was written after it was freed.
+		const u8* memory = (const u8*)GetPayload(block) + block->owner;
+		const GuardHeader* header = (const GuardHeader*)memory - 1;
+		for (u64 i = 0; i < header->requestedSize; ++i)
+		{
+			if (memory[i] != FreedFill)
+			{
+				FATAL_LOG("Write after free to %llu bytes at %p, offset %llu was modified!", header->requestedSize, memory, i);
+				break;
+			}
+		}
+
+		block->owner = 0;
+		FreeBlock(block);
+		m_GuardedLive.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+frostwave::Allocator::Block* frostwave::Allocator::FindFreeBlock(u64 searchSize, u32& firstLevel, u32& secondLevel)
+{
+	MappingSearch(searchSize, firstLevel, secondLevel);
+
+	Block* block = FindSuitable(firstLevel, secondLevel);
+	if (!block)
+	{
+		// Rounding up can skip a block in the exact size class that still fits, only scan it before giving up.
+		Mapping(searchSize, firstLevel, secondLevel);
+		if (firstLevel < FirstLevelCount)
+		{
+			block = m_FreeLists[firstLevel][secondLevel];
+			while (block && GetBlockSize(block) < searchSize)
+				block = block->nextFree;
+		}
+	}
+	return block;
+}
+
+bool frostwave::Allocator::Grow(u64 minSize)
+{
+	if (!m_Growable) return false;
+
+	// The free tail is merged with the new pages, so only the part it can not cover has to be committed.
+	u64 tail = IsPrevFree(m_Sentinel) ? GetBlockSize(m_Sentinel->prevPhysical) : 0;
+	u64 needed = AlignUp(minSize + MinBlockSize - (tail < minSize ? tail : minSize), m_HugePageSize);
+	u64 growth = AlignUp(needed > GrowthStep ? needed : GrowthStep, m_HugePageSize);
+
+	u64 available = m_Reserved - m_Size.AsBytes();
+	if (growth > available) growth = available;
+	if (growth < needed) return false;
+
+	if (!VirtualMemory::Commit(m_Memory + m_Size.AsBytes(), growth))
+	{
+		ERROR_LOG("Failed to commit %llu more bytes for the allocator!", growth);
+		return false;
+	}
+
+	// The old sentinel becomes the header of the new pages, and a new one is placed at the end.
+	Block* block = m_Sentinel;
+	SetBlockSize(block, growth);
+	block->size |= FreeFlag;
+
+	m_Sentinel = GetNextPhysical(block);
+	m_Sentinel->size = PrevFreeFlag;
+
+	if (IsPrevFree(block))
+	{
+		Block* prev = block->prevPhysical;
+		RemoveFree(prev);
+		SetBlockSize(prev, GetBlockSize(prev) + growth);
+		block = prev;
+	}
+	m_Sentinel->prevPhysical = block;
+	InsertFree(block);
+
+	m_Size = Size(m_Size.AsBytes() + growth);
+	return true;
+}
+
+void frostwave::Allocator::Shrink()
+{
+	if (!m_Growable || !IsPrevFree(m_Sentinel)) return;
+
+	// Keeps GrowthStep of slack past the last used block, so a heap hovering around one size does not
+	// commit and decommit every frame.
+	Block* last = m_Sentinel->prevPhysical;
+	u64 keep = AlignUp((u64)((u8*)last - m_Memory) + MinBlockSize + sizeof(Block), m_HugePageSize) + GrowthStep;
+	if (keep < m_MinCommitted) keep = m_MinCommitted;
+	if (keep + GrowthStep > m_Size.AsBytes()) return;
+
+	Block* sentinel = (Block*)(m_Memory + keep - sizeof(Block));
+	RemoveFree(last);
+	SetBlockSize(last, (u64)((u8*)sentinel - (u8*)last));
+	InsertFree(last);
+
+	sentinel->prevPhysical = last;
+	sentinel->size = PrevFreeFlag;
+	m_Sentinel = sentinel;
+
+	VirtualMemory::Decommit(m_Memory + keep, m_Size.AsBytes() - keep);
+	m_Size = Size(keep);
+}
+
+void frostwave::Allocator::TrackFree(const Block* block)
+{
+#if FW_MEMORY_TELEMETRY
+	m_Telemetry.OnFree((u32)(block->telemetry & ((1ull << TelemetrySiteBits) - 1)), block->telemetry >> TelemetrySiteBits);
+#else
+	block;
+#endif
+}
+
+u32 frostwave::Allocator::GetCachedClass(u64 blockSize)
+{
+	// Blocks can come out of the heap slightly larger than asked for, they still serve the class below.
+	if (blockSize > MaxCachedBlockSize) blockSize = MaxCachedBlockSize;
+	return (u32)((blockSize - MinBlockSize) / Alignment);
+}
+
+u64 frostwave::Allocator::GetCachedClassSize(u32 cachedClass)
+{
+	return MinBlockSize + cachedClass * Alignment;
+}
+
+frostwave::Allocator::ThreadCache* frostwave::Allocator::GetThreadCache()
+{
+	ThreadCacheSlot& slot = t_CacheSlot;
+	if (slot.allocatorId == m_Id)
+		return (ThreadCache*)slot.cache;
+
+	Lock();
+	ThreadCache* cache = m_OrphanedCaches;
+	if (cache)
+	{
+		m_OrphanedCaches = cache->nextOrphan;
+		cache->nextOrphan = nullptr;
+	}
+	else
+	{
+		Block* block = AllocateBlock((sizeof(ThreadCache) + sizeof(Block) + Alignment - 1) & ~(Alignment - 1), CacheLineSize);
+		if (!block)
+		{
+			Unlock();
+			FATAL_LOG("Failed to get memory cause ran out!");
+			return nullptr;
+		}
+		cache = new (GetPayload(block)) ThreadCache();
+		cache->nextCache = m_Caches.load(std::memory_order_relaxed);
+		m_Caches.store(cache, std::memory_order_release);
+	}
+	// Reopens the queue of an adopted cache, frees that found it closed already went straight to the heap.
+	cache->remoteQueue.store(nullptr, std::memory_order_release);
+	Unlock();
+
+	slot.cache = cache;
+	slot.allocatorId = m_Id;
+	return cache;
+}
+
+frostwave::Allocator::Block* frostwave::Allocator::AllocateCached(u64 blockSize)
+{
+	ThreadCache* cache = GetThreadCache();
+	if (!cache) return nullptr;
+
+	u32 cachedClass = GetCachedClass(blockSize);
+
+	Block* block = cache->freeLists[cachedClass];
+	if (!block)
+	{
+		DrainRemoteFrees(cache);
+		block = cache->freeLists[cachedClass];
+	}
+
+	if (!block)
+		return RefillCache(cache, cachedClass);
+
+	cache->freeLists[cachedClass] = block->nextCached;
+	cache->counts[cachedClass]--;
+	cache->hits.fetch_add(1, std::memory_order_relaxed);
+
+	block->owner = MakeOwner(cache, cachedClass);
+	block->nextCached = nullptr;
+	return block;
+}
+
+void frostwave::Allocator::FreeCached(Block* block)
 {
-	for (i32 i = 0; i < m_Blocks.size(); ++i)
+	ThreadCache* owner = GetOwnerCache(block->owner);
+	u32 cachedClass = GetOwnerClass(block->owner);
+	if (block->owner & OwnerCachedFlag)
+	{
+		FATAL_LOG("Tried to free memory that was already freed!");
+		return;
+	}
+
+	// A stray pointer reads garbage as the owner tag, only trust it when it names one of our caches.
+	// Caches are never unlinked, orphaned ones stay in the list until the allocator is destroyed.
 	{
-		if ((u64)((i8*)memory - (i8*)m_Memory) == m_Blocks[i].offset)
+		ThreadCache* cache = m_Caches.load(std::memory_order_acquire);
+		while (cache && cache != owner) cache = cache->nextCache;
+		if (!cache || cachedClass >= CachedClassCount)
 		{
-			m_UsedSize = Size(m_UsedSize.AsBytes() - m_Blocks[i].size.AsBytes());
-			m_Blocks.erase(m_Blocks.begin() + i);
+			FATAL_LOG("Tried to free memory not owned by this allocator!");
 			return;
 		}
 	}
 
-	FATAL_LOG("Tried to free memory not owned by this allocator!");
+	TrackFree(block);
+
+	ThreadCacheSlot& slot = t_CacheSlot;
+	if (slot.allocatorId == m_Id && slot.cache == owner)
+	{
+		PushCached(owner, block, cachedClass);
+
+		u32 batch = (u32)(CacheRefillBytes / GetCachedClassSize(cachedClass));
+		if (owner->counts[cachedClass] > batch * 2)
+		{
+			Lock();
+			ReleaseCachedBlocks(owner, cachedClass, batch);
+			Unlock();
+		}
+		return;
+	}
+
+	owner->remoteFrees.fetch_add(1, std::memory_order_relaxed);
+
+	Block* head = owner->remoteQueue.load(std::memory_order_relaxed);
+	do
+	{
+		if (head == GetClosedQueue())
+		{
+			// The owning thread is gone, nobody is left to drain the queue.
+			Lock();
+			block->owner = 0;
+			FreeBlock(block);
+			Unlock();
+			return;
+		}
+		block->nextCached = head;
+	} while (!owner->remoteQueue.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
 }
 
-bool frostwave::Allocator::IsAllocated(void* memory)
+frostwave::Allocator::Block* frostwave::Allocator::RefillCache(ThreadCache* cache, u32 cachedClass)
+{
+	u64 blockSize = GetCachedClassSize(cachedClass);
+	u32 batch = (u32)(CacheRefillBytes / blockSize);
+
+	cache->refills.fetch_add(1, std::memory_order_relaxed);
+
+	Lock();
+	Block* result = AllocateBlock(blockSize, Alignment);
+	for (u32 i = 1; result && i < batch; ++i)
+	{
+		Block* block = AllocateBlock(blockSize, Alignment);
+		if (!block) break;
+
+		PushCached(cache, block, cachedClass);
+	}
+	Unlock();
+
+	if (result)
+		result->owner = MakeOwner(cache, cachedClass);
+	return result;
+}
+
+void frostwave::Allocator::DrainRemoteFrees(ThreadCache* cache)
+{
+	// Only the owning thread drains or closes its queue, so a closed queue cannot reopen underneath us.
+	Block* head = cache->remoteQueue.load(std::memory_order_relaxed);
+	if (!head || head == GetClosedQueue()) return;
+
+	Block* block = cache->remoteQueue.exchange(nullptr, std::memory_order_acquire);
+	while (block)
+	{
+		Block* next = block->nextCached;
+		PushCached(cache, block, GetOwnerClass(block->owner));
+		block = next;
+	}
+}
+
+void frostwave::Allocator::PushCached(ThreadCache* cache, Block* block, u32 cachedClass)
+{
+	block->owner = MakeOwner(cache, cachedClass) | OwnerCachedFlag;
+	block->nextCached = cache->freeLists[cachedClass];
+	cache->freeLists[cachedClass] = block;
+	cache->counts[cachedClass]++;
+}
+
+void frostwave::Allocator::ReleaseCachedBlocks(ThreadCache* cache, u32 cachedClass, u32 count)
+{
+	for (u32 i = 0; i < count && cache->freeLists[cachedClass]; ++i)
+	{
+		Block* block = cache->freeLists[cachedClass];
+		cache->freeLists[cachedClass] = block->nextCached;
+		cache->counts[cachedClass]--;
+
+		block->owner = 0;
+		block->nextCached = nullptr;
+		FreeBlock(block);
+	}
+}
+
+void frostwave::Allocator::OrphanCache(ThreadCache* cache)
+{
+	// Closing the queue sends late remote frees straight to the heap instead of into a cache nobody drains.
+	Block* remote = cache->remoteQueue.exchange(GetClosedQueue(), std::memory_order_acquire);
+	while (remote)
+	{
+		Block* next = remote->nextCached;
+		PushCached(cache, remote, GetOwnerClass(remote->owner));
+		remote = next;
+	}
+
+	Lock();
+	for (u32 i = 0; i < CachedClassCount; ++i)
+		ReleaseCachedBlocks(cache, i, cache->counts[i]);
+
+	cache->nextOrphan = m_OrphanedCaches;
+	m_OrphanedCaches = cache;
+	Unlock();
+}
+
+void frostwave::Allocator::Lock()
+{
+	if (!m_Concurrent) return;
+
+	if (!m_Mutex.try_lock())
+	{
+		m_ContendedLocks.fetch_add(1, std::memory_order_relaxed);
+		m_Mutex.lock();
+	}
+	m_LockAcquisitions.fetch_add(1, std::memory_order_relaxed);
+}
+
+void frostwave::Allocator::Unlock()
+{
+	if (!m_Concurrent) return;
+	m_Mutex.unlock();
+}
+
+void frostwave::Allocator::Mapping(u64 size, u32& firstLevel, u32& secondLevel)
+{
+	if (size < SmallBlockSize)
+	{
+		firstLevel = 0;
+		secondLevel = (u32)(size >> AlignmentLog2);
+		return;
+	}
+
+	u32 highBit = (u32)std::bit_width(size) - 1;
+	secondLevel = (u32)((size >> (highBit - SecondLevelLog2)) ^ SecondLevelCount);
+	firstLevel = highBit - (u32)(FirstLevelShift - 1);
+}
+
+void frostwave::Allocator::MappingSearch(u64 size, u32& firstLevel, u32& secondLevel)
 {
-	for (i32 i = 0; i < m_Blocks.size(); ++i)
+	// Round up to the next size class so every block in the found list is large enough.
+	if (size >= SmallBlockSize)
 	{
-		if ((u64)((i8*)memory - (i8*)m_Memory) == m_Blocks[i].offset)
+		size += (1ull << (std::bit_width(size) - 1 - SecondLevelLog2)) - 1;
+	}
+	Mapping(size, firstLevel, secondLevel);
+}
+
+frostwave::Allocator::Block* frostwave::Allocator::FindSuitable(u32& firstLevel, u32& secondLevel)
+{
+	if (firstLevel >= FirstLevelCount) return nullptr;
+
+	u32 secondLevelMap = m_SecondLevelBitmap[firstLevel] & (~0u << secondLevel);
+	if (!secondLevelMap)
+	{
+		u64 firstLevelMap = (firstLevel + 1 < 64) ? (m_FirstLevelBitmap & (~0ull << (firstLevel + 1))) : 0;
+		if (!firstLevelMap) return nullptr;
+
+		firstLevel = (u32)std::countr_zero(firstLevelMap);
+		secondLevelMap = m_SecondLevelBitmap[firstLevel];
+	}
+
+	secondLevel = (u32)std::countr_zero(secondLevelMap);
+	return m_FreeLists[firstLevel][secondLevel];
+}
+
+void frostwave::Allocator::InsertFree(Block* block)
+{
+	u32 firstLevel, secondLevel;
+	Mapping(GetBlockSize(block), firstLevel, secondLevel);
+
+	Block* head = m_FreeLists[firstLevel][secondLevel];
+	block->nextFree = head;
+	block->prevFree = nullptr;
+	if (head) head->prevFree = block;
+
+	m_FreeLists[firstLevel][secondLevel] = block;
+	m_FirstLevelBitmap |= 1ull << firstLevel;
+	m_SecondLevelBitmap[firstLevel] |= 1u << secondLevel;
+}
+
+void frostwave::Allocator::RemoveFree(Block* block)
+{
+	u32 firstLevel, secondLevel;
+	Mapping(GetBlockSize(block), firstLevel, secondLevel);
+	RemoveFree(block, firstLevel, secondLevel);
+}
+
+void frostwave::Allocator::RemoveFree(Block* block, u32 firstLevel, u32 secondLevel)
+{
+	if (block->nextFree) block->nextFree->prevFree = block->prevFree;
+	if (block->prevFree) block->prevFree->nextFree = block->nextFree;
+
+	if (m_FreeLists[firstLevel][secondLevel] == block)
+	{
+		m_FreeLists[firstLevel][secondLevel] = block->nextFree;
+		if (!block->nextFree)
 		{
-			return true;
+			m_SecondLevelBitmap[firstLevel] &= ~(1u << secondLevel);
+			if (!m_SecondLevelBitmap[firstLevel])
+				m_FirstLevelBitmap &= ~(1ull << firstLevel);
 		}
 	}
-	return false;
+
+	block->nextFree = nullptr;
+	block->prevFree = nullptr;
+}
+
+frostwave::Allocator::Block* frostwave::Allocator::FindBlock(void* memory) const
+{
+	u8* ptr = (u8*)memory;
+	if (!m_FirstBlock || ptr < (u8*)GetPayload(m_FirstBlock) || ptr >= (u8*)m_Sentinel) return nullptr;
+	if (((u64)ptr & (Alignment - 1)) != 0) return nullptr;
+
+	// A real block header links back from its physical neighbour, so stray pointers into a payload are rejected.
+	Block* block = GetBlock(memory);
+	u64 size = GetBlockSize(block);
+	if (size < MinBlockSize || (u8*)block + size > (u8*)m_Sentinel) return nullptr;
+	if (GetNextPhysical(block)->prevPhysical != block) return nullptr;
+
+	return block;
 }
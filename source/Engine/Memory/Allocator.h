@@ -2,11 +2,23 @@
 #include <Engine/Core/Types.h>
 #include <Engine/Logging/Logger.h>
 #include <Engine/Memory/Size.h>
+#include <Engine/Memory/Telemetry.h>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <type_traits>
 #include <typeinfo>
+#include <cassert>
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <unordered_map>
+#include <source_location>
+
+// Soak builds define this to run the whole engine with guarded allocations.
+#ifndef FW_MEMORY_GUARDS
+	#define FW_MEMORY_GUARDS 0
+#endif
 
 template <class, class = void>
 struct is_defined : std::false_type { };
@@ -22,60 +34,202 @@ namespace frostwave
 		Size size;
 	};
 
+	class PoolBase;
+	template <typename T> class Pool;
+
+	// Generational reference to a movable allocation. A handle whose allocation was freed no longer resolves,
+	// so a stale handle is caught by comparing one integer instead of touching freed memory.
+	struct MovableHandle
+	{
+		u32 index = 0;
+		u32 generation = 0;
+
+		explicit operator bool() const { return generation != 0; }
+		bool operator==(const MovableHandle& other) const { return index == other.index && generation == other.generation; }
+	};
+
+	// Specialized through FW_REGISTER_POOL for types that are allocated from a Pool.
+	template <typename T>
+	struct PoolTraits
+	{
+		static constexpr u64 SlabCapacity = 0;
+	};
+
+	template <typename T>
+	inline constexpr bool IsPooled = PoolTraits<std::remove_cv_t<T>>::SlabCapacity > 0;
+
+	// Two-level segregated fit allocator (TLSF) over a single preallocated heap.
+	// Allocate and Free are O(1): free blocks are bucketed by size class in a two-level bitmap,
+	// and physically adjacent free blocks are coalesced on Free.
+	//
+	// The heap lives in a reserved range of address space. Pages are committed as the heap grows,
+	// and a large free tail is decommitted again, so running past the initial size is not fatal.
+	//
+	// Guards trade speed for catching heap corruption: canaries around every allocation are checked on Free,
+	// fresh and freed memory is filled with recognizable patterns, and freed blocks wait in a quarantine
+	// where writes after free are detected before the memory is reused. Selected types can instead get
+	// their own pages with an inaccessible page right behind them, so an overrun faults on the spot.
+	//
+	// Movable allocations are only reachable through a MovableHandle, which lets Defragment slide them down
+	// into the free space in front of them, a bounded amount of work per frame.
+	//
+	// In Concurrent mode the heap is guarded by a mutex and every thread gets a cache of small blocks,
+	// refilled from the heap in batches. Blocks freed by another thread go back to their owning cache
+	// through a lock-free return queue.
 	class Allocator
 	{
 	public:
-		Allocator(const Size size);
+		static constexpr u64 DefaultAlignment = 16;
+		static constexpr u64 CacheLineSize = 64;
+
+		// Address space reserved for the heap unless Create is asked for more up front, nothing is committed until used.
+		static constexpr u64 DefaultReserveSize = 64ull * 1024 * 1024 * 1024;
+		// Smallest amount the heap grows by, and the free tail it keeps committed before handing pages back.
+		static constexpr u64 GrowthStep = 8ull * 1024 * 1024;
+		static constexpr u32 MaxMovableHandles = 1u << 20;
+
+		// Same patterns as the MSVC debug heap, so they read the same in the debugger.
+		static constexpr u8 FreshFill = 0xCD;
+		static constexpr u8 FreedFill = 0xDD;
+		static constexpr u8 CanaryFill = 0xFD;
+
+		enum GuardFlags : u32
+		{
+			GuardNone = 0,
+			GuardCanaries = 1 << 0,
+			GuardFill = 1 << 1,
+			// Implies GuardFill, the freed pattern is what the quarantine checks.
+			GuardQuarantine = 1 << 2,
+			GuardAll = GuardCanaries | GuardFill | GuardQuarantine
+		};
+		static constexpr u64 DefaultQuarantineSize = 16ull * 1024 * 1024;
+		static constexpr u32 MaxGuardPageTypes = 16;
+		static constexpr u32 GuardPageQuarantineCount = 1024;
+
+		enum class Mode
+		{
+			SingleThreaded,
+			Concurrent
+		};
+
+		enum class PageMode
+		{
+			Default,
+			// Hints the OS to back the heap with huge pages, commits happen in huge page steps.
+			TransparentHuge,
+			// Commits the whole heap in large pages up front, it can neither grow nor shrink.
+			// Falls back to Default when large pages are unavailable (on Windows that needs SeLockMemoryPrivilege).
+			ExplicitHuge
+		};
+
+		Allocator(const Size size, Mode mode = Mode::SingleThreaded, PageMode pageMode = PageMode::Default);
 		~Allocator();
 
-		static void Create(Size maxSize);
+		// initialSize is committed right away, the heap grows on demand up to DefaultReserveSize.
+		static void Create(Size initialSize, Mode mode = Mode::SingleThreaded, PageMode pageMode = PageMode::Default);
 		static void Destroy();
 
 		static Allocator* Get();
 
-	#ifdef _DEBUG 
+		// Hands the calling thread's cache back to the allocator, runs automatically when a thread exits.
+		static void ReleaseThreadCache();
+
+		struct ConcurrencyStats
+		{
+			u64 lockAcquisitions;
+			u64 contendedLocks;
+			u64 cacheHits;
+			u64 cacheRefills;
+			u64 remoteFrees;
+			u64 threadCaches;
+		};
+		ConcurrencyStats GetConcurrencyStats() const;
+
+		struct DefragStats
+		{
+			u64 liveHandles;
+			u64 moves;
+			u64 movedBytes;
+			u64 passes;
+		};
+		DefragStats GetDefragStats() const;
+
+	#if FW_MEMORY_TELEMETRY
+		MemoryTelemetry& GetTelemetry() { return m_Telemetry; }
+	#endif
+
+	#ifdef _DEBUG
 		struct MemoryStats
 		{
 			Size max;
 			Size current;
+			Size reserved;
 		};
 		MemoryStats GetStats();
-
-		AllocResult Allocate(const Size size, std::string type);
-	#else
-		AllocResult Allocate(const Size size);
 	#endif
 
+		// The type name and callsite are what telemetry attributes the allocation to.
+		AllocResult Allocate(const Size size, const c8* type, u64 alignment = DefaultAlignment, const std::source_location& location = std::source_location::current());
+
 		void Free(void* memory);
 		bool IsAllocated(void* memory);
 
+		// Applies to allocations made from now on, set it right after Create. Guarded allocations bypass the thread caches.
+		// Pooled types keep coming from their pools and are never guarded.
+		void SetGuards(u32 flags, Size quarantineSize = Size(DefaultQuarantineSize));
+		// Allocations with this type name get guard pages while guards are enabled.
+		// Matched by pointer, pass the same string the allocations use (typeid(T).name() for Allocate<T>).
+		void AddGuardPageType(const c8* type);
+
+		// Movable memory is always DefaultAlignment aligned and may move during Defragment,
+		// so resolved pointers must not be kept across it.
+		MovableHandle AllocateMovable(const Size size, const c8* type, const std::source_location& location = std::source_location::current());
+		void FreeMovable(MovableHandle handle);
+		// False once the allocation is freed, even if its slot has been handed out again since.
+		bool IsValid(MovableHandle handle) const { return handle.generation != 0 && m_Handles[handle.index].generation == handle.generation; }
+		// Returns nullptr for a freed or null handle, stale handles also assert.
+		void* Resolve(MovableHandle handle) const
+		{
+			if (IsValid(handle)) return m_Handles[handle.index].memory;
+
+			assert(!handle && "Resolving a handle to memory that has been freed!");
+			return nullptr;
+		}
+
+		// Moves movable blocks down into the free space before them until the budget runs out,
+		// the next call continues where this one stopped. Call it where no resolved pointers are held.
+		void Defragment(f64 budgetMilliseconds);
+
+		void RegisterPool(PoolBase* pool);
+
 		class NewResult
 		{
 		public:
-			NewResult(u64 amount) : m_Amount(amount) { }
+			NewResult(u64 amount, const std::source_location& location) : m_Amount(amount), m_Location(location) { }
 
 			template<typename T>
 			operator T () const
 			{
-				if constexpr (!std::is_pointer_v<T>)
+				static_assert(std::is_pointer_v<T>, "Allocate needs to be called with a pointer type as the return value!");
+
+				AllocResult res = { nullptr, Size(0) };
+				if constexpr (IsPooled<std::remove_pointer_t<T>>)
 				{
-					static_assert(false, "Allocate needs to be called with a pointer type as the return value!");
+					assert(m_Amount == 1 && "Pooled types can only be allocated one at a time!");
+					res = AllocResult{ Pool<std::remove_pointer_t<T>>::Get()->Allocate(m_Location), Size(sizeof(std::remove_pointer_t<T>)) };
+				}
+				else
+				{
+					res = Allocator::Get()->Allocate(Size::Bytes(sizeof(std::remove_pointer_t<T>) * m_Amount), typeid(std::remove_pointer_t<T>).name(), alignof(std::remove_pointer_t<T>), m_Location);
 				}
 
-#ifdef _DEBUG
-				AllocResult res = Allocator::Get()->Allocate(Size::Bytes(sizeof(std::remove_pointer_t<T>) * m_Amount), typeid(std::remove_pointer_t<T>).name());
-#else
-				AllocResult res = Allocator::Get()->Allocate(Size::Bytes(sizeof(std::remove_pointer_t<T>) * m_Amount));
-#endif
-
-#ifdef _DEBUG
-				if (Logger::Valid())
+				if constexpr (Logger::Level::Verbose >= Logger::CompiledLevel)
 				{
-					f64 used = (f64)(Allocator::Get()->m_UsedSize / 1024.0 / 1024.0);
-					f64 max = (f64)(Allocator::Get()->m_Size / 1024.0 / 1024.0);
-					VERBOSE_LOG("Allocated %llux of type %s - size: %llu bytes - %f%% used", m_Amount, typeid(std::remove_pointer_t<T>).name(), res.size.AsBytes(), used/max*100.0);
+					if (Logger::Valid())
+					{
+						VERBOSE_LOG("Allocated %llux of type %s - size: %llu bytes - %f%% used", m_Amount, typeid(std::remove_pointer_t<T>).name(), res.size.AsBytes(), (f64)Allocator::Get()->m_UsedSize / (f64)Allocator::Get()->m_Size * 100.0);
+					}
 				}
-#endif
 
 				if constexpr (std::is_trivially_constructible_v<T>)
 				{
@@ -90,41 +244,272 @@ namespace frostwave
 			}
 		private:
 			u64 m_Amount;
+			std::source_location m_Location;
 		};
 
 	private:
-		static Allocator* s_Instance;
+		static constexpr u64 AlignmentLog2 = 4;
+		static constexpr u64 Alignment = 1ull << AlignmentLog2;
+		static_assert(Alignment == DefaultAlignment);
+		static constexpr u64 SecondLevelLog2 = 4;
+		static constexpr u64 SecondLevelCount = 1ull << SecondLevelLog2;
+		static constexpr u64 FirstLevelShift = SecondLevelLog2 + AlignmentLog2;
+		static constexpr u64 FirstLevelMax = 40;
+		static constexpr u64 FirstLevelCount = FirstLevelMax - FirstLevelShift + 1;
+		static constexpr u64 SmallBlockSize = 1ull << FirstLevelShift;
 
-		void* m_Memory;
-		Size m_Size, m_UsedSize;
+		static constexpr u64 FreeFlag = 1 << 0;
+		static constexpr u64 PrevFreeFlag = 1 << 1;
+		static constexpr u64 MovableFlag = 1 << 2;
+		static constexpr u64 GuardedFlag = 1 << 3;
+		static constexpr u64 FlagMask = FreeFlag | PrevFreeFlag | MovableFlag | GuardedFlag;
+		static_assert(FlagMask < Alignment, "Block flags have to fit below the size alignment!");
+
+		// Header placed in front of every block, the size includes the header itself.
+		// While a block is allocated the free list links are reused: owner tags blocks that belong to a thread cache
+		// (cache pointer, size class and a bit set while it sits in the cache), nextCached links cached and remotely freed blocks.
+		// While the block is handed out, telemetry holds its site and requested size instead.
+		struct alignas(Alignment) Block
+		{
+			Block* prevPhysical;
+			u64 size;
+			union { Block* nextFree; u64 owner; };
+			union { Block* prevFree; Block* nextCached; u64 telemetry; };
+		};
+
+		static constexpr u64 TelemetrySiteBits = 16;
+		static_assert(MemoryTelemetry::MaxSites <= (1ull << TelemetrySiteBits) && FirstLevelMax <= 64 - TelemetrySiteBits);
 
-		struct Block
+		static constexpr u64 MinBlockSize = sizeof(Block) + Alignment;
+
+		// Movable payloads start with the index of their handle, so Defragment can patch the table after a move.
+		// The first word stays zero so a movable pointer passed to Free never looks like a cached block.
+		struct MovableHeader
 		{
-			u64 offset;
-			Size size;
-		#ifdef _DEBUG
-			std::string type;
-			void* ptr;
-		#endif
+			u64 reserved;
+			u64 handleIndex;
 		};
-		std::vector<Block> m_Blocks;
+		static_assert(sizeof(MovableHeader) == Alignment);
+
+		// Sits right in front of a guarded allocation, the rest of the front padding and the tail of the block are canary bytes.
+		struct GuardHeader
+		{
+			u64 requestedSize;
+			u32 frontPad;
+			u32 canary;
+		};
+		static constexpr u32 GuardCanary = 0xFDFDFDFD;
+		// Replaces the canary while the block is quarantined, so a second Free is told apart from corruption.
+		static constexpr u32 GuardFreedMarker = 0xDDDDDDDD;
+		static constexpr u64 BackCanarySize = Alignment;
+
+		struct GuardPageRegion
+		{
+			u8* base;
+			u64 committed;
+			u64 requestedSize;
+			u64 telemetry;
+		};
+
+		struct HandleEntry
+		{
+			void* memory;
+			u32 generation;
+			u32 nextFree;
+		};
+
+		static constexpr u64 MaxCachedBlockSize = 512;
+		static constexpr u64 CachedClassCount = (MaxCachedBlockSize - MinBlockSize) / Alignment + 1;
+		static constexpr u64 CacheRefillBytes = 4096;
+
+		// The size class travels in the owner tag, a cached block's size field belongs to the heap lock.
+		static constexpr u64 OwnerCachedFlag = 1;
+		static constexpr u64 OwnerClassShift = 1;
+		static constexpr u64 OwnerClassMask = (CacheLineSize - 1) >> OwnerClassShift;
+		static_assert(CachedClassCount <= OwnerClassMask + 1, "Cached size classes do not fit in the owner tag!");
+
+		struct ThreadCache;
+
+		static u64 GetBlockSize(const Block* block) { return block->size & ~FlagMask; }
+		static void SetBlockSize(Block* block, u64 size) { block->size = size | (block->size & FlagMask); }
+		static u64 AlignUp(u64 value, u64 alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+		static bool IsFree(const Block* block) { return block->size & FreeFlag; }
+		static bool IsPrevFree(const Block* block) { return block->size & PrevFreeFlag; }
+		static bool IsMovable(const Block* block) { return block->size & MovableFlag; }
+		static bool IsGuarded(const Block* block) { return block->size & GuardedFlag; }
+		static Block* GetNextPhysical(const Block* block) { return (Block*)((u8*)block + GetBlockSize(block)); }
+		static void* GetPayload(const Block* block) { return (u8*)block + sizeof(Block); }
+		static Block* GetBlock(const void* memory) { return (Block*)((u8*)memory - sizeof(Block)); }
+
+		static void Mapping(u64 size, u32& firstLevel, u32& secondLevel);
+		static void MappingSearch(u64 size, u32& firstLevel, u32& secondLevel);
+
+		Block* FindSuitable(u32& firstLevel, u32& secondLevel);
+		void InsertFree(Block* block);
+		void RemoveFree(Block* block);
+		void RemoveFree(Block* block, u32 firstLevel, u32 secondLevel);
+		Block* FindBlock(void* memory) const;
+
+		Block* FindFreeBlock(u64 searchSize, u32& firstLevel, u32& secondLevel);
+		bool Grow(u64 minSize);
+		void Shrink();
+
+		Block* AllocateBlock(u64 blockSize, u64 alignment);
+		void FreeBlock(Block* block);
+		Block* MoveBlock(Block* block);
+		u32 AcquireHandle();
+
+		void* AllocateGuarded(u64 size, const c8* type, u64 alignment, const std::source_location& location);
+		void* AllocateGuardPages(u64 size, const c8* type, u64 alignment, const std::source_location& location);
+		// Both return false when memory is not a guarded allocation, they are called with the lock held.
+		// Returns the block of a live or quarantined guarded allocation, memory is the pointer handed to the user.
+		Block* FindGuardedBlock(void* memory) const;
+		bool FreeGuarded(void* memory);
+		bool FreeGuardPages(void* memory);
+		void CheckCanaries(const Block* block, const GuardHeader* header);
+		void EvictQuarantine(u64 targetSize);
+		u64 MakeTelemetry(u64 size, const c8* type, const std::source_location& location);
+		void TrackFree(const Block* block);
+
+		static u32 GetCachedClass(u64 blockSize);
+		static u64 GetCachedClassSize(u32 cachedClass);
+		static Block* GetClosedQueue() { return (Block*)1; }
+		static u64 MakeOwner(const ThreadCache* cache, u32 cachedClass) { return (u64)cache | ((u64)cachedClass << OwnerClassShift); }
+		static ThreadCache* GetOwnerCache(u64 owner) { return (ThreadCache*)(owner & ~(CacheLineSize - 1)); }
+		static u32 GetOwnerClass(u64 owner) { return (u32)((owner >> OwnerClassShift) & OwnerClassMask); }
+
+		ThreadCache* GetThreadCache();
+		Block* AllocateCached(u64 blockSize);
+		void FreeCached(Block* block);
+		Block* RefillCache(ThreadCache* cache, u32 cachedClass);
+		void DrainRemoteFrees(ThreadCache* cache);
+		void PushCached(ThreadCache* cache, Block* block, u32 cachedClass);
+		void ReleaseCachedBlocks(ThreadCache* cache, u32 cachedClass, u32 count);
+		void OrphanCache(ThreadCache* cache);
+
+		void Lock();
+		void Unlock();
+
+		static Allocator* s_Instance;
+		static std::atomic<u64> s_NextId;
+
+		u8* m_Memory;
+		u64 m_Reserved;
+		u64 m_MinCommitted;
+		// The OS base page size, used for the handle table and guard pages.
+		u64 m_PageSize;
+		// The step the heap is committed, grown and shrunk in. Equal to m_PageSize unless huge pages are in use.
+		u64 m_HugePageSize;
+		bool m_Growable;
+		// Committed size of the heap.
+		Size m_Size, m_UsedSize;
+
+		Block* m_FirstBlock;
+		Block* m_Sentinel;
+		u64 m_FirstLevelBitmap;
+		u32 m_SecondLevelBitmap[FirstLevelCount];
+		Block* m_FreeLists[FirstLevelCount][SecondLevelCount];
+
+		PoolBase* m_Pools;
+
+		// Reserved up front so Resolve never races a reallocation of the table.
+		HandleEntry* m_Handles;
+		u32 m_HandleCount, m_CommittedHandles;
+		u32 m_FreeHandle;
+		u64 m_LiveHandles;
+		Block* m_DefragCursor;
+		u64 m_DefragMoves, m_DefragMovedBytes, m_DefragPasses;
+
+		u32 m_GuardFlags;
+		// Guarded blocks, guard page regions and quarantined blocks still alive. Free skips the lock-free path while any exist.
+		std::atomic<u64> m_GuardedLive;
+		u64 m_QuarantineLimit, m_QuarantineSize;
+		Block* m_QuarantineHead;
+		Block* m_QuarantineTail;
+		const c8* m_GuardPageTypes[MaxGuardPageTypes];
+		u32 m_GuardPageTypeCount;
+		std::unordered_map<void*, GuardPageRegion> m_GuardPages;
+		std::deque<GuardPageRegion> m_GuardPageQuarantine;
+
+		u64 m_Id;
+		bool m_Concurrent;
+		std::mutex m_Mutex;
+		std::atomic<ThreadCache*> m_Caches;
+		ThreadCache* m_OrphanedCaches;
+		std::atomic<u64> m_LockAcquisitions, m_ContendedLocks;
+
+	#if FW_MEMORY_TELEMETRY
+		MemoryTelemetry m_Telemetry;
+	#endif
+	};
+}
+
+#include <Engine/Memory/Pool.h>
+
+namespace frostwave
+{
+#pragma warning(push)
+#pragma warning(disable : 4324)
+	// Pads a value out to its own cache line, for per-thread data that would otherwise suffer from false sharing.
+	template <typename T>
+	struct alignas(Allocator::CacheLineSize) CacheAligned
+	{
+		T value;
 	};
+#pragma warning(pop)
 
+	// Constructs a T, telemetry attributes it to location.
 	template <typename T, typename... Ts>
-	inline static T* Allocate(Ts&&... args) {
-#ifdef _DEBUG 
-		AllocResult result = Allocator::Get()->Allocate(Size(sizeof(T)), typeid(T).name());
-#else
-		AllocResult result = Allocator::Get()->Allocate(Size(sizeof(T)));
-#endif
-		T* ret = new (result.mem) T(std::forward<Ts>(args)...);
+	inline static T* AllocateAt(const std::source_location& location, Ts&&... args) {
+		void* memory;
+		if constexpr (IsPooled<T>)
+		{
+			memory = Pool<T>::Get()->Allocate(location);
+		}
+		else
+		{
+			memory = Allocator::Get()->Allocate(Size(sizeof(T)), typeid(T).name(), alignof(T), location).mem;
+		}
+		T* ret = new (memory) T(std::forward<Ts>(args)...);
 		return ret;
 	}
 
+	// A defaulted source_location can't follow a parameter pack, so Allocate<T> is spelled out per argument count.
+	// Constructors taking more arguments than this go through AllocateAt.
+	template <typename T>
+	inline static T* Allocate(const std::source_location& location = std::source_location::current()) {
+		return AllocateAt<T>(location);
+	}
+
+	template <typename T, typename A0>
+	inline static T* Allocate(A0&& a0, const std::source_location& location = std::source_location::current()) {
+		return AllocateAt<T>(location, std::forward<A0>(a0));
+	}
+
+	template <typename T, typename A0, typename A1>
+	inline static T* Allocate(A0&& a0, A1&& a1, const std::source_location& location = std::source_location::current()) {
+		return AllocateAt<T>(location, std::forward<A0>(a0), std::forward<A1>(a1));
+	}
+
+	template <typename T, typename A0, typename A1, typename A2>
+	inline static T* Allocate(A0&& a0, A1&& a1, A2&& a2, const std::source_location& location = std::source_location::current()) {
+		return AllocateAt<T>(location, std::forward<A0>(a0), std::forward<A1>(a1), std::forward<A2>(a2));
+	}
+
+	template <typename T, typename A0, typename A1, typename A2, typename A3>
+	inline static T* Allocate(A0&& a0, A1&& a1, A2&& a2, A3&& a3, const std::source_location& location = std::source_location::current()) {
+		return AllocateAt<T>(location, std::forward<A0>(a0), std::forward<A1>(a1), std::forward<A2>(a2), std::forward<A3>(a3));
+	}
+
+	template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4>
+	inline static T* Allocate(A0&& a0, A1&& a1, A2&& a2, A3&& a3, A4&& a4, const std::source_location& location = std::source_location::current()) {
+		return AllocateAt<T>(location, std::forward<A0>(a0), std::forward<A1>(a1), std::forward<A2>(a2), std::forward<A3>(a3), std::forward<A4>(a4));
+	}
+
 	//The NewResult type automatically deduces into the correct type
-	inline static Allocator::NewResult Allocate(u64 amount = 1)
+	inline static Allocator::NewResult Allocate(u64 amount = 1, const std::source_location& location = std::source_location::current())
 	{
-		return Allocator::NewResult(amount);
+		return Allocator::NewResult(amount, location);
 	}
 
 	template<typename T>
@@ -136,14 +521,20 @@ namespace frostwave
 	template<typename T>
 	inline static void Free(T* memory)
 	{
-#ifdef _DEBUG
 		VERBOSE_LOG("Freed memory of type %s!", typeid(T).name());
-#endif
 		if constexpr (std::is_trivially_destructible_v<T> || std::is_destructible_v<T>)
 		{
 			memory->~T();
 		}
-		return Allocator::Get()->Free((void*)memory);
+
+		if constexpr (IsPooled<T>)
+		{
+			Pool<std::remove_cv_t<T>>::Get()->Free((void*)memory);
+		}
+		else
+		{
+			Allocator::Get()->Free((void*)memory);
+		}
 	}
 }
-namespace fw = frostwave;
\ No newline at end of file
+namespace fw = frostwave;
@@ -0,0 +1,88 @@
+#include "Arena.h"
+#include <Engine/Memory/Allocator.h>
+#include <cassert>
+
+frostwave::LinearArena* frostwave::LinearArena::s_Instances[(i32)Scope::Count] = { };
+
+frostwave::LinearArena::LinearArena(const Size size) : m_Memory(nullptr), m_Size(size.AsBytes()), m_Offset(0), m_LastOffset(0), m_Peak(0), m_Generation(1), m_ResetCount(0)
+{
+	m_Memory = (u8*)Allocator::Get()->Allocate(size, "LinearArena", Allocator::CacheLineSize).mem;
+}
+
+frostwave::LinearArena::~LinearArena()
+{
+	Allocator::Get()->Free(m_Memory);
+}
+
+void frostwave::LinearArena::Create(Scope scope, Size size)
+{
+	if (s_Instances[(i32)scope])
+	{
+		FATAL_LOG("Already called Create on LinearArena.");
+	}
+
+	s_Instances[(i32)scope] = Allocate<LinearArena>(size);
+}
+
+void frostwave::LinearArena::Destroy(Scope scope)
+{
+	if (s_Instances[(i32)scope])
+		Free(s_Instances[(i32)scope]);
+	s_Instances[(i32)scope] = nullptr;
+}
+
+frostwave::LinearArena* frostwave::LinearArena::Get(Scope scope)
+{
+	return s_Instances[(i32)scope];
+}
+
+void* frostwave::LinearArena::Push(u64 size, u64 alignment)
+{
+	void* memory = TryPush(size, alignment);
+	if (!memory)
+	{
+		FATAL_LOG("LinearArena ran out of memory (%llu/%llu bytes used, requested %llu)", m_Offset, m_Size, size);
+	}
+	return memory;
+}
+
+void* frostwave::LinearArena::TryPush(u64 size, u64 alignment)
+{
+	assert((alignment & (alignment - 1)) == 0 && "Alignment has to be a power of two!");
+
+	u64 address = (u64)m_Memory + m_Offset;
+	u64 offset = m_Offset + (((address + alignment - 1) & ~(alignment - 1)) - address);
+	if (offset + size > m_Size) return nullptr;
+
+	m_LastOffset = offset;
+	m_Offset = offset + size;
+	if (m_Offset > m_Peak) m_Peak = m_Offset;
+
+	return m_Memory + offset;
+}
+
+bool frostwave::LinearArena::Extend(void* memory, u64 newSize)
+{
+	if ((u8*)memory != m_Memory + m_LastOffset) return false;
+	if (m_LastOffset + newSize > m_Size) return false;
+
+	m_Offset = m_LastOffset + newSize;
+	if (m_Offset > m_Peak) m_Peak = m_Offset;
+
+	return true;
+}
+
+void frostwave::LinearArena::PopToMarker(u64 marker)
+{
+	assert(marker <= m_Offset && "Popping to a marker above the current position!");
+
+	m_Offset = marker;
+	m_LastOffset = marker;
+	m_Generation++;
+}
+
+void frostwave::LinearArena::Reset()
+{
+	PopToMarker(0);
+	m_ResetCount++;
+}
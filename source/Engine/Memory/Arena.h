@@ -0,0 +1,158 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <Engine/Memory/Size.h>
+#include <type_traits>
+#include <cstring>
+#include <cassert>
+
+namespace frostwave
+{
+	// Bump-pointer allocator over a single block taken from the Allocator.
+	// Nothing is freed individually, the arena is rewound to a marker or reset as a whole.
+	class LinearArena
+	{
+	public:
+		enum class Scope
+		{
+			Frame,	// Reset at the start of every Engine::Tick
+			Level,	// Stack of load-time data, rewound with markers
+			Count
+		};
+
+		static constexpr u64 DefaultAlignment = 16;
+
+		LinearArena(const Size size);
+		~LinearArena();
+
+		static void Create(Scope scope, Size size);
+		static void Destroy(Scope scope);
+		static LinearArena* Get(Scope scope);
+
+		void* Push(u64 size, u64 alignment = DefaultAlignment);
+		// Returns nullptr instead of failing when the arena is exhausted.
+		void* TryPush(u64 size, u64 alignment = DefaultAlignment);
+
+		template <typename T>
+		T* Push(u64 count = 1) { return (T*)Push(sizeof(T) * count, alignof(T) > DefaultAlignment ? alignof(T) : DefaultAlignment); }
+
+		template <typename T>
+		T* TryPush(u64 count = 1) { return (T*)TryPush(sizeof(T) * count, alignof(T) > DefaultAlignment ? alignof(T) : DefaultAlignment); }
+
+		// Grows the most recent allocation without moving it, fails if something was pushed after it.
+		bool Extend(void* memory, u64 newSize);
+
+		u64 GetMarker() const { return m_Offset; }
+		void PopToMarker(u64 marker);
+		void Reset();
+
+		// Bumped every time memory is rewound, so containers can tell their storage went stale.
+		u64 GetGeneration() const { return m_Generation; }
+		// Only bumped by Reset, tells a rewind to a marker apart from the arena being reset.
+		u64 GetResetCount() const { return m_ResetCount; }
+
+		Size GetSize() const { return Size(m_Size); }
+		Size GetUsedSize() const { return Size(m_Offset); }
+		Size GetPeakSize() const { return Size(m_Peak); }
+
+	private:
+		static LinearArena* s_Instances[(i32)Scope::Count];
+
+		u8* m_Memory;
+		u64 m_Size;
+		u64 m_Offset;
+		u64 m_LastOffset;
+		u64 m_Peak;
+		u64 m_Generation;
+		u64 m_ResetCount;
+	};
+
+	// Records the arena position on construction and rewinds to it when leaving the scope.
+	class ArenaScope
+	{
+	public:
+		ArenaScope(LinearArena* arena) : m_Arena(arena), m_Marker(arena->GetMarker()) { }
+		ArenaScope(LinearArena::Scope scope) : ArenaScope(LinearArena::Get(scope)) { }
+		~ArenaScope() { m_Arena->PopToMarker(m_Marker); }
+
+		ArenaScope(const ArenaScope&) = delete;
+		ArenaScope& operator=(const ArenaScope&) = delete;
+
+	private:
+		LinearArena* m_Arena;
+		u64 m_Marker;
+	};
+
+	// Growable array living in the frame arena. Contents are dropped automatically once the frame arena resets,
+	// so per-frame submission lists cost a pointer bump instead of general heap traffic.
+	// Any PopToMarker or ArenaScope on the frame arena drops the contents as well, so the frame arena must not be
+	// rewound to a marker while a FrameVector holds data. Debug builds assert when that happens.
+	template <typename T>
+	class FrameVector
+	{
+		static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "FrameVector only holds trivially copyable types!");
+	public:
+		FrameVector() : m_Data(nullptr), m_Size(0), m_Capacity(0), m_Generation(0), m_ResetCount(0) { }
+
+		void push_back(const T& value)
+		{
+			if (!IsCurrent())
+			{
+				m_Data = nullptr;
+				m_Size = m_Capacity = 0;
+				m_Generation = GetArena()->GetGeneration();
+				m_ResetCount = GetArena()->GetResetCount();
+			}
+
+			if (m_Size == m_Capacity) Grow();
+			m_Data[m_Size++] = value;
+		}
+
+		void clear() { m_Size = 0; }
+		u64 size() const { return IsCurrent() ? m_Size : 0; }
+		bool empty() const { return size() == 0; }
+
+		T* data() { return IsCurrent() ? m_Data : nullptr; }
+		T* begin() { return data(); }
+		T* end() { return data() + size(); }
+		const T* begin() const { return IsCurrent() ? m_Data : nullptr; }
+		const T* end() const { return begin() + size(); }
+
+		T& operator[](u64 index) { return m_Data[index]; }
+		const T& operator[](u64 index) const { return m_Data[index]; }
+
+	private:
+		static LinearArena* GetArena() { return LinearArena::Get(LinearArena::Scope::Frame); }
+		bool IsCurrent() const
+		{
+			if (!m_Data) return false;
+			if (m_Generation == GetArena()->GetGeneration()) return true;
+
+			assert((m_Size == 0 || m_ResetCount != GetArena()->GetResetCount()) && "The frame arena was rewound to a marker while a FrameVector held data!");
+			return false;
+		}
+
+		void Grow()
+		{
+			static constexpr u64 MinCapacity = 16;
+			u64 capacity = m_Capacity ? m_Capacity * 2 : MinCapacity;
+
+			if (m_Data && GetArena()->Extend(m_Data, capacity * sizeof(T)))
+			{
+				m_Capacity = capacity;
+				return;
+			}
+
+			T* data = GetArena()->Push<T>(capacity);
+			if (m_Size) memcpy(data, m_Data, m_Size * sizeof(T));
+			m_Data = data;
+			m_Capacity = capacity;
+		}
+
+		T* m_Data;
+		u64 m_Size;
+		u64 m_Capacity;
+		u64 m_Generation;
+		u64 m_ResetCount;
+	};
+}
+namespace fw = frostwave;
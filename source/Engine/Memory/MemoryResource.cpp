@@ -0,0 +1,49 @@
+#include "MemoryResource.h"
+
+std::pmr::memory_resource* frostwave::AllocatorResource::s_Previous = nullptr;
+
+frostwave::AllocatorResource* frostwave::AllocatorResource::Get()
+{
+	static AllocatorResource s_Resource;
+	return &s_Resource;
+}
+
+void frostwave::AllocatorResource::InstallDefault()
+{
+	s_Previous = std::pmr::set_default_resource(Get());
+}
+
+void frostwave::AllocatorResource::UninstallDefault()
+{
+	std::pmr::set_default_resource(s_Previous);
+	s_Previous = nullptr;
+}
+
+void* frostwave::AllocatorResource::do_allocate(size_t bytes, size_t alignment)
+{
+	void* memory = Allocator::Get()->Allocate(Size(bytes), m_Type, alignment).mem;
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void frostwave::AllocatorResource::do_deallocate(void* memory, size_t, size_t)
+{
+	Allocator::Get()->Free(memory);
+}
+
+bool frostwave::AllocatorResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	// Every AllocatorResource shares the one heap, only the telemetry name differs.
+	return this == &other || dynamic_cast<const AllocatorResource*>(&other) != nullptr;
+}
+
+void* frostwave::ArenaResource::do_allocate(size_t bytes, size_t alignment)
+{
+	return m_Arena->Push(bytes, alignment > LinearArena::DefaultAlignment ? alignment : LinearArena::DefaultAlignment);
+}
+
+bool frostwave::ArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	const ArenaResource* arena = dynamic_cast<const ArenaResource*>(&other);
+	return arena && arena->m_Arena == m_Arena;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <Engine/Memory/Allocator.h>
+#include <Engine/Memory/Arena.h>
+#include <Engine/Memory/Pool.h>
+#include <memory_resource>
+
+namespace frostwave
+{
+	// std::pmr::memory_resource over the Allocator heap, so pmr containers show up in the allocator stats and telemetry.
+	// Allocations are attributed to the resource's type name, give hot containers their own resource to tell them apart.
+	class AllocatorResource : public std::pmr::memory_resource
+	{
+	public:
+		explicit AllocatorResource(const c8* type = "std::pmr") : m_Type(type) { }
+
+		// Shared resource for containers that do not need their own telemetry entry.
+		static AllocatorResource* Get();
+
+		// Makes Get() the std::pmr default resource, pmr containers constructed without a resource then use the Allocator.
+		// Has to be undone before Allocator::Destroy, anything still allocated through the default resource is a leak by then.
+		static void InstallDefault();
+		static void UninstallDefault();
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* memory, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	private:
+		static std::pmr::memory_resource* s_Previous;
+		const c8* m_Type;
+	};
+
+	// Hands out memory from a LinearArena. Deallocation is a no-op, memory comes back when the arena is rewound,
+	// so containers using it must not outlive the arena scope they were filled in.
+	class ArenaResource : public std::pmr::memory_resource
+	{
+	public:
+		explicit ArenaResource(LinearArena* arena) : m_Arena(arena) { }
+		explicit ArenaResource(LinearArena::Scope scope) : ArenaResource(LinearArena::Get(scope)) { }
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void*, size_t, size_t) override { }
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	private:
+		LinearArena* m_Arena;
+	};
+
+	// Serves requests that fit a slot of Pool<T> from the pool, anything larger goes to the upstream resource.
+	// Useful for node based containers and allocate_shared of pooled types.
+	template <typename T>
+	class PoolResource : public std::pmr::memory_resource
+	{
+	public:
+		explicit PoolResource(std::pmr::memory_resource* upstream = AllocatorResource::Get()) : m_Upstream(upstream) { }
+
+	protected:
+		// A pool slot also holds the free list link, so it is never smaller or less aligned than a pointer.
+		static constexpr size_t SlotSize = sizeof(T) > sizeof(void*) ? sizeof(T) : sizeof(void*);
+		static constexpr size_t SlotAlignment = alignof(T) > alignof(void*) ? alignof(T) : alignof(void*);
+
+		static bool FitsSlot(size_t bytes, size_t alignment) { return bytes <= SlotSize && alignment <= SlotAlignment; }
+
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			return FitsSlot(bytes, alignment) ? Pool<T>::Get()->Allocate() : m_Upstream->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+		{
+			if (FitsSlot(bytes, alignment))
+				Pool<T>::Get()->Free(memory);
+			else
+				m_Upstream->deallocate(memory, bytes, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			const PoolResource* pool = dynamic_cast<const PoolResource*>(&other);
+			return pool && pool->m_Upstream->is_equal(*m_Upstream);
+		}
+
+	private:
+		std::pmr::memory_resource* m_Upstream;
+	};
+}
+namespace fw = frostwave;
@@ -0,0 +1,144 @@
+#pragma once
+#include <Engine/Memory/Allocator.h>
+#include <cassert>
+#include <mutex>
+
+// Marks a type as pooled, Allocate<T>/Free<T> then go through a Pool<T> instead of the general heap.
+// Has to be placed at global scope right after the type definition, before the first Allocate of that type.
+#define FW_REGISTER_POOL(Type, Capacity) \
+	template <> struct frostwave::PoolTraits<Type> { static constexpr u64 SlabCapacity = Capacity; };
+
+namespace frostwave
+{
+	class PoolBase
+	{
+	public:
+		virtual ~PoolBase() { }
+		// Called from Allocator::Destroy, hands every slab back to the heap.
+		virtual void Release() = 0;
+
+	protected:
+		friend class Allocator;
+		PoolBase* m_NextPool = nullptr;
+		bool m_Registered = false;
+	};
+
+	// Fixed-size object pool for a single type. Objects live in slabs of SlabCapacity slots taken from the Allocator,
+	// free slots form an intrusive list so Allocate and Free are O(1) and same-type objects stay packed together.
+	// Every pool has its own lock, so pooled types can be allocated and freed from any thread.
+	template <typename T>
+	class Pool : public PoolBase
+	{
+	public:
+		static constexpr u64 SlabCapacity = PoolTraits<T>::SlabCapacity;
+		static_assert(SlabCapacity > 0, "Pool used for a type without FW_REGISTER_POOL!");
+
+		static Pool* Get()
+		{
+			static Pool s_Pool;
+			return &s_Pool;
+		}
+
+		// The slab is attributed to the allocation that needed it.
+		void* Allocate(const std::source_location& location = std::source_location::current())
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (!m_FreeList) AddSlab(location);
+
+			Slot* slot = m_FreeList;
+			m_FreeList = slot->next;
+			m_LiveCount++;
+			return slot;
+		}
+
+		void Free(void* memory)
+		{
+		#ifdef _DEBUG
+			assert(Owns(memory) && "Freeing memory not owned by this pool!");
+		#endif
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			Slot* slot = (Slot*)memory;
+			slot->next = m_FreeList;
+			m_FreeList = slot;
+			m_LiveCount--;
+		}
+
+		bool Owns(const void* memory) const
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (Slab* slab = m_Slabs; slab; slab = slab->next)
+			{
+				if (memory >= (const void*)slab->slots && memory < (const void*)(slab->slots + SlabCapacity))
+					return true;
+			}
+			return false;
+		}
+
+		u64 GetLiveCount() const
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			return m_LiveCount;
+		}
+
+		void Release() override
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Registered = false;
+			m_NextPool = nullptr;
+
+			if (m_LiveCount > 0)
+			{
+				ERROR_LOG("%llu objects of pooled type '%s' still alive, leaking their slabs", m_LiveCount, typeid(T).name());
+				return;
+			}
+
+			while (Slab* slab = m_Slabs)
+			{
+				m_Slabs = slab->next;
+				Allocator::Get()->Free(slab);
+			}
+			m_FreeList = nullptr;
+		}
+
+	private:
+#pragma warning(push)
+		// Slots take the alignment of T, for the math types that pads the slab.
+#pragma warning(disable: 4324)
+		union Slot
+		{
+			Slot* next;
+			alignas(T) u8 storage[sizeof(T)];
+		};
+
+		struct Slab
+		{
+			Slab* next;
+			Slot slots[SlabCapacity];
+		};
+#pragma warning(pop)
+
+		// Called with m_Mutex held.
+		void AddSlab(const std::source_location& location)
+		{
+			Slab* slab = (Slab*)Allocator::Get()->Allocate(Size(sizeof(Slab)), typeid(Pool).name(), alignof(Slab), location).mem;
+			slab->next = m_Slabs;
+			m_Slabs = slab;
+
+			// Threaded back to front so consecutive allocations hand out neighbouring slots.
+			for (u64 i = SlabCapacity; i-- > 0;)
+			{
+				slab->slots[i].next = m_FreeList;
+				m_FreeList = &slab->slots[i];
+			}
+
+			if (!m_Registered)
+				Allocator::Get()->RegisterPool(this);
+		}
+
+		Slot* m_FreeList = nullptr;
+		Slab* m_Slabs = nullptr;
+		u64 m_LiveCount = 0;
+		mutable std::mutex m_Mutex;
+	};
+}
+namespace fw = frostwave;
@@ -0,0 +1,461 @@
+#include "Telemetry.h"
+#include <Engine/Logging/Logger.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <bit>
+#include <new>
+
+std::atomic<frostwave::MemoryTelemetry*> frostwave::MemoryTelemetry::s_Instance = nullptr;
+std::atomic<u64> frostwave::MemoryTelemetry::s_NextId = 1;
+
+namespace
+{
+	struct ThreadShardSlot
+	{
+		void* shard = nullptr;
+		u64 telemetryId = 0;
+
+		~ThreadShardSlot() { frostwave::MemoryTelemetry::ReleaseThreadShard(); }
+	};
+	thread_local ThreadShardSlot t_ShardSlot;
+
+	// Shard counters have a single writer, a plain load and store is enough and avoids a locked instruction.
+	void Bump(std::atomic<u64>& counter, u64 value)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	u64 HashString(const c8* string)
+	{
+		u64 hash = 0xcbf29ce484222325ull;
+		for (; *string; ++string)
+		{
+			hash ^= (u8)*string;
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	u64 HashSite(const c8* type, const c8* file, u32 line)
+	{
+		u64 hash = (u64)type * 0x9e3779b97f4a7c15ull;
+		hash ^= (u64)file * 0xc2b2ae3d27d4eb4full;
+		hash ^= (u64)line * 0x165667b19e3779f9ull;
+		return hash ^ (hash >> 29);
+	}
+
+	void WriteJsonString(FILE* file, const c8* string)
+	{
+		fputc('"', file);
+		for (; string && *string; ++string)
+		{
+			if (*string == '"' || *string == '\\') fputc('\\', file);
+			fputc(*string, file);
+		}
+		fputc('"', file);
+	}
+
+	// Type names can hold commas and quotes (templates, anonymous namespaces), so fields are always quoted.
+	void WriteCsvString(FILE* file, const c8* string)
+	{
+		fputc('"', file);
+		for (; string && *string; ++string)
+		{
+			if (*string == '"') fputc('"', file);
+			fputc(*string, file);
+		}
+		fputc('"', file);
+	}
+
+	void WriteJsonCounters(FILE* file, const frostwave::MemoryTelemetry::Counters& counters)
+	{
+		fprintf(file, "\"liveBytes\": %llu, \"liveCount\": %llu, \"peakBytes\": %llu, \"allocations\": %llu, \"allocatedBytes\": %llu, \"frameAllocations\": %llu",
+			counters.liveBytes, counters.liveCount, counters.peakBytes, counters.allocations, counters.allocatedBytes, counters.frameAllocations);
+	}
+}
+
+frostwave::MemoryTelemetry::MemoryTelemetry() : m_Id(s_NextId++), m_SiteCount(0), m_SitesPublished(0), m_Shards(nullptr), m_LiveBytes(0), m_PeakBytes(0),
+	m_FrameAllocationsMark(0), m_FrameAllocations(0), m_FrameBytesMark(0), m_FrameBytes(0)
+{
+	m_Sites[OverflowIndex].type = "<overflow>";
+	m_Sites[OverflowIndex].file = "";
+	m_Sites[OverflowIndex].state = Ready;
+	m_Types[OverflowIndex].name = "<overflow>";
+	m_Types[OverflowIndex].state = Ready;
+	m_SiteOrder[m_SiteCount++] = OverflowIndex;
+	m_SitesPublished = m_SiteCount.load();
+
+	s_Instance = this;
+}
+
+frostwave::MemoryTelemetry::~MemoryTelemetry()
+{
+	s_Instance = nullptr;
+
+	Shard* shard = m_Shards.load(std::memory_order_acquire);
+	while (shard)
+	{
+		Shard* next = shard->next;
+		shard->~Shard();
+		::operator delete(shard);
+		shard = next;
+	}
+}
+
+void frostwave::MemoryTelemetry::ReleaseThreadShard()
+{
+	ThreadShardSlot& slot = t_ShardSlot;
+	MemoryTelemetry* instance = s_Instance.load(std::memory_order_acquire);
+	if (slot.shard && instance && instance->m_Id == slot.telemetryId)
+	{
+		((Shard*)slot.shard)->inUse.store(false, std::memory_order_release);
+	}
+	slot.shard = nullptr;
+	slot.telemetryId = 0;
+}
+
+frostwave::MemoryTelemetry::Shard* frostwave::MemoryTelemetry::GetShard()
+{
+	ThreadShardSlot& slot = t_ShardSlot;
+	if (slot.telemetryId == m_Id)
+		return (Shard*)slot.shard;
+
+	// Adopting a shard keeps its counts, sums stay valid no matter which thread wrote them.
+	Shard* shard = m_Shards.load(std::memory_order_acquire);
+	for (; shard; shard = shard->next)
+	{
+		bool inUse = false;
+		if (shard->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire))
+			break;
+	}
+
+	if (!shard)
+	{
+		// Shards come from the system heap, the allocator is the one calling in here.
+		shard = new (::operator new(sizeof(Shard))) Shard();
+		for (auto& site : shard->sites)
+		{
+			site.allocations = 0;
+			site.allocatedBytes = 0;
+			site.frees = 0;
+			site.freedBytes = 0;
+		}
+		for (auto& bucket : shard->histogram) bucket = 0;
+		shard->inUse = true;
+
+		Shard* head = m_Shards.load(std::memory_order_relaxed);
+		do
+		{
+			shard->next = head;
+		} while (!m_Shards.compare_exchange_weak(head, shard, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	slot.shard = shard;
+	slot.telemetryId = m_Id;
+	return shard;
+}
+
+u32 frostwave::MemoryTelemetry::Intern(const c8* type, const c8* file, u32 line)
+{
+	if (!type) type = "<unknown>";
+	u64 hash = HashSite(type, file, line);
+
+	for (u32 probe = 0; probe < MaxSites; ++probe)
+	{
+		u32 index = (u32)((hash + probe) & (MaxSites - 1));
+		if (index == OverflowIndex) continue;
+
+		Site& site = m_Sites[index];
+		u32 state = site.state.load(std::memory_order_acquire);
+		if (state == Empty)
+		{
+			if (site.state.compare_exchange_strong(state, Claimed, std::memory_order_acquire))
+			{
+				site.type = type;
+				site.file = file;
+				site.line = line;
+				site.typeIndex = InternType(type);
+				site.state.store(Ready, std::memory_order_release);
+
+				u32 order = m_SiteCount.fetch_add(1, std::memory_order_relaxed);
+				m_SiteOrder[order] = index;
+
+				// Entries are published in the order they were claimed, wait for the interns that claimed the earlier ones.
+				u32 published = order;
+				while (!m_SitesPublished.compare_exchange_weak(published, order + 1, std::memory_order_release, std::memory_order_relaxed))
+					published = order;
+				return index;
+			}
+		}
+
+		// Another thread is filling in this slot, it might be the site we are looking for.
+		while (state == Claimed)
+			state = site.state.load(std::memory_order_acquire);
+
+		if (site.type == type && site.file == file && site.line == line)
+			return index;
+	}
+	return OverflowIndex;
+}
+
+u32 frostwave::MemoryTelemetry::InternType(const c8* name)
+{
+	// Types are matched by name, string literals and typeid names are not guaranteed to be unique across modules.
+	u64 hash = HashString(name);
+
+	for (u32 probe = 0; probe < MaxTypes; ++probe)
+	{
+		u32 index = (u32)((hash + probe) & (MaxTypes - 1));
+		if (index == OverflowIndex) continue;
+
+		Type& type = m_Types[index];
+		u32 state = type.state.load(std::memory_order_acquire);
+		if (state == Empty)
+		{
+			if (type.state.compare_exchange_strong(state, Claimed, std::memory_order_acquire))
+			{
+				type.hash = hash;
+				type.name = name;
+				type.state.store(Ready, std::memory_order_release);
+				return index;
+			}
+		}
+
+		while (state == Claimed)
+			state = type.state.load(std::memory_order_acquire);
+
+		if (type.hash == hash && strcmp(type.name, name) == 0)
+			return index;
+	}
+	return OverflowIndex;
+}
+
+void frostwave::MemoryTelemetry::OnAllocate(u32 site, u64 bytes)
+{
+	Shard* shard = GetShard();
+	Bump(shard->sites[site].allocations, 1);
+	Bump(shard->sites[site].allocatedBytes, bytes);
+	Bump(shard->histogram[std::min((u32)std::bit_width(bytes), HistogramBucketCount - 1)], 1);
+
+	u64 live = m_LiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	u64 peak = m_PeakBytes.load(std::memory_order_relaxed);
+	while (live > peak && !m_PeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+}
+
+void frostwave::MemoryTelemetry::OnFree(u32 site, u64 bytes)
+{
+	Shard* shard = GetShard();
+	Bump(shard->sites[site].frees, 1);
+	Bump(shard->sites[site].freedBytes, bytes);
+
+	m_LiveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+frostwave::MemoryTelemetry::Counters frostwave::MemoryTelemetry::LoadSite(u32 site) const
+{
+	u64 freed = 0, frees = 0, allocated = 0, allocations = 0;
+	for (Shard* shard = m_Shards.load(std::memory_order_acquire); shard; shard = shard->next)
+	{
+		const SiteCounters& counters = shard->sites[site];
+		freed += counters.freedBytes.load(std::memory_order_relaxed);
+		frees += counters.frees.load(std::memory_order_relaxed);
+		allocated += counters.allocatedBytes.load(std::memory_order_relaxed);
+		allocations += counters.allocations.load(std::memory_order_relaxed);
+	}
+
+	// A free seen without its allocation can only happen mid-read on another thread, clamp instead of wrapping.
+	Counters counters;
+	counters.allocations = allocations;
+	counters.allocatedBytes = allocated;
+	counters.liveBytes = allocated > freed ? allocated - freed : 0;
+	counters.liveCount = allocations > frees ? allocations - frees : 0;
+	counters.peakBytes = std::max(m_Sites[site].peakBytes, counters.liveBytes);
+	counters.frameAllocations = m_Sites[site].frameAllocations;
+	return counters;
+}
+
+void frostwave::MemoryTelemetry::BeginFrame()
+{
+	u64 allocations = 0, bytes = 0;
+
+	u32 count = m_SitesPublished.load(std::memory_order_acquire);
+	for (u32 i = 0; i < count; ++i)
+	{
+		Site& site = m_Sites[m_SiteOrder[i]];
+		if (site.state.load(std::memory_order_acquire) != Ready) continue;
+
+		Counters counters = LoadSite(m_SiteOrder[i]);
+		site.peakBytes = counters.peakBytes;
+		site.frameAllocations = counters.allocations - site.frameMark;
+		site.frameMark = counters.allocations;
+
+		allocations += counters.allocations;
+		bytes += counters.allocatedBytes;
+	}
+
+	m_FrameAllocations = allocations - m_FrameAllocationsMark;
+	m_FrameAllocationsMark = allocations;
+	m_FrameBytes = bytes - m_FrameBytesMark;
+	m_FrameBytesMark = bytes;
+}
+
+frostwave::MemoryTelemetry::Summary frostwave::MemoryTelemetry::GetSummary() const
+{
+	Summary summary = { };
+
+	u32 count = m_SitesPublished.load(std::memory_order_acquire);
+	for (u32 i = 0; i < count; ++i)
+	{
+		if (m_Sites[m_SiteOrder[i]].state.load(std::memory_order_acquire) != Ready) continue;
+
+		Counters counters = LoadSite(m_SiteOrder[i]);
+		summary.counters.liveCount += counters.liveCount;
+		summary.counters.allocations += counters.allocations;
+		summary.counters.allocatedBytes += counters.allocatedBytes;
+	}
+
+	for (Shard* shard = m_Shards.load(std::memory_order_acquire); shard; shard = shard->next)
+	{
+		for (u32 i = 0; i < HistogramBucketCount; ++i)
+			summary.histogram[i] += shard->histogram[i].load(std::memory_order_relaxed);
+	}
+
+	summary.counters.liveBytes = m_LiveBytes.load(std::memory_order_relaxed);
+	summary.counters.peakBytes = m_PeakBytes.load(std::memory_order_relaxed);
+	summary.counters.frameAllocations = m_FrameAllocations;
+	summary.frameBytes = m_FrameBytes;
+	return summary;
+}
+
+std::vector<frostwave::MemoryTelemetry::SiteStats> frostwave::MemoryTelemetry::GetSites() const
+{
+	std::vector<SiteStats> sites;
+
+	u32 count = m_SitesPublished.load(std::memory_order_acquire);
+	for (u32 i = 0; i < count; ++i)
+	{
+		const Site& site = m_Sites[m_SiteOrder[i]];
+		if (site.state.load(std::memory_order_acquire) != Ready) continue;
+
+		Counters counters = LoadSite(m_SiteOrder[i]);
+		if (counters.allocations == 0) continue;
+
+		sites.push_back({ site.type, site.file, site.line, counters });
+	}
+
+	std::sort(sites.begin(), sites.end(), [](const SiteStats& a, const SiteStats& b) { return a.counters.liveBytes > b.counters.liveBytes; });
+	return sites;
+}
+
+std::vector<frostwave::MemoryTelemetry::TypeStats> frostwave::MemoryTelemetry::GetTypes() const
+{
+	std::vector<Counters> counters(MaxTypes, Counters{ });
+
+	u32 count = m_SitesPublished.load(std::memory_order_acquire);
+	for (u32 i = 0; i < count; ++i)
+	{
+		const Site& site = m_Sites[m_SiteOrder[i]];
+		if (site.state.load(std::memory_order_acquire) != Ready) continue;
+
+		Counters siteCounters = LoadSite(m_SiteOrder[i]);
+		Counters& typeCounters = counters[site.typeIndex];
+		typeCounters.liveBytes += siteCounters.liveBytes;
+		typeCounters.liveCount += siteCounters.liveCount;
+		typeCounters.peakBytes += siteCounters.peakBytes;
+		typeCounters.allocations += siteCounters.allocations;
+		typeCounters.allocatedBytes += siteCounters.allocatedBytes;
+		typeCounters.frameAllocations += siteCounters.frameAllocations;
+	}
+
+	std::vector<TypeStats> types;
+	for (u32 i = 0; i < MaxTypes; ++i)
+	{
+		if (counters[i].allocations == 0) continue;
+		types.push_back({ m_Types[i].name, counters[i] });
+	}
+
+	std::sort(types.begin(), types.end(), [](const TypeStats& a, const TypeStats& b) { return a.counters.liveBytes > b.counters.liveBytes; });
+	return types;
+}
+
+bool frostwave::MemoryTelemetry::ExportJson(const std::string& path) const
+{
+	FILE* file = nullptr;
+	if (fopen_s(&file, path.c_str(), "w") != 0 || !file)
+	{
+		ERROR_LOG("Failed to open '%s' for writing memory telemetry", path.c_str());
+		return false;
+	}
+
+	Summary summary = GetSummary();
+	fprintf(file, "{\n\t\"total\": { ");
+	WriteJsonCounters(file, summary.counters);
+	fprintf(file, ", \"frameBytes\": %llu },\n\t\"histogram\": [", summary.frameBytes);
+	for (u32 i = 0; i < HistogramBucketCount; ++i)
+		fprintf(file, "%s%llu", i ? ", " : "", summary.histogram[i]);
+
+	fprintf(file, "],\n\t\"types\": [");
+	auto types = GetTypes();
+	for (u64 i = 0; i < types.size(); ++i)
+	{
+		fprintf(file, "%s\n\t\t{ \"type\": ", i ? "," : "");
+		WriteJsonString(file, types[i].type);
+		fprintf(file, ", ");
+		WriteJsonCounters(file, types[i].counters);
+		fprintf(file, " }");
+	}
+
+	fprintf(file, "\n\t],\n\t\"sites\": [");
+	auto sites = GetSites();
+	for (u64 i = 0; i < sites.size(); ++i)
+	{
+		fprintf(file, "%s\n\t\t{ \"type\": ", i ? "," : "");
+		WriteJsonString(file, sites[i].type);
+		fprintf(file, ", \"file\": ");
+		WriteJsonString(file, sites[i].file);
+		fprintf(file, ", \"line\": %u, ", sites[i].line);
+		WriteJsonCounters(file, sites[i].counters);
+		fprintf(file, " }");
+	}
+	fprintf(file, "\n\t]\n}\n");
+
+	fclose(file);
+	return true;
+}
+
+bool frostwave::MemoryTelemetry::ExportCsv(const std::string& path) const
+{
+	FILE* file = nullptr;
+	if (fopen_s(&file, path.c_str(), "w") != 0 || !file)
+	{
+		ERROR_LOG("Failed to open '%s' for writing memory telemetry", path.c_str());
+		return false;
+	}
+
+	fprintf(file, "type,file,line,liveBytes,liveCount,peakBytes,allocations,allocatedBytes,frameAllocations\n");
+	for (auto& site : GetSites())
+	{
+		WriteCsvString(file, site.type);
+		fputc(',', file);
+		WriteCsvString(file, site.file);
+		fprintf(file, ",%u,%llu,%llu,%llu,%llu,%llu,%llu\n", site.line,
+			site.counters.liveBytes, site.counters.liveCount, site.counters.peakBytes, site.counters.allocations, site.counters.allocatedBytes, site.counters.frameAllocations);
+	}
+
+	fclose(file);
+	return true;
+}
+
+u64 frostwave::MemoryTelemetry::ReportLeaks() const
+{
+	u64 leaked = 0;
+	for (auto& site : GetSites())
+	{
+		if (site.counters.liveCount == 0) continue;
+
+		ERROR_LOG("Leaked %llu allocations (%llu bytes) of type '%s' from %s:%u", site.counters.liveCount, site.counters.liveBytes, site.type, site.file, site.line);
+		leaked += site.counters.liveCount;
+	}
+	return leaked;
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Telemetry is compiled into Debug and Release builds, Retail pays nothing for it.
+#ifndef FW_MEMORY_TELEMETRY
+	#ifdef _RETAIL
+		#define FW_MEMORY_TELEMETRY 0
+	#else
+		#define FW_MEMORY_TELEMETRY 1
+	#endif
+#endif
+
+namespace frostwave
+{
+	// Allocation accounting keyed by interned (type, callsite) pairs.
+	// Every live block remembers the site that allocated it, so Free can be attributed without any lookup.
+	// Counters live in per-thread shards that only their thread writes, so recording an allocation is
+	// a handful of plain stores plus one atomic add for the global live size. Shards are summed on read.
+	class MemoryTelemetry
+	{
+	public:
+		static constexpr u32 MaxSites = 4096;
+		static constexpr u32 MaxTypes = 1024;
+		// Sites and types past the table capacity are all accounted to index 0.
+		static constexpr u32 OverflowIndex = 0;
+		// Bucket i counts allocations of [2^(i-1), 2^i) bytes.
+		static constexpr u32 HistogramBucketCount = 41;
+
+		struct Counters
+		{
+			u64 liveBytes;
+			u64 liveCount;
+			u64 peakBytes;
+			u64 allocations;
+			u64 allocatedBytes;
+			u64 frameAllocations;
+		};
+
+		// Site and type peaks are sampled once per frame, only the total peak is exact.
+		struct SiteStats
+		{
+			const c8* type;
+			const c8* file;
+			u32 line;
+			Counters counters;
+		};
+
+		// Summed over the sites of the type, so peakBytes is an upper bound of the real type peak.
+		struct TypeStats
+		{
+			const c8* type;
+			Counters counters;
+		};
+
+		struct Summary
+		{
+			Counters counters;
+			u64 frameBytes;
+			u64 histogram[HistogramBucketCount];
+		};
+
+		MemoryTelemetry();
+		~MemoryTelemetry();
+
+		u32 Intern(const c8* type, const c8* file, u32 line);
+		void OnAllocate(u32 site, u64 bytes);
+		void OnFree(u32 site, u64 bytes);
+
+		// Closes the current frame, per-frame rates report the frame that just ended.
+		void BeginFrame();
+
+		Summary GetSummary() const;
+		std::vector<SiteStats> GetSites() const;
+		std::vector<TypeStats> GetTypes() const;
+
+		bool ExportJson(const std::string& path) const;
+		bool ExportCsv(const std::string& path) const;
+
+		// Logs every site that still has live allocations, returns the number of leaked allocations.
+		u64 ReportLeaks() const;
+
+		// Lets another thread adopt the calling thread's shard, runs automatically when a thread exits.
+		static void ReleaseThreadShard();
+
+	private:
+		enum SlotState : u32
+		{
+			Empty,
+			Claimed,
+			Ready
+		};
+
+		struct SiteCounters
+		{
+			std::atomic<u64> allocations;
+			std::atomic<u64> allocatedBytes;
+			std::atomic<u64> frees;
+			std::atomic<u64> freedBytes;
+		};
+
+		struct Shard
+		{
+			SiteCounters sites[MaxSites];
+			std::atomic<u64> histogram[HistogramBucketCount];
+			std::atomic<bool> inUse;
+			Shard* next;
+		};
+
+		struct Site
+		{
+			std::atomic<u32> state = Empty;
+			const c8* type = nullptr;
+			const c8* file = nullptr;
+			u32 line = 0;
+			u32 typeIndex = OverflowIndex;
+
+			// Only touched by BeginFrame.
+			u64 peakBytes = 0;
+			u64 frameMark = 0;
+			u64 frameAllocations = 0;
+		};
+
+		struct Type
+		{
+			std::atomic<u32> state = Empty;
+			u64 hash = 0;
+			const c8* name = nullptr;
+		};
+
+		static std::atomic<MemoryTelemetry*> s_Instance;
+		static std::atomic<u64> s_NextId;
+
+		u32 InternType(const c8* name);
+		Shard* GetShard();
+		Counters LoadSite(u32 site) const;
+
+		u64 m_Id;
+		Site m_Sites[MaxSites];
+		Type m_Types[MaxTypes];
+		// Indices of the interned sites in the order they were added, so readers skip the empty slots.
+		// Interning claims an entry through m_SiteCount, readers only see entries below m_SitesPublished.
+		u32 m_SiteOrder[MaxSites];
+		std::atomic<u32> m_SiteCount;
+		std::atomic<u32> m_SitesPublished;
+
+		std::atomic<Shard*> m_Shards;
+		std::atomic<u64> m_LiveBytes;
+		std::atomic<u64> m_PeakBytes;
+
+		u64 m_FrameAllocationsMark, m_FrameAllocations;
+		u64 m_FrameBytesMark, m_FrameBytes;
+	};
+}
+namespace fw = frostwave;
@@ -0,0 +1,187 @@
+#include "VirtualMemory.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+
+namespace
+{
+	// Large pages need SeLockMemoryPrivilege enabled on the process token.
+	bool EnableLockMemoryPrivilege()
+	{
+		static bool s_Enabled = []()
+		{
+			HANDLE token = nullptr;
+			if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+				return false;
+
+			TOKEN_PRIVILEGES privileges = { };
+			privileges.PrivilegeCount = 1;
+			privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+			bool enabled = LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid)
+				&& AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr)
+				&& GetLastError() == ERROR_SUCCESS;
+
+			CloseHandle(token);
+			return enabled;
+		}();
+		return s_Enabled;
+	}
+}
+
+u64 frostwave::VirtualMemory::GetPageSize()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+}
+
+u64 frostwave::VirtualMemory::GetLargePageSize()
+{
+	if (!EnableLockMemoryPrivilege()) return 0;
+	return GetLargePageMinimum();
+}
+
+void* frostwave::VirtualMemory::Reserve(u64 size)
+{
+	return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool frostwave::VirtualMemory::Commit(void* address, u64 size)
+{
+	return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void frostwave::VirtualMemory::Decommit(void* address, u64 size)
+{
+#pragma warning(push)
+#pragma warning(disable : 6250)
+	VirtualFree(address, size, MEM_DECOMMIT);
+#pragma warning(pop)
+}
+
+void frostwave::VirtualMemory::Release(void* address, u64)
+{
+	VirtualFree(address, 0, MEM_RELEASE);
+}
+
+void* frostwave::VirtualMemory::AllocateLarge(u64 size)
+{
+	u64 pageSize = GetLargePageSize();
+	if (!pageSize) return nullptr;
+
+	size = (size + pageSize - 1) & ~(pageSize - 1);
+	return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+}
+
+bool frostwave::VirtualMemory::AdviseHugePages(void*, u64)
+{
+	// Windows has no transparent huge pages, large pages are only available through AllocateLarge.
+	return false;
+}
+
+void* frostwave::VirtualMemory::MapFile(const c8* path, u64 size)
+{
+	HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, nullptr);
+	void* address = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size) : nullptr;
+
+	// The view keeps the mapping and the file alive on its own.
+	if (mapping) CloseHandle(mapping);
+	CloseHandle(file);
+	return address;
+}
+
+void frostwave::VirtualMemory::UnmapFile(void* address, u64)
+{
+	UnmapViewOfFile(address);
+}
+
+void frostwave::VirtualMemory::FlushFile(void* address, u64 size)
+{
+	FlushViewOfFile(address, size);
+}
+
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+u64 frostwave::VirtualMemory::GetPageSize()
+{
+	return (u64)sysconf(_SC_PAGESIZE);
+}
+
+u64 frostwave::VirtualMemory::GetLargePageSize()
+{
+	return 2ull * 1024 * 1024;
+}
+
+void* frostwave::VirtualMemory::Reserve(u64 size)
+{
+	void* address = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return address == MAP_FAILED ? nullptr : address;
+}
+
+bool frostwave::VirtualMemory::Commit(void* address, u64 size)
+{
+	return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void frostwave::VirtualMemory::Decommit(void* address, u64 size)
+{
+	madvise(address, size, MADV_DONTNEED);
+	mprotect(address, size, PROT_NONE);
+}
+
+void frostwave::VirtualMemory::Release(void* address, u64 size)
+{
+	munmap(address, size);
+}
+
+void* frostwave::VirtualMemory::AllocateLarge(u64 size)
+{
+	u64 pageSize = GetLargePageSize();
+	size = (size + pageSize - 1) & ~(pageSize - 1);
+
+	void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	return address == MAP_FAILED ? nullptr : address;
+}
+
+bool frostwave::VirtualMemory::AdviseHugePages(void* address, u64 size)
+{
+#ifdef MADV_HUGEPAGE
+	return madvise(address, size, MADV_HUGEPAGE) == 0;
+#else
+	(void)address; (void)size;
+	return false;
+#endif
+}
+
+void* frostwave::VirtualMemory::MapFile(const c8* path, u64 size)
+{
+	int file = open(path, O_RDWR | O_CREAT, 0644);
+	if (file < 0) return nullptr;
+
+	void* address = nullptr;
+	if (ftruncate(file, (off_t)size) == 0)
+	{
+		address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+		if (address == MAP_FAILED) address = nullptr;
+	}
+
+	close(file);
+	return address;
+}
+
+void frostwave::VirtualMemory::UnmapFile(void* address, u64 size)
+{
+	munmap(address, size);
+}
+
+void frostwave::VirtualMemory::FlushFile(void* address, u64 size)
+{
+	msync(address, size, MS_SYNC);
+}
+#endif
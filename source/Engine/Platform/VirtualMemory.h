@@ -0,0 +1,33 @@
+#pragma once
+#include <Engine/Core/Types.h>
+
+namespace frostwave
+{
+	// Thin wrapper over the OS virtual memory API. Address space is reserved without backing,
+	// pages are committed on demand and handed back to the OS when they are no longer needed.
+	class VirtualMemory
+	{
+	public:
+		static u64 GetPageSize();
+		// Returns 0 when the OS or the current process can not use large pages.
+		static u64 GetLargePageSize();
+
+		static void* Reserve(u64 size);
+		static bool Commit(void* address, u64 size);
+		static void Decommit(void* address, u64 size);
+		static void Release(void* address, u64 size);
+
+		// Reserves and commits the whole range in large pages up front, returns nullptr if that is not possible.
+		static void* AllocateLarge(u64 size);
+		// Asks the OS to back the range with transparent huge pages where it supports that.
+		static bool AdviseHugePages(void* address, u64 size);
+
+		// Maps a file of the given size read/write, creating or resizing it as needed. Writes reach the file
+		// through the OS page cache, so they survive the process crashing.
+		static void* MapFile(const c8* path, u64 size);
+		static void UnmapFile(void* address, u64 size);
+		// Forces mapped pages out to disk, only needed to survive the whole machine going down.
+		static void FlushFile(void* address, u64 size);
+	};
+}
+namespace fw = frostwave;
@@ -0,0 +1,145 @@
+#include "FrameStats.h"
+#include <Engine/Logging/Logger.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+frostwave::FrameStats::FrameStats()
+{
+	m_BudgetNanoseconds = 1000000000ull / 60;
+	Reset();
+}
+
+frostwave::FrameStats::~FrameStats()
+{
+}
+
+void frostwave::FrameStats::AddFrame(u64 nanoseconds)
+{
+	if (m_Count == HistorySize)
+	{
+		u64 oldest = m_History[m_Next];
+		m_Histogram[GetBucket(oldest)]--;
+		if (oldest > m_BudgetNanoseconds) m_Hitches--;
+	}
+	else
+	{
+		m_Count++;
+	}
+
+	m_History[m_Next] = nanoseconds;
+	m_Next = (m_Next + 1) % HistorySize;
+	m_Histogram[GetBucket(nanoseconds)]++;
+
+	bool hitch = nanoseconds > m_BudgetNanoseconds;
+	m_Hitches += hitch;
+	m_LifetimeHitches += hitch;
+	m_LifetimeFrames++;
+	m_LifetimeNanoseconds += nanoseconds;
+	m_LifetimeMax = std::max(m_LifetimeMax, nanoseconds);
+}
+
+void frostwave::FrameStats::Reset()
+{
+	memset(m_History, 0, sizeof(m_History));
+	memset(m_Histogram, 0, sizeof(m_Histogram));
+	m_Next = 0;
+	m_Count = 0;
+	m_Hitches = 0;
+	m_LifetimeFrames = 0;
+	m_LifetimeHitches = 0;
+	m_LifetimeMax = 0;
+	m_LifetimeNanoseconds = 0;
+}
+
+void frostwave::FrameStats::SetBudget(f64 milliseconds)
+{
+	m_BudgetNanoseconds = (u64)(milliseconds * 1e6);
+
+	// Only the rolling count can be redone, lifetime hitches keep the budget they were counted against.
+	m_Hitches = 0;
+	for (u32 i = 0; i < m_Count; ++i)
+		m_Hitches += m_History[i] > m_BudgetNanoseconds;
+}
+
+frostwave::FrameStats::Summary frostwave::FrameStats::GetSummary() const
+{
+	Summary summary = { };
+	summary.frames = m_Count;
+	summary.hitches = m_Hitches;
+	if (!m_Count) return summary;
+
+	u64 sorted[HistorySize];
+	memcpy(sorted, m_History, m_Count * sizeof(u64));
+	u64* end = sorted + m_Count;
+
+	u64 total = 0;
+	for (u64* it = sorted; it != end; ++it)
+		total += *it;
+	summary.mean = (f64)total / (f64)m_Count * 1e-6;
+
+	// Nearest rank, each selection only has to look at what is above the previous one.
+	u64* previous = sorted;
+	auto percentile = [&](f64 fraction)
+	{
+		u32 rank = (u32)std::ceil(fraction * (f64)m_Count);
+		u64* nth = sorted + std::clamp(rank, 1u, m_Count) - 1;
+		std::nth_element(previous, nth, end);
+		previous = nth;
+		return (f64)*nth * 1e-6;
+	};
+	summary.p50 = percentile(0.50);
+	summary.p95 = percentile(0.95);
+	summary.p99 = percentile(0.99);
+	summary.max = (f64)*std::max_element(previous, end) * 1e-6;
+	return summary;
+}
+
+u32 frostwave::FrameStats::GetHistory(f32* milliseconds, u32 capacity) const
+{
+	u32 count = std::min(capacity, m_Count);
+	u32 first = (m_Next + HistorySize - count) % HistorySize;
+	for (u32 i = 0; i < count; ++i)
+		milliseconds[i] = (f32)((f64)m_History[(first + i) % HistorySize] * 1e-6);
+	return count;
+}
+
+void frostwave::FrameStats::Dump() const
+{
+	Summary summary = GetSummary();
+	INFO_LOG("Frame times over the last %u frames: mean %.2fms, p50 %.2fms, p95 %.2fms, p99 %.2fms, max %.2fms, %u over the %.2fms budget",
+		summary.frames, summary.mean, summary.p50, summary.p95, summary.p99, summary.max, summary.hitches, GetBudget());
+	if (m_LifetimeFrames)
+	{
+		INFO_LOG("Frame times over all %llu frames: mean %.2fms, max %.2fms, %llu hitches",
+			m_LifetimeFrames, (f64)m_LifetimeNanoseconds / (f64)m_LifetimeFrames * 1e-6, GetLifetimeMax(), m_LifetimeHitches);
+	}
+}
+
+bool frostwave::FrameStats::ExportCsv(const std::string& path) const
+{
+	FILE* file = nullptr;
+	if (fopen_s(&file, path.c_str(), "w") != 0 || !file)
+	{
+		ERROR_LOG("Failed to open '%s' to export frame stats", path.c_str());
+		return false;
+	}
+
+	fprintf(file, "frame,milliseconds\n");
+	u32 first = (m_Next + HistorySize - m_Count) % HistorySize;
+	for (u32 i = 0; i < m_Count; ++i)
+		fprintf(file, "%u,%.4f\n", i, (f64)m_History[(first + i) % HistorySize] * 1e-6);
+
+	fprintf(file, "\nbucket_ms,frames\n");
+	for (u32 i = 0; i < HistogramBucketCount; ++i)
+		fprintf(file, "%u,%u\n", i, m_Histogram[i]);
+
+	fclose(file);
+	return true;
+}
+
+u32 frostwave::FrameStats::GetBucket(u64 nanoseconds)
+{
+	return (u32)std::min<u64>(nanoseconds / 1000000, HistogramBucketCount - 1);
+}
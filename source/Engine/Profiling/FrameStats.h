@@ -0,0 +1,69 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <string>
+
+namespace frostwave
+{
+	// Rolling frame time statistics over the last HistorySize frames, plus lifetime totals.
+	// Frames are stored as integer nanoseconds. AddFrame only writes the ring and moves one
+	// histogram count, percentiles are worked out when they are asked for.
+	class FrameStats
+	{
+	public:
+		static constexpr u32 HistorySize = 1024;
+		// Bucket i counts frames of [i, i + 1) milliseconds, the last one everything slower.
+		static constexpr u32 HistogramBucketCount = 100;
+
+		// All times in milliseconds.
+		struct Summary
+		{
+			u32 frames;
+			f64 mean;
+			f64 p50;
+			f64 p95;
+			f64 p99;
+			f64 max;
+			// Frames over budget in the history.
+			u32 hitches;
+		};
+
+		FrameStats();
+		~FrameStats();
+
+		void AddFrame(u64 nanoseconds);
+		void Reset();
+
+		// Frames that take longer than this count as hitches.
+		void SetBudget(f64 milliseconds);
+		f64 GetBudget() const { return (f64)m_BudgetNanoseconds * 1e-6; }
+
+		Summary GetSummary() const;
+		const u32* GetHistogram() const { return m_Histogram; }
+		// Oldest first, returns how many were written.
+		u32 GetHistory(f32* milliseconds, u32 capacity) const;
+
+		u64 GetLifetimeFrames() const { return m_LifetimeFrames; }
+		u64 GetLifetimeHitches() const { return m_LifetimeHitches; }
+		f64 GetLifetimeMax() const { return (f64)m_LifetimeMax * 1e-6; }
+
+		// Writes the summary and the lifetime numbers to the log.
+		void Dump() const;
+		bool ExportCsv(const std::string& path) const;
+
+	private:
+		static u32 GetBucket(u64 nanoseconds);
+
+		u64 m_History[HistorySize];
+		u32 m_Histogram[HistogramBucketCount];
+		u32 m_Next;
+		u32 m_Count;
+		u32 m_Hitches;
+		u64 m_BudgetNanoseconds;
+
+		u64 m_LifetimeFrames;
+		u64 m_LifetimeHitches;
+		u64 m_LifetimeMax;
+		u64 m_LifetimeNanoseconds;
+	};
+}
+namespace fw = frostwave;
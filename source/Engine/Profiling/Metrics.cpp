@@ -0,0 +1,146 @@
+#include "Metrics.h"
+#include <Engine/Memory/Allocator.h>
+#include <cstdio>
+
+frostwave::Metrics* frostwave::Metrics::m_Instance = nullptr;
+frostwave::Metric* frostwave::Metrics::s_Metrics[MaxMetrics] = { };
+std::atomic<u32> frostwave::Metrics::s_MetricCount = 0;
+
+frostwave::Metric frostwave::metrics::DrawCalls("Draw calls");
+frostwave::Metric frostwave::metrics::DrawnIndices("Drawn indices");
+frostwave::Metric frostwave::metrics::ShaderBinds("Shader binds");
+frostwave::Metric frostwave::metrics::TextureBinds("Texture binds");
+frostwave::Metric frostwave::metrics::BufferBinds("Buffer binds");
+frostwave::Metric frostwave::metrics::BufferUploads("Buffer uploads");
+frostwave::Metric frostwave::metrics::UploadedBytes("Uploaded bytes");
+frostwave::Metric frostwave::metrics::SubmittedModels("Submitted models");
+frostwave::Metric frostwave::metrics::SceneModels("Scene models", Metric::Kind::Gauge);
+
+frostwave::Metric::Metric(const c8* name, Kind kind) : m_Value(0), m_Name(name), m_Kind(kind)
+{
+	Metrics::Register(this);
+}
+
+void frostwave::Metrics::Create()
+{
+	m_Instance = Allocate();
+}
+
+void frostwave::Metrics::Destroy()
+{
+	Free(m_Instance);
+	m_Instance = nullptr;
+}
+
+void frostwave::Metrics::Snapshot(u64 frameIndex)
+{
+	if (!m_Instance) return;
+
+	i64* row = m_Instance->m_History[m_Instance->m_Next];
+	u32 count = GetMetricCount();
+	for (u32 i = 0; i < count; ++i)
+	{
+		Metric* metric = s_Metrics[i];
+		row[i] = metric->m_Kind == Metric::Kind::Counter ? metric->m_Value.exchange(0, std::memory_order_relaxed) : metric->m_Value.load(std::memory_order_relaxed);
+	}
+
+	m_Instance->m_Frames[m_Instance->m_Next] = frameIndex;
+	m_Instance->m_Next = (m_Instance->m_Next + 1) % HistorySize;
+	m_Instance->m_Count = std::min(m_Instance->m_Count + 1, HistorySize);
+}
+
+u32 frostwave::Metrics::GetFrameCount()
+{
+	return m_Instance ? m_Instance->m_Count : 0;
+}
+
+i64 frostwave::Metrics::GetLast(u32 metric)
+{
+	if (!GetFrameCount()) return 0;
+	return m_Instance->m_History[GetSlot(0)][metric];
+}
+
+u32 frostwave::Metrics::GetHistory(u32 metric, f32* values, u32 capacity)
+{
+	u32 count = std::min(capacity, GetFrameCount());
+	for (u32 i = 0; i < count; ++i)
+		values[i] = (f32)m_Instance->m_History[GetSlot(count - 1 - i)][metric];
+	return count;
+}
+
+bool frostwave::Metrics::ExportCsv(const std::string& path)
+{
+	FILE* file = nullptr;
+	if (fopen_s(&file, path.c_str(), "w") != 0 || !file)
+	{
+		ERROR_LOG("Failed to open '%s' for writing metrics", path.c_str());
+		return false;
+	}
+
+	u32 metricCount = GetMetricCount();
+	fprintf(file, "frame");
+	for (u32 i = 0; i < metricCount; ++i)
+		fprintf(file, ",\"%s\"", s_Metrics[i]->GetName());
+	fprintf(file, "\n");
+
+	for (u32 age = GetFrameCount(); age-- > 0;)
+	{
+		u32 slot = GetSlot(age);
+		fprintf(file, "%llu", m_Instance->m_Frames[slot]);
+		for (u32 i = 0; i < metricCount; ++i)
+			fprintf(file, ",%lld", m_Instance->m_History[slot][i]);
+		fprintf(file, "\n");
+	}
+
+	fclose(file);
+	return true;
+}
+
+bool frostwave::Metrics::ExportJson(const std::string& path)
+{
+	FILE* file = nullptr;
+	if (fopen_s(&file, path.c_str(), "w") != 0 || !file)
+	{
+		ERROR_LOG("Failed to open '%s' for writing metrics", path.c_str());
+		return false;
+	}
+
+	u32 metricCount = GetMetricCount();
+	fprintf(file, "{\n\t\"metrics\": [");
+	for (u32 i = 0; i < metricCount; ++i)
+		fprintf(file, "%s{ \"name\": \"%s\", \"kind\": \"%s\" }", i ? ", " : "", s_Metrics[i]->GetName(), s_Metrics[i]->GetKind() == Metric::Kind::Counter ? "counter" : "gauge");
+	fprintf(file, "],\n\t\"frames\": [\n");
+
+	for (u32 age = GetFrameCount(); age-- > 0;)
+	{
+		u32 slot = GetSlot(age);
+		fprintf(file, "\t\t{ \"frame\": %llu, \"values\": [", m_Instance->m_Frames[slot]);
+		for (u32 i = 0; i < metricCount; ++i)
+			fprintf(file, "%s%lld", i ? ", " : "", m_Instance->m_History[slot][i]);
+		fprintf(file, "] }%s\n", age ? "," : "");
+	}
+	fprintf(file, "\t]\n}\n");
+
+	fclose(file);
+	return true;
+}
+
+frostwave::Metrics::Metrics() : m_History(), m_Frames(), m_Next(0), m_Count(0)
+{
+}
+
+frostwave::Metrics::~Metrics()
+{
+}
+
+void frostwave::Metrics::Register(Metric* metric)
+{
+	u32 index = s_MetricCount.fetch_add(1, std::memory_order_acq_rel);
+	if (index < MaxMetrics)
+		s_Metrics[index] = metric;
+}
+
+u32 frostwave::Metrics::GetSlot(u32 age)
+{
+	return (m_Instance->m_Next + HistorySize - 1 - age) % HistorySize;
+}
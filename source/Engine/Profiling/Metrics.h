@@ -0,0 +1,116 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+// Counting stays in every configuration, an event is one relaxed add so production captures can keep it on.
+#ifndef FW_METRICS
+	#define FW_METRICS 1
+#endif
+
+#if FW_METRICS
+#define FW_METRIC_ADD(metric, amount) (metric).Add((i64)(amount))
+#define FW_METRIC_SET(metric, value) (metric).Set((i64)(value))
+#else
+#define FW_METRIC_ADD(metric, amount)
+#define FW_METRIC_SET(metric, value)
+#endif
+
+namespace frostwave
+{
+	// A named value that Metrics snapshots once per frame. Metrics are meant to be globals: they register
+	// themselves when constructed and have to outlive every snapshot.
+	class Metric
+	{
+	public:
+		enum class Kind
+		{
+			// Summed over a frame and reset by the snapshot.
+			Counter,
+			// Keeps the last value set.
+			Gauge,
+		};
+
+		Metric(const c8* name, Kind kind = Kind::Counter);
+
+		void Add(i64 amount) { m_Value.fetch_add(amount, std::memory_order_relaxed); }
+		void Set(i64 value) { m_Value.store(value, std::memory_order_relaxed); }
+
+		const c8* GetName() const { return m_Name; }
+		Kind GetKind() const { return m_Kind; }
+
+		Metric(const Metric&) = delete;
+		Metric& operator=(const Metric&) = delete;
+
+	private:
+		friend class Metrics;
+
+		std::atomic<i64> m_Value;
+		const c8* m_Name;
+		Kind m_Kind;
+	};
+
+	// Registry of every Metric and a ring of the last HistorySize frame snapshots.
+	class Metrics
+	{
+	public:
+		static constexpr u32 MaxMetrics = 64;
+		static constexpr u32 HistorySize = 240;
+
+		static void Create();
+		static void Destroy();
+
+		// Records every metric into the ring and starts the next frame's counters at zero.
+		static void Snapshot(u64 frameIndex);
+
+		static u32 GetMetricCount() { return std::min(s_MetricCount.load(std::memory_order_acquire), MaxMetrics); }
+		static const Metric* GetMetric(u32 index) { return s_Metrics[index]; }
+
+		// Snapshots in the ring, at most HistorySize.
+		static u32 GetFrameCount();
+		// Value of a metric in the last snapshot.
+		static i64 GetLast(u32 metric);
+		// Oldest first, returns how many were written.
+		static u32 GetHistory(u32 metric, f32* values, u32 capacity);
+
+		// One row per frame, one column per metric.
+		static bool ExportCsv(const std::string& path);
+		static bool ExportJson(const std::string& path);
+
+	private:
+		friend class Metric;
+		friend class Allocator;
+
+		Metrics();
+		~Metrics();
+
+		static void Register(Metric* metric);
+		static u32 GetSlot(u32 age);
+
+		static Metrics* m_Instance;
+		// Filled while globals are constructed, before anything can create the instance.
+		static Metric* s_Metrics[MaxMetrics];
+		static std::atomic<u32> s_MetricCount;
+
+		i64 m_History[HistorySize][MaxMetrics];
+		u64 m_Frames[HistorySize];
+		u32 m_Next;
+		u32 m_Count;
+	};
+
+	// Engine wide metrics, counted where the work is issued.
+	namespace metrics
+	{
+		extern Metric DrawCalls;
+		extern Metric DrawnIndices;
+		extern Metric ShaderBinds;
+		extern Metric TextureBinds;
+		extern Metric BufferBinds;
+		extern Metric BufferUploads;
+		extern Metric UploadedBytes;
+		extern Metric SubmittedModels;
+		extern Metric SceneModels;
+	}
+}
+namespace fw = frostwave;
@@ -0,0 +1,290 @@
+#include "Profiler.h"
+#include <Engine/Memory/Allocator.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define FW_PROFILE_RDTSC 1
+#endif
+
+frostwave::Profiler* frostwave::Profiler::m_Instance = nullptr;
+std::atomic<bool> frostwave::Profiler::s_Capturing = false;
+
+#pragma warning(push)
+// Padding is the point of the cache line alignment.
+#pragma warning(disable : 4324)
+// Only the owning thread writes, the capture is read after recording stopped. A thread starts over
+// when it sees a new capture generation, so nothing but the owner ever resets the count.
+struct frostwave::Profiler::ThreadBuffer
+{
+	struct OpenScope
+	{
+		const c8* name;
+		u64 begin;
+	};
+
+	alignas(Allocator::CacheLineSize) std::atomic<u64> count = 0;
+	u32 generation = 0;
+	u32 depth = 0;
+	u32 index = 0;
+	u64 dropped = 0;
+	std::atomic<bool> orphaned = false;
+	ThreadBuffer* next = nullptr;
+
+	OpenScope stack[MaxDepth];
+	Event events[EventsPerThread];
+};
+#pragma warning(pop)
+
+namespace
+{
+	// Buffers belong to one profiler, a thread that outlives it asks for a new one.
+	std::atomic<u64> s_ProfilerGeneration = 0;
+
+	struct ThreadBufferSlot
+	{
+		void* buffer = nullptr;
+		std::atomic<bool>* orphaned = nullptr;
+		u64 profilerGeneration = 0;
+
+		// Lets a later thread reuse the buffer, what it recorded stays part of the capture.
+		~ThreadBufferSlot()
+		{
+			if (orphaned && profilerGeneration == s_ProfilerGeneration.load(std::memory_order_relaxed))
+				orphaned->store(true, std::memory_order_release);
+		}
+	};
+	thread_local ThreadBufferSlot t_BufferSlot;
+
+	void WriteJsonString(FILE* file, const c8* string)
+	{
+		fputc('"', file);
+		for (const c8* c = string; *c; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+				fprintf(file, "\\%c", *c);
+			else if ((u8)*c < 0x20)
+				fprintf(file, "\\u%04x", (u32)(u8)*c);
+			else
+				fputc(*c, file);
+		}
+		fputc('"', file);
+	}
+}
+
+void frostwave::Profiler::Create()
+{
+	m_Instance = Allocate();
+	s_ProfilerGeneration++;
+}
+
+void frostwave::Profiler::Destroy()
+{
+	s_Capturing = false;
+	Profiler* profiler = m_Instance;
+	m_Instance = nullptr;
+	s_ProfilerGeneration++;
+
+	ThreadBuffer* buffer = profiler->m_Buffers.exchange(nullptr);
+	while (buffer)
+	{
+		ThreadBuffer* next = buffer->next;
+		delete buffer;
+		buffer = next;
+	}
+	Free(profiler);
+}
+
+void frostwave::Profiler::BeginCapture()
+{
+	if (!m_Instance || s_Capturing) return;
+
+	m_Instance->m_Generation++;
+	m_Instance->m_CaptureTicks = GetTicks();
+	m_Instance->m_CaptureNanoseconds = (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	s_Capturing.store(true, std::memory_order_release);
+}
+
+bool frostwave::Profiler::EndCapture(const c8* path)
+{
+	if (!m_Instance || !s_Capturing) return false;
+	s_Capturing.store(false, std::memory_order_release);
+
+	// Calibrates the scope clock against the steady clock over the length of the capture.
+	u64 ticks = GetTicks() - m_Instance->m_CaptureTicks;
+	u64 nanoseconds = (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - m_Instance->m_CaptureNanoseconds;
+	f64 microsecondsPerTick = ticks ? (f64)nanoseconds / (f64)ticks * 1e-3 : 0.0;
+
+	return WriteTrace(path, m_Instance->m_CaptureTicks, microsecondsPerTick);
+}
+
+void frostwave::Profiler::SetThreadName(const c8* name)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+	if (!buffer) return;
+
+	std::lock_guard<std::mutex> lock(m_Instance->m_NameMutex);
+	m_Instance->m_ThreadNames[buffer->index] = m_Instance->m_Names.emplace(name).first->c_str();
+}
+
+const c8* frostwave::Profiler::Intern(std::string_view name)
+{
+	if (!m_Instance) return "";
+
+	std::lock_guard<std::mutex> lock(m_Instance->m_NameMutex);
+	return m_Instance->m_Names.emplace(name).first->c_str();
+}
+
+void frostwave::Profiler::BeginScope(const c8* name)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+	if (!buffer) return;
+
+	if (buffer->depth < MaxDepth)
+		buffer->stack[buffer->depth] = { name, GetTicks() };
+	buffer->depth++;
+}
+
+void frostwave::Profiler::EndScope()
+{
+	u64 end = GetTicks();
+	ThreadBuffer* buffer = GetThreadBuffer();
+	if (!buffer || !buffer->depth) return;
+
+	u32 depth = --buffer->depth;
+	if (depth >= MaxDepth || !s_Capturing.load(std::memory_order_relaxed)) return;
+
+	u32 generation = m_Instance->m_Generation.load(std::memory_order_relaxed);
+	if (buffer->generation != generation)
+	{
+		buffer->generation = generation;
+		buffer->dropped = 0;
+		buffer->count.store(0, std::memory_order_relaxed);
+	}
+
+	u64 count = buffer->count.load(std::memory_order_relaxed);
+	if (count == EventsPerThread)
+	{
+		buffer->dropped++;
+		return;
+	}
+
+	const ThreadBuffer::OpenScope& scope = buffer->stack[depth];
+	buffer->events[count] = { scope.name, scope.begin, end, buffer->index, depth };
+	buffer->count.store(count + 1, std::memory_order_release);
+}
+
+u64 frostwave::Profiler::GetTicks()
+{
+#if FW_PROFILE_RDTSC
+	return __rdtsc();
+#else
+	return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+frostwave::Profiler::Profiler() : m_Buffers(nullptr), m_NextThreadIndex(1), m_Generation(0), m_CaptureTicks(0), m_CaptureNanoseconds(0)
+{
+}
+
+frostwave::Profiler::~Profiler()
+{
+}
+
+frostwave::Profiler::ThreadBuffer* frostwave::Profiler::GetThreadBuffer()
+{
+	ThreadBufferSlot& slot = t_BufferSlot;
+	u64 generation = s_ProfilerGeneration.load(std::memory_order_relaxed);
+	if (slot.buffer && slot.profilerGeneration == generation) return (ThreadBuffer*)slot.buffer;
+	if (!m_Instance) return nullptr;
+
+	// Reuse the buffer of a thread that exited before allocating another one.
+	ThreadBuffer* buffer = nullptr;
+	for (ThreadBuffer* it = m_Instance->m_Buffers.load(std::memory_order_acquire); it; it = it->next)
+	{
+		bool orphaned = true;
+		if (it->orphaned.load(std::memory_order_relaxed) && it->orphaned.compare_exchange_strong(orphaned, false, std::memory_order_acquire))
+		{
+			buffer = it;
+			break;
+		}
+	}
+
+	if (!buffer)
+	{
+		buffer = new ThreadBuffer;
+		buffer->next = m_Instance->m_Buffers.load(std::memory_order_relaxed);
+		while (!m_Instance->m_Buffers.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed)) { }
+	}
+
+	// Events already recorded keep the index of the thread that recorded them.
+	buffer->index = m_Instance->m_NextThreadIndex++;
+	buffer->depth = 0;
+	slot.buffer = buffer;
+	slot.orphaned = &buffer->orphaned;
+	slot.profilerGeneration = generation;
+	return buffer;
+}
+
+bool frostwave::Profiler::WriteTrace(const c8* path, u64 captureBegin, f64 microsecondsPerTick)
+{
+	FILE* file = nullptr;
+	if (fopen_s(&file, path, "w") != 0 || !file)
+	{
+		ERROR_LOG("Failed to open '%s' to write the profiler capture", path);
+		return false;
+	}
+
+	u32 generation = m_Instance->m_Generation.load(std::memory_order_relaxed);
+	u64 eventCount = 0;
+	u64 dropped = 0;
+	bool first = true;
+
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+	for (ThreadBuffer* buffer = m_Instance->m_Buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+	{
+		if (buffer->generation != generation) continue;
+
+		u64 count = buffer->count.load(std::memory_order_acquire);
+		for (u64 i = 0; i < count; ++i)
+		{
+			const Event& event = buffer->events[i];
+			// Scopes that were already open when the capture started are cut to its start.
+			u64 begin = std::max(event.begin, captureBegin);
+			fprintf(file, "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":", first ? "" : ",\n", event.thread,
+				(f64)(begin - captureBegin) * microsecondsPerTick, (f64)(event.end - begin) * microsecondsPerTick);
+			WriteJsonString(file, event.name);
+			fputc('}', file);
+			first = false;
+		}
+
+		eventCount += count;
+		dropped += buffer->dropped;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Instance->m_NameMutex);
+		for (auto& [thread, name] : m_Instance->m_ThreadNames)
+		{
+			fprintf(file, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", first ? "" : ",\n", thread);
+			WriteJsonString(file, name);
+			fputs("}}", file);
+			first = false;
+		}
+	}
+	fputs("\n]}\n", file);
+	fclose(file);
+
+	if (dropped)
+	{
+		WARNING_LOG("Profiler capture '%s' dropped %llu scopes, threads ran out of room for events", path, dropped);
+	}
+	INFO_LOG("Wrote %llu profiler scopes to '%s'", eventCount, path);
+	return true;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <Engine/Core/Types.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+// Scopes are compiled into Debug and Release builds, Retail pays nothing for them.
+#ifndef FW_PROFILE
+	#ifdef _RETAIL
+		#define FW_PROFILE 0
+	#else
+		#define FW_PROFILE 1
+	#endif
+#endif
+
+#define FW_PROFILE_CONCAT_INNER(a, b) a##b
+#define FW_PROFILE_CONCAT(a, b) FW_PROFILE_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing block, the name has to outlive the capture (a literal, or Profiler::Intern).
+#if FW_PROFILE
+#define FW_PROFILE_SCOPE(name) fw::ProfileScope FW_PROFILE_CONCAT(fwProfileScope, __LINE__)(name)
+#define FW_PROFILE_FUNCTION() FW_PROFILE_SCOPE(__FUNCTION__)
+#else
+#define FW_PROFILE_SCOPE(name)
+#define FW_PROFILE_FUNCTION()
+#endif
+
+namespace frostwave
+{
+	// Records nested CPU scopes into buffers owned by each thread while a capture runs and writes the capture
+	// as Chrome trace JSON, which chrome://tracing and ui.perfetto.dev open. Outside a capture a scope is one
+	// relaxed load, inside it is two timestamps and a store into the thread's own buffer.
+	class Profiler
+	{
+	public:
+		// Deeper scopes are not recorded, their parents still are.
+		static constexpr u32 MaxDepth = 64;
+		// Events a thread keeps per capture, later ones are dropped and counted.
+		static constexpr u64 EventsPerThread = 64 * 1024;
+
+		struct Event
+		{
+			const c8* name;
+			u64 begin;
+			u64 end;
+			u32 thread;
+			u32 depth;
+		};
+
+		static void Create();
+		static void Destroy();
+
+		static void BeginCapture();
+		// Stops recording and writes what was captured to path.
+		static bool EndCapture(const c8* path);
+		static bool IsCapturing() { return s_Capturing.load(std::memory_order_relaxed); }
+
+		// Shown as the thread's name in the trace.
+		static void SetThreadName(const c8* name);
+		// Gives names built at runtime a lifetime that scopes can point at, the same string returns the same pointer.
+		static const c8* Intern(std::string_view name);
+
+		// Prefer FW_PROFILE_SCOPE, these are for scopes that do not follow a block like Framework's events.
+		// A scope begun outside a capture is still tracked, so begin and end stay paired whenever the capture starts.
+		static void BeginScope(const c8* name);
+		static void EndScope();
+
+		// Raw timestamp of the scope clock, converted to time when a capture is written.
+		static u64 GetTicks();
+
+	private:
+		struct ThreadBuffer;
+
+		Profiler();
+		~Profiler();
+		friend class Allocator;
+
+		static ThreadBuffer* GetThreadBuffer();
+		static bool WriteTrace(const c8* path, u64 captureBegin, f64 microsecondsPerTick);
+
+		static Profiler* m_Instance;
+		static std::atomic<bool> s_Capturing;
+
+		std::atomic<ThreadBuffer*> m_Buffers;
+		std::atomic<u32> m_NextThreadIndex;
+		std::atomic<u32> m_Generation;
+
+		u64 m_CaptureTicks;
+		u64 m_CaptureNanoseconds;
+
+		std::mutex m_NameMutex;
+		std::unordered_set<std::string> m_Names;
+		std::unordered_map<u32, const c8*> m_ThreadNames;
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const c8* name) : m_Active(Profiler::IsCapturing())
+		{
+			if (m_Active) Profiler::BeginScope(name);
+		}
+		~ProfileScope()
+		{
+			if (m_Active) Profiler::EndScope();
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		bool m_Active;
+	};
+}
+namespace fw = frostwave;
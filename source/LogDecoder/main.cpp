@@ -0,0 +1,597 @@
+#include <Engine/Logging/BinaryLog.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Turns a capture written by BinaryFileSink back into the text FileSink would have written, or into JSON.
+// Given a FlightRecorder file it dumps the records still in the ring, oldest first, with the frame markers between them.
+// Usage: LogDecoder <capture.fwlog|recording.flight> [--json] [--output <file>]
+
+namespace
+{
+	struct Site
+	{
+		u8 level = 0;
+		u64 line = 0;
+		std::string file;
+		std::string function;
+		std::string format;
+		std::string signature;
+	};
+
+	struct Argument
+	{
+		c8 kind = 0;
+		u64 bits = 0;
+		f64 real = 0.0;
+		// Strings are kept as UTF-8, wide ones are converted while reading.
+		std::string text;
+	};
+
+	const c8* GetLevelString(u8 level)
+	{
+		constexpr const c8* Levels[] = { "ALL", "VERBOSE", "INFO", "WARNING", "ERROR", "FATAL" };
+		return level < sizeof(Levels) / sizeof(Levels[0]) ? Levels[level] : "???";
+	}
+
+	void AppendUtf8(std::string& out, u32 codepoint)
+	{
+		if (codepoint < 0x80)
+		{
+			out += (c8)codepoint;
+		}
+		else if (codepoint < 0x800)
+		{
+			out += (c8)(0xc0 | (codepoint >> 6));
+			out += (c8)(0x80 | (codepoint & 0x3f));
+		}
+		else if (codepoint < 0x10000)
+		{
+			out += (c8)(0xe0 | (codepoint >> 12));
+			out += (c8)(0x80 | ((codepoint >> 6) & 0x3f));
+			out += (c8)(0x80 | (codepoint & 0x3f));
+		}
+		else
+		{
+			out += (c8)(0xf0 | (codepoint >> 18));
+			out += (c8)(0x80 | ((codepoint >> 12) & 0x3f));
+			out += (c8)(0x80 | ((codepoint >> 6) & 0x3f));
+			out += (c8)(0x80 | (codepoint & 0x3f));
+		}
+	}
+
+	void AppendString(Argument& argument, const u8* characters, u64 length, u64 size)
+	{
+		for (u64 c = 0; c < length; ++c)
+		{
+			if (argument.kind == 's')
+			{
+				argument.text += (c8)characters[c];
+				continue;
+			}
+
+			u32 codepoint = 0;
+			memcpy(&codepoint, characters + c * size, size < sizeof(u32) ? size : sizeof(u32));
+			// Windows captures hold UTF-16, join surrogate pairs.
+			if (size == 2 && codepoint >= 0xd800 && codepoint < 0xdc00 && c + 1 < length)
+			{
+				u32 low = 0;
+				memcpy(&low, characters + (c + 1) * size, size);
+				if (low >= 0xdc00 && low < 0xe000)
+				{
+					codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+					++c;
+				}
+			}
+			AppendUtf8(argument.text, codepoint);
+		}
+	}
+
+	void ReadFloat(Argument& argument, const u8* cursor, u64 size)
+	{
+		if (size == sizeof(f32))
+		{
+			f32 value;
+			memcpy(&value, cursor, sizeof(f32));
+			argument.real = value;
+		}
+		else if (size == sizeof(f64))
+		{
+			memcpy(&argument.real, cursor, sizeof(f64));
+		}
+		else if (size == sizeof(long double))
+		{
+			long double value;
+			memcpy(&value, cursor, sizeof(long double));
+			argument.real = (f64)value;
+		}
+	}
+
+	bool ReadString(const u8*& cursor, const u8* end, std::string& string)
+	{
+		u64 length;
+		if (!fw::ReadVarint(cursor, end, length) || (u64)(end - cursor) < length) return false;
+		string.assign((const c8*)cursor, length);
+		cursor += length;
+		return true;
+	}
+
+	// Unpacks the arguments as BinaryFileSink packed them, guided by the site's signature.
+	bool ReadArguments(const Site& site, const u8* cursor, const u8* end, std::vector<Argument>& arguments)
+	{
+		arguments.clear();
+		for (u64 i = 0; i + 1 < site.signature.size(); i += 2)
+		{
+			Argument& argument = arguments.emplace_back();
+			argument.kind = site.signature[i];
+			u64 size = (u64)(site.signature[i + 1] - '0');
+
+			if (argument.kind == 's' || argument.kind == 'w')
+			{
+				u64 length;
+				if (!fw::ReadVarint(cursor, end, length) || size == 0 || (u64)(end - cursor) / size < length) return false;
+
+				AppendString(argument, cursor, length, size);
+				cursor += length * size;
+			}
+			else if (argument.kind == 'f')
+			{
+				if ((u64)(end - cursor) < size) return false;
+				ReadFloat(argument, cursor, size);
+				cursor += size;
+			}
+			else
+			{
+				if (!fw::ReadVarint(cursor, end, argument.bits)) return false;
+				if (argument.kind == 'i') argument.bits = (u64)fw::ZigZagDecode(argument.bits);
+			}
+		}
+		return true;
+	}
+
+	// Reads arguments as the logger's ring holds them, which is what a flight recorder slot stores. Arguments that
+	// did not fit in the slot are left out, the message shows them as missing.
+	void ReadRingArguments(const Site& site, const u8* cursor, const u8* end, std::vector<Argument>& arguments)
+	{
+		arguments.clear();
+		for (u64 i = 0; i + 1 < site.signature.size(); i += 2)
+		{
+			c8 kind = site.signature[i];
+			u64 size = (u64)(site.signature[i + 1] - '0');
+			if (size == 0 || (u64)(end - cursor) < 8) return;
+
+			Argument argument;
+			argument.kind = kind;
+			if (kind == 's' || kind == 'w')
+			{
+				u64 length;
+				memcpy(&length, cursor, sizeof(u64));
+				u64 padded = (sizeof(u64) + (length + 1) * size + 7) & ~7ull;
+				if ((u64)(end - cursor) < padded) return;
+				AppendString(argument, cursor + sizeof(u64), length, size);
+				cursor += padded;
+			}
+			else
+			{
+				u64 padded = (size + 7) & ~7ull;
+				if ((u64)(end - cursor) < padded) return;
+				if (kind == 'f')
+				{
+					ReadFloat(argument, cursor, size);
+				}
+				else
+				{
+					memcpy(&argument.bits, cursor, size < sizeof(u64) ? size : sizeof(u64));
+					// Sign extend, the formatter treats bits as 64 bit.
+					if (kind == 'i' && size < sizeof(u64) && (argument.bits >> (size * 8 - 1)) & 1) argument.bits |= ~0ull << (size * 8);
+				}
+				cursor += padded;
+			}
+			arguments.push_back(std::move(argument));
+		}
+	}
+
+	// Formats the message one conversion at a time, widening every value to 64 bits so the capture
+	// decodes the same no matter which platform wrote it.
+	std::string FormatMessage(const Site& site, const std::vector<Argument>& arguments)
+	{
+		std::string message;
+		u64 next = 0;
+		auto take = [&]() -> const Argument*
+		{
+			return next < arguments.size() ? &arguments[next++] : nullptr;
+		};
+
+		const c8* format = site.format.c_str();
+		for (const c8* c = format; *c; ++c)
+		{
+			if (*c != '%')
+			{
+				message += *c;
+				continue;
+			}
+			if (c[1] == '%')
+			{
+				message += '%';
+				++c;
+				continue;
+			}
+
+			std::string spec = "%";
+			++c;
+			while (*c && strchr("-+ #0", *c)) spec += *c++;
+
+			if (*c == '*')
+			{
+				const Argument* width = take();
+				spec += std::to_string(width ? (i64)width->bits : 0);
+				++c;
+			}
+			while (*c >= '0' && *c <= '9') spec += *c++;
+
+			if (*c == '.')
+			{
+				spec += *c++;
+				if (*c == '*')
+				{
+					const Argument* precision = take();
+					spec += std::to_string(precision ? (i64)precision->bits : 0);
+					++c;
+				}
+				while (*c >= '0' && *c <= '9') spec += *c++;
+			}
+
+			// Lengths are dropped, the value is passed at the width the rebuilt conversion asks for.
+			while (*c && strchr("hlwjztLI", *c))
+			{
+				if (*c == 'I' && ((c[1] == '6' && c[2] == '4') || (c[1] == '3' && c[2] == '2'))) c += 2;
+				++c;
+			}
+			if (!*c) break;
+
+			const Argument* argument = take();
+			if (!argument)
+			{
+				message += "<missing>";
+				continue;
+			}
+
+			c8 buffer[512];
+			switch (*c)
+			{
+			case 'd': case 'i':
+				spec += "lld";
+				snprintf(buffer, sizeof(buffer), spec.c_str(), (long long)argument->bits);
+				break;
+			case 'u': case 'o': case 'x': case 'X':
+				spec += "ll";
+				spec += *c;
+				snprintf(buffer, sizeof(buffer), spec.c_str(), (unsigned long long)argument->bits);
+				break;
+			case 'c': case 'C':
+			{
+				std::string character;
+				AppendUtf8(character, (u32)argument->bits);
+				spec += 's';
+				snprintf(buffer, sizeof(buffer), spec.c_str(), character.c_str());
+				break;
+			}
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+				spec += *c;
+				snprintf(buffer, sizeof(buffer), spec.c_str(), argument->real);
+				break;
+			case 's': case 'S':
+				// Long strings go around the buffer, only the padding has to be formatted.
+				if (spec.size() == 1)
+				{
+					message += argument->text;
+					continue;
+				}
+				spec += 's';
+				snprintf(buffer, sizeof(buffer), spec.c_str(), argument->text.c_str());
+				break;
+			case 'p':
+				snprintf(buffer, sizeof(buffer), "%016llX", (unsigned long long)argument->bits);
+				break;
+			default:
+				snprintf(buffer, sizeof(buffer), "<%%%c>", *c);
+				break;
+			}
+			message += buffer;
+		}
+		return message;
+	}
+
+	void WriteJsonString(FILE* output, const std::string& string)
+	{
+		fputc('"', output);
+		for (c8 c : string)
+		{
+			switch (c)
+			{
+			case '"': fputs("\\\"", output); break;
+			case '\\': fputs("\\\\", output); break;
+			case '\n': fputs("\\n", output); break;
+			case '\r': fputs("\\r", output); break;
+			case '\t': fputs("\\t", output); break;
+			default:
+				if ((u8)c < 0x20)
+					fprintf(output, "\\u%04x", (u32)(u8)c);
+				else
+					fputc(c, output);
+				break;
+			}
+		}
+		fputc('"', output);
+	}
+
+	void WriteMessage(FILE* output, bool json, bool first, f64 seconds, u64 thread, const Site& site, const std::string& message)
+	{
+		if (json)
+		{
+			fprintf(output, "%s  { \"time\": %.9f, \"thread\": %llu, \"level\": \"%s\", \"file\": ", first ? "" : ",\n", seconds, (unsigned long long)thread, GetLevelString(site.level));
+			WriteJsonString(output, site.file);
+			fprintf(output, ", \"line\": %llu, \"function\": ", (unsigned long long)site.line);
+			WriteJsonString(output, site.function);
+			fputs(", \"message\": ", output);
+			WriteJsonString(output, message);
+			fputs(" }", output);
+		}
+		else
+		{
+			fprintf(output, "[%.6f][%llu][%s] %s:%llu:%s: %s\n", seconds, (unsigned long long)thread, GetLevelString(site.level),
+				site.file.c_str(), (unsigned long long)site.line, site.function.c_str(), message.c_str());
+		}
+	}
+
+	// Returns the number of messages, reports a capture cut off by a crash after the last complete record.
+	u64 DecodeCapture(const std::vector<u8>& data, FILE* output, bool json)
+	{
+		std::vector<Site> sites;
+		std::vector<Argument> arguments;
+		u64 time = 0;
+		u64 count = 0;
+		bool truncated = false;
+
+		const u8* cursor = data.data() + sizeof(fw::BinaryLogHeader);
+		const u8* end = data.data() + data.size();
+		while (cursor < end)
+		{
+			auto type = (fw::BinaryLogRecordType)*cursor++;
+			if (type == fw::BinaryLogRecordType::Site)
+			{
+				Site site;
+				u64 id;
+				if (!fw::ReadVarint(cursor, end, id) || cursor >= end) { truncated = true; break; }
+				site.level = *cursor++;
+				if (!fw::ReadVarint(cursor, end, site.line) || !ReadString(cursor, end, site.file) || !ReadString(cursor, end, site.function) ||
+					!ReadString(cursor, end, site.format) || !ReadString(cursor, end, site.signature))
+				{
+					truncated = true;
+					break;
+				}
+
+				if (id >= sites.size()) sites.resize(id + 1);
+				sites[id] = std::move(site);
+			}
+			else if (type == fw::BinaryLogRecordType::Message)
+			{
+				u64 id, thread, delta, size;
+				if (!fw::ReadVarint(cursor, end, id) || !fw::ReadVarint(cursor, end, thread) || !fw::ReadVarint(cursor, end, delta) ||
+					!fw::ReadVarint(cursor, end, size) || (u64)(end - cursor) < size || id >= sites.size())
+				{
+					truncated = true;
+					break;
+				}
+
+				time += (u64)fw::ZigZagDecode(delta);
+				const Site& site = sites[id];
+				if (!ReadArguments(site, cursor, cursor + size, arguments))
+				{
+					truncated = true;
+					break;
+				}
+				cursor += size;
+
+				WriteMessage(output, json, count == 0, (f64)time * 1e-9, thread, site, FormatMessage(site, arguments));
+				++count;
+			}
+			else
+			{
+				truncated = true;
+				break;
+			}
+		}
+
+		if (truncated) fprintf(stderr, "Capture ends in an incomplete record after %llu messages\n", (unsigned long long)count);
+		return count;
+	}
+
+	bool ReadCString(const c8*& cursor, const c8* end, std::string& string)
+	{
+		const c8* terminator = (const c8*)memchr(cursor, 0, (u64)(end - cursor));
+		if (!terminator) return false;
+		string.assign(cursor, terminator);
+		cursor = terminator + 1;
+		return true;
+	}
+
+	u64 DecodeFlightRecording(const std::vector<u8>& data, FILE* output, bool json)
+	{
+		const fw::FlightRecorderHeader& header = *(const fw::FlightRecorderHeader*)data.data();
+		fw::FlightRecorderLayout layout = fw::GetFlightRecorderLayout(header.slotCount, header.siteCapacity, header.stringCapacity);
+		if (data.size() < layout.size)
+		{
+			fprintf(stderr, "Flight recording is smaller than its header says\n");
+			return 0;
+		}
+
+		u32 siteCount = header.siteCount.load();
+		if (siteCount >= header.siteCapacity) siteCount = header.siteCapacity - 1;
+		const c8* strings = (const c8*)data.data() + layout.strings;
+		const c8* stringsEnd = strings + header.stringSize.load();
+
+		// Site 0 is never used.
+		std::vector<Site> sites(siteCount + 1);
+		for (u32 id = 1; id <= siteCount; ++id)
+		{
+			u32 offset;
+			memcpy(&offset, data.data() + layout.sites + id * sizeof(u32), sizeof(u32));
+			const c8* cursor = strings + offset;
+			if (cursor + 5 > stringsEnd) continue;
+
+			Site& site = sites[id];
+			site.level = (u8)*cursor++;
+			u32 line;
+			memcpy(&line, cursor, sizeof(u32));
+			site.line = line;
+			cursor += sizeof(u32);
+			if (!ReadCString(cursor, stringsEnd, site.file) || !ReadCString(cursor, stringsEnd, site.function) ||
+				!ReadCString(cursor, stringsEnd, site.format) || !ReadCString(cursor, stringsEnd, site.signature))
+				sites[id] = Site();
+		}
+
+		u64 write = header.write.load();
+		u64 first = write > header.slotCount ? write - header.slotCount : 0;
+		const fw::FlightRecorderSlot* slots = (const fw::FlightRecorderSlot*)(data.data() + layout.slots);
+
+		std::vector<Argument> arguments;
+		u64 count = 0;
+		u64 skipped = 0;
+		for (u64 index = first; index < write; ++index)
+		{
+			const fw::FlightRecorderSlot& slot = slots[index & (header.slotCount - 1)];
+			// Anything else was being written when the process died, or was lapped by a newer record.
+			if (slot.sequence.load() != index + 1 || slot.size > fw::FlightRecorderSlot::PayloadSize)
+			{
+				++skipped;
+				continue;
+			}
+
+			f64 seconds = (f64)(i64)(slot.timestamp - header.startTimestamp) * 1e-9;
+			if (slot.type == fw::FlightRecordType::Frame)
+			{
+				if (json)
+					fprintf(output, "%s  { \"time\": %.9f, \"thread\": %u, \"frame\": %u }", count ? ",\n" : "", seconds, slot.thread, slot.site);
+				else
+					fprintf(output, "[%.6f][%u] ---- frame %u ----\n", seconds, slot.thread, slot.site);
+			}
+			else if (slot.site < sites.size() && !sites[slot.site].format.empty())
+			{
+				const Site& site = sites[slot.site];
+				ReadRingArguments(site, slot.payload, slot.payload + slot.size, arguments);
+				WriteMessage(output, json, count == 0, seconds, slot.thread, site, FormatMessage(site, arguments));
+			}
+			else
+			{
+				++skipped;
+				continue;
+			}
+			++count;
+		}
+
+		fprintf(stderr, "%llu records, %llu torn or unreadable, recording %s\n", (unsigned long long)count, (unsigned long long)skipped,
+			header.clean ? "was closed normally" : "ends in a crash");
+		return count;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const c8* inputPath = nullptr;
+	const c8* outputPath = nullptr;
+	bool json = false;
+	for (i32 i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--json") == 0)
+			json = true;
+		else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+			outputPath = argv[++i];
+		else
+			inputPath = argv[i];
+	}
+
+	if (!inputPath)
+	{
+		fprintf(stderr, "Usage: LogDecoder <capture.fwlog|recording.flight> [--json] [--output <file>]\n");
+		return 1;
+	}
+
+	FILE* input = nullptr;
+	if (fopen_s(&input, inputPath, "rb") != 0 || !input)
+	{
+		fprintf(stderr, "Failed to open '%s'\n", inputPath);
+		return 1;
+	}
+
+	std::vector<u8> data;
+	c8 chunk[64 * 1024];
+	u64 read;
+	while ((read = fread(chunk, 1, sizeof(chunk), input)) > 0)
+		data.insert(data.end(), chunk, chunk + read);
+	fclose(input);
+
+	bool flight = data.size() >= sizeof(fw::FlightRecorderHeader) && memcmp(data.data(), fw::FlightRecorderHeader::Magic, sizeof(fw::FlightRecorderHeader::Magic)) == 0;
+	if (flight)
+	{
+		u32 version;
+		memcpy(&version, data.data() + offsetof(fw::FlightRecorderHeader, version), sizeof(u32));
+		if (version != fw::FlightRecorderHeader::CurrentVersion)
+		{
+			fprintf(stderr, "'%s' is not a version %u flight recording\n", inputPath, fw::FlightRecorderHeader::CurrentVersion);
+			return 1;
+		}
+
+		// The decoder masks slot indices with slotCount - 1 and reads strings up to stringSize, a damaged header is rejected.
+		u64 slotCount;
+		u32 siteCapacity, stringCapacity, stringSize;
+		memcpy(&slotCount, data.data() + offsetof(fw::FlightRecorderHeader, slotCount), sizeof(slotCount));
+		memcpy(&siteCapacity, data.data() + offsetof(fw::FlightRecorderHeader, siteCapacity), sizeof(siteCapacity));
+		memcpy(&stringCapacity, data.data() + offsetof(fw::FlightRecorderHeader, stringCapacity), sizeof(stringCapacity));
+		memcpy(&stringSize, data.data() + offsetof(fw::FlightRecorderHeader, stringSize), sizeof(stringSize));
+		if (slotCount == 0 || (slotCount & (slotCount - 1)) != 0 || slotCount > data.size() / sizeof(fw::FlightRecorderSlot))
+		{
+			fprintf(stderr, "'%s' has an invalid slot count of %llu\n", inputPath, (unsigned long long)slotCount);
+			return 1;
+		}
+		if (siteCapacity == 0 || stringSize > stringCapacity)
+		{
+			fprintf(stderr, "'%s' has an invalid site or string table (%u sites, %u of %u string bytes)\n", inputPath, siteCapacity, stringSize, stringCapacity);
+			return 1;
+		}
+	}
+	else
+	{
+		fw::BinaryLogHeader header;
+		if (data.size() < sizeof(header))
+		{
+			fprintf(stderr, "'%s' is too small to be a log capture\n", inputPath);
+			return 1;
+		}
+		memcpy(&header, data.data(), sizeof(header));
+		if (memcmp(header.magic, fw::BinaryLogHeader::Magic, sizeof(header.magic)) != 0 || header.version != fw::BinaryLogHeader::CurrentVersion)
+		{
+			fprintf(stderr, "'%s' is not a version %u log capture\n", inputPath, fw::BinaryLogHeader::CurrentVersion);
+			return 1;
+		}
+	}
+
+	FILE* output = stdout;
+	if (outputPath && (fopen_s(&output, outputPath, "w") != 0 || !output))
+	{
+		fprintf(stderr, "Failed to open '%s' for writing\n", outputPath);
+		return 1;
+	}
+
+	if (json) fputs("[\n", output);
+	if (flight)
+		DecodeFlightRecording(data, output, json);
+	else
+		DecodeCapture(data, output, json);
+	if (json) fputs("\n]\n", output);
+
+	if (output != stdout) fclose(output);
+	return 0;
+}